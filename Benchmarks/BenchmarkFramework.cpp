@@ -0,0 +1,164 @@
+#include "BenchmarkFramework.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+
+namespace {
+    std::atomic<uint64_t> keptValue{0};
+
+    std::string escapeJson(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped.push_back('\\');
+            }
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
+    // Value of "key": in one line of our own output (strings unquoted); false if absent
+    bool findField(const std::string& line, const std::string& key, std::string& value) {
+        std::string pattern = "\"" + key + "\":";
+        size_t position = line.find(pattern);
+        if (position == std::string::npos) {
+            return false;
+        }
+        position += pattern.size();
+        while (position < line.size() && line[position] == ' ') {
+            ++position;
+        }
+        if (position < line.size() && line[position] == '"') {
+            size_t end = position + 1;
+            value.clear();
+            while (end < line.size() && line[end] != '"') {
+                if (line[end] == '\\' && end + 1 < line.size()) {
+                    ++end;
+                }
+                value.push_back(line[end++]);
+            }
+            return end < line.size();
+        }
+        size_t end = line.find_first_of(",}", position);
+        value = line.substr(position, end == std::string::npos ? std::string::npos : end - position);
+        return !value.empty();
+    }
+}
+
+void benchmarkKeep(uint64_t value) {
+    keptValue.fetch_xor(value, std::memory_order_relaxed);
+}
+
+void BenchmarkFramework::addBenchmark(const std::string& name, const std::string& unit, std::function<uint64_t()> body) {
+    benchmarks.push_back({ name, unit, std::move(body) });
+}
+
+void BenchmarkFramework::runAll(const RunConfig& config) {
+    results.clear();
+    size_t repetitions = std::max<size_t>(config.repetitions, 1);
+
+    for (const auto& benchmark : benchmarks) {
+        if (!config.filter.empty() && benchmark.name.find(config.filter) == std::string::npos) {
+            continue;
+        }
+        std::cout << "Running " << benchmark.name << "..." << std::flush;
+
+        benchmark.body();  // Warm-up: caches, lazily built tables, CUDA context
+        std::vector<double> seconds;
+        uint64_t operations = 0;
+        for (size_t i = 0; i < repetitions; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            operations = benchmark.body();
+            seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        std::sort(seconds.begin(), seconds.end());
+
+        Result result;
+        result.name = benchmark.name;
+        result.unit = benchmark.unit;
+        result.operations = operations;
+        result.medianSeconds = seconds[seconds.size() / 2];
+        result.minSeconds = seconds.front();
+        result.maxSeconds = seconds.back();
+        result.opsPerSecond = result.medianSeconds > 0.0 ? operations / result.medianSeconds : 0.0;
+        results.push_back(result);
+        std::cout << " " << std::fixed << std::setprecision(0) << result.opsPerSecond << " " << result.unit << "/s" << std::endl;
+    }
+}
+
+void BenchmarkFramework::printResults() const {
+    std::cout << std::endl << std::string(86, '=') << std::endl;
+    std::cout << std::left << std::setw(36) << "BENCHMARK" << std::right << std::setw(18) << "RATE (/s)"
+              << std::setw(12) << "UNIT" << std::setw(10) << "MEDIAN" << std::setw(10) << "SPREAD" << std::endl;
+    std::cout << std::string(86, '=') << std::endl;
+    for (const auto& result : results) {
+        double spread = result.medianSeconds > 0.0 ? (result.maxSeconds - result.minSeconds) / result.medianSeconds * 100.0 : 0.0;
+        std::cout << std::left << std::setw(36) << result.name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(18) << result.opsPerSecond << std::setw(12) << result.unit << std::setprecision(1)
+                  << std::setw(8) << result.medianSeconds * 1000.0 << "ms" << std::setw(9) << spread << "%" << std::endl;
+    }
+    std::cout << std::string(86, '=') << std::endl;
+}
+
+bool BenchmarkFramework::writeJson(const std::string& filePath, const std::vector<std::pair<std::string, std::string>>& context) const {
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file << "{\"context\": {";
+    for (size_t i = 0; i < context.size(); ++i) {
+        file << (i > 0 ? ", " : "") << "\"" << escapeJson(context[i].first) << "\": \"" << escapeJson(context[i].second) << "\"";
+    }
+    file << "},\n\"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        file << std::setprecision(9) << "{\"name\": \"" << escapeJson(result.name) << "\", \"unit\": \"" << escapeJson(result.unit)
+             << "\", \"operations\": " << result.operations << ", \"median_seconds\": " << result.medianSeconds
+             << ", \"min_seconds\": " << result.minSeconds << ", \"max_seconds\": " << result.maxSeconds
+             << ", \"ops_per_second\": " << result.opsPerSecond << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "]}\n";
+    return file.good();
+}
+
+bool BenchmarkFramework::readJson(const std::string& filePath, std::vector<Result>& results) {
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    results.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        Result result = {};
+        std::string operations, median, minimum, maximum, rate;
+        if (!findField(line, "name", result.name) || !findField(line, "ops_per_second", rate)) {
+            continue;  // Context and bracket lines
+        }
+        findField(line, "unit", result.unit);
+        if (findField(line, "operations", operations)) result.operations = std::stoull(operations);
+        if (findField(line, "median_seconds", median)) result.medianSeconds = std::stod(median);
+        if (findField(line, "min_seconds", minimum)) result.minSeconds = std::stod(minimum);
+        if (findField(line, "max_seconds", maximum)) result.maxSeconds = std::stod(maximum);
+        result.opsPerSecond = std::stod(rate);
+        results.push_back(result);
+    }
+    return true;
+}
+
+std::vector<BenchmarkFramework::Regression> BenchmarkFramework::compare(const std::vector<Result>& baseline,
+                                                                        const std::vector<Result>& current, double tolerance) {
+    std::vector<Regression> regressions;
+    for (const Result& result : current) {
+        auto previous = std::find_if(baseline.begin(), baseline.end(), [&](const Result& entry) { return entry.name == result.name; });
+        if (previous != baseline.end() && result.opsPerSecond < previous->opsPerSecond * (1.0 - tolerance)) {
+            regressions.push_back({ result.name, previous->opsPerSecond, result.opsPerSecond });
+        }
+    }
+    return regressions;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <functional>
+#include <vector>
+#include <cstdint>
+
+// Repeatable throughput benchmarks. Every benchmark body does a fixed amount of work and
+// returns how many operations it performed; it runs once as warm-up and then `repetitions`
+// times, and the median repetition is its result. Results are printed and can be written as
+// JSON (one benchmark per line) so a later run can compare against them with --baseline.
+class BenchmarkFramework {
+public:
+    struct Result {
+        std::string name;
+        std::string unit;            // What one operation is ("mappings", "words", ...)
+        uint64_t operations;         // Per repetition
+        double medianSeconds;
+        double minSeconds;
+        double maxSeconds;
+        double opsPerSecond;         // operations / medianSeconds
+    };
+
+    struct BenchmarkCase {
+        std::string name;
+        std::string unit;
+        std::function<uint64_t()> body;
+    };
+
+    struct RunConfig {
+        size_t repetitions;          // Timed runs per benchmark (after one warm-up run)
+        std::string filter;          // Only benchmarks whose name contains this ("" = all)
+
+        RunConfig() : repetitions(5) {}
+    };
+
+    // One benchmark that got slower than the baseline allows
+    struct Regression {
+        std::string name;
+        double baselineOpsPerSecond;
+        double currentOpsPerSecond;
+    };
+
+private:
+    std::vector<BenchmarkCase> benchmarks;
+    std::vector<Result> results;
+
+public:
+    void addBenchmark(const std::string& name, const std::string& unit, std::function<uint64_t()> body);
+
+    void runAll(const RunConfig& config = RunConfig());
+    void printResults() const;
+    const std::vector<Result>& getResults() const { return results; }
+
+    // {"context": {...}, "benchmarks": [ one object per line ]}; context values are strings
+    bool writeJson(const std::string& filePath, const std::vector<std::pair<std::string, std::string>>& context) const;
+    static bool readJson(const std::string& filePath, std::vector<Result>& results);
+
+    // Benchmarks present in both runs whose rate fell by more than tolerance (0.1 = 10%)
+    static std::vector<Regression> compare(const std::vector<Result>& baseline, const std::vector<Result>& current,
+                                           double tolerance);
+};
+
+// Keeps a computed value alive so the optimizer cannot drop the work that produced it
+void benchmarkKeep(uint64_t value);
@@ -0,0 +1,85 @@
+#include "BenchmarkFramework.h"
+#include "../StaticTranslator.h"
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Forward declarations for benchmark registration functions
+void registerStageBenchmarks(BenchmarkFramework& framework);
+void registerEndToEndBenchmarks(BenchmarkFramework& framework);
+
+// Usage: VoynichDecoderBenchmarks [--filter text] [--repetitions n] [--json results.json]
+//                                 [--baseline previous.json] [--tolerance 0.10] [--label text]
+// With --baseline the exit code is 2 when any benchmark is slower than the baseline by more
+// than the tolerance, so a script can run it before and after a change.
+int main(int argc, char* argv[]) {
+    BenchmarkFramework::RunConfig runConfig;
+    std::string jsonPath;
+    std::string baselinePath;
+    std::string label;
+    double tolerance = 0.10;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option = argv[i];
+        std::string value = argv[i + 1];
+        if (option == "--filter") {
+            runConfig.filter = value;
+        } else if (option == "--repetitions") {
+            runConfig.repetitions = std::stoul(value);
+        } else if (option == "--json") {
+            jsonPath = value;
+        } else if (option == "--baseline") {
+            baselinePath = value;
+        } else if (option == "--tolerance") {
+            tolerance = std::stod(value);
+        } else if (option == "--label") {
+            label = value;
+        } else {
+            std::cerr << "Unknown option " << option << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "VoynichDecoder Benchmarks" << std::endl;
+    std::cout << "=========================" << std::endl;
+
+    BenchmarkFramework framework;
+    registerStageBenchmarks(framework);
+    registerEndToEndBenchmarks(framework);
+
+    framework.runAll(runConfig);
+    framework.printResults();
+
+    if (!jsonPath.empty()) {
+        std::vector<std::pair<std::string, std::string>> context = {
+            { "label", label },
+            { "repetitions", std::to_string(runConfig.repetitions) },
+            { "hardware_threads", std::to_string(std::thread::hardware_concurrency()) },
+            { "simd_level", StaticTranslator::getSimdLevelName(StaticTranslator::getSimdLevel()) },
+            { "cuda_devices", std::to_string(StaticTranslator::getCudaDeviceCount()) }
+        };
+        if (!framework.writeJson(jsonPath, context)) {
+            std::cerr << "Could not write " << jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << jsonPath << std::endl;
+    }
+
+    if (!baselinePath.empty()) {
+        std::vector<BenchmarkFramework::Result> baseline;
+        if (!BenchmarkFramework::readJson(baselinePath, baseline)) {
+            std::cerr << "Could not read baseline " << baselinePath << std::endl;
+            return 1;
+        }
+
+        auto regressions = BenchmarkFramework::compare(baseline, framework.getResults(), tolerance);
+        for (const auto& regression : regressions) {
+            std::cout << "REGRESSION " << regression.name << ": " << regression.currentOpsPerSecond << "/s vs "
+                      << regression.baselineOpsPerSecond << "/s baseline ("
+                      << (1.0 - regression.currentOpsPerSecond / regression.baselineOpsPerSecond) * 100.0 << "% slower)" << std::endl;
+        }
+        std::cout << regressions.size() << " regression(s) beyond " << tolerance * 100.0 << "% against " << baselinePath << std::endl;
+        return regressions.empty() ? 0 : 2;
+    }
+    return 0;
+}
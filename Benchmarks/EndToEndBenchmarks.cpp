@@ -0,0 +1,101 @@
+#include "BenchmarkFramework.h"
+#include "../VoynichDecoder.h"
+#include "../StaticTranslator.h"
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+namespace {
+    // Same fixed range as the stage benchmarks; every repetition scores exactly these mappings
+    const uint64_t START_INDEX = 1000000000000ULL;
+    const uint64_t CPU_MAPPINGS = 200000;
+    const uint64_t CUDA_MAPPINGS = 20000000;
+
+    struct EndToEndCase {
+        const char* name;
+        VoynichDecoder::TranslatorType translatorType;
+        VoynichDecoder::EnumerationMode enumerationMode;
+        bool boundedScoring;
+        uint64_t mappings;
+    };
+
+    // Nothing reaches the threshold, so the results file is never written during a run
+    VoynichDecoder::DecoderConfig benchmarkDecoderConfig(const EndToEndCase& test) {
+        VoynichDecoder::DecoderConfig config;
+        config.translatorType = test.translatorType;
+        config.enumerationMode = test.enumerationMode;
+        config.boundedScoring = test.boundedScoring;
+        config.lexiconBackend = HebrewValidator::LexiconBackend::PERFECT_HASH;
+        config.scoreThreshold = 100.0;
+        config.resultsFilePath = "benchmark_results.txt";
+        config.topResultsCount = 100;
+        return config;
+    }
+
+    // Score [startIndex, endIndex) on one decoder, initialized on first use (the warm-up run)
+    uint64_t scoreRange(const std::shared_ptr<VoynichDecoder>& decoder, bool& initialized, uint64_t startIndex, uint64_t endIndex) {
+        if (!initialized) {
+            initialized = decoder->initialize();
+            if (!initialized) {
+                return 0;
+            }
+        }
+        decoder->processMappingRange(startIndex, endIndex, 0,
+                                     [](const VoynichDecoder::ProcessingResult&) {},
+                                     [](int, uint64_t, uint64_t, double, bool) {});
+        return endIndex - startIndex;
+    }
+}
+
+void registerEndToEndBenchmarks(BenchmarkFramework& framework) {
+    using TranslatorType = VoynichDecoder::TranslatorType;
+    using EnumerationMode = VoynichDecoder::EnumerationMode;
+
+    std::vector<EndToEndCase> cases = {
+        { "end_to_end/CPU", TranslatorType::CPU, EnumerationMode::INDEXED, false, CPU_MAPPINGS },
+        { "end_to_end/PERMUTATION", TranslatorType::PERMUTATION, EnumerationMode::INDEXED, false, CPU_MAPPINGS },
+        { "end_to_end/SIMD", TranslatorType::SIMD, EnumerationMode::INDEXED, false, CPU_MAPPINGS },
+        { "end_to_end/SIMD_bounded", TranslatorType::SIMD, EnumerationMode::INDEXED, true, CPU_MAPPINGS },
+        { "end_to_end/CPU_adjacent_swap", TranslatorType::CPU, EnumerationMode::ADJACENT_SWAP, false, CPU_MAPPINGS }
+    };
+    if (StaticTranslator::isCudaAvailable()) {
+        cases.push_back({ "end_to_end/CUDA", TranslatorType::CUDA, EnumerationMode::INDEXED, false, CUDA_MAPPINGS });
+    }
+
+    for (const EndToEndCase& test : cases) {
+        auto decoder = std::make_shared<VoynichDecoder>(benchmarkDecoderConfig(test));
+        auto initialized = std::make_shared<bool>(false);
+        uint64_t mappings = test.mappings;
+        framework.addBenchmark(test.name, "mappings", [decoder, initialized, mappings]() {
+            return scoreRange(decoder, *initialized, START_INDEX, START_INDEX + mappings);
+        });
+    }
+
+    // Every hardware thread scores an equal share of the range on its own decoder
+    size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    EndToEndCase threaded = { "end_to_end/SIMD_all_threads", TranslatorType::SIMD, EnumerationMode::INDEXED, false, CPU_MAPPINGS * threadCount };
+    auto decoders = std::make_shared<std::vector<std::shared_ptr<VoynichDecoder>>>();
+    for (size_t i = 0; i < threadCount; ++i) {
+        decoders->push_back(std::make_shared<VoynichDecoder>(benchmarkDecoderConfig(threaded)));
+    }
+    auto initialized = std::make_shared<std::vector<char>>(threadCount, 0);
+    framework.addBenchmark(threaded.name, "mappings", [decoders, initialized, threadCount]() {
+        std::atomic<uint64_t> scored{0};
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([&, i]() {
+                bool ready = (*initialized)[i] != 0;
+                uint64_t start = START_INDEX + i * CPU_MAPPINGS;
+                scored += scoreRange((*decoders)[i], ready, start, start + CPU_MAPPINGS);
+                (*initialized)[i] = ready ? 1 : 0;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return scored.load();
+    });
+}
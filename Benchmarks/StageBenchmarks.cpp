@@ -0,0 +1,261 @@
+#include "BenchmarkFramework.h"
+#include "../MappingGenerator.h"
+#include "../StaticTranslator.h"
+#include "../PermutationTranslator.h"
+#include "../ScoringKernels.h"
+#include "../HebrewLexicon.h"
+#include "../ResultSink.h"
+#include "../WorkStealingScheduler.h"
+#include "../WordSet.h"
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    // Every run measures the same mappings: a fixed range of generator indices
+    const uint64_t START_INDEX = 1000000000000ULL;
+    const size_t UNRANK_COUNT = 1000000;
+    const size_t TRANSLATE_MAPPINGS = 200000;
+    const size_t DISTINCT_MAPPINGS = 1024;      // Cycled by the translation and probe benchmarks
+    const size_t PROBE_ROUNDS = 64;             // Passes over the translated corpora per probe run
+    const size_t SINK_RECORDS = 20000;
+    const uint64_t DISPATCH_MAPPINGS = 1ULL << 30;
+    const uint64_t DISPATCH_CHUNK = 4096;
+
+    std::vector<Permutation> fixedPermutations(size_t count) {
+        std::vector<Permutation> permutations(count);
+        for (size_t i = 0; i < count; ++i) {
+            MappingGenerator::unrankPermutation(START_INDEX + i, permutations[i]);
+        }
+        return permutations;
+    }
+
+    void registerUnrankBenchmarks(BenchmarkFramework& framework) {
+        framework.addBenchmark("unrank/indexed", "mappings", []() {
+            Permutation permutation;
+            uint64_t sum = 0;
+            for (size_t i = 0; i < UNRANK_COUNT; ++i) {
+                MappingGenerator::unrankPermutation(START_INDEX + i, permutation);
+                sum += permutation[0];
+            }
+            benchmarkKeep(sum);
+            return static_cast<uint64_t>(UNRANK_COUNT);
+        });
+
+        framework.addBenchmark("unrank/block_cursor", "mappings", []() {
+            MappingGenerator::BlockCursor cursor(START_INDEX, START_INDEX + UNRANK_COUNT);
+            Permutation permutation;
+            uint64_t index = 0;
+            uint64_t sum = 0;
+            while (cursor.next(permutation, index)) {
+                sum += permutation[0];
+            }
+            benchmarkKeep(sum);
+            return static_cast<uint64_t>(UNRANK_COUNT);
+        });
+    }
+
+    void registerTranslationBenchmarks(BenchmarkFramework& framework, const std::shared_ptr<const WordSet::MaskTable>& corpus) {
+        auto permutations = std::make_shared<std::vector<Permutation>>(fixedPermutations(DISTINCT_MAPPINGS));
+
+        // CPU: the mapping's letter loop over each mask (mappings built beforehand)
+        auto mappings = std::make_shared<std::vector<Mapping>>(DISTINCT_MAPPINGS);
+        for (size_t i = 0; i < DISTINCT_MAPPINGS; ++i) {
+            PermutationTranslator::permutationToMapping((*permutations)[i], (*mappings)[i]);
+        }
+        framework.addBenchmark("translate/CPU", "mappings", [corpus, mappings]() {
+            std::vector<uint32_t> hebrewMasks(corpus->masks.size());
+            uint64_t sum = 0;
+            for (size_t i = 0; i < TRANSLATE_MAPPINGS; ++i) {
+                StaticTranslator::translateMasks(corpus->masks, (*mappings)[i % DISTINCT_MAPPINGS], hebrewMasks);
+                sum += hebrewMasks[0];
+            }
+            benchmarkKeep(sum);
+            return static_cast<uint64_t>(TRANSLATE_MAPPINGS);
+        });
+
+        // PERMUTATION and SIMD: the table is compiled per mapping, as in the decoder
+        framework.addBenchmark("translate/PERMUTATION", "mappings", [corpus, permutations]() {
+            std::vector<uint32_t> hebrewMasks(corpus->masks.size());
+            PermutationTranslator::LookupTable table;
+            uint64_t sum = 0;
+            for (size_t i = 0; i < TRANSLATE_MAPPINGS; ++i) {
+                PermutationTranslator::buildLookupTable((*permutations)[i % DISTINCT_MAPPINGS], table);
+                PermutationTranslator::translateMasks(table, corpus->masks.data(), hebrewMasks.data(), hebrewMasks.size());
+                sum += hebrewMasks[0];
+            }
+            benchmarkKeep(sum);
+            return static_cast<uint64_t>(TRANSLATE_MAPPINGS);
+        });
+
+        // The same, with the table and translation kernels the decoder selects for this corpus
+        framework.addBenchmark("translate/SPECIALISED", "mappings", [corpus, permutations]() {
+            uint32_t letterUnion = 0;
+            for (uint32_t mask : corpus->masks) {
+                letterUnion |= mask;
+            }
+            auto kernels = ScoringKernels::select(TargetAlphabet::HEBREW_27, letterUnion, corpus->masks.size());
+            std::vector<uint32_t> hebrewMasks(corpus->masks.size());
+            PermutationTranslator::LookupTable table;
+            uint64_t sum = 0;
+            for (size_t i = 0; i < TRANSLATE_MAPPINGS; ++i) {
+                kernels.buildTable((*permutations)[i % DISTINCT_MAPPINGS], table);
+                kernels.translateCorpus(table, corpus->masks.data(), hebrewMasks.data(), hebrewMasks.size());
+                sum += hebrewMasks[0];
+            }
+            benchmarkKeep(sum);
+            return static_cast<uint64_t>(TRANSLATE_MAPPINGS);
+        });
+
+        auto detected = StaticTranslator::getSimdLevel();
+        for (auto level : { StaticTranslator::SimdLevel::AVX2, StaticTranslator::SimdLevel::AVX512 }) {
+            if (static_cast<int>(level) > static_cast<int>(detected)) {
+                continue;
+            }
+            framework.addBenchmark("translate/SIMD_" + StaticTranslator::getSimdLevelName(level), "mappings", [corpus, permutations, level]() {
+                std::vector<uint32_t> hebrewMasks(corpus->masks.size());
+                PermutationTranslator::LookupTable table;
+                uint64_t sum = 0;
+                for (size_t i = 0; i < TRANSLATE_MAPPINGS; ++i) {
+                    PermutationTranslator::buildLookupTable((*permutations)[i % DISTINCT_MAPPINGS], table);
+                    StaticTranslator::translateMasksSimd(table, corpus->masks.data(), hebrewMasks.data(), hebrewMasks.size(), level);
+                    sum += hebrewMasks[0];
+                }
+                benchmarkKeep(sum);
+                return static_cast<uint64_t>(TRANSLATE_MAPPINGS);
+            });
+        }
+    }
+
+    void registerProbeBenchmarks(BenchmarkFramework& framework, const std::shared_ptr<const WordSet::MaskTable>& corpus) {
+        // Translated corpora of the fixed mappings, probed back to back
+        auto translated = std::make_shared<std::vector<uint32_t>>();
+        PermutationTranslator::LookupTable table;
+        std::vector<uint32_t> hebrewMasks(corpus->masks.size());
+        for (const Permutation& permutation : fixedPermutations(DISTINCT_MAPPINGS)) {
+            PermutationTranslator::buildLookupTable(permutation, table);
+            PermutationTranslator::translateMasks(table, corpus->masks.data(), hebrewMasks.data(), hebrewMasks.size());
+            translated->insert(translated->end(), hebrewMasks.begin(), hebrewMasks.end());
+        }
+
+        const std::pair<HebrewLexicon::Backend, const char*> backends[] = {
+            { HebrewLexicon::Backend::HASH_SET, "HASH_SET" },
+            { HebrewLexicon::Backend::BITSET, "BITSET" },
+            { HebrewLexicon::Backend::PERFECT_HASH, "PERFECT_HASH" }
+        };
+        for (const auto& backend : backends) {
+            auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", backend.first);
+            if (lexicon->empty()) {
+                std::cout << "resources/Tanah2.txt not found - probe benchmarks skipped" << std::endl;
+                return;
+            }
+            framework.addBenchmark(std::string("probe/") + backend.second, "words", [corpus, translated, lexicon]() {
+                size_t wordCount = corpus->masks.size();
+                uint64_t matched = 0;
+                for (size_t round = 0; round < PROBE_ROUNDS; ++round) {
+                    for (size_t offset = 0; offset < translated->size(); offset += wordCount) {
+                        matched += lexicon->countMatches(translated->data() + offset, corpus->weights.data(), wordCount);
+                    }
+                }
+                benchmarkKeep(matched);
+                return static_cast<uint64_t>(translated->size() * PROBE_ROUNDS);
+            });
+        }
+    }
+
+    void registerSinkBenchmarks(BenchmarkFramework& framework) {
+        const std::pair<ResultSink::Format, const char*> formats[] = {
+            { ResultSink::Format::TEXT, "TEXT" },
+            { ResultSink::Format::CSV, "CSV" },
+            { ResultSink::Format::BINARY, "BINARY" }
+        };
+        for (const auto& format : formats) {
+            framework.addBenchmark(std::string("result_sink/") + format.second, "records", [format]() {
+                const std::string filePath = "benchmark_result_sink.tmp";
+                {
+                    ResultSink::SinkConfig config;
+                    config.format = format.first;
+                    ResultSink sink(filePath, config);
+                    sink.clear();
+                    auto permutations = fixedPermutations(16);
+                    for (size_t i = 0; i < SINK_RECORDS; ++i) {
+                        ResultSink::Record record;
+                        record.mappingId = START_INDEX + i;
+                        record.score = 50.0;
+                        record.matchedWords = 50;
+                        record.totalWords = 100;
+                        record.timestamp = std::chrono::system_clock::now();
+                        record.hasPermutation = true;
+                        record.permutation = permutations[i % permutations.size()];
+                        sink.submit(std::move(record));
+                    }
+                    sink.flush();
+                }
+                std::remove(filePath.c_str());
+                return static_cast<uint64_t>(SINK_RECORDS);
+            });
+        }
+    }
+
+    void registerDispatchBenchmarks(BenchmarkFramework& framework) {
+        // Pieces handed out and completed per second: scheduler and generator overhead only
+        size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<size_t> threadCounts = { 1, 4 };
+        if (hardwareThreads > 4) {
+            threadCounts.push_back(hardwareThreads);
+        }
+        for (size_t threadCount : threadCounts) {
+            framework.addBenchmark("dispatch/threads_" + std::to_string(threadCount), "pieces", [threadCount]() {
+                MappingGenerator::GeneratorConfig generatorConfig;
+                generatorConfig.blockSize = 1 << 20;
+                generatorConfig.enableStateFile = false;
+                MappingGenerator generator(generatorConfig);
+
+                WorkStealingScheduler::SchedulerConfig schedulerConfig;
+                schedulerConfig.chunkSize = DISPATCH_CHUNK;
+                schedulerConfig.minStealSize = DISPATCH_CHUNK / 4;
+                schedulerConfig.mappingBudget = DISPATCH_MAPPINGS;
+                WorkStealingScheduler scheduler(generator, threadCount, schedulerConfig);
+
+                std::atomic<uint64_t> pieces{0};
+                std::vector<std::thread> workers;
+                for (size_t workerId = 0; workerId < threadCount; ++workerId) {
+                    workers.emplace_back([&, workerId]() {
+                        WorkStealingScheduler::WorkItem item;
+                        uint64_t local = 0;
+                        while (scheduler.acquire(static_cast<int>(workerId), item)) {
+                            scheduler.complete(item);
+                            ++local;
+                        }
+                        pieces += local;
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                return pieces.load();
+            });
+        }
+    }
+}
+
+void registerStageBenchmarks(BenchmarkFramework& framework) {
+    WordSet corpusWords;
+    corpusWords.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+
+    registerUnrankBenchmarks(framework);
+    registerSinkBenchmarks(framework);
+    registerDispatchBenchmarks(framework);
+    if (corpusWords.size() == 0) {
+        std::cout << "resources not found - translation and probe benchmarks skipped" << std::endl;
+        return;
+    }
+
+    auto corpus = std::make_shared<const WordSet::MaskTable>(corpusWords.buildMaskTable());
+    registerTranslationBenchmarks(framework, corpus);
+    registerProbeBenchmarks(framework, corpus);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Portable bit helpers for packed 27-bit letter masks
+namespace BitUtils {
+    // Index of the lowest set bit (mask must be non-zero)
+    inline int countTrailingZeros(uint32_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+    
+    // Number of set bits
+    inline int popCount(uint32_t mask) {
+#ifdef _MSC_VER
+        return static_cast<int>(__popcnt(mask));
+#else
+        return __builtin_popcount(mask);
+#endif
+    }
+}
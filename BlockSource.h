@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// Where the work-stealing scheduler claims generator blocks: the local MappingGenerator, or
+// a ClusterCoordinator on another host reached through a ClusterClient. A claimed block stays
+// PENDING until completeSharedBlock is called with the claiming thread id.
+class BlockSource {
+public:
+    virtual ~BlockSource() = default;
+    
+    virtual bool claimSharedBlock(int threadId, uint64_t& blockIndex, uint64_t& startIndex, uint64_t& endIndex) = 0;
+    virtual void completeSharedBlock(int claimingThreadId, uint64_t blockIndex) = 0;
+};
@@ -0,0 +1,153 @@
+#include "ClusterClient.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+ClusterClient::ClusterClient(const ClientConfig& config)
+    : config(config), nodeId(-1), blockSize(0), leaseTimeoutMs(0) {
+    // Node names are a single protocol token
+    std::replace(this->config.nodeName.begin(), this->config.nodeName.end(), ' ', '_');
+    if (this->config.nodeName.empty()) {
+        this->config.nodeName = "node";
+    }
+}
+
+ClusterClient::~ClusterClient() {
+    disconnect();
+}
+
+bool ClusterClient::connect() {
+    connection = TcpConnection::connect(config.host, config.port);
+    if (!connection) {
+        std::wcerr << L"Cluster client: cannot reach coordinator " << config.host.c_str() << L":" << config.port << std::endl;
+        return false;
+    }
+    connected = true;
+    
+    std::ostringstream hello;
+    hello << "HELLO " << config.nodeName << " " << config.threads;
+    auto tokens = splitMessage(request(hello.str()));
+    if (tokens.size() < 4 || tokens[0] != "WELCOME") {
+        std::wcerr << L"Cluster client: coordinator refused node " << config.nodeName.c_str() << std::endl;
+        connection->close();
+        connected = false;
+        return false;
+    }
+    
+    try {
+        nodeId = std::stoi(tokens[1]);
+        blockSize = std::stoull(tokens[2]);
+        leaseTimeoutMs = std::stoi(tokens[3]);
+    } catch (const std::exception&) {
+        connection->close();
+        connected = false;
+        return false;
+    }
+    
+    stopping = false;
+    heartbeatThread = std::thread(&ClusterClient::heartbeatLoop, this);
+    
+    std::wcout << L"Joined cluster at " << config.host.c_str() << L":" << config.port << L" as node " << nodeId
+               << L" (block size " << blockSize << L")" << std::endl;
+    return true;
+}
+
+void ClusterClient::disconnect() {
+    requestStop();
+    if (heartbeatThread.joinable()) {
+        heartbeatThread.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(requestMutex);
+    if (connection && connection->isOpen()) {
+        connection->sendLine("BYE");
+        connection->close();
+    }
+    connected = false;
+}
+
+void ClusterClient::requestStop() {
+    {
+        std::lock_guard<std::mutex> lock(heartbeatMutex);
+        stopping = true;
+    }
+    heartbeatCondition.notify_all();
+}
+
+std::string ClusterClient::request(const std::string& message) {
+    std::lock_guard<std::mutex> lock(requestMutex);
+    if (!connected.load() || !connection) {
+        return "";
+    }
+    
+    std::string reply;
+    if (!connection->sendLine(message) || !connection->receiveLine(reply, config.requestTimeoutMs)) {
+        // A lost coordinator ends this node's run; its leases expire and are reassigned
+        std::wcerr << L"Cluster client: lost connection to coordinator" << std::endl;
+        connection->close();
+        connected = false;
+        return "";
+    }
+    return reply;
+}
+
+void ClusterClient::heartbeatLoop() {
+    int intervalMs = config.heartbeatIntervalMs > 0 ? config.heartbeatIntervalMs : std::max(leaseTimeoutMs / 3, 100);
+    
+    std::unique_lock<std::mutex> lock(heartbeatMutex);
+    while (!stopping.load()) {
+        heartbeatCondition.wait_for(lock, std::chrono::milliseconds(intervalMs), [this]() { return stopping.load(); });
+        if (stopping.load()) break;
+        
+        lock.unlock();
+        request("HEARTBEAT");
+        lock.lock();
+    }
+}
+
+// Leases are held per node, not per thread, so the BlockSource thread ids go unused
+bool ClusterClient::claimSharedBlock(int, uint64_t& blockIndex, uint64_t& startIndex, uint64_t& endIndex) {
+    while (!stopping.load()) {
+        auto tokens = splitMessage(request("LEASE"));
+        if (tokens.size() >= 4 && tokens[0] == "BLOCK") {
+            try {
+                blockIndex = std::stoull(tokens[1]);
+                startIndex = std::stoull(tokens[2]);
+                endIndex = std::stoull(tokens[3]);
+            } catch (const std::exception&) {
+                return false;
+            }
+            return startIndex < endIndex;
+        }
+        
+        if (tokens.empty() || tokens[0] != "WAIT") {
+            return false; // DONE, error or connection lost
+        }
+        
+        // Other nodes still hold leases that may expire and come back to the pool
+        std::unique_lock<std::mutex> lock(heartbeatMutex);
+        heartbeatCondition.wait_for(lock, std::chrono::milliseconds(config.waitRetryMs), [this]() { return stopping.load(); });
+    }
+    return false;
+}
+
+void ClusterClient::completeSharedBlock(int, uint64_t blockIndex) {
+    std::string reply = request("COMPLETE " + std::to_string(blockIndex));
+    if (reply == "STALE") {
+        // Our lease expired and the block went to another node, which will report it
+        staleCompletions++;
+    }
+}
+
+bool ClusterClient::submitResult(uint64_t mappingIndex, const Permutation& permutation, double score, size_t matchedWords, size_t totalWords) {
+    std::ostringstream message;
+    message << "RESULT " << mappingIndex << " " << std::fixed << std::setprecision(4) << score << " "
+            << matchedWords << " " << totalWords;
+    for (uint8_t hebrewLetter : permutation) {
+        message << " " << static_cast<int>(hebrewLetter);
+    }
+    return request(message.str()) == "OK";
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "BlockSource.h"
+#include "NetworkConnection.h"
+#include "PermutationTranslator.h"
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <condition_variable>
+
+// Worker-node side of the cluster protocol (see ClusterCoordinator). Blocks are leased from the
+// coordinator instead of a local MappingGenerator, so the work-stealing scheduler and every
+// worker thread run unchanged; a background thread keeps the node's leases alive with
+// heartbeats. All requests share one connection and are answered in order.
+class ClusterClient : public BlockSource {
+public:
+    struct ClientConfig {
+        std::string host;
+        uint16_t port;
+        std::string nodeName;          // Shown in coordinator logs and results (no spaces)
+        size_t threads;                // Worker threads on this node (informational)
+        int heartbeatIntervalMs;       // 0 = a third of the coordinator's lease timeout
+        int requestTimeoutMs;          // A reply taking longer than this drops the connection
+        int waitRetryMs;               // Pause before asking again after a WAIT reply
+        
+        ClientConfig() : port(5757), nodeName("node"), threads(0), heartbeatIntervalMs(0),
+                         requestTimeoutMs(30000), waitRetryMs(1000) {}
+    };
+
+private:
+    ClientConfig config;
+    std::unique_ptr<TcpConnection> connection;
+    std::mutex requestMutex;           // One request/reply exchange at a time
+    int nodeId;
+    uint64_t blockSize;
+    int leaseTimeoutMs;
+    
+    std::thread heartbeatThread;
+    std::mutex heartbeatMutex;
+    std::condition_variable heartbeatCondition;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> connected{false};
+    std::atomic<uint64_t> staleCompletions{0};
+    
+    // Send a request and wait for its reply; empty string if the connection failed
+    std::string request(const std::string& message);
+    void heartbeatLoop();
+
+public:
+    explicit ClusterClient(const ClientConfig& config);
+    ~ClusterClient();
+    
+    // Join the cluster (HELLO/WELCOME) and start heartbeats; false if unreachable or refused
+    bool connect();
+    
+    // Leave the cluster; leases still held are released by the coordinator
+    void disconnect();
+    
+    // Abort WAIT retries so worker threads blocked in claimSharedBlock return promptly
+    void requestStop();
+    
+    // BlockSource: lease the next block / report it scored (threadId is local to this node)
+    bool claimSharedBlock(int threadId, uint64_t& blockIndex, uint64_t& startIndex, uint64_t& endIndex) override;
+    void completeSharedBlock(int claimingThreadId, uint64_t blockIndex) override;
+    
+    // Forward a high score to the coordinator's results file: the scored mapping's generator
+    // index (the same on every node) and its permutation
+    bool submitResult(uint64_t mappingIndex, const Permutation& permutation, double score, size_t matchedWords, size_t totalWords);
+    
+    bool isConnected() const { return connected.load(); }
+    int getNodeId() const { return nodeId; }
+    uint64_t getBlockSize() const { return blockSize; }
+    uint64_t getStaleCompletions() const { return staleCompletions.load(); }
+};
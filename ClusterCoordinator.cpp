@@ -0,0 +1,398 @@
+#include "ClusterCoordinator.h"
+#include <iostream>
+#include <sstream>
+
+namespace {
+    constexpr int SESSION_POLL_MS = 500;    // Session threads re-check the stop flag this often
+    constexpr int ACCEPT_POLL_MS = 200;
+    
+    bool parseUnsigned(const std::string& token, uint64_t& value) {
+        try {
+            size_t consumed = 0;
+            value = std::stoull(token, &consumed);
+            return consumed == token.size();
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+}
+
+ClusterCoordinator::ClusterCoordinator(const CoordinatorConfig& config)
+    : config(config), leasesGranted(0), leasesExpired(0), blocksCompleted(0), staleCompletions(0), resultsReceived(0) {
+    MappingGenerator::GeneratorConfig generatorConfig;
+    generatorConfig.blockSize = config.blockSize;
+    generatorConfig.stateFilePath = config.stateFilePath;
+    generatorConfig.enableStateFile = config.enableStateFile;
+    generator = std::make_unique<MappingGenerator>(generatorConfig);
+    resultSink = ResultSink::acquire(config.resultsFilePath);
+}
+
+ClusterCoordinator::~ClusterCoordinator() {
+    stop();
+}
+
+bool ClusterCoordinator::start() {
+    if (running.load()) {
+        return true;
+    }
+    if (!listener.listen(config.port)) {
+        std::wcerr << L"Cluster coordinator: cannot listen on port " << config.port << std::endl;
+        return false;
+    }
+    
+    running = true;
+    acceptThread = std::thread(&ClusterCoordinator::acceptLoop, this);
+    reaperThread = std::thread(&ClusterCoordinator::reaperLoop, this);
+    
+    std::wcout << L"Cluster coordinator listening on port " << listener.getPort()
+               << L" (block size " << config.blockSize << L", lease timeout " << config.leaseTimeoutMs << L" ms)" << std::endl;
+    return true;
+}
+
+void ClusterCoordinator::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    
+    if (acceptThread.joinable()) {
+        acceptThread.join();
+    }
+    if (reaperThread.joinable()) {
+        reaperThread.join();
+    }
+    listener.close();
+    
+    // Wake every session out of its receive; their leases stay PENDING in the state file
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        for (auto& session : sessions) {
+            session->connection->shutdown();
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        for (auto& session : sessions) {
+            if (session->thread.joinable()) {
+                session->thread.join();
+            }
+        }
+        sessions.clear();
+    }
+    
+    generator->saveCurrentState();
+    resultSink->flush();
+}
+
+void ClusterCoordinator::acceptLoop() {
+    while (running.load()) {
+        auto connection = listener.accept(ACCEPT_POLL_MS);
+        joinFinishedSessions();
+        if (!connection) {
+            continue;
+        }
+        
+        auto session = std::make_unique<Session>();
+        session->connection = std::move(connection);
+        Session* served = session.get();
+        
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        sessions.push_back(std::move(session));
+        served->thread = std::thread(&ClusterCoordinator::serveSession, this, std::ref(*served));
+    }
+}
+
+void ClusterCoordinator::joinFinishedSessions() {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        if ((*it)->finished.load()) {
+            if ((*it)->thread.joinable()) {
+                (*it)->thread.join();
+            }
+            it = sessions.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ClusterCoordinator::reaperLoop() {
+    while (running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(config.reaperIntervalMs));
+        size_t released = expireSilentNodes();
+        if (released > 0) {
+            std::wcout << L"Cluster coordinator: released " << released << L" expired lease(s) for reassignment" << std::endl;
+        }
+    }
+}
+
+void ClusterCoordinator::serveSession(Session& session) {
+    TcpConnection& connection = *session.connection;
+    int nodeId = -1;
+    
+    std::string line;
+    while (running.load()) {
+        bool timedOut = false;
+        if (!connection.receiveLine(line, SESSION_POLL_MS, &timedOut)) {
+            if (timedOut) continue;
+            break; // Node disconnected
+        }
+        
+        auto tokens = splitMessage(line);
+        if (tokens.empty()) continue;
+        const std::string& command = tokens[0];
+        
+        if (nodeId >= 0) {
+            std::lock_guard<std::mutex> lock(clusterMutex);
+            auto it = nodes.find(nodeId);
+            if (it != nodes.end()) {
+                it->second.lastSeen = std::chrono::steady_clock::now();
+            }
+        }
+        
+        std::string reply;
+        if (command == "HELLO" && nodeId < 0) {
+            reply = handleHello(tokens, nodeId);
+        } else if (nodeId < 0) {
+            reply = "ERROR expected HELLO";
+        } else if (command == "LEASE") {
+            reply = handleLease(nodeId);
+        } else if (command == "COMPLETE") {
+            reply = handleComplete(nodeId, tokens);
+        } else if (command == "RESULT") {
+            reply = handleResult(nodeId, tokens);
+        } else if (command == "HEARTBEAT") {
+            reply = "OK";
+        } else if (command == "BYE") {
+            break;
+        } else {
+            reply = "ERROR unknown command";
+        }
+        
+        if (!connection.sendLine(reply)) {
+            break;
+        }
+    }
+    
+    if (nodeId >= 0) {
+        removeNode(nodeId);
+    }
+    session.finished = true;
+}
+
+std::string ClusterCoordinator::handleHello(const std::vector<std::string>& tokens, int& nodeId) {
+    uint64_t threads = 0;
+    if (tokens.size() < 3 || !parseUnsigned(tokens[2], threads)) {
+        return "ERROR usage: HELLO <name> <threads>";
+    }
+    
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    
+    // Node ids double as generator thread slots; reuse the lowest free one
+    int id = 0;
+    while (id < MappingGenerator::MAX_THREAD_SLOTS && nodes.count(id) > 0) {
+        id++;
+    }
+    if (id == MappingGenerator::MAX_THREAD_SLOTS) {
+        return "ERROR cluster full";
+    }
+    
+    Node& node = nodes[id];
+    node.name = tokens[1];
+    node.threads = static_cast<size_t>(threads);
+    node.lastSeen = std::chrono::steady_clock::now();
+    nodeId = id;
+    
+    std::wcout << L"Cluster coordinator: node " << id << L" (" << node.name.c_str() << L", "
+               << node.threads << L" threads) joined" << std::endl;
+    
+    std::ostringstream reply;
+    reply << "WELCOME " << id << " " << config.blockSize << " " << config.leaseTimeoutMs;
+    return reply.str();
+}
+
+std::string ClusterCoordinator::handleLease(int nodeId) {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    auto it = nodes.find(nodeId);
+    if (it == nodes.end()) {
+        return "ERROR unknown node";
+    }
+    
+    uint64_t blockIndex = 0;
+    uint64_t startIndex = 0;
+    uint64_t endIndex = 0;
+    if (!generator->claimSharedBlock(nodeId, blockIndex, startIndex, endIndex)) {
+        // Leases still out may expire and come back, so only report DONE when none are left
+        return leaseOwners.empty() ? "DONE" : "WAIT";
+    }
+    
+    it->second.leases.insert(blockIndex);
+    leaseOwners[blockIndex] = nodeId;
+    leasesGranted++;
+    
+    std::ostringstream reply;
+    reply << "BLOCK " << blockIndex << " " << startIndex << " " << endIndex;
+    return reply.str();
+}
+
+std::string ClusterCoordinator::handleComplete(int nodeId, const std::vector<std::string>& tokens) {
+    uint64_t blockIndex = 0;
+    if (tokens.size() < 2 || !parseUnsigned(tokens[1], blockIndex)) {
+        return "ERROR usage: COMPLETE <blockIndex>";
+    }
+    
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    auto owner = leaseOwners.find(blockIndex);
+    if (owner == leaseOwners.end() || owner->second != nodeId) {
+        // Expired and handed to another node (or never leased); that node's result counts
+        staleCompletions++;
+        return "STALE";
+    }
+    
+    leaseOwners.erase(owner);
+    auto it = nodes.find(nodeId);
+    if (it != nodes.end()) {
+        it->second.leases.erase(blockIndex);
+        it->second.blocksCompleted++;
+    }
+    generator->completeSharedBlock(nodeId, blockIndex);
+    blocksCompleted++;
+    return "OK";
+}
+
+std::string ClusterCoordinator::handleResult(int nodeId, const std::vector<std::string>& tokens) {
+    uint64_t mappingIndex = 0;
+    uint64_t matched = 0;
+    uint64_t total = 0;
+    double score = 0.0;
+    if (tokens.size() != 5 + Word::ALPHABET_SIZE || !parseUnsigned(tokens[1], mappingIndex) ||
+        !parseUnsigned(tokens[3], matched) || !parseUnsigned(tokens[4], total)) {
+        return "ERROR usage: RESULT <mappingIndex> <score> <matched> <total> <permutation>";
+    }
+    try {
+        score = std::stod(tokens[2]);
+    } catch (const std::exception&) {
+        return "ERROR invalid score";
+    }
+    
+    // Each Hebrew letter is assigned to exactly one EVA letter
+    Permutation permutation;
+    uint32_t usedLetters = 0;
+    for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+        uint64_t hebrewLetter = 0;
+        if (!parseUnsigned(tokens[5 + letter], hebrewLetter) || hebrewLetter >= Word::ALPHABET_SIZE ||
+            (usedLetters & (1u << hebrewLetter))) {
+            return "ERROR invalid permutation";
+        }
+        usedLetters |= 1u << hebrewLetter;
+        permutation[letter] = static_cast<uint8_t>(hebrewLetter);
+    }
+    
+    std::string nodeName;
+    {
+        std::lock_guard<std::mutex> lock(clusterMutex);
+        auto it = nodes.find(nodeId);
+        if (it != nodes.end()) {
+            it->second.resultsReported++;
+            nodeName = it->second.name;
+        }
+        resultsReceived++;
+    }
+    
+    appendResult(nodeName, mappingIndex, permutation, score, static_cast<size_t>(matched), static_cast<size_t>(total));
+    return "OK";
+}
+
+void ClusterCoordinator::appendResult(const std::string& nodeName, uint64_t mappingIndex, const Permutation& permutation,
+                                      double score, size_t matched, size_t total) {
+    // Same layout as a node's own results file, plus the reporting node
+    ResultSink::Record record;
+    record.mappingId = mappingIndex;
+    record.hasPermutation = true;
+    record.permutation = permutation;
+    record.score = score;
+    record.matchedWords = static_cast<uint32_t>(matched);
+    record.totalWords = static_cast<uint32_t>(total);
+    record.timestamp = std::chrono::system_clock::now();
+    record.source = nodeName;
+    resultSink->submit(std::move(record));
+}
+
+size_t ClusterCoordinator::expireSilentNodes() {
+    auto now = std::chrono::steady_clock::now();
+    auto timeout = std::chrono::milliseconds(config.leaseTimeoutMs);
+    
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    size_t released = 0;
+    for (auto& entry : nodes) {
+        Node& node = entry.second;
+        if (!node.leases.empty() && now - node.lastSeen > timeout) {
+            released += node.leases.size();
+            std::wcout << L"Cluster coordinator: node " << entry.first << L" (" << node.name.c_str()
+                       << L") missed its heartbeats" << std::endl;
+            releaseNodeLeases(node, entry.first);
+        }
+    }
+    return released;
+}
+
+void ClusterCoordinator::releaseNodeLeases(Node& node, int nodeId) {
+    for (uint64_t blockIndex : node.leases) {
+        leaseOwners.erase(blockIndex);
+        generator->releaseSharedBlock(nodeId, blockIndex);
+        leasesExpired++;
+    }
+    node.leases.clear();
+}
+
+void ClusterCoordinator::removeNode(int nodeId) {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    auto it = nodes.find(nodeId);
+    if (it == nodes.end()) {
+        return;
+    }
+    
+    // A coordinator shutting down keeps the leases PENDING; a departing node gives them back
+    if (running.load()) {
+        releaseNodeLeases(it->second, nodeId);
+    }
+    std::wcout << L"Cluster coordinator: node " << nodeId << L" (" << it->second.name.c_str() << L") left" << std::endl;
+    nodes.erase(it);
+}
+
+bool ClusterCoordinator::isSearchComplete() const {
+    {
+        std::lock_guard<std::mutex> lock(clusterMutex);
+        if (!leaseOwners.empty()) {
+            return false;
+        }
+    }
+    return generator->isGenerationComplete();
+}
+
+ClusterCoordinator::CoordinatorStats ClusterCoordinator::getStats() const {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    CoordinatorStats stats;
+    stats.nodesConnected = nodes.size();
+    stats.leasesGranted = leasesGranted;
+    stats.leasesExpired = leasesExpired;
+    stats.blocksCompleted = blocksCompleted;
+    stats.staleCompletions = staleCompletions;
+    stats.resultsReceived = resultsReceived;
+    return stats;
+}
+
+std::vector<ClusterCoordinator::NodeStatus> ClusterCoordinator::getNodes() const {
+    std::lock_guard<std::mutex> lock(clusterMutex);
+    std::vector<NodeStatus> status;
+    for (const auto& entry : nodes) {
+        NodeStatus node;
+        node.nodeId = entry.first;
+        node.name = entry.second.name;
+        node.threads = entry.second.threads;
+        node.leasedBlocks = entry.second.leases.size();
+        node.blocksCompleted = entry.second.blocksCompleted;
+        node.resultsReported = entry.second.resultsReported;
+        status.push_back(node);
+    }
+    return status;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "MappingGenerator.h"
+#include "NetworkConnection.h"
+#include "ResultSink.h"
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <chrono>
+
+// Leases generator blocks to remote worker processes (ThreadManager with a coordinator
+// address, see ClusterClient). Every node gets one generator thread slot, so a lease is an
+// ordinary shared claim and shows up as a PENDING block in the window and state file. A node
+// that stops sending heartbeats, or disconnects, has its leases released back into the window,
+// where they are reassigned to the next node that asks for work.
+//
+// Protocol (one text line per message, node -> coordinator / reply):
+//   HELLO <name> <threads>                -> WELCOME <nodeId> <blockSize> <leaseTimeoutMs>
+//   LEASE                                 -> BLOCK <blockIndex> <startIndex> <endIndex> | WAIT | DONE
+//   COMPLETE <blockIndex>                 -> OK | STALE (lease expired and was reassigned)
+//   RESULT <mappingIndex> <score> <matched> <total> <27 Hebrew letters, one per EVA letter> -> OK
+//   HEARTBEAT                             -> OK
+//   BYE                                   -> (connection closed, leases released)
+class ClusterCoordinator {
+public:
+    struct CoordinatorConfig {
+        uint16_t port;                 // TCP port to listen on (0 = any free port)
+        size_t blockSize;              // Mappings per leased block
+        std::string stateFilePath;     // Generator state file (authoritative cluster progress)
+        bool enableStateFile;
+        std::string resultsFilePath;   // High scores reported by all nodes
+        int leaseTimeoutMs;            // Leases of a node silent for this long are reassigned
+        int reaperIntervalMs;          // How often lease expiry is checked
+        
+        CoordinatorConfig() : port(5757), blockSize(1000000), stateFilePath("cluster_generator_state.bin"),
+                              enableStateFile(true), resultsFilePath("cluster_results.txt"),
+                              leaseTimeoutMs(30000), reaperIntervalMs(1000) {}
+    };
+    
+    struct NodeStatus {
+        int nodeId;
+        std::string name;
+        size_t threads;
+        size_t leasedBlocks;
+        uint64_t blocksCompleted;
+        uint64_t resultsReported;
+    };
+    
+    struct CoordinatorStats {
+        size_t nodesConnected;
+        uint64_t leasesGranted;
+        uint64_t leasesExpired;       // Released by heartbeat timeout or disconnect
+        uint64_t blocksCompleted;
+        uint64_t staleCompletions;    // Completions for leases that had already been released
+        uint64_t resultsReceived;
+    };
+
+private:
+    struct Node {
+        std::string name;
+        size_t threads;
+        std::chrono::steady_clock::time_point lastSeen;
+        std::set<uint64_t> leases;
+        uint64_t blocksCompleted;
+        uint64_t resultsReported;
+        
+        Node() : threads(0), blocksCompleted(0), resultsReported(0) {}
+    };
+    
+    // One connected node; the session thread serves its requests
+    struct Session {
+        std::unique_ptr<TcpConnection> connection;
+        std::thread thread;
+        std::atomic<bool> finished{false};
+    };
+    
+    CoordinatorConfig config;
+    std::unique_ptr<MappingGenerator> generator;
+    TcpListener listener;
+    
+    mutable std::mutex clusterMutex;             // Protects nodes, leaseOwners and the counters
+    std::map<int, Node> nodes;                   // By node id (= generator thread slot)
+    std::map<uint64_t, int> leaseOwners;         // Leased block -> node id
+    uint64_t leasesGranted;
+    uint64_t leasesExpired;
+    uint64_t blocksCompleted;
+    uint64_t staleCompletions;
+    uint64_t resultsReceived;
+    
+    std::shared_ptr<ResultSink> resultSink;      // Shared writer for the results file
+    
+    std::mutex sessionsMutex;
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::thread acceptThread;
+    std::thread reaperThread;
+    std::atomic<bool> running{false};
+    
+    void acceptLoop();
+    void reaperLoop();
+    void serveSession(Session& session);
+    void joinFinishedSessions();
+    
+    // Request handlers (return the reply line)
+    std::string handleHello(const std::vector<std::string>& tokens, int& nodeId);
+    std::string handleLease(int nodeId);
+    std::string handleComplete(int nodeId, const std::vector<std::string>& tokens);
+    std::string handleResult(int nodeId, const std::vector<std::string>& tokens);
+    
+    void releaseNodeLeases(Node& node, int nodeId);   // Caller holds clusterMutex
+    void removeNode(int nodeId);
+    void appendResult(const std::string& nodeName, uint64_t mappingIndex, const Permutation& permutation,
+                      double score, size_t matched, size_t total);
+
+public:
+    explicit ClusterCoordinator(const CoordinatorConfig& config = CoordinatorConfig());
+    ~ClusterCoordinator();
+    
+    // Start listening and serving nodes; false if the port cannot be bound
+    bool start();
+    void stop();
+    bool isRunning() const { return running.load(); }
+    uint16_t getPort() const { return listener.getPort(); }
+    
+    // Release the leases of every node silent for longer than leaseTimeoutMs (run periodically
+    // by the reaper thread); returns the number of blocks released
+    size_t expireSilentNodes();
+    
+    // Every block has been leased and completed
+    bool isSearchComplete() const;
+    
+    CoordinatorStats getStats() const;
+    std::vector<NodeStatus> getNodes() const;
+    MappingGenerator& getGenerator() { return *generator; }
+    
+    // Block until every reported result is in the results file
+    void flushResults() { resultSink->flush(); }
+};
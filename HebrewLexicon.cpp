@@ -0,0 +1,392 @@
+#include "HebrewLexicon.h"
+#include "BitUtils.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+    const char IMAGE_FILE_MAGIC[4] = { 'V', 'D', 'L', 'X' };
+
+    uint64_t fnv1a(const uint8_t* data, size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    void appendInteger(std::string& buffer, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    struct ByteReader {
+        const uint8_t* data;
+        size_t size;
+        size_t position;
+        bool ok;
+
+        ByteReader(const uint8_t* data, size_t size) : data(data), size(size), position(0), ok(true) {}
+
+        uint64_t read(int bytes) {
+            if (!ok || position + bytes > size) {
+                ok = false;
+                return 0;
+            }
+            uint64_t value = 0;
+            for (int i = 0; i < bytes; ++i) {
+                value |= static_cast<uint64_t>(data[position + i]) << (8 * i);
+            }
+            position += bytes;
+            return value;
+        }
+
+        std::vector<uint32_t> readArray(uint64_t count) {
+            if (!ok || count > (size - position) / 4) {
+                ok = false;
+                return {};
+            }
+            std::vector<uint32_t> values(static_cast<size_t>(count));
+            for (uint32_t& value : values) {
+                value = static_cast<uint32_t>(read(4));
+            }
+            return values;
+        }
+    };
+
+    // Size and FNV-1a of a file's bytes; false if it cannot be read
+    bool fingerprintFile(const std::string& filePath, uint64_t& size, uint64_t& hash) {
+        MappedFile file;
+        if (!file.open(filePath)) {
+            return false;
+        }
+        size = file.size();
+        hash = fnv1a(file.data(), file.size());
+        return true;
+    }
+}
+
+HebrewLexicon::HebrewLexicon(const WordSet& hebrewWords, Backend backend)
+    : backend(backend), target(TargetAlphabet::HEBREW_27), uniqueMasks(0), wordCount(hebrewWords.size()) {
+
+    distinctMasks.reserve(hebrewWords.size());
+    for (uint32_t mask : hebrewWords.getLetterMasks()) {
+        if (isValidMask(mask)) {
+            distinctMasks.push_back(mask);
+        }
+    }
+    std::sort(distinctMasks.begin(), distinctMasks.end());
+    distinctMasks.erase(std::unique(distinctMasks.begin(), distinctMasks.end()), distinctMasks.end());
+    uniqueMasks = distinctMasks.size();
+    buildBackend(nullptr);
+}
+
+HebrewLexicon::HebrewLexicon(std::vector<uint32_t> distinctMasks, size_t wordCount, Backend backend, PerfectHashSet* prebuiltHash)
+    : backend(backend), target(TargetAlphabet::HEBREW_27), distinctMasks(std::move(distinctMasks)), uniqueMasks(0), wordCount(wordCount) {
+    uniqueMasks = this->distinctMasks.size();
+    buildBackend(prebuiltHash);
+}
+
+void HebrewLexicon::buildBackend(PerfectHashSet* prebuiltHash) {
+    // Build only the structure the configured backend probes
+    switch (backend) {
+        case Backend::BITSET:
+            maskBits.assign((static_cast<size_t>(1) << Word::ALPHABET_SIZE) / 64, 0);
+            for (uint32_t mask : distinctMasks) {
+                maskBits[mask >> 6] |= static_cast<uint64_t>(1) << (mask & 63);
+            }
+            break;
+
+        case Backend::PERFECT_HASH:
+            if (prebuiltHash) {
+                perfectHash = std::move(*prebuiltHash);
+            } else {
+                perfectHash.build(distinctMasks);
+            }
+            break;
+
+        case Backend::HASH_SET:
+        default:
+            // Convert Hebrew words to binary hashes and signatures (repeated masks add nothing)
+            for (uint32_t mask : distinctMasks) {
+                binaryHashes.insert(maskToHash(mask));
+                binarySignatures.insert(maskToSignature(mask));
+            }
+            break;
+    }
+}
+
+std::shared_ptr<const HebrewLexicon> HebrewLexicon::acquire(const std::string& filePath, Backend backend,
+                                                            const std::string& imagePath, TargetAlphabet target) {
+    static std::mutex registryMutex;
+    static std::map<std::tuple<std::string, int, int>, std::weak_ptr<const HebrewLexicon>> registry;
+
+    // Held while loading so concurrent callers wait for the first load instead of repeating it
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    auto key = std::make_tuple(filePath, static_cast<int>(backend), static_cast<int>(target));
+    auto it = registry.find(key);
+    if (it != registry.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    std::shared_ptr<const HebrewLexicon> lexicon;
+    if (!imagePath.empty()) {
+        lexicon = loadImage(imagePath, filePath, backend);
+    }
+    if (!lexicon) {
+        WordSet hebrewWords;
+        hebrewWords.readFromFile(filePath, Alphabet::HEBREW);
+        lexicon = std::make_shared<const HebrewLexicon>(hebrewWords, backend);
+
+        // The next start maps the image instead of parsing the word file
+        if (!imagePath.empty() && !lexicon->empty() && lexicon->saveImage(imagePath, filePath)) {
+            std::wcout << L"Lexicon image: wrote " << imagePath.c_str() << std::endl;
+        }
+    }
+
+    if (target != TargetAlphabet::HEBREW_27) {
+        lexicon = lexicon->foldedTo(target);
+    }
+    registry[key] = lexicon;
+    return lexicon;
+}
+
+std::shared_ptr<const HebrewLexicon> HebrewLexicon::foldedTo(TargetAlphabet foldedTarget) const {
+    if (foldedTarget == target || foldedTarget == TargetAlphabet::HEBREW_27) {
+        return std::make_shared<const HebrewLexicon>(*this);  // Folding cannot be undone
+    }
+
+    // Words that differ only in final forms now share a mask
+    std::vector<uint32_t> folded;
+    folded.reserve(distinctMasks.size());
+    for (uint32_t mask : distinctMasks) {
+        folded.push_back(Word::foldFinalForms(mask));
+    }
+    std::sort(folded.begin(), folded.end());
+    folded.erase(std::unique(folded.begin(), folded.end()), folded.end());
+
+    std::shared_ptr<HebrewLexicon> lexicon(new HebrewLexicon(std::move(folded), wordCount, backend, nullptr));
+    lexicon->target = foldedTarget;
+    return lexicon;
+}
+
+bool HebrewLexicon::saveImage(const std::string& imagePath, const std::string& sourcePath) const {
+    // An image stands for its word file as read, so folded masks are never written
+    if (target != TargetAlphabet::HEBREW_27) {
+        return false;
+    }
+
+    uint64_t sourceSize = 0, sourceHash = 0;
+    if (!fingerprintFile(sourcePath, sourceSize, sourceHash)) {
+        return false;
+    }
+
+    // Every backend's image carries the perfect hash, the one structure worth not rebuilding
+    PerfectHashSet builtHash;
+    const PerfectHashSet* hash = &perfectHash;
+    if (backend != Backend::PERFECT_HASH) {
+        builtHash.build(distinctMasks);
+        hash = &builtHash;
+    }
+
+    std::string buffer(IMAGE_FILE_MAGIC, sizeof(IMAGE_FILE_MAGIC));
+    appendInteger(buffer, IMAGE_FORMAT_VERSION, 4);
+    appendInteger(buffer, sourceSize, 8);
+    appendInteger(buffer, sourceHash, 8);
+    appendInteger(buffer, wordCount, 8);
+    appendInteger(buffer, distinctMasks.size(), 4);
+    appendInteger(buffer, hash->getSeeds().size(), 4);
+    appendInteger(buffer, hash->getKeys().size(), 4);
+    for (const std::vector<uint32_t>* values : { &distinctMasks, &hash->getSeeds(), &hash->getKeys() }) {
+        for (uint32_t value : *values) {
+            appendInteger(buffer, value, 4);
+        }
+    }
+    appendInteger(buffer, fnv1a(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size()), 8);
+
+    // Written beside the previous image and renamed over it
+    std::string tempPath = imagePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.flush();
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, imagePath, error);
+    if (error) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const HebrewLexicon> HebrewLexicon::loadImage(const std::string& imagePath, const std::string& sourcePath,
+                                                              Backend backend) {
+    MappedFile image;
+    if (!image.open(imagePath)) {
+        return nullptr;
+    }
+
+    const size_t checksumSize = sizeof(uint64_t);
+    if (image.size() < sizeof(IMAGE_FILE_MAGIC) + checksumSize ||
+        std::memcmp(image.data(), IMAGE_FILE_MAGIC, sizeof(IMAGE_FILE_MAGIC)) != 0) {
+        std::wcerr << L"Lexicon image " << imagePath.c_str() << L" is not a lexicon image; rebuilding" << std::endl;
+        return nullptr;
+    }
+    size_t payloadSize = image.size() - checksumSize;
+    ByteReader checksumReader(image.data(), image.size());
+    checksumReader.position = payloadSize;
+    if (checksumReader.read(8) != fnv1a(image.data(), payloadSize)) {
+        std::wcerr << L"Lexicon image " << imagePath.c_str() << L" failed its checksum; rebuilding" << std::endl;
+        return nullptr;
+    }
+
+    ByteReader reader(image.data(), payloadSize);
+    reader.position = sizeof(IMAGE_FILE_MAGIC);
+    uint64_t version = reader.read(4);
+    if (version != IMAGE_FORMAT_VERSION) {
+        std::wcerr << L"Lexicon image " << imagePath.c_str() << L" has unsupported version " << version << L"; rebuilding" << std::endl;
+        return nullptr;
+    }
+
+    // Only the word file the image was built from may use it (a missing one cannot be checked)
+    uint64_t imageSourceSize = reader.read(8);
+    uint64_t imageSourceHash = reader.read(8);
+    uint64_t sourceSize = 0, sourceHash = 0;
+    if (fingerprintFile(sourcePath, sourceSize, sourceHash) && (sourceSize != imageSourceSize || sourceHash != imageSourceHash)) {
+        std::wcout << L"Lexicon image " << imagePath.c_str() << L" is out of date with " << sourcePath.c_str()
+                   << L"; rebuilding" << std::endl;
+        return nullptr;
+    }
+
+    uint64_t wordCount = reader.read(8);
+    uint64_t maskCount = reader.read(4);
+    uint64_t bucketCount = reader.read(4);
+    uint64_t slotCount = reader.read(4);
+    std::vector<uint32_t> masks = reader.readArray(maskCount);
+    std::vector<uint32_t> seeds = reader.readArray(bucketCount);
+    std::vector<uint32_t> keys = reader.readArray(slotCount);
+    PerfectHashSet hash;
+    if (!reader.ok || reader.position != payloadSize || slotCount != maskCount || !hash.assign(std::move(seeds), std::move(keys))) {
+        std::wcerr << L"Lexicon image " << imagePath.c_str() << L" is malformed; rebuilding" << std::endl;
+        return nullptr;
+    }
+
+    return std::shared_ptr<const HebrewLexicon>(new HebrewLexicon(std::move(masks), static_cast<size_t>(wordCount), backend, &hash));
+}
+
+template <typename WeightOf>
+size_t HebrewLexicon::countMatchesWith(const uint32_t* hebrewMasks, size_t count, WeightOf weightOf) const {
+    size_t matched = 0;
+
+    // Backend is fixed per instance, so dispatch once outside the word loop
+    switch (backend) {
+        case Backend::BITSET: {
+            if (maskBits.empty()) break;
+            const uint64_t* bits = maskBits.data();
+            for (size_t i = 0; i < count; ++i) {
+                // Mask 0 is never inserted; out-of-alphabet bits are cleared by FULL_MASK and rejected
+                uint32_t mask = hebrewMasks[i];
+                uint32_t index = mask & Word::FULL_MASK;
+                matched += static_cast<size_t>(((bits[index >> 6] >> (index & 63)) & 1) & (index == mask)) * weightOf(i);
+            }
+            break;
+        }
+
+        case Backend::PERFECT_HASH:
+            for (size_t i = 0; i < count; ++i) {
+                matched += perfectHash.contains(hebrewMasks[i]) ? weightOf(i) : 0;
+            }
+            break;
+
+        case Backend::HASH_SET:
+        default:
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t mask = hebrewMasks[i];
+
+                if (isValidMask(mask)) {
+                    // O(1) hash lookup with signature verification for collision detection
+                    if (binaryHashes.find(maskToHash(mask)) != binaryHashes.end() &&
+                        binarySignatures.find(maskToSignature(mask)) != binarySignatures.end()) {
+                        matched += weightOf(i);
+                    }
+                }
+            }
+            break;
+    }
+
+    return matched;
+}
+
+size_t HebrewLexicon::countMatches(const uint32_t* hebrewMasks, size_t count) const {
+    return countMatchesWith(hebrewMasks, count, [](size_t) { return static_cast<size_t>(1); });
+}
+
+size_t HebrewLexicon::countMatches(const uint32_t* hebrewMasks, const uint32_t* weights, size_t count) const {
+    return countMatchesWith(hebrewMasks, count, [weights](size_t i) { return static_cast<size_t>(weights[i]); });
+}
+
+uint32_t HebrewLexicon::maskToHash(uint32_t mask) {
+    // Convert 27-bit letter mask to 32-bit hash using polynomial rolling hash
+    uint32_t hash = 0;
+    uint32_t base = 31; // Prime base for polynomial hash
+
+    mask &= Word::FULL_MASK;
+    while (mask) {
+        int i = BitUtils::countTrailingZeros(mask);
+        hash = hash * base + (i + 1); // +1 to avoid zero multiplication
+        mask &= mask - 1;
+    }
+
+    return hash;
+}
+
+uint64_t HebrewLexicon::maskToSignature(uint32_t mask) {
+    // Direct bit packing for first 27 bits
+    uint64_t signature = mask & Word::FULL_MASK;
+
+    // Add position-weighted hash for additional entropy
+    uint64_t weightedHash = 0;
+    uint32_t remaining = mask & Word::FULL_MASK;
+    while (remaining) {
+        uint64_t i = BitUtils::countTrailingZeros(remaining);
+        weightedHash += (i + 1) * (i + 1); // Quadratic weighting
+        remaining &= remaining - 1;
+    }
+
+    // Combine bit pattern with weighted hash in upper bits
+    signature |= (weightedHash << 32);
+
+    return signature;
+}
+
+bool HebrewLexicon::isValidMask(uint32_t mask) {
+    // Non-empty and no bits outside the 27-letter alphabet
+    return mask != 0 && (mask & ~Word::FULL_MASK) == 0;
+}
+
+size_t HebrewLexicon::getMemoryBytes() const {
+    return maskBits.size() * sizeof(uint64_t) + perfectHash.memoryBytes() + distinctMasks.size() * sizeof(uint32_t) +
+           binaryHashes.size() * sizeof(uint32_t) + binarySignatures.size() * sizeof(uint64_t);
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "WordSet.h"
+#include "PerfectHashSet.h"
+#include <unordered_set>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Read-only Hebrew lexicon shared by all validators.
+// Built once per (file, backend) through acquire(); every worker thread then probes the
+// same instance, so startup work and resident memory no longer scale with thread count.
+// A lexicon image (see saveImage) skips parsing the word file and building the perfect
+// hash on later starts; it records the word file's size and hash and is rebuilt when they
+// no longer match.
+class HebrewLexicon {
+public:
+    // Lexicon storage backends
+    enum class Backend {
+        HASH_SET,       // unordered_set of hash + signature (two probes per word)
+        BITSET,         // Flat 2^27-bit table indexed by letter mask (16 MiB, one load)
+        PERFECT_HASH    // Compact minimal perfect hash over the lexicon masks (one slot compare)
+    };
+
+private:
+    Backend backend;
+    TargetAlphabet target;                         // Letters the masks distinguish
+    std::unordered_set<uint32_t> binaryHashes;     // 32-bit hashes of Hebrew word binary vectors
+    std::unordered_set<uint64_t> binarySignatures; // 64-bit signatures for collision detection
+    std::vector<uint64_t> maskBits;                // BITSET backend: one bit per 27-bit mask
+    PerfectHashSet perfectHash;                    // PERFECT_HASH backend
+    std::vector<uint32_t> distinctMasks;           // Sorted distinct word masks (source for device tables)
+    size_t uniqueMasks;                            // Distinct letter sets in the lexicon
+    size_t wordCount;                              // Total Hebrew words loaded
+
+    // From sorted distinct masks (images); a prebuilt perfect hash is adopted instead of rebuilt
+    HebrewLexicon(std::vector<uint32_t> distinctMasks, size_t wordCount, Backend backend, PerfectHashSet* prebuiltHash);
+    void buildBackend(PerfectHashSet* prebuiltHash);
+
+    // Backend dispatch shared by both countMatches overloads (weightOf(i) = weight of mask i)
+    template <typename WeightOf>
+    size_t countMatchesWith(const uint32_t* hebrewMasks, size_t count, WeightOf weightOf) const;
+
+public:
+    // Build from already-parsed Hebrew words
+    HebrewLexicon(const WordSet& hebrewWords, Backend backend);
+
+    // Process-wide registry: returns the cached instance for this file, backend and target,
+    // loading it on first use. Entries are released when the last user drops them.
+    // With an imagePath the lexicon is mapped from that image when it matches filePath,
+    // and otherwise parsed from filePath and written to it for the next start. Images hold
+    // the 27-letter masks; other targets are folded from them.
+    static std::shared_ptr<const HebrewLexicon> acquire(const std::string& filePath, Backend backend,
+                                                        const std::string& imagePath = "",
+                                                        TargetAlphabet target = TargetAlphabet::HEBREW_27);
+    
+    // The same words with their masks folded to a target alphabet (a copy if already in it)
+    std::shared_ptr<const HebrewLexicon> foldedTo(TargetAlphabet foldedTarget) const;
+
+    // Image layout: "VDLX" | u32 version | u64 source size | u64 source FNV-1a | u64 word count |
+    //   u32 mask count | u32 bucket count | u32 slot count | sorted distinct masks |
+    //   perfect hash seeds | perfect hash slots (u32 each) | u64 FNV-1a of the preceding
+    //   bytes, little-endian. The perfect hash is stored whatever the backend.
+    static constexpr uint32_t IMAGE_FORMAT_VERSION = 1;
+
+    // Write this lexicon's image, fingerprinting sourcePath (temporary file renamed over the old one;
+    // 27-letter lexicons only)
+    bool saveImage(const std::string& imagePath, const std::string& sourcePath) const;
+
+    // Map an image; nullptr if it is missing, damaged or was built from another version of
+    // sourcePath. An image whose source file is absent is used as is.
+    static std::shared_ptr<const HebrewLexicon> loadImage(const std::string& imagePath, const std::string& sourcePath,
+                                                          Backend backend);
+
+    // Count how many of the packed Hebrew masks are lexicon words
+    size_t countMatches(const uint32_t* hebrewMasks, size_t count) const;
+
+    // Same, with each mask counting weights[i] times (see WordSet::buildMaskTable)
+    size_t countMatches(const uint32_t* hebrewMasks, const uint32_t* weights, size_t count) const;
+    bool contains(uint32_t hebrewMask) const { return countMatches(&hebrewMask, 1) != 0; }
+
+    // Mask hashing used by the HASH_SET backend
+    static uint32_t maskToHash(uint32_t mask);
+    static uint64_t maskToSignature(uint32_t mask);
+    static bool isValidMask(uint32_t mask);
+
+    // Sorted distinct valid word masks, whatever the backend (used to build GPU-resident tables)
+    const std::vector<uint32_t>& getDistinctMasks() const { return distinctMasks; }
+
+    // Statistics
+    Backend getBackend() const { return backend; }
+    TargetAlphabet getTargetAlphabet() const { return target; }
+    size_t getWordCount() const { return wordCount; }
+    size_t getUniqueMaskCount() const { return uniqueMasks; }
+    size_t getUniqueHashCount() const { return binaryHashes.size(); }
+    size_t getUniqueSignatureCount() const { return binarySignatures.size(); }
+    size_t getMemoryBytes() const;
+    bool empty() const { return wordCount == 0; }
+};
\ No newline at end of file
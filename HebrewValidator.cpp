@@ -1,107 +1,89 @@
 #include "HebrewValidator.h"
 #include <chrono>
-#include <sstream>
-#include <iomanip>
+#include <fstream>
 #include <iostream>
 #include <algorithm>
 #include <thread>
 
 HebrewValidator::HebrewValidator(const ValidatorConfig& config) : config(config) {
-    // Initialize lexicon for this instance
+    // Attach the process-wide lexicon (loaded on first use)
     initializeLexicon();
+    attachResultSink();
 }
 
-bool HebrewValidator::initializeLexicon() {
-    // Load Hebrew words
-    WordSet hebrewWords;
-    hebrewWords.readFromFile(config.hebrewLexiconPath, Alphabet::HEBREW);
-    
-    if (hebrewWords.size() == 0) {
-        lexicon.isLoaded = true; // Mark as loaded even if empty to prevent retries
-        return false;
+HebrewValidator::HebrewValidator(const ValidatorConfig& config, std::shared_ptr<const HebrewLexicon> sharedLexicon)
+    : lexicon(std::move(sharedLexicon)), config(config) {
+    if (!lexicon) {
+        initializeLexicon();
     }
-    
-    // Convert Hebrew words to binary hashes and signatures
-    for (const auto& word : hebrewWords) {
-        const auto& binaryVector = word.getBinaryMatrix();
-        
-        if (isValidHebrewBinaryVector(binaryVector)) {
-            uint32_t hash = binaryVectorToHash(binaryVector);
-            uint64_t signature = binaryVectorToSignature(binaryVector);
-            
-            lexicon.binaryHashes.insert(hash);
-            lexicon.binarySignatures.insert(signature);
-        }
+    attachResultSink();
+}
+
+void HebrewValidator::attachResultSink() {
+    // Every validator saving to this file shares one writer
+    if (config.enableResultsSaving) {
+        ResultSink::SinkConfig sinkConfig;
+        sinkConfig.format = config.resultsFormat;
+        resultSink = ResultSink::acquire(config.resultsFilePath, sinkConfig);
     }
-    
-    lexicon.wordCount = hebrewWords.size();
-    lexicon.isLoaded = true;
-    
-    return true;
+}
+
+bool HebrewValidator::initializeLexicon() {
+    lexicon = HebrewLexicon::acquire(config.hebrewLexiconPath, config.lexiconBackend, config.lexiconImagePath, config.targetAlphabet);
+    return !lexicon->empty();
 }
 
 uint32_t HebrewValidator::binaryVectorToHash(const std::vector<int>& binaryVector) {
-    // Convert 27-bit binary vector to 32-bit hash using polynomial rolling hash
-    uint32_t hash = 0;
-    uint32_t base = 31; // Prime base for polynomial hash
-    
-    for (size_t i = 0; i < std::min(binaryVector.size(), size_t(27)); ++i) {
-        if (binaryVector[i]) {
-            hash = hash * base + (i + 1); // +1 to avoid zero multiplication
-        }
-    }
-    
-    return hash;
+    return maskToHash(Word::binaryVectorToMask(binaryVector));
 }
 
 uint64_t HebrewValidator::binaryVectorToSignature(const std::vector<int>& binaryVector) {
-    // Convert 27-bit binary vector to 64-bit signature for collision detection
-    uint64_t signature = 0;
-    
-    // Direct bit packing for first 27 bits
-    for (size_t i = 0; i < std::min(binaryVector.size(), size_t(27)); ++i) {
-        if (binaryVector[i]) {
-            signature |= (1ULL << i);
-        }
-    }
+    return maskToSignature(Word::binaryVectorToMask(binaryVector));
+}
+
+uint32_t HebrewValidator::maskToHash(uint32_t mask) {
+    return HebrewLexicon::maskToHash(mask);
+}
+
+uint64_t HebrewValidator::maskToSignature(uint32_t mask) {
+    return HebrewLexicon::maskToSignature(mask);
+}
+
+HebrewValidator::ValidationResult HebrewValidator::validateTranslation(const WordSet& translatedWords) {
+    return validateMasks(translatedWords.maskData(), translatedWords.size());
+}
+
+HebrewValidator::ValidationResult HebrewValidator::validateTranslation(const std::vector<uint32_t>& hebrewMasks) {
+    return validateMasks(hebrewMasks.data(), hebrewMasks.size());
+}
+
+HebrewValidator::ValidationResult HebrewValidator::validateMasks(const uint32_t* hebrewMasks, size_t count) {
+    ValidationResult result;
+    result.totalWords = count;
     
-    // Add position-weighted hash for additional entropy
-    uint64_t weightedHash = 0;
-    for (size_t i = 0; i < std::min(binaryVector.size(), size_t(27)); ++i) {
-        if (binaryVector[i]) {
-            weightedHash += (i + 1) * (i + 1); // Quadratic weighting
-        }
+    if (!isLexiconReady() || result.totalWords == 0) {
+        return result;
     }
     
-    // Combine bit pattern with weighted hash in upper bits
-    signature |= (weightedHash << 32);
-    
-    return signature;
+    // Validate each translated word (no locking needed - lexicon is read-only)
+    return buildResult(count, lexicon->countMatches(hebrewMasks, count));
 }
 
-HebrewValidator::ValidationResult HebrewValidator::validateTranslation(const WordSet& translatedWords) {
+HebrewValidator::ValidationResult HebrewValidator::validateMasks(const uint32_t* hebrewMasks, const uint32_t* weights, size_t count, size_t totalWords) {
     ValidationResult result;
-    result.totalWords = translatedWords.size();
+    result.totalWords = totalWords;
     
     if (!isLexiconReady() || result.totalWords == 0) {
         return result;
     }
     
-    // Validate each translated word (no locking needed - instance lexicon)
-    for (const auto& word : translatedWords) {
-        const auto& binaryVector = word.getBinaryMatrix();
-        
-        if (isValidHebrewBinaryVector(binaryVector)) {
-            uint32_t hash = binaryVectorToHash(binaryVector);
-            uint64_t signature = binaryVectorToSignature(binaryVector);
-            
-            // O(1) hash lookup with signature verification for collision detection
-            if (lexicon.binaryHashes.find(hash) != lexicon.binaryHashes.end() &&
-                lexicon.binarySignatures.find(signature) != lexicon.binarySignatures.end()) {
-                result.matchedWords++;
-            }
-        }
-    }
+    return buildResult(totalWords, lexicon->countMatches(hebrewMasks, weights, count));
+}
+
+HebrewValidator::ValidationResult HebrewValidator::buildResult(size_t totalWords, size_t matchedWords) const {
+    ValidationResult result;
+    result.totalWords = totalWords;
+    result.matchedWords = matchedWords;
     
     // Calculate metrics
     result.matchPercentage = (result.totalWords > 0) ? 
@@ -113,6 +95,29 @@ HebrewValidator::ValidationResult HebrewValidator::validateTranslation(const Wor
     return result;
 }
 
+size_t HebrewValidator::getMinMatchedForHighScore(size_t totalWords) const {
+    for (size_t matched = 0; matched <= totalWords; ++matched) {
+        if (buildResult(totalWords, matched).isHighScore) {
+            return matched;
+        }
+    }
+    return totalWords + 1;
+}
+
+size_t HebrewValidator::getMinMatchedAbove(size_t totalWords, double minScore) const {
+    // The score never decreases with matches, so the answer is a partition point
+    size_t low = 0, high = totalWords + 1;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (buildResult(totalWords, middle).score > minScore) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
 HebrewValidator::ValidationResult HebrewValidator::validateTranslationWithMapping(
     const WordSet& translatedWords,
     uint64_t mappingId,
@@ -128,6 +133,35 @@ HebrewValidator::ValidationResult HebrewValidator::validateTranslationWithMappin
     return result;
 }
 
+HebrewValidator::ValidationResult HebrewValidator::validateMasksWithMapping(
+    const uint32_t* hebrewMasks,
+    size_t count,
+    uint64_t mappingId,
+    const std::vector<uint8_t>& mappingData) {
+    
+    ValidationResult result = validateMasks(hebrewMasks, count);
+    
+    // Save high scores if enabled
+    if (result.isHighScore && config.enableResultsSaving) {
+        saveValidationResult(result, mappingId, mappingData);
+    }
+    
+    return result;
+}
+
+bool HebrewValidator::recordHighScore(const ValidationResult& result, uint64_t mappingId, const Mapping& mapping) {
+    if (!result.isHighScore || !config.enableResultsSaving) {
+        return false;
+    }
+    
+    ResultSink::Record record;
+    record.hasPermutation = PermutationTranslator::permutationFromMapping(mapping, record.permutation);
+    if (!record.hasPermutation && config.resultsFormat == ResultFormat::TEXT) {
+        record.mappingText = mapping.serializeMappingVisualization();
+    }
+    return submitResult(result, mappingId, record);
+}
+
 double HebrewValidator::calculateScore(const ValidationResult& result) const {
     if (result.totalWords == 0) return 0.0;
     
@@ -147,68 +181,39 @@ double HebrewValidator::calculateScore(const ValidationResult& result) const {
 }
 
 bool HebrewValidator::saveValidationResult(const ValidationResult& result, uint64_t mappingId, const std::vector<uint8_t>& mappingData) {
-    std::lock_guard<std::mutex> lock(resultsMutex);
-    
-    ValidationEntry entry;
-    entry.mappingId = mappingId;
-    entry.score = result.score;
-    entry.matchedWords = result.matchedWords;
-    entry.totalWords = result.totalWords;
-    entry.timestamp = getCurrentTimestamp();
-    entry.mappingData = mappingData;
-    
-    return appendResultToFile(entry);
+    ResultSink::Record record;
+    record.mappingText.assign(mappingData.begin(), mappingData.end());
+    return submitResult(result, mappingId, record);
 }
 
-std::string HebrewValidator::getCurrentTimestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    
-    std::tm tm_buf;
-    localtime_s(&tm_buf, &time_t);
-    
-    std::stringstream ss;
-    ss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-    return ss.str();
-}
-
-bool HebrewValidator::appendResultToFile(const ValidationEntry& entry) {
-    std::ofstream file(config.resultsFilePath, std::ios::app);
-    if (!file.is_open()) {
+bool HebrewValidator::submitResult(const ValidationResult& result, uint64_t mappingId, ResultSink::Record& record) {
+    if (!resultSink) {
         return false;
     }
     
-    // Write header information
-    file << "================================================================================\n";
-    file << "Date/Time: " << entry.timestamp << "\n";
-    file << "Mapping ID: " << entry.mappingId << "\n";
-    file << "Score: " << std::fixed << std::setprecision(2) << entry.score 
-         << "% (" << entry.matchedWords << "/" << entry.totalWords << " matches)\n";
-    file << "================================================================================\n";
-    
-    // Write the mapping visualization
-    if (!entry.mappingData.empty()) {
-        std::string mappingViz(entry.mappingData.begin(), entry.mappingData.end());
-        file << mappingViz << "\n";
-    }
-    
-    file << "\n" << std::endl;
-    
-    file.close();
+    record.mappingId = mappingId;
+    record.score = result.score;
+    record.matchedWords = static_cast<uint32_t>(result.matchedWords);
+    record.totalWords = static_cast<uint32_t>(result.totalWords);
+    record.timestamp = std::chrono::system_clock::now();
+    resultSink->submit(std::move(record));
     return true;
 }
 
 bool HebrewValidator::isLexiconReady() const {
-    return lexicon.isLoaded;
+    return lexicon != nullptr;
 }
 
 HebrewValidator::LexiconStats HebrewValidator::getLexiconStats() const {
     LexiconStats stats;
     
-    stats.wordCount = lexicon.wordCount;
-    stats.uniqueHashes = lexicon.binaryHashes.size();
-    stats.uniqueSignatures = lexicon.binarySignatures.size();
-    stats.isLoaded = lexicon.isLoaded;
+    stats.wordCount = lexicon ? lexicon->getWordCount() : 0;
+    stats.uniqueHashes = lexicon ? lexicon->getUniqueHashCount() : 0;
+    stats.uniqueSignatures = lexicon ? lexicon->getUniqueSignatureCount() : 0;
+    stats.uniqueMasks = lexicon ? lexicon->getUniqueMaskCount() : 0;
+    stats.memoryBytes = lexicon ? lexicon->getMemoryBytes() : 0;
+    stats.backend = config.lexiconBackend;
+    stats.isLoaded = isLexiconReady();
     
     return stats;
 }
@@ -248,48 +253,47 @@ bool HebrewValidator::isValidHebrewBinaryVector(const std::vector<int>& binaryVe
     return hasSetBit;
 }
 
+bool HebrewValidator::isValidHebrewMask(uint32_t mask) {
+    return HebrewLexicon::isValidMask(mask);
+}
+
 HebrewValidator::HighScoresSummary HebrewValidator::getHighScoresSummary() const {
     HighScoresSummary summary;
     
-    std::ifstream file(config.resultsFilePath);
-    if (!file.is_open()) {
+    if (resultSink) {
+        resultSink->flush();
+    }
+    
+    // Read back in the format the shared writer actually uses for this file
+    std::vector<ResultSink::Record> records;
+    ResultFormat format = resultSink ? resultSink->getFormat() : config.resultsFormat;
+    if (!ResultSink::readRecords(config.resultsFilePath, format, records)) {
         return summary;
     }
     
-    std::string line;
     double totalScore = 0.0;
-    size_t totalWordsValidated = 0;
-    
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string token;
-        
-        // Parse tab-separated values
-        if (std::getline(iss, token, '\t')) { // mappingId
-            if (std::getline(iss, token, '\t')) { // score
-                double score = std::stod(token);
-                summary.totalResults++;
-                totalScore += score;
-                summary.highestScore = std::max(summary.highestScore, score);
-                
-                if (std::getline(iss, token, '\t')) { // matchedWords
-                    if (std::getline(iss, token, '\t')) { // totalWords
-                        totalWordsValidated += std::stoull(token);
-                    }
-                }
-            }
-        }
+    for (const auto& record : records) {
+        summary.totalResults++;
+        totalScore += record.score;
+        summary.highestScore = std::max(summary.highestScore, record.score);
+        summary.totalWordsValidated += record.totalWords;
     }
-    
     summary.averageScore = (summary.totalResults > 0) ? (totalScore / summary.totalResults) : 0.0;
-    summary.totalWordsValidated = totalWordsValidated;
     
     return summary;
 }
 
 bool HebrewValidator::clearResults() {
-    std::lock_guard<std::mutex> lock(resultsMutex);
+    if (resultSink) {
+        return resultSink->clear();
+    }
     
     std::ofstream file(config.resultsFilePath, std::ios::trunc);
     return file.is_open();
-}
\ No newline at end of file
+}
+
+void HebrewValidator::flushResults() {
+    if (resultSink) {
+        resultSink->flush();
+    }
+}
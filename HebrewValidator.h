@@ -2,12 +2,11 @@
 
 #include "WordSet.h"
 #include "Mapping.h"
-#include <unordered_set>
+#include "HebrewLexicon.h"
+#include "ResultSink.h"
 #include <memory>
 #include <string>
 #include <vector>
-#include <mutex>
-#include <fstream>
 #include <cstdint>
 
 class HebrewValidator {
@@ -23,68 +22,82 @@ public:
         ValidationResult() : totalWords(0), matchedWords(0), matchPercentage(0.0), score(0.0), isHighScore(false) {}
     };
     
+    // Lexicon storage backends (see HebrewLexicon)
+    using LexiconBackend = HebrewLexicon::Backend;
+    
+    // Results file layouts (see ResultSink)
+    using ResultFormat = ResultSink::Format;
+    
     // Configuration for the validator
     struct ValidatorConfig {
         std::string hebrewLexiconPath;    // Path to Hebrew words file
+        std::string lexiconImagePath;     // Prebuilt lexicon image, rebuilt when stale ("" = parse every start)
         std::string resultsFilePath;     // Path to save high scores
         double scoreThreshold;           // Minimum score to save (default: 25.0)
-        bool enableResultsSaving;        // Whether to save high scores
-        size_t maxResultsToSave;         // Maximum results to keep in file
+        bool enableResultsSaving;        // Whether to save high scores (a bounded best-N set is
+                                         // ThreadManagerConfig::topResultsCount)
+        LexiconBackend lexiconBackend;   // How the lexicon is stored and probed
+        TargetAlphabet targetAlphabet;   // Hebrew letters the lexicon masks distinguish
+        ResultFormat resultsFormat;      // Layout of the results file
         
         ValidatorConfig() : 
             hebrewLexiconPath("Tanah2.txt"),
+            lexiconImagePath(""),
             resultsFilePath("hebrew_validation_results.txt"),
             scoreThreshold(25.0),
             enableResultsSaving(true),
-            maxResultsToSave(1000) {}
+            lexiconBackend(LexiconBackend::HASH_SET),
+            targetAlphabet(TargetAlphabet::HEBREW_27),
+            resultsFormat(ResultFormat::TEXT) {}
     };
     
-    // Result entry for file storage
-    struct ValidationEntry {
-        uint64_t mappingId;          // Unique identifier for mapping
-        double score;                // Validation score
-        size_t matchedWords;         // Number of matched words
-        size_t totalWords;           // Total words validated
-        std::string timestamp;       // When validation occurred
-        std::vector<uint8_t> mappingData; // Serialized mapping for reproduction
-    };
-
 private:
-    // Instance-specific Hebrew lexicon (each validator has its own copy)
-    struct Lexicon {
-        std::unordered_set<uint32_t> binaryHashes;     // 32-bit hashes of Hebrew word binary vectors
-        std::unordered_set<uint64_t> binarySignatures; // 64-bit signatures for collision detection
-        size_t wordCount;                              // Total Hebrew words loaded
-        bool isLoaded;                                 // Loading completion flag
-        
-        Lexicon() : wordCount(0), isLoaded(false) {}
-    };
-    
-    Lexicon lexicon;                          // Instance lexicon (no thread safety needed)
+    std::shared_ptr<const HebrewLexicon> lexicon;  // Shared read-only lexicon (no thread safety needed)
     ValidatorConfig config;                   // Instance configuration
-    mutable std::mutex resultsMutex;          // Protects results file operations
+    std::shared_ptr<ResultSink> resultSink;   // Process-wide writer for the results file
     
     // Binary vector conversion methods
     static uint32_t binaryVectorToHash(const std::vector<int>& binaryVector);
     static uint64_t binaryVectorToSignature(const std::vector<int>& binaryVector);
     
-    // Lexicon management
-    bool loadHebrewLexicon(const std::string& filePath);
+    // Packed mask conversion methods (same hash and signature values as the vector forms)
+    static uint32_t maskToHash(uint32_t mask);
+    static uint64_t maskToSignature(uint32_t mask);
+    
     
     // Scoring and persistence
     double calculateScore(const ValidationResult& result) const;
     bool saveValidationResult(const ValidationResult& result, uint64_t mappingId, const std::vector<uint8_t>& mappingData);
-    std::string getCurrentTimestamp() const;
-    
-    // Thread-safe file operations
-    bool appendResultToFile(const ValidationEntry& entry);
+    bool submitResult(const ValidationResult& result, uint64_t mappingId, ResultSink::Record& record);
+    void attachResultSink();
     
 public:
     explicit HebrewValidator(const ValidatorConfig& config = ValidatorConfig());
     
+    // Use an already loaded lexicon instead of acquiring one from the registry
+    HebrewValidator(const ValidatorConfig& config, std::shared_ptr<const HebrewLexicon> sharedLexicon);
+    
     // Main validation method - validates translated words against Hebrew lexicon
     ValidationResult validateTranslation(const WordSet& translatedWords);
     
+    // Validate packed Hebrew letter masks directly
+    ValidationResult validateTranslation(const std::vector<uint32_t>& hebrewMasks);
+    ValidationResult validateMasks(const uint32_t* hebrewMasks, size_t count);
+    
+    // Validate deduplicated masks: mask i stands for weights[i] of the totalWords words
+    ValidationResult validateMasks(const uint32_t* hebrewMasks, const uint32_t* weights, size_t count, size_t totalWords);
+    
+    // Build a full result (percentage, score, high-score flag) from match counts
+    ValidationResult buildResult(size_t totalWords, size_t matchedWords) const;
+    
+    // Fewest matches that reach the score threshold for this many words (totalWords + 1 if
+    // none do). The score only grows with matches, so batch scorers can compare counts instead.
+    size_t getMinMatchedForHighScore(size_t totalWords) const;
+    
+    // Fewest matches whose score exceeds minScore (totalWords + 1 if none do); a bound for
+    // scorers that stop once a mapping can no longer beat minScore
+    size_t getMinMatchedAbove(size_t totalWords, double minScore) const;
+    
     // Validate with mapping context (for result saving)
     ValidationResult validateTranslationWithMapping(
         const WordSet& translatedWords,
@@ -92,17 +105,33 @@ public:
         const std::vector<uint8_t>& mappingData
     );
     
+    // Validate packed masks with mapping context (for result saving)
+    ValidationResult validateMasksWithMapping(
+        const uint32_t* hebrewMasks,
+        size_t count,
+        uint64_t mappingId,
+        const std::vector<uint8_t>& mappingData
+    );
+    
+    // Queue a high score for the results writer; a permutation mapping is stored as its letter
+    // order and only formatted on the writer thread (keeps the hot loop allocation-free)
+    bool recordHighScore(const ValidationResult& result, uint64_t mappingId, const Mapping& mapping);
+    
     // Check if lexicon is loaded and ready
     bool isLexiconReady() const;
     
-    // Initialize lexicon for this instance
+    // Attach the shared lexicon for the configured path and backend
     bool initializeLexicon();
+    std::shared_ptr<const HebrewLexicon> getLexicon() const { return lexicon; }
     
     // Get lexicon statistics
     struct LexiconStats {
         size_t wordCount;
         size_t uniqueHashes;
         size_t uniqueSignatures;
+        size_t uniqueMasks;
+        size_t memoryBytes;
+        LexiconBackend backend;
         bool isLoaded;
     };
     
@@ -119,6 +148,7 @@ public:
     
     // Utility methods
     static bool isValidHebrewBinaryVector(const std::vector<int>& binaryVector);
+    static bool isValidHebrewMask(uint32_t mask);
     
     // Configuration access
     const ValidatorConfig& getConfig() const { return config; }
@@ -130,8 +160,14 @@ public:
         double highestScore;
         double averageScore;
         size_t totalWordsValidated;
+        
+        HighScoresSummary() : totalResults(0), highestScore(0.0), averageScore(0.0), totalWordsValidated(0) {}
     };
     
+    // Summary of the results file (waits for queued results to be written first)
     HighScoresSummary getHighScoresSummary() const;
     bool clearResults(); // Clear results file
+    
+    // Block until every result queued so far is in the results file
+    void flushResults();
 };
\ No newline at end of file
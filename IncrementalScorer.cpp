@@ -0,0 +1,89 @@
+#include "IncrementalScorer.h"
+#include <algorithm>
+
+IncrementalScorer::IncrementalScorer(const std::vector<uint32_t>& evaMasks, std::shared_ptr<const HebrewLexicon> lexicon,
+                                     const std::vector<uint32_t>& weights)
+    : evaMasks(evaMasks), hebrewMasks(evaMasks.size(), 0), matched(evaMasks.size(), 0),
+      weights(weights.empty() ? std::vector<uint32_t>(evaMasks.size(), 1) : weights),
+      lexicon(std::move(lexicon)), permutation(PermutationTranslator::identityPermutation()),
+      matchedWords(0), totalWords(0), wordsRescored(0), wordsProbed(0), wordsProbedMatched(0) {
+    
+    for (uint32_t weight : this->weights) {
+        totalWords += weight;
+    }
+    
+    // Bucket word indices by the EVA letters they contain
+    uint32_t counts[Word::ALPHABET_SIZE] = {};
+    for (uint32_t mask : this->evaMasks) {
+        for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+            if (mask & (1u << letter)) counts[letter]++;
+        }
+    }
+    
+    letterOffsets[0] = 0;
+    for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+        letterOffsets[letter + 1] = letterOffsets[letter] + counts[letter];
+    }
+    
+    letterWords.resize(letterOffsets[Word::ALPHABET_SIZE]);
+    uint32_t fill[Word::ALPHABET_SIZE];
+    std::copy(letterOffsets, letterOffsets + Word::ALPHABET_SIZE, fill);
+    for (uint32_t wordIndex = 0; wordIndex < this->evaMasks.size(); ++wordIndex) {
+        for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+            if (this->evaMasks[wordIndex] & (1u << letter)) {
+                letterWords[fill[letter]++] = wordIndex;
+            }
+        }
+    }
+}
+
+void IncrementalScorer::reset(const Permutation& newPermutation) {
+    permutation = newPermutation;
+    
+    PermutationTranslator::LookupTable table;
+    PermutationTranslator::buildLookupTable(permutation, table);
+    PermutationTranslator::translateMasks(table, evaMasks.data(), hebrewMasks.data(), evaMasks.size());
+    
+    matchedWords = 0;
+    for (size_t i = 0; i < hebrewMasks.size(); ++i) {
+        matched[i] = lexicon->contains(hebrewMasks[i]) ? 1 : 0;
+        matchedWords += matched[i] * weights[i];
+    }
+    wordsRescored += hebrewMasks.size();
+    wordsProbed += totalWords;
+    wordsProbedMatched += matchedWords;
+}
+
+void IncrementalScorer::applySwap(int evaA, int evaB) {
+    if (evaA == evaB) return;
+    
+    // Words with exactly one of the two letters trade one Hebrew letter for the other;
+    // words with both (or neither) keep the same letter set
+    const uint32_t toggleMask = (1u << permutation[evaA]) | (1u << permutation[evaB]);
+    const uint32_t bitA = 1u << evaA;
+    const uint32_t bitB = 1u << evaB;
+    
+    for (uint32_t i = letterOffsets[evaA]; i < letterOffsets[evaA + 1]; ++i) {
+        uint32_t wordIndex = letterWords[i];
+        if (!(evaMasks[wordIndex] & bitB)) rescoreWord(wordIndex, toggleMask);
+    }
+    for (uint32_t i = letterOffsets[evaB]; i < letterOffsets[evaB + 1]; ++i) {
+        uint32_t wordIndex = letterWords[i];
+        if (!(evaMasks[wordIndex] & bitA)) rescoreWord(wordIndex, toggleMask);
+    }
+    
+    std::swap(permutation[evaA], permutation[evaB]);
+}
+
+void IncrementalScorer::rescoreWord(uint32_t wordIndex, uint32_t toggleMask) {
+    uint32_t mask = hebrewMasks[wordIndex] ^ toggleMask;
+    hebrewMasks[wordIndex] = mask;
+    
+    uint8_t isMatch = lexicon->contains(mask) ? 1 : 0;
+    matchedWords += isMatch * weights[wordIndex];
+    matchedWords -= matched[wordIndex] * weights[wordIndex];
+    matched[wordIndex] = isMatch;
+    wordsRescored++;
+    wordsProbed += weights[wordIndex];
+    wordsProbedMatched += isMatch * weights[wordIndex];
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "HebrewLexicon.h"
+#include "PermutationTranslator.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Keeps the translated masks and lexicon matches of a fixed Voynich corpus up to date while
+// the mapping changes by transpositions. Swapping the Hebrew letters of two EVA letters only
+// affects the words that contain exactly one of them, so only those words are re-probed.
+class IncrementalScorer {
+public:
+    // weights[i] is the number of corpus words mask i stands for (empty: one word per mask)
+    IncrementalScorer(const std::vector<uint32_t>& evaMasks, std::shared_ptr<const HebrewLexicon> lexicon,
+                      const std::vector<uint32_t>& weights = {});
+    
+    // Translate and probe every word for a new permutation
+    void reset(const Permutation& permutation);
+    
+    // Exchange the Hebrew letters assigned to EVA letters a and b, rescoring affected words only
+    void applySwap(int evaA, int evaB);
+    
+    size_t getMatchedWords() const { return matchedWords; }
+    size_t getTotalWords() const { return totalWords; }
+    const Permutation& getPermutation() const { return permutation; }
+    const std::vector<uint32_t>& getHebrewMasks() const { return hebrewMasks; }
+    
+    // Number of word probes performed so far (for measuring the incremental saving)
+    uint64_t getWordsRescored() const { return wordsRescored; }
+    
+    // Corpus words behind those probes (mask weights summed), and how many of them matched
+    uint64_t getWordsProbed() const { return wordsProbed; }
+    uint64_t getWordsProbedMatched() const { return wordsProbedMatched; }
+    
+private:
+    std::vector<uint32_t> evaMasks;
+    std::vector<uint32_t> hebrewMasks;
+    std::vector<uint8_t> matched;
+    std::vector<uint32_t> weights;
+    std::shared_ptr<const HebrewLexicon> lexicon;
+    
+    // Words containing each EVA letter: letterWords[letterOffsets[i] .. letterOffsets[i + 1])
+    uint32_t letterOffsets[Word::ALPHABET_SIZE + 1];
+    std::vector<uint32_t> letterWords;
+    
+    Permutation permutation;
+    size_t matchedWords;
+    size_t totalWords;
+    uint64_t wordsRescored;
+    uint64_t wordsProbed;
+    uint64_t wordsProbedMatched;
+    
+    void rescoreWord(uint32_t wordIndex, uint32_t toggleMask);
+};
@@ -0,0 +1,180 @@
+#include "LocalSearch.h"
+#include "BitUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const uint64_t STOP_CHECK_MOVES = 4096;
+}
+
+LocalSearch::LocalSearch(const WordSet& words, std::shared_ptr<const HebrewLexicon> lexicon, const SearchConfig& config)
+    : config(config), lexicon(std::move(lexicon)), maskTable(words.buildMaskTable()), totalWords(words.size()),
+      startTime(std::chrono::steady_clock::now()), sharedBest(PermutationTranslator::identityPermutation()),
+      sharedBestMatched(0), secondsToBest(0.0), chainCount(0) {
+    uint32_t corpusLetters = 0;
+    for (uint32_t mask : maskTable.masks) {
+        corpusLetters |= mask;
+    }
+    for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+        ((corpusLetters >> letter) & 1 ? usedLetters : unusedLetters).push_back(static_cast<uint8_t>(letter));
+    }
+}
+
+Permutation LocalSearch::randomPermutation(std::mt19937_64& rng) const {
+    Permutation permutation = PermutationTranslator::identityPermutation();
+    std::shuffle(permutation.begin(), permutation.end(), rng);
+    return permutation;
+}
+
+void LocalSearch::canonicalize(Permutation& permutation) const {
+    uint32_t leftOver = Word::FULL_MASK;
+    for (uint8_t letter : usedLetters) {
+        leftOver &= ~(1u << permutation[letter]);
+    }
+    for (uint8_t letter : unusedLetters) {
+        permutation[letter] = static_cast<uint8_t>(BitUtils::countTrailingZeros(leftOver));
+        leftOver &= leftOver - 1;
+    }
+}
+
+void LocalSearch::restart(Chain& chain, const Permutation& start) {
+    chain.scorer.reset(start);
+    chain.temperature = config.initialTemperature;
+    chain.best = start;
+    canonicalize(chain.best);
+    chain.bestMatched = chain.scorer.getMatchedWords();
+    chain.roundsSinceImprovement = 0;
+}
+
+std::unique_ptr<LocalSearch::Chain> LocalSearch::createChain(uint64_t chainId) {
+    uint64_t seed = config.randomSeed != 0 ? config.randomSeed + chainId : std::random_device{}();
+    auto chain = std::make_unique<Chain>(maskTable.masks, lexicon, maskTable.weights, seed);
+    
+    const std::vector<Permutation>& seeds = config.seedPermutations;
+    restart(*chain, seeds.empty() ? randomPermutation(chain->rng) : seeds[chainId % seeds.size()]);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    chainCount++;
+    return chain;
+}
+
+uint64_t LocalSearch::claimMoves() {
+    if (config.moveBudget == 0) {
+        return config.movesPerRound;
+    }
+    uint64_t claimed = movesClaimed.fetch_add(config.movesPerRound);
+    if (claimed >= config.moveBudget) {
+        return 0;
+    }
+    return std::min(config.movesPerRound, config.moveBudget - claimed);
+}
+
+bool LocalSearch::runRound(Chain& chain, const ImprovementCallback& onImprovement, const std::function<bool()>& shouldStop,
+                           RoundStats& stats) {
+    uint64_t moves = finished.load() ? 0 : claimMoves();
+    if (moves == 0 || usedLetters.empty()) {
+        finished = true;
+        return false;
+    }
+    
+    // First letter among the used ones, second any other letter
+    std::uniform_int_distribution<size_t> pickUsed(0, usedLetters.size() - 1);
+    std::uniform_int_distribution<int> pickOther(0, Word::ALPHABET_SIZE - 2);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    IncrementalScorer& scorer = chain.scorer;
+    const uint64_t probedBefore = scorer.getWordsProbed();
+    const uint64_t probedMatchedBefore = scorer.getWordsProbedMatched();
+    
+    RoundStats round;
+    bool stopped = false;
+    bool improved = false;
+    for (uint64_t move = 0; move < moves; ++move) {
+        if (shouldStop && move % STOP_CHECK_MOVES == STOP_CHECK_MOVES - 1 && shouldStop()) {
+            stopped = true;
+            break;
+        }
+        
+        int evaA = usedLetters[pickUsed(chain.rng)];
+        int evaB = pickOther(chain.rng);
+        evaB += evaB >= evaA ? 1 : 0;
+        
+        size_t before = scorer.getMatchedWords();
+        scorer.applySwap(evaA, evaB);
+        size_t after = scorer.getMatchedWords();
+        round.movesEvaluated++;
+        round.wordsMatched += after;
+        
+        if (after < before) {
+            double delta = static_cast<double>(after) - static_cast<double>(before);
+            if (!(chain.temperature > 0.0 && unit(chain.rng) < std::exp(delta / chain.temperature))) {
+                scorer.applySwap(evaA, evaB);  // Rejected: swap back
+                continue;
+            }
+        }
+        round.movesAccepted++;
+        
+        if (after > chain.bestMatched) {
+            chain.best = scorer.getPermutation();
+            canonicalize(chain.best);
+            chain.bestMatched = after;
+            improved = true;
+            if (onImprovement) {
+                onImprovement(chain.best, after);
+            }
+            if (config.targetMatched > 0 && after >= config.targetMatched) {
+                finished = true;
+                break;
+            }
+        }
+    }
+    
+    // Cool, or restart a chain that is cold or stuck
+    chain.roundsSinceImprovement = improved ? 0 : chain.roundsSinceImprovement + 1;
+    chain.temperature *= config.coolingRate;
+    bool cold = config.initialTemperature > 0.0 && chain.temperature < config.minTemperature;
+    bool restartChain = !stopped && (cold || chain.roundsSinceImprovement >= config.stuckRounds);
+    Permutation start;
+    {
+        // Publish this chain's best; a restart may continue from the best of all chains
+        std::lock_guard<std::mutex> lock(mutex);
+        if (chain.bestMatched > sharedBestMatched) {
+            sharedBest = chain.best;
+            sharedBestMatched = chain.bestMatched;
+            secondsToBest = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+        if (restartChain) {
+            round.restarts++;
+            bool adoptBest = sharedBestMatched > 0 && unit(chain.rng) < config.adoptBestProbability;
+            start = adoptBest ? sharedBest : randomPermutation(chain.rng);
+        }
+    }
+    if (restartChain) {
+        restart(chain, start);
+    }
+    
+    // The restart's full rescoring is work of this round too
+    round.wordsProbed = scorer.getWordsProbed() - probedBefore;
+    round.wordsProbedMatched = scorer.getWordsProbedMatched() - probedMatchedBefore;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        totals.movesEvaluated += round.movesEvaluated;
+        totals.movesAccepted += round.movesAccepted;
+        totals.wordsMatched += round.wordsMatched;
+        totals.wordsProbed += round.wordsProbed;
+        totals.wordsProbedMatched += round.wordsProbedMatched;
+        totals.restarts += round.restarts;
+    }
+    
+    stats.movesEvaluated += round.movesEvaluated;
+    stats.movesAccepted += round.movesAccepted;
+    stats.wordsMatched += round.wordsMatched;
+    stats.wordsProbed += round.wordsProbed;
+    stats.wordsProbedMatched += round.wordsProbedMatched;
+    stats.restarts += round.restarts;
+    return !stopped && !finished.load();
+}
+
+LocalSearch::Progress LocalSearch::getProgress() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Progress{ sharedBestMatched, secondsToBest, chainCount, totals };
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "IncrementalScorer.h"
+#include "HebrewLexicon.h"
+#include "WordSet.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+// Stochastic alternative to exhaustive enumeration: independent chains of swap moves, one per
+// worker, each move rescored incrementally (only the distinct masks containing exactly one of
+// the swapped letters are probed again). Moves that lose matches are accepted with probability
+// exp(delta / temperature), so temperature 0 is plain hill climbing. A chain cools every round
+// and, once cold or stuck, restarts either from the best mapping any chain has found or from a
+// fresh random one; chains publish their best after every round.
+//
+// Only swaps involving an EVA letter the corpus uses are tried (the others cannot change a
+// score), and reported mappings give the unused letters the left-over Hebrew letters in
+// ascending order, as in SearchSpace, so equal assignments get the same key.
+class LocalSearch {
+public:
+    struct SearchConfig {
+        uint64_t movesPerRound;            // Swap moves a chain makes between exchanges
+        double initialTemperature;        // In matched words (0 = hill climbing)
+        double coolingRate;               // Temperature factor applied after every round
+        double minTemperature;            // Colder chains restart
+        uint64_t stuckRounds;             // Rounds without a new chain best before a restart
+        double adoptBestProbability;      // Chance a restart continues from the shared best
+        uint64_t moveBudget;              // Moves over all chains (0 = unlimited)
+        size_t targetMatched;             // Finish once a chain matches this many words (0 = never)
+        uint64_t randomSeed;              // Chain c is seeded with randomSeed + c (0 = random_device)
+        std::vector<Permutation> seedPermutations;  // Chain c starts from entry c % size (empty = random)
+        
+        SearchConfig() :
+            movesPerRound(100000),
+            initialTemperature(2.0),
+            coolingRate(0.9),
+            minTemperature(0.05),
+            stuckRounds(20),
+            adoptBestProbability(0.5),
+            moveBudget(0),
+            targetMatched(0),
+            randomSeed(0) {}
+    };
+    
+    // One worker's chain: its scorer, random state and schedule
+    struct Chain {
+        IncrementalScorer scorer;
+        std::mt19937_64 rng;
+        double temperature;
+        Permutation best;                 // Best mapping since the chain's last restart
+        size_t bestMatched;
+        uint64_t roundsSinceImprovement;
+        
+        Chain(const std::vector<uint32_t>& masks, std::shared_ptr<const HebrewLexicon> lexicon,
+              const std::vector<uint32_t>& weights, uint64_t seed) :
+            scorer(masks, std::move(lexicon), weights), rng(seed), temperature(0.0), bestMatched(0),
+            roundsSinceImprovement(0) {}
+    };
+    
+    // Work done by one round (and, summed, by the whole search)
+    struct RoundStats {
+        uint64_t movesEvaluated = 0;      // Swaps scored (each one a mapping)
+        uint64_t movesAccepted = 0;
+        uint64_t wordsMatched = 0;        // Matched words summed over evaluated mappings
+        uint64_t wordsProbed = 0;         // Words the scorer actually looked up (restarts included)
+        uint64_t wordsProbedMatched = 0;  // Of those, words found in the lexicon
+        uint64_t restarts = 0;
+    };
+    
+    struct Progress {
+        size_t bestMatched;               // Best over all chains
+        double secondsToBest;             // Time from construction until it was first reached
+        uint64_t chains;
+        RoundStats totals;
+    };
+    
+    // A chain's new best since its last restart, with its exact match count
+    using ImprovementCallback = std::function<void(const Permutation& permutation, size_t matched)>;
+
+private:
+    SearchConfig config;
+    std::shared_ptr<const HebrewLexicon> lexicon;
+    WordSet::MaskTable maskTable;
+    size_t totalWords;
+    std::vector<uint8_t> usedLetters;
+    std::vector<uint8_t> unusedLetters;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<uint64_t> movesClaimed{0};
+    std::atomic<bool> finished{false};
+    
+    // Exchange and totals (guarded by mutex)
+    mutable std::mutex mutex;
+    Permutation sharedBest;
+    size_t sharedBestMatched;
+    double secondsToBest;
+    uint64_t chainCount;
+    RoundStats totals;
+    
+    Permutation randomPermutation(std::mt19937_64& rng) const;
+    void canonicalize(Permutation& permutation) const;
+    void restart(Chain& chain, const Permutation& start);
+    uint64_t claimMoves();
+
+public:
+    LocalSearch(const WordSet& words, std::shared_ptr<const HebrewLexicon> lexicon, const SearchConfig& config = SearchConfig());
+    
+    // A chain at its seed (or a random) permutation; chainId picks the seed and random stream
+    std::unique_ptr<Chain> createChain(uint64_t chainId);
+    
+    // Make up to movesPerRound moves, reporting each new chain best, then publish the chain's
+    // best and cool (or restart) it. shouldStop is polled every few thousand moves. Returns
+    // false once the search is over: stopped, budget spent or target reached.
+    bool runRound(Chain& chain, const ImprovementCallback& onImprovement, const std::function<bool()>& shouldStop,
+                  RoundStats& stats);
+    
+    bool isFinished() const { return finished.load(); }
+    size_t getTotalWords() const { return totalWords; }
+    size_t getUsedLetterCount() const { return usedLetters.size(); }
+    Progress getProgress() const;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Read-only memory mapping of a whole file (mmap, or a file mapping view on Windows). The
+// bytes stay valid until the mapping is closed or replaced; an empty file maps as no bytes.
+class MappedFile {
+private:
+    const uint8_t* bytes;
+    size_t length;
+    bool mapped;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map filePath, replacing any earlier mapping; false if it cannot be opened or mapped
+    bool open(const std::string& filePath);
+    void close();
+
+    bool isOpen() const { return mapped; }
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+};
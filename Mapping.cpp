@@ -1,10 +1,14 @@
 #include "Mapping.h"
+#include "BitUtils.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <iterator>
 
 Mapping::Mapping() {
     // Initialize 27x27 matrix with zeros
     mappingMatrix.resize(27, std::vector<int>(27, 0));
+    std::fill(std::begin(rowMasks), std::end(rowMasks), 0u);
 }
 
 void Mapping::createEvaToHebrewMapping() {
@@ -13,6 +17,7 @@ void Mapping::createEvaToHebrewMapping() {
         for (int j = 0; j < 27; j++) {
             mappingMatrix[i][j] = 0;
         }
+        rowMasks[i] = 0;
     }
     
     // Create a sample mapping from EVA to Hebrew
@@ -121,6 +126,18 @@ std::vector<int> Mapping::applyMapping(const std::vector<int>& inputVector) cons
     return result;
 }
 
+uint32_t Mapping::applyMappingToMask(uint32_t evaMask) const {
+    uint32_t result = 0;
+    
+    // OR together the packed rows of every EVA letter present in the word
+    while (evaMask) {
+        result |= rowMasks[BitUtils::countTrailingZeros(evaMask)];
+        evaMask &= evaMask - 1;
+    }
+    
+    return result;
+}
+
 Word Mapping::translateToHebrew(const Word& evaWord) const {
     if (evaWord.getAlphabet() != Alphabet::EVA) {
         std::wcerr << L"Error: Input word must be in EVA alphabet" << std::endl;
@@ -183,6 +200,7 @@ void Mapping::printMappingMatrix() const {
 void Mapping::setMapping(int evaIndex, int hebrewIndex) {
     if (evaIndex >= 0 && evaIndex < 27 && hebrewIndex >= 0 && hebrewIndex < 27) {
         mappingMatrix[evaIndex][hebrewIndex] = 1;
+        rowMasks[evaIndex] |= (1u << hebrewIndex);
     }
 }
 
@@ -3,10 +3,12 @@
 #include "Word.h"
 #include <vector>
 #include <string>
+#include <cstdint>
 
 class Mapping {
 private:
     std::vector<std::vector<int>> mappingMatrix; // 27x27 binary matrix
+    uint32_t rowMasks[Word::ALPHABET_SIZE];       // Packed rows: Hebrew letters targeted by each EVA letter
     
 public:
     Mapping();
@@ -17,6 +19,12 @@ public:
     // Apply mapping to a Word's binary matrix (matrix multiplication)
     std::vector<int> applyMapping(const std::vector<int>& inputVector) const;
     
+    // Apply mapping to a packed EVA letter mask, producing a packed Hebrew letter mask
+    uint32_t applyMappingToMask(uint32_t evaMask) const;
+    
+    // Packed row of the mapping matrix for one EVA letter
+    uint32_t getRowMask(int evaIndex) const { return rowMasks[evaIndex]; }
+    
     // Translate an EVA Word to Hebrew representation
     Word translateToHebrew(const Word& evaWord) const;
     
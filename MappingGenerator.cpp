@@ -4,6 +4,9 @@
 #include <fstream>
 #include <chrono>
 #include <iomanip>
+#include <stdexcept>
+#include <filesystem>
+#include <cstdio>
 
 // Include nlohmann/json - assume it's available in project
 #ifdef _WIN32
@@ -31,14 +34,80 @@ namespace {
         ss >> time_t;
         return std::chrono::system_clock::from_time_t(time_t);
     }
+    
+    // Binary state file helpers (fixed-width little-endian fields)
+    const char STATE_FILE_MAGIC[4] = { 'V', 'D', 'G', 'S' };
+    
+    uint64_t fnv1a(const char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+    
+    void appendInteger(std::string& buffer, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+    
+    struct ByteReader {
+        const std::string& data;
+        size_t position;
+        bool ok;
+        
+        explicit ByteReader(const std::string& data) : data(data), position(0), ok(true) {}
+        
+        uint64_t read(int bytes) {
+            if (!ok || position + bytes > data.size()) {
+                ok = false;
+                return 0;
+            }
+            uint64_t value = 0;
+            for (int i = 0; i < bytes; ++i) {
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(data[position + i])) << (8 * i);
+            }
+            position += bytes;
+            return value;
+        }
+    };
+    
+    int64_t timePointToSeconds(const std::chrono::system_clock::time_point& tp) {
+        return static_cast<int64_t>(std::chrono::system_clock::to_time_t(tp));
+    }
+    
+    std::chrono::system_clock::time_point secondsToTimePoint(int64_t seconds) {
+        return std::chrono::system_clock::from_time_t(static_cast<std::time_t>(seconds));
+    }
+    
+    // JSON form of a search space: "full", or the used letter count and the letter order
+    std::string searchSpaceToString(const SearchSpace& space) {
+        if (space.isFull()) {
+            return "full";
+        }
+        std::ostringstream out;
+        out << space.getUsedLetterCount() << ":";
+        for (int i = 0; i < Word::ALPHABET_SIZE; ++i) {
+            out << (i > 0 ? "," : "") << static_cast<int>(space.getLetterOrder()[i]);
+        }
+        return out.str();
+    }
 }
 
 MappingGenerator::MappingGenerator(const GeneratorConfig& config) 
-    : config(config) {
+    : config(config), nextBlockCounter(0), completedBlockCounter(0), unassignedPendingBlocks(0),
+      blocksExhausted(false), stateDirty(false), threadSlotCount(0), generatedBlocksBase(0), nextBlockBase(0),
+      stopCheckpointer(false) {
+    
+    for (auto& slot : threadSlots) {
+        slot.store(nullptr);
+    }
     
     // Load previous state if enabled
     if (config.enableStateFile) {
-        if (!loadStateFromJson()) {
+        if (!loadState()) {
             // Initialize with default state if loading fails
             state = GeneratorState();
             std::wcout << L"Starting with clean generator state" << std::endl;
@@ -53,152 +122,426 @@ MappingGenerator::MappingGenerator(const GeneratorConfig& config)
     if (config.enableStateFile) {
         loadPendingBlocksFromState();
     }
+    
+    resetCounters();
+    
+    // Persist on a timer instead of on every block allocation/completion
+    if (config.enableStateFile && config.checkpointIntervalMs > 0) {
+        checkpointThread = std::thread(&MappingGenerator::checkpointLoop, this);
+    }
 }
 
 MappingGenerator::~MappingGenerator() {
+    stopCheckpointThread();
+    
     // Save state on destruction
     if (config.enableStateFile) {
-        saveStateToJson();
+        checkpointState();
+    }
+    
+    for (auto& slot : threadSlots) {
+        delete slot.load();
+    }
+}
+
+void MappingGenerator::resetCounters() {
+    // Rebase the lock-free counters on the current (loaded or cleared) state
+    nextBlockCounter = state.nextBlockToGenerate;
+    completedBlockCounter = state.totalBlocksCompleted;
+    blocksExhausted = state.isComplete;
+    generatedBlocksBase = state.totalBlocksGenerated;
+    nextBlockBase = state.nextBlockToGenerate;
+    stateDirty = false;
+    
+    uint64_t unassigned = 0;
+    for (const auto& block : blockWindow) {
+        if (block.state == BlockState::PENDING && block.assignedThreadId == -1) {
+            unassigned++;
+        }
+    }
+    unassignedPendingBlocks = unassigned;
+}
+
+void MappingGenerator::checkpointLoop() {
+    std::unique_lock<std::mutex> lock(checkpointMutex);
+    while (!stopCheckpointer) {
+        checkpointCondition.wait_for(lock, std::chrono::milliseconds(config.checkpointIntervalMs),
+                                     [this]() { return stopCheckpointer; });
+        if (stopCheckpointer) break;
+        
+        lock.unlock();
+        if (stateDirty.exchange(false)) {
+            checkpointState();
+        }
+        lock.lock();
+    }
+}
+
+void MappingGenerator::stopCheckpointThread() {
+    {
+        std::lock_guard<std::mutex> lock(checkpointMutex);
+        stopCheckpointer = true;
+    }
+    checkpointCondition.notify_all();
+    if (checkpointThread.joinable()) {
+        checkpointThread.join();
     }
 }
 
 std::vector<std::unique_ptr<Mapping>> MappingGenerator::getNextBlock(int threadId) {
-    std::lock_guard<std::mutex> lock(generatorMutex);
+    uint64_t blockIndex = assignBlockToThread(threadId);
+    if (blockIndex == UINT64_MAX) {
+        return {}; // No more blocks available
+    }
+    
+    // Generate the block mappings
+    return generateBlock(blockIndex);
+}
+
+MappingGenerator::BlockCursor MappingGenerator::getNextBlockCursor(int threadId) {
+    uint64_t startIndex = 0;
+    uint64_t endIndex = 0;
+    if (!claimBlockRange(threadId, startIndex, endIndex)) {
+        return BlockCursor();
+    }
+    return BlockCursor(startIndex, endIndex, config.searchSpace);
+}
+
+MappingGenerator::BlockCursor::BlockCursor(uint64_t startIndex, uint64_t endIndex, const SearchSpace& space)
+    : space(&space), firstIndex(startIndex), lastIndex(endIndex), nextIndex(startIndex), stepsToPrefixChange(0), started(false) {
+}
+
+bool MappingGenerator::BlockCursor::next(Permutation& permutation, uint64_t& globalIndex) {
+    if (nextIndex >= lastIndex) {
+        return false;
+    }
     
-    // Check if this thread already has an active block
-    auto threadIt = threadToBlock.find(threadId);
-    if (threadIt != threadToBlock.end()) {
-        // Thread already has a block, mark the previous one as completed first
-        completeBlockForThread(threadId);
+    if (started && stepsToPrefixChange > 1) {
+        // Same leading positions: step the tail instead of unranking again
+        space->stepToNext(current);
+        stepsToPrefixChange--;
+    } else {
+        space->unrank(nextIndex, current);
+        stepsToPrefixChange = space->stepsUntilPrefixChange(nextIndex);
+        started = true;
     }
     
-    if (state.isComplete) {
-        return {}; // No more blocks available
+    permutation = current;
+    globalIndex = nextIndex++;
+    return true;
+}
+
+bool MappingGenerator::claimBlockRange(int threadId, uint64_t& startIndex, uint64_t& endIndex) {
+    uint64_t blockIndex = assignBlockToThread(threadId);
+    if (blockIndex == UINT64_MAX) {
+        return false;
     }
     
-    // First, look for existing pending blocks that aren't assigned
+    startIndex = blockIndex * config.blockSize;
+    endIndex = std::min<uint64_t>(startIndex + config.blockSize, getCombinationCount());
+    return startIndex < endIndex;
+}
+
+bool MappingGenerator::claimSharedBlock(int threadId, uint64_t& blockIndex, uint64_t& startIndex, uint64_t& endIndex) {
+    blockIndex = assignBlockToThread(threadId, true);
+    if (blockIndex == UINT64_MAX) {
+        return false;
+    }
+    
+    startIndex = blockIndex * config.blockSize;
+    endIndex = std::min<uint64_t>(startIndex + config.blockSize, getCombinationCount());
+    return startIndex < endIndex;
+}
+
+uint64_t MappingGenerator::assignBlockToThread(int threadId, bool shared) {
+    ThreadSlot& slot = slotForThread(threadId);
+    
+    // A thread asking for a new block has finished its previous one (shared claims are
+    // completed explicitly, since other threads may still be working on them)
+    if (!shared) {
+        std::lock_guard<std::mutex> slotLock(slot.slotMutex);
+        if (slot.hasActiveBlock) {
+            completeActiveBlock(slot);
+            stateDirty = true;
+        }
+    }
+    
+    // Resumed pending blocks go first; they are rare, so only then is the shared mutex taken
+    if (unassignedPendingBlocks.load() > 0) {
+        uint64_t blockIndex = reassignPendingBlock(threadId, shared);
+        if (blockIndex != UINT64_MAX) {
+            return blockIndex;
+        }
+    }
+    
+    if (blocksExhausted.load()) {
+        return UINT64_MAX; // No more blocks available
+    }
+    
+    // The counter is advanced inside the slot lock so synchronizeSlots never sees an
+    // issued block index before its claim is visible in the owning slot
+    std::lock_guard<std::mutex> slotLock(slot.slotMutex);
+    uint64_t blockIndex = nextBlockCounter.fetch_add(1);
+    if (blockIndex >= totalBlockCount()) {
+        blocksExhausted = true;
+        stateDirty = true;
+        return UINT64_MAX;
+    }
+    
+    ThreadSlot::Event event;
+    event.blockIndex = blockIndex;
+    event.inWindow = false;
+    event.assignedTime = std::chrono::system_clock::now();
+    recordClaim(slot, event, shared);
+    
+    if (config.logBlockEvents) {
+        std::wcout << L"[BLOCK] Allocated block " << blockIndex << L" to thread " << threadId << std::endl;
+    }
+    
+    return blockIndex;
+}
+
+uint64_t MappingGenerator::reassignPendingBlock(int threadId, bool shared) {
+    std::lock_guard<std::mutex> lock(generatorMutex);
+    
     for (auto& block : blockWindow) {
         if (block.state == BlockState::PENDING && block.assignedThreadId == -1) {
             // Assign this pending block to the thread
             block.assignedThreadId = threadId;
             block.assignedTime = std::chrono::system_clock::now();
-            threadToBlock[threadId] = block.blockIndex;
+            unassignedPendingBlocks--;
             
-            std::wcout << L"[BLOCK] Reassigned pending block " << block.blockIndex << L" to thread " << threadId << std::endl;
+            ThreadSlot& slot = slotForThread(threadId);
+            std::lock_guard<std::mutex> slotLock(slot.slotMutex);
+            ThreadSlot::Event event;
+            event.blockIndex = block.blockIndex;
+            event.inWindow = true;
+            event.assignedTime = block.assignedTime;
+            recordClaim(slot, event, shared);
             
-            // Save state after reassignment
-            if (config.enableStateFile) {
-                saveStateToJson();
+            if (config.logBlockEvents) {
+                std::wcout << L"[BLOCK] Reassigned pending block " << block.blockIndex << L" to thread " << threadId << std::endl;
             }
             
-            // Generate the block mappings
-            return generateBlock(block.blockIndex);
+            return block.blockIndex;
         }
     }
     
-    // No pending blocks available, create a new block for this thread
-    uint64_t newBlockIndex = createNewBlockForThread(threadId);
-    if (newBlockIndex == UINT64_MAX) {
-        return {}; // No more blocks can be created
+    unassignedPendingBlocks = 0;
+    return UINT64_MAX;
+}
+
+void MappingGenerator::recordClaim(ThreadSlot& slot, const ThreadSlot::Event& event, bool shared) {
+    if (shared) {
+        slot.shared.push_back(event);
+    } else {
+        slot.hasActiveBlock = true;
+        slot.activeSynchronized = event.inWindow;
+        slot.active = event;
     }
-    
-    // Generate the block mappings
-    return generateBlock(newBlockIndex);
+    stateDirty = true;
 }
 
-void MappingGenerator::completeCurrentBlock(int threadId) {
-    std::lock_guard<std::mutex> lock(generatorMutex);
-    completeBlockForThread(threadId);
+void MappingGenerator::completeSharedBlock(int claimingThreadId, uint64_t blockIndex) {
+    ThreadSlot* slot = findSlot(claimingThreadId);
+    if (!slot) {
+        return; // Thread never claimed a block
+    }
     
-    // Clean up completed blocks from the beginning of the sequence
-    removeCompletedSequentialBlocks();
+    std::lock_guard<std::mutex> slotLock(slot->slotMutex);
+    auto it = std::find_if(slot->shared.begin(), slot->shared.end(),
+                           [blockIndex](const ThreadSlot::Event& event) { return event.blockIndex == blockIndex; });
+    if (it == slot->shared.end()) {
+        return; // Not an open shared claim of this thread
+    }
     
-    // Save state after completion
-    if (config.enableStateFile) {
-        saveStateToJson();
+    ThreadSlot::Event event = *it;
+    event.completedTime = std::chrono::system_clock::now();
+    slot->shared.erase(it);
+    slot->completed.push_back(event);
+    completedBlockCounter++;
+    stateDirty = true;
+    
+    if (config.logBlockEvents) {
+        std::wcout << L"[BLOCK] Completed shared block " << blockIndex << L" claimed by thread " << claimingThreadId 
+                   << L" (Total completed: " << completedBlockCounter.load() << L")" << std::endl;
     }
 }
 
-
-void MappingGenerator::completeBlockForThread(int threadId) {
-    auto threadIt = threadToBlock.find(threadId);
-    if (threadIt == threadToBlock.end()) {
-        return; // Thread has no active block
+bool MappingGenerator::releaseSharedBlock(int claimingThreadId, uint64_t blockIndex) {
+    std::lock_guard<std::mutex> lock(generatorMutex);
+    
+    // Merge first so the claim is tracked in the window, where reassignment picks it up
+    synchronizeSlots();
+    
+    ThreadSlot* slot = findSlot(claimingThreadId);
+    if (!slot) {
+        return false; // Thread never claimed a block
     }
     
-    uint64_t blockIndex = threadIt->second;
-    BlockInfo* block = findBlockInWindow(blockIndex);
-    if (block && block->state == BlockState::PENDING && block->assignedThreadId == threadId) {
-        // Mark block as completed
-        block->state = BlockState::COMPLETED;
-        block->completedTime = std::chrono::system_clock::now();
-        state.totalBlocksCompleted++;
-        
-        // Log block completion
-        std::wcout << L"[BLOCK] Completed block " << blockIndex << L" by thread " << threadId 
-                   << L" (Total completed: " << state.totalBlocksCompleted << L")" << std::endl;
-        
-        // Save state immediately after block completion
-        if (config.enableStateFile) {
-            saveStateToJson();
+    {
+        std::lock_guard<std::mutex> slotLock(slot->slotMutex);
+        auto it = std::find_if(slot->shared.begin(), slot->shared.end(),
+                               [blockIndex](const ThreadSlot::Event& event) { return event.blockIndex == blockIndex; });
+        if (it == slot->shared.end()) {
+            return false; // Not an open shared claim of this thread
         }
+        slot->shared.erase(it);
     }
     
-    // Remove thread mapping
-    threadToBlock.erase(threadIt);
-}
-
-MappingGenerator::BlockInfo* MappingGenerator::findBlockInWindow(uint64_t blockIndex) {
-    for (auto& block : blockWindow) {
-        if (block.blockIndex == blockIndex) {
-            return &block;
-        }
+    BlockInfo* block = findBlockInWindow(blockIndex);
+    if (!block || block->state != BlockState::PENDING) {
+        return false;
     }
-    return nullptr;
+    block->assignedThreadId = -1;
+    block->assignedTime = std::chrono::system_clock::time_point{};
+    unassignedPendingBlocks++;
+    stateDirty = true;
+    
+    if (config.logBlockEvents) {
+        std::wcout << L"[BLOCK] Released shared block " << blockIndex << L" claimed by thread " << claimingThreadId << std::endl;
+    }
+    return true;
 }
 
-uint64_t MappingGenerator::createNewBlockForThread(int threadId) {
-    // Check if we've reached the total combinations limit
-    uint64_t totalMappingsGenerated = state.nextBlockToGenerate * config.blockSize;
-    if (totalMappingsGenerated >= TOTAL_COMBINATIONS) {
-        state.isComplete = true;
-        return UINT64_MAX;
+void MappingGenerator::completeCurrentBlock(int threadId) {
+    ThreadSlot* slot = findSlot(threadId);
+    if (!slot) {
+        return; // Thread never claimed a block
     }
     
+    std::lock_guard<std::mutex> slotLock(slot->slotMutex);
+    if (!slot->hasActiveBlock) {
+        return; // Thread has no active block
+    }
     
-    uint64_t newBlockIndex = state.nextBlockToGenerate;
+    uint64_t blockIndex = slot->active.blockIndex;
+    completeActiveBlock(*slot);
+    stateDirty = true;
     
-    // Create new block info and assign to thread immediately as PENDING
-    addBlockToWindow(newBlockIndex, threadId);
+    if (config.logBlockEvents) {
+        std::wcout << L"[BLOCK] Completed block " << blockIndex << L" by thread " << threadId 
+                   << L" (Total completed: " << completedBlockCounter.load() << L")" << std::endl;
+    }
+}
+
+void MappingGenerator::completeActiveBlock(ThreadSlot& slot) {
+    ThreadSlot::Event event = slot.active;
+    event.inWindow = slot.activeSynchronized || slot.active.inWindow;
+    event.completedTime = std::chrono::system_clock::now();
+    slot.completed.push_back(event);
+    slot.hasActiveBlock = false;
+    slot.activeSynchronized = false;
+    completedBlockCounter++;
+}
+
+MappingGenerator::ThreadSlot& MappingGenerator::slotForThread(int threadId) {
+    if (threadId < 0 || threadId >= MAX_THREAD_SLOTS) {
+        throw std::runtime_error("MappingGenerator: thread id out of range");
+    }
     
-    state.nextBlockToGenerate++;
-    state.totalBlocksGenerated++;
+    ThreadSlot* slot = threadSlots[threadId].load(std::memory_order_acquire);
+    if (slot) {
+        return *slot;
+    }
     
-    // Save state immediately after block allocation
-    if (config.enableStateFile) {
-        saveStateToJson();
+    // First claim from this thread: publish a new slot (losers of a race discard theirs)
+    ThreadSlot* created = new ThreadSlot();
+    ThreadSlot* expected = nullptr;
+    if (!threadSlots[threadId].compare_exchange_strong(expected, created, std::memory_order_acq_rel)) {
+        delete created;
+        return *expected;
     }
     
-    return newBlockIndex;
+    int count = threadSlotCount.load();
+    while (count < threadId + 1 && !threadSlotCount.compare_exchange_weak(count, threadId + 1)) {
+    }
+    return *created;
 }
 
-void MappingGenerator::addBlockToWindow(uint64_t blockIndex, int threadId) {
-    // Check if block is already being tracked
-    if (findBlockInWindow(blockIndex)) {
-        return;
+MappingGenerator::ThreadSlot* MappingGenerator::findSlot(int threadId) const {
+    if (threadId < 0 || threadId >= MAX_THREAD_SLOTS) {
+        return nullptr;
     }
+    return threadSlots[threadId].load(std::memory_order_acquire);
+}
+
+void MappingGenerator::synchronizeSlots() {
+    // Read the counter before scanning: every index below it was issued under its slot lock,
+    // so the scan sees all of them and the saved state never skips an unmerged block
+    uint64_t issuedBlocks = std::min(nextBlockCounter.load(), totalBlockCount());
     
-    // Create new block info assigned as PENDING to thread
-    BlockInfo newBlock(blockIndex, threadId);
+    int slotCount = threadSlotCount.load();
+    for (int threadId = 0; threadId < slotCount; ++threadId) {
+        ThreadSlot* slot = findSlot(threadId);
+        if (!slot) continue;
+        
+        std::lock_guard<std::mutex> slotLock(slot->slotMutex);
+        
+        for (const auto& event : slot->completed) {
+            if (!event.inWindow) {
+                BlockInfo block(event.blockIndex, threadId);
+                block.assignedTime = event.assignedTime;
+                insertBlockIntoWindow(block);
+            }
+            
+            BlockInfo* block = findBlockInWindow(event.blockIndex);
+            if (block && block->state == BlockState::PENDING) {
+                block->state = BlockState::COMPLETED;
+                block->assignedThreadId = threadId;
+                block->completedTime = event.completedTime;
+            }
+        }
+        slot->completed.clear();
+        
+        if (slot->hasActiveBlock && !slot->activeSynchronized) {
+            BlockInfo block(slot->active.blockIndex, threadId);
+            block.assignedTime = slot->active.assignedTime;
+            insertBlockIntoWindow(block);
+            slot->activeSynchronized = true;
+        }
+        
+        for (auto& event : slot->shared) {
+            if (!event.inWindow) {
+                BlockInfo block(event.blockIndex, threadId);
+                block.assignedTime = event.assignedTime;
+                insertBlockIntoWindow(block);
+                event.inWindow = true;
+            }
+        }
+    }
     
-    // Insert in sorted order (should be at the end for sequential generation)
-    blockWindow.push_back(newBlock);
+    state.nextBlockToGenerate = issuedBlocks;
+    state.totalBlocksGenerated = generatedBlocksBase + (issuedBlocks - nextBlockBase);
+    state.totalBlocksCompleted = completedBlockCounter.load();
+    state.isComplete = blocksExhausted.load();
     
-    // Update thread mapping
-    threadToBlock[threadId] = blockIndex;
+    removeCompletedSequentialBlocks();
+}
+
+MappingGenerator::BlockInfo* MappingGenerator::findBlockInWindow(uint64_t blockIndex) {
+    // Window is kept sorted by block index
+    auto it = std::lower_bound(blockWindow.begin(), blockWindow.end(), blockIndex,
+                               [](const BlockInfo& block, uint64_t index) { return block.blockIndex < index; });
+    if (it != blockWindow.end() && it->blockIndex == blockIndex) {
+        return &*it;
+    }
+    return nullptr;
+}
+
+void MappingGenerator::insertBlockIntoWindow(const BlockInfo& block) {
+    // Claims are merged roughly in order, so this is almost always an append
+    if (blockWindow.empty() || blockWindow.back().blockIndex < block.blockIndex) {
+        blockWindow.push_back(block);
+        return;
+    }
     
-    // Log block allocation
-    std::wcout << L"[BLOCK] Allocated block " << blockIndex << L" to thread " << threadId << std::endl;
+    auto it = std::lower_bound(blockWindow.begin(), blockWindow.end(), block.blockIndex,
+                               [](const BlockInfo& existing, uint64_t index) { return existing.blockIndex < index; });
+    if (it != blockWindow.end() && it->blockIndex == block.blockIndex) {
+        return; // Already tracked
+    }
+    blockWindow.insert(it, block);
 }
 
 void MappingGenerator::removeCompletedSequentialBlocks() {
@@ -208,20 +551,14 @@ void MappingGenerator::removeCompletedSequentialBlocks() {
            blockWindow.front().state == BlockState::COMPLETED &&
            blockWindow.front().blockIndex == state.oldestTrackedBlock) {
         
-        uint64_t removedBlockIndex = blockWindow.front().blockIndex;
         blockWindow.pop_front();
         state.oldestTrackedBlock++;
         removedCount++;
     }
     
-    if (removedCount > 0) {
+    if (removedCount > 0 && config.logBlockEvents) {
         std::wcout << L"[BLOCK] Cleaned up " << removedCount << L" completed sequential blocks, "
                    << L"oldest tracked now: " << state.oldestTrackedBlock << std::endl;
-        
-        // Save state immediately after cleanup
-        if (config.enableStateFile) {
-            saveStateToJson();
-        }
     }
 }
 
@@ -233,8 +570,8 @@ std::vector<std::unique_ptr<Mapping>> MappingGenerator::generateBlock(uint64_t b
     uint64_t endIndex = startIndex + config.blockSize;
     
     // Make sure we don't exceed total combinations
-    if (endIndex > TOTAL_COMBINATIONS) {
-        endIndex = TOTAL_COMBINATIONS;
+    if (endIndex > getCombinationCount()) {
+        endIndex = getCombinationCount();
     }
     
     for (uint64_t i = startIndex; i < endIndex; ++i) {
@@ -248,63 +585,39 @@ std::vector<std::unique_ptr<Mapping>> MappingGenerator::generateBlock(uint64_t b
 }
 
 bool MappingGenerator::generateSingleMapping(uint64_t globalIndex, std::unique_ptr<Mapping>& mapping) {
-    if (globalIndex >= TOTAL_COMBINATIONS) {
+    if (globalIndex >= getCombinationCount()) {
         return false;
     }
     
     // Convert global index to permutation
-    std::vector<int> permutation = indexToPermutation(globalIndex);
-    
-    // Create mapping from permutation
-    mapping = std::make_unique<Mapping>();
+    Permutation permutation;
+    config.searchSpace.unrank(globalIndex, permutation);
     
     // Map EVA alphabet to Hebrew letters based on permutation
-    const std::vector<wchar_t> evaAlphabet = {
-        L'a', L'b', L'c', L'd', L'e', L'f', L'g', L'h', L'i', L'j', L'k', L'l', L'm',
-        L'n', L'o', L'p', L'q', L'r', L's', L't', L'u', L'v', L'w', L'x', L'y', L'z', L' '
-    };
-    
-    const std::vector<wchar_t> hebrewAlphabet = {
-        0x05D0, 0x05D1, 0x05D2, 0x05D3, 0x05D4, 0x05D5, 0x05D6, 0x05D7, 0x05D8,
-        0x05D9, 0x05DB, 0x05DC, 0x05DE, 0x05E0, 0x05E1, 0x05E2, 0x05E4, 0x05E6,
-        0x05E7, 0x05E8, 0x05E9, 0x05EA, 0x05DA, 0x05DD, 0x05DF, 0x05E3, 0x05E5
-    };
-    
-    // Build the mapping based on permutation
-    for (size_t i = 0; i < evaAlphabet.size() && i < permutation.size(); ++i) {
-        if (permutation[i] < static_cast<int>(hebrewAlphabet.size())) {
-            mapping->setMapping(static_cast<int>(i), permutation[i]);
-        }
-    }
+    mapping = std::make_unique<Mapping>();
+    PermutationTranslator::permutationToMapping(permutation, *mapping);
     
     return true;
 }
 
+void MappingGenerator::unrankPermutation(uint64_t index, Permutation& permutation) {
+    SearchSpace::full().unrank(index, permutation);
+}
+
+uint64_t MappingGenerator::stepsUntilPrefixChange(uint64_t index) {
+    return SearchSpace::full().stepsUntilPrefixChange(index);
+}
+
 std::vector<int> MappingGenerator::indexToPermutation(uint64_t index) const {
-    std::vector<int> result;
-    std::vector<int> available;
-    
-    // Initialize available numbers (0 to 26 for 27 characters)
-    for (int i = 0; i < 27; ++i) {
-        available.push_back(i);
-    }
-    
-    // Convert index to permutation using factorial number system
-    uint64_t remaining = index;
-    for (int position = 27; position > 0; --position) {
-        uint64_t factorial_val = factorial(position - 1);
-        int chosen_index = static_cast<int>(remaining / factorial_val);
-        
-        if (chosen_index >= static_cast<int>(available.size())) {
-            chosen_index = available.size() - 1;
-        }
-        
-        result.push_back(available[chosen_index]);
-        available.erase(available.begin() + chosen_index);
-        remaining %= factorial_val;
-    }
-    
-    return result;
+    Permutation permutation;
+    unrankPermutation(index, permutation);
+    return std::vector<int>(permutation.begin(), permutation.end());
+}
+
+uint64_t MappingGenerator::totalBlockCount() const {
+    uint64_t blockSize = static_cast<uint64_t>(config.blockSize);
+    uint64_t combinations = getCombinationCount();
+    return combinations / blockSize + (combinations % blockSize != 0 ? 1 : 0);
 }
 
 uint64_t MappingGenerator::factorial(int n) const {
@@ -317,30 +630,50 @@ uint64_t MappingGenerator::factorial(int n) const {
 }
 
 bool MappingGenerator::isGenerationComplete() const {
+    // Polled by every worker before each block, so answer without locking while blocks remain
+    if (!blocksExhausted.load()) {
+        return false;
+    }
+    
     std::lock_guard<std::mutex> lock(generatorMutex);
+    const_cast<MappingGenerator*>(this)->synchronizeSlots();
     return state.isComplete && blockWindow.empty();
 }
 
 MappingGenerator::GeneratorState MappingGenerator::getCurrentState() const {
     std::lock_guard<std::mutex> lock(generatorMutex);
+    const_cast<MappingGenerator*>(this)->synchronizeSlots();
     return state;
 }
 
 double MappingGenerator::getProgressPercentage() const {
-    std::lock_guard<std::mutex> lock(generatorMutex);
-    if (TOTAL_COMBINATIONS == 0) return 100.0;
+    uint64_t combinations = getCombinationCount();
+    if (combinations == 0) return 100.0;
     
-    uint64_t processedMappings = state.totalBlocksCompleted * config.blockSize;
-    return (static_cast<double>(processedMappings) / TOTAL_COMBINATIONS) * 100.0;
+    uint64_t processedMappings = completedBlockCounter.load() * config.blockSize;
+    return (static_cast<double>(processedMappings) / combinations) * 100.0;
 }
 
 void MappingGenerator::reset() {
+    // Hold off checkpoints so none started before the reset rewrites the removed file
+    std::lock_guard<std::mutex> fileLock(stateFileMutex);
     std::lock_guard<std::mutex> lock(generatorMutex);
     
     // Clear all state
     state = GeneratorState();
     blockWindow.clear();
-    threadToBlock.clear();
+    
+    int slotCount = threadSlotCount.load();
+    for (int threadId = 0; threadId < slotCount; ++threadId) {
+        ThreadSlot* slot = findSlot(threadId);
+        if (!slot) continue;
+        std::lock_guard<std::mutex> slotLock(slot->slotMutex);
+        slot->hasActiveBlock = false;
+        slot->activeSynchronized = false;
+        slot->shared.clear();
+        slot->completed.clear();
+    }
+    resetCounters();
     
     // Remove state file if it exists
     if (config.enableStateFile) {
@@ -349,18 +682,18 @@ void MappingGenerator::reset() {
 }
 
 bool MappingGenerator::saveCurrentState() const {
-    std::lock_guard<std::mutex> lock(generatorMutex);
-    return saveStateToJson();
+    return const_cast<MappingGenerator*>(this)->checkpointState();
 }
 
 uint64_t MappingGenerator::getRemainingMappings() const {
-    std::lock_guard<std::mutex> lock(generatorMutex);
-    uint64_t processedMappings = state.totalBlocksCompleted * config.blockSize;
-    return (processedMappings < TOTAL_COMBINATIONS) ? (TOTAL_COMBINATIONS - processedMappings) : 0;
+    uint64_t processedMappings = completedBlockCounter.load() * config.blockSize;
+    uint64_t combinations = getCombinationCount();
+    return (processedMappings < combinations) ? (combinations - processedMappings) : 0;
 }
 
 MappingGenerator::BlockStatus MappingGenerator::getBlockStatus() const {
     std::lock_guard<std::mutex> lock(generatorMutex);
+    const_cast<MappingGenerator*>(this)->synchronizeSlots();
     
     BlockStatus status;
     status.blockSize = config.blockSize;
@@ -388,9 +721,15 @@ MappingGenerator::ThreadBlockInfo MappingGenerator::getThreadBlockInfo(int threa
     info.blockIndex = 0;
     info.blockState = BlockState::PENDING;
     
-    auto threadIt = threadToBlock.find(threadId);
-    if (threadIt != threadToBlock.end()) {
-        uint64_t blockIndex = threadIt->second;
+    const_cast<MappingGenerator*>(this)->synchronizeSlots();
+    
+    ThreadSlot* slot = findSlot(threadId);
+    if (slot) {
+        std::lock_guard<std::mutex> slotLock(slot->slotMutex);
+        if (!slot->hasActiveBlock) {
+            return info;
+        }
+        uint64_t blockIndex = slot->active.blockIndex;
         const BlockInfo* block = const_cast<MappingGenerator*>(this)->findBlockInWindow(blockIndex);
         if (block) {
             info.hasActiveBlock = true;
@@ -405,6 +744,7 @@ MappingGenerator::ThreadBlockInfo MappingGenerator::getThreadBlockInfo(int threa
 
 std::vector<MappingGenerator::BlockInfo> MappingGenerator::getWindowSnapshot() const {
     std::lock_guard<std::mutex> lock(generatorMutex);
+    const_cast<MappingGenerator*>(this)->synchronizeSlots();
     return std::vector<BlockInfo>(blockWindow.begin(), blockWindow.end());
 }
 
@@ -426,9 +766,118 @@ MappingGenerator::BlockState MappingGenerator::stringToBlockState(const std::str
     return BlockState::PENDING;
 }
 
+bool MappingGenerator::loadState() {
+    std::ifstream file(config.stateFilePath, std::ios::binary);
+    if (!file.is_open()) {
+        // Progress saved before the binary format: same name with a .json extension
+        const std::string binaryExtension = ".bin";
+        const std::string& path = config.stateFilePath;
+        if (path.size() > binaryExtension.size() &&
+            path.compare(path.size() - binaryExtension.size(), binaryExtension.size(), binaryExtension) == 0) {
+            std::string legacyPath = path.substr(0, path.size() - binaryExtension.size()) + ".json";
+            if (std::ifstream(legacyPath).good()) {
+                std::wcout << L"Resuming from legacy JSON state " << legacyPath.c_str() << std::endl;
+                return loadStateFromJson(legacyPath);
+            }
+        }
+        return false;
+    }
+    
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    
+    // The format is recognized by its magic, whatever the configured one
+    if (contents.size() >= sizeof(STATE_FILE_MAGIC) && contents.compare(0, sizeof(STATE_FILE_MAGIC), STATE_FILE_MAGIC, sizeof(STATE_FILE_MAGIC)) == 0) {
+        return loadStateFromBinary(contents);
+    }
+    return loadStateFromJson(config.stateFilePath);
+}
+
+bool MappingGenerator::loadStateFromBinary(const std::string& contents) {
+    const size_t checksumSize = sizeof(uint64_t);
+    if (contents.size() < sizeof(STATE_FILE_MAGIC) + checksumSize) {
+        std::wcerr << L"State file " << config.stateFilePath.c_str() << L" is truncated" << std::endl;
+        return false;
+    }
+    
+    size_t payloadSize = contents.size() - checksumSize;
+    ByteReader checksumReader(contents);
+    checksumReader.position = payloadSize;
+    if (checksumReader.read(8) != fnv1a(contents.data(), payloadSize)) {
+        std::wcerr << L"State file " << config.stateFilePath.c_str() << L" failed its checksum" << std::endl;
+        return false;
+    }
+    
+    ByteReader reader(contents);
+    reader.position = sizeof(STATE_FILE_MAGIC);
+    uint32_t version = static_cast<uint32_t>(reader.read(4));
+    if (version != 1 && version != STATE_FORMAT_VERSION) {
+        std::wcerr << L"State file " << config.stateFilePath.c_str() << L" has unsupported version " << version << std::endl;
+        return false;
+    }
+    
+    uint64_t savedBlockSize = reader.read(8);
+    if (savedBlockSize != config.blockSize) {
+        std::wcerr << L"Warning: state file was written with block size " << savedBlockSize
+                   << L", generator uses " << config.blockSize << std::endl;
+    }
+    
+    // Block indices only mean something in the space they were handed out in
+    SearchSpace savedSpace;
+    if (version >= 2) {
+        int usedLetterCount = static_cast<int>(reader.read(1));
+        uint8_t letters[Word::ALPHABET_SIZE];
+        for (int i = 0; i < Word::ALPHABET_SIZE; ++i) {
+            letters[i] = static_cast<uint8_t>(reader.read(1));
+        }
+        if (!reader.ok || !SearchSpace::fromLetterOrder(letters, usedLetterCount, savedSpace)) {
+            std::wcerr << L"State file " << config.stateFilePath.c_str() << L" is malformed" << std::endl;
+            return false;
+        }
+    }
+    if (savedSpace != config.searchSpace) {
+        std::wcerr << L"Warning: state file " << config.stateFilePath.c_str() << L" was written for "
+                   << savedSpace.describe().c_str() << L", ignoring it" << std::endl;
+        return false;
+    }
+    
+    GeneratorState loaded;
+    loaded.nextBlockToGenerate = reader.read(8);
+    loaded.oldestTrackedBlock = reader.read(8);
+    loaded.totalBlocksGenerated = reader.read(8);
+    loaded.totalBlocksCompleted = reader.read(8);
+    loaded.isComplete = reader.read(1) != 0;
+    
+    // Records are written in window order, so no parsing pass or sort is needed
+    uint64_t windowSize = reader.read(8);
+    std::deque<BlockInfo> window;
+    for (uint64_t i = 0; i < windowSize && reader.ok; ++i) {
+        BlockInfo block;
+        block.blockIndex = reader.read(8);
+        block.state = reader.read(1) != 0 ? BlockState::COMPLETED : BlockState::PENDING;
+        block.assignedThreadId = static_cast<int32_t>(static_cast<uint32_t>(reader.read(4)));
+        block.assignedTime = secondsToTimePoint(static_cast<int64_t>(reader.read(8)));
+        block.completedTime = secondsToTimePoint(static_cast<int64_t>(reader.read(8)));
+        if (!window.empty() && window.back().blockIndex >= block.blockIndex) {
+            reader.ok = false;
+        }
+        window.push_back(block);
+    }
+    
+    if (!reader.ok || reader.position != payloadSize) {
+        std::wcerr << L"State file " << config.stateFilePath.c_str() << L" is malformed" << std::endl;
+        return false;
+    }
+    
+    state = loaded;
+    blockWindow = std::move(window);
+    std::wcout << L"[BLOCK] Loaded " << blockWindow.size() << L" blocks from state file" << std::endl;
+    return true;
+}
+
 // Simple JSON implementation for now (would normally use nlohmann/json)
-bool MappingGenerator::loadStateFromJson() {
-    std::ifstream file(config.stateFilePath);
+bool MappingGenerator::loadStateFromJson(const std::string& path) {
+    std::ifstream file(path);
     if (!file.is_open()) {
         return false;
     }
@@ -436,53 +885,144 @@ bool MappingGenerator::loadStateFromJson() {
     // Simple JSON parsing for our specific structure
     std::string line;
     bool inBlocksArray = false;
+    GeneratorState loaded;
+    std::string savedSpace = searchSpaceToString(SearchSpace::full());  // Files from before the field
     
     while (std::getline(file, line)) {
         // Remove whitespace
         line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
         
-        if (line.find("\"nextBlockToGenerate\":") != std::string::npos) {
+        if (line.find("\"searchSpace\":") != std::string::npos) {
+            size_t pos = line.find('"', line.find(':')) + 1;
+            savedSpace = line.substr(pos, line.find('"', pos) - pos);
+        }
+        else if (line.find("\"nextBlockToGenerate\":") != std::string::npos) {
             size_t pos = line.find(':') + 1;
             size_t end = line.find(',', pos);
             if (end == std::string::npos) end = line.find('}', pos);
-            state.nextBlockToGenerate = std::stoull(line.substr(pos, end - pos));
+            loaded.nextBlockToGenerate = std::stoull(line.substr(pos, end - pos));
         }
         else if (line.find("\"oldestTrackedBlock\":") != std::string::npos) {
             size_t pos = line.find(':') + 1;
             size_t end = line.find(',', pos);
             if (end == std::string::npos) end = line.find('}', pos);
-            state.oldestTrackedBlock = std::stoull(line.substr(pos, end - pos));
+            loaded.oldestTrackedBlock = std::stoull(line.substr(pos, end - pos));
         }
         else if (line.find("\"totalBlocksGenerated\":") != std::string::npos) {
             size_t pos = line.find(':') + 1;
             size_t end = line.find(',', pos);
             if (end == std::string::npos) end = line.find('}', pos);
-            state.totalBlocksGenerated = std::stoull(line.substr(pos, end - pos));
+            loaded.totalBlocksGenerated = std::stoull(line.substr(pos, end - pos));
         }
         else if (line.find("\"totalBlocksCompleted\":") != std::string::npos) {
             size_t pos = line.find(':') + 1;
             size_t end = line.find(',', pos);
             if (end == std::string::npos) end = line.find('}', pos);
-            state.totalBlocksCompleted = std::stoull(line.substr(pos, end - pos));
+            loaded.totalBlocksCompleted = std::stoull(line.substr(pos, end - pos));
         }
         else if (line.find("\"isComplete\":") != std::string::npos) {
-            state.isComplete = line.find("true") != std::string::npos;
+            loaded.isComplete = line.find("true") != std::string::npos;
         }
     }
     
     file.close();
     
+    // Block indices only mean something in the space they were handed out in
+    if (savedSpace != searchSpaceToString(config.searchSpace)) {
+        std::wcerr << L"Warning: state file " << path.c_str() << L" was written for search space \""
+                   << savedSpace.c_str() << L"\", ignoring it" << std::endl;
+        return false;
+    }
+    state = loaded;
+    
     // Parse and restore block window from JSON
-    loadBlockWindowFromJson();
+    loadBlockWindowFromJson(path);
     
     return true;
 }
 
-bool MappingGenerator::saveStateToJson() const {
-    std::ofstream file(config.stateFilePath);
-    if (!file.is_open()) {
+std::string MappingGenerator::serializeStateBinary() const {
+    const size_t recordSize = 8 + 1 + 4 + 8 + 8;
+    std::string buffer;
+    buffer.reserve(64 + blockWindow.size() * recordSize);
+    
+    buffer.append(STATE_FILE_MAGIC, sizeof(STATE_FILE_MAGIC));
+    appendInteger(buffer, STATE_FORMAT_VERSION, 4);
+    appendInteger(buffer, config.blockSize, 8);
+    appendInteger(buffer, config.searchSpace.getUsedLetterCount(), 1);
+    buffer.append(reinterpret_cast<const char*>(config.searchSpace.getLetterOrder()), Word::ALPHABET_SIZE);
+    appendInteger(buffer, state.nextBlockToGenerate, 8);
+    appendInteger(buffer, state.oldestTrackedBlock, 8);
+    appendInteger(buffer, state.totalBlocksGenerated, 8);
+    appendInteger(buffer, state.totalBlocksCompleted, 8);
+    appendInteger(buffer, state.isComplete ? 1 : 0, 1);
+    
+    appendInteger(buffer, blockWindow.size(), 8);
+    for (const auto& block : blockWindow) {
+        appendInteger(buffer, block.blockIndex, 8);
+        appendInteger(buffer, block.state == BlockState::COMPLETED ? 1 : 0, 1);
+        appendInteger(buffer, static_cast<uint32_t>(block.assignedThreadId), 4);
+        appendInteger(buffer, static_cast<uint64_t>(timePointToSeconds(block.assignedTime)), 8);
+        appendInteger(buffer, static_cast<uint64_t>(timePointToSeconds(block.completedTime)), 8);
+    }
+    
+    appendInteger(buffer, fnv1a(buffer.data(), buffer.size()), 8);
+    return buffer;
+}
+
+bool MappingGenerator::checkpointState() {
+    std::lock_guard<std::mutex> fileLock(stateFileMutex);
+    
+    // Only the in-memory snapshot is taken under generatorMutex; the disk write is not
+    std::string contents;
+    {
+        std::lock_guard<std::mutex> lock(generatorMutex);
+        synchronizeSlots();
+        contents = (config.stateFormat == StateFileFormat::JSON) ? serializeStateJson() : serializeStateBinary();
+    }
+    if (!writeStateFile(contents)) {
+        return false;
+    }
+    
+    if (checkpointListener) {
+        checkpointListener();
+    }
+    return true;
+}
+
+void MappingGenerator::setCheckpointListener(std::function<void()> listener) {
+    std::lock_guard<std::mutex> fileLock(stateFileMutex);
+    checkpointListener = std::move(listener);
+}
+
+bool MappingGenerator::writeStateFile(const std::string& contents) const {
+    // Write the complete checkpoint beside the state file, then swap it in with one rename
+    std::string tempPath = config.stateFilePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.flush();
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(tempPath, config.stateFilePath, error);
+    if (error) {
+        std::remove(tempPath.c_str());
         return false;
     }
+    return true;
+}
+
+std::string MappingGenerator::serializeStateJson() const {
+    std::ostringstream file;
     
     // Write JSON manually (would normally use nlohmann/json)
     file << "{\n";
@@ -508,12 +1048,12 @@ bool MappingGenerator::saveStateToJson() const {
     file << "  ],\n";
     
     file << "  \"config\": {\n";
-    file << "    \"blockSize\": " << config.blockSize << "\n";
+    file << "    \"blockSize\": " << config.blockSize << ",\n";
+    file << "    \"searchSpace\": \"" << searchSpaceToString(config.searchSpace) << "\"\n";
     file << "  }\n";
     file << "}\n";
     
-    file.close();
-    return true;
+    return file.str();
 }
 
 void MappingGenerator::loadPendingBlocksFromState() {
@@ -523,22 +1063,20 @@ void MappingGenerator::loadPendingBlocksFromState() {
             // Reset the assignment but keep it as pending
             block.assignedThreadId = -1;
             block.assignedTime = std::chrono::system_clock::time_point{};
-            std::wcout << L"[BLOCK] Reset pending block " << block.blockIndex << L" for reassignment" << std::endl;
+            if (config.logBlockEvents) {
+                std::wcout << L"[BLOCK] Reset pending block " << block.blockIndex << L" for reassignment" << std::endl;
+            }
         }
     }
-    
-    // Clear thread mappings since we're resetting pending blocks
-    threadToBlock.clear();
 }
 
-void MappingGenerator::loadBlockWindowFromJson() {
-    std::ifstream file(config.stateFilePath);
+void MappingGenerator::loadBlockWindowFromJson(const std::string& path) {
+    std::ifstream file(path);
     if (!file.is_open()) {
         return;
     }
     
     blockWindow.clear();
-    threadToBlock.clear();
     
     // Simple JSON parsing for block window
     std::string line;
@@ -605,6 +1143,10 @@ void MappingGenerator::loadBlockWindowFromJson() {
     
     file.close();
     
+    // Lookups binary-search the window, so keep it ordered even for hand-edited files
+    std::sort(blockWindow.begin(), blockWindow.end(),
+              [](const BlockInfo& a, const BlockInfo& b) { return a.blockIndex < b.blockIndex; });
+    
     std::wcout << L"[BLOCK] Loaded " << blockWindow.size() << L" blocks from state file" << std::endl;
 }
 
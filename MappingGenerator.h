@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Mapping.h"
+#include "PermutationTranslator.h"
+#include "SearchSpace.h"
+#include "BlockSource.h"
 #include <vector>
 #include <memory>
 #include <mutex>
@@ -11,6 +14,9 @@
 #include <unordered_map>
 #include <deque>
 #include <chrono>
+#include <thread>
+#include <condition_variable>
+#include <functional>
 
 // Forward declaration for JSON support
 namespace nlohmann { class json; }
@@ -18,7 +24,7 @@ namespace nlohmann { class json; }
 // Forward declaration for friend class
 class VoynichDecoder;
 
-class MappingGenerator {
+class MappingGenerator : public BlockSource {
     friend class VoynichDecoder;
 public:
     // Block states for tracking
@@ -53,28 +59,90 @@ public:
                           totalBlocksGenerated(0), totalBlocksCompleted(0), isComplete(false) {}
     };
     
+    // On-disk format of the state file. Either is read back regardless of this setting.
+    enum class StateFileFormat {
+        BINARY,     // Versioned, checksummed records (default)
+        JSON        // Human-readable, for inspection and hand edits
+    };
+    
     // Configuration for the generator
     struct GeneratorConfig {
         size_t blockSize;              // Number of mappings per block (default: 1,000,000)
-        std::string stateFilePath;     // Path to JSON state file
+        std::string stateFilePath;     // Path to the state file
         bool enableStateFile;          // Whether to use persistent state
+        int checkpointIntervalMs;      // Background state checkpoint period (state file only)
+        bool logBlockEvents;           // Print per-block allocation/completion messages
+        StateFileFormat stateFormat;   // Format written by checkpoints
+        SearchSpace searchSpace;       // Permutations enumerated (default: the full 27! space)
         
-        GeneratorConfig() : blockSize(1000000), stateFilePath("mapping_generator_state.json"), 
-                           enableStateFile(true) {}
+        GeneratorConfig() : blockSize(1000000), stateFilePath("mapping_generator_state.bin"), 
+                           enableStateFile(true), checkpointIntervalMs(5000), logBlockEvents(false),
+                           stateFormat(StateFileFormat::BINARY) {}
     };
+    
+    // Binary state file layout, version 2 (all integers little-endian):
+    //   "VDGS" | u32 version | u64 blockSize | u8 usedLetterCount | 27 x u8 search space letter
+    //   order | u64 nextBlockToGenerate | u64 oldestTrackedBlock |
+    //   u64 totalBlocksGenerated | u64 totalBlocksCompleted | u8 isComplete | u64 windowSize |
+    //   windowSize x (u64 blockIndex | u8 state | i32 assignedThreadId | i64 assignedTime |
+    //   i64 completedTime) | u64 FNV-1a checksum of all preceding bytes
+    // Version 1 files have no search space fields and are read as the full space.
+    static constexpr uint32_t STATE_FORMAT_VERSION = 2;
+
+    // Largest supported thread id + 1 (one completion slot per worker thread)
+    static constexpr int MAX_THREAD_SLOTS = 1024;
 
 private:
-    mutable std::mutex generatorMutex; // Protects all generator operations
+    // Claim/completion record owned by a single worker thread. Only the owning thread and the
+    // synchronizer touch it, so its mutex is practically uncontended.
+    struct alignas(64) ThreadSlot {
+        struct Event {
+            uint64_t blockIndex;
+            bool inWindow;     // Block is already tracked in blockWindow (reassigned pending block)
+            std::chrono::system_clock::time_point assignedTime;
+            std::chrono::system_clock::time_point completedTime;
+        };
+        
+        std::mutex slotMutex;
+        bool hasActiveBlock;
+        bool activeSynchronized;   // Active block has been merged into blockWindow
+        Event active;
+        std::vector<Event> shared;     // Open shared claims (inWindow set once merged)
+        std::vector<Event> completed;  // Completions not yet merged into blockWindow
+        
+        ThreadSlot() : hasActiveBlock(false), activeSynchronized(false), active() {}
+    };
     
-    GeneratorState state;              // Current generator state
+    mutable std::mutex generatorMutex; // Protects blockWindow and state
+    mutable std::mutex stateFileMutex; // Orders checkpoints; taken before generatorMutex, held during file I/O
+    std::function<void()> checkpointListener;  // Guarded by stateFileMutex
+    
+    GeneratorState state;              // Snapshot of the generator state (refreshed by synchronizeSlots)
     GeneratorConfig config;            // Generator configuration
     
     // Dynamic window of block tracking (ordered by block index)
     std::deque<BlockInfo> blockWindow;    // Blocks in memory for tracking
-    std::unordered_map<int, uint64_t> threadToBlock;  // threadId -> current block index
     
-    // Total possible combinations (27! permutations)
-    static constexpr uint64_t TOTAL_COMBINATIONS = 10888869450418352160ULL; // 27!
+    // Lock-free claim path: blocks are handed out from an atomic counter and recorded in
+    // per-thread slots; the window and state file are brought up to date lazily.
+    std::atomic<uint64_t> nextBlockCounter;        // Next never-issued block index
+    std::atomic<uint64_t> completedBlockCounter;   // Total blocks completed
+    std::atomic<uint64_t> unassignedPendingBlocks; // PENDING window blocks without a thread (resumed state)
+    std::atomic<bool> blocksExhausted;             // A claim ran past the last block
+    std::atomic<bool> stateDirty;                  // Changes since the last checkpoint
+    std::atomic<ThreadSlot*> threadSlots[MAX_THREAD_SLOTS];
+    std::atomic<int> threadSlotCount;              // Highest allocated slot + 1
+    uint64_t generatedBlocksBase;                  // totalBlocksGenerated when the counter was last rebased
+    uint64_t nextBlockBase;                        // nextBlockCounter value at the same point
+    
+    // Background checkpointer (only when the state file is enabled)
+    std::thread checkpointThread;
+    std::mutex checkpointMutex;
+    std::condition_variable checkpointCondition;
+    bool stopCheckpointer;
+    
+    // Total possible combinations of the full space (27! permutations)
+    static constexpr uint64_t TOTAL_COMBINATIONS = SearchSpace::FULL_INDEX_COUNT; // 27!
     
     // Internal mapping generation
     std::vector<std::unique_ptr<Mapping>> generateBlock(uint64_t blockIndex);
@@ -83,33 +151,114 @@ private:
     // Combinatorial mathematics
     std::vector<int> indexToPermutation(uint64_t index) const;
     uint64_t factorial(int n) const;
+    uint64_t totalBlockCount() const;
+    
+    // Block assignment shared by getNextBlock, claimBlockRange and claimSharedBlock (UINT64_MAX
+    // if none left). Does not take generatorMutex unless a resumed pending block is waiting for
+    // reassignment. Shared claims are kept open beside the active block instead of replacing it.
+    uint64_t assignBlockToThread(int threadId, bool shared = false);
+    uint64_t reassignPendingBlock(int threadId, bool shared);
+    void recordClaim(ThreadSlot& slot, const ThreadSlot::Event& event, bool shared);  // Caller holds slot.slotMutex
+    
+    // Per-thread slots
+    ThreadSlot& slotForThread(int threadId);
+    ThreadSlot* findSlot(int threadId) const;
+    void completeActiveBlock(ThreadSlot& slot);   // Caller holds slot.slotMutex
+    
+    // Merge per-thread claims and completions into blockWindow and state (generatorMutex held)
+    void synchronizeSlots();
+    void resetCounters();
+    
+    // Background checkpointing
+    void checkpointLoop();
+    void stopCheckpointThread();
     
-    // JSON state management
-    bool loadStateFromJson();
-    bool saveStateToJson() const;
+    // State file management. A checkpoint serializes the merged state into memory under
+    // generatorMutex and writes it outside that lock, to a temporary file that is then renamed
+    // over the state file, so a crash mid-write leaves the previous checkpoint intact.
+    bool loadState();
+    bool loadStateFromBinary(const std::string& contents);
+    bool loadStateFromJson(const std::string& path);
+    std::string serializeStateBinary() const;
+    std::string serializeStateJson() const;
+    bool writeStateFile(const std::string& contents) const;
+    bool checkpointState();
     std::string blockStateToString(BlockState state) const;
     BlockState stringToBlockState(const std::string& str) const;
     
     // Enhanced block management
     BlockInfo* findBlockInWindow(uint64_t blockIndex);
-    uint64_t createNewBlockForThread(int threadId);
-    void cleanupCompletedBlocks();
-    void completeBlockForThread(int threadId);
+    void insertBlockIntoWindow(const BlockInfo& block);
     void completeCurrentBlock(int threadId);  // Friend access only
     
     // Dynamic window management
-    void addBlockToWindow(uint64_t blockIndex, int threadId);
     void removeCompletedSequentialBlocks();
     void loadPendingBlocksFromState();
-    void loadBlockWindowFromJson();
+    void loadBlockWindowFromJson(const std::string& path);
 
 public:
     explicit MappingGenerator(const GeneratorConfig& config = GeneratorConfig());
     ~MappingGenerator();
     
+    // Lazily yields the permutations of one claimed block, in generator index order.
+    // Holds a single permutation, so walking a block needs constant memory.
+    class BlockCursor {
+    public:
+        BlockCursor() : space(&SearchSpace::full()), firstIndex(0), lastIndex(0), nextIndex(0), stepsToPrefixChange(0), started(false) {}
+        BlockCursor(uint64_t startIndex, uint64_t endIndex, const SearchSpace& space = SearchSpace::full());
+        
+        // Produce the next permutation and its global index; false when the block is exhausted
+        bool next(Permutation& permutation, uint64_t& globalIndex);
+        
+        bool empty() const { return firstIndex >= lastIndex; }
+        uint64_t size() const { return lastIndex - firstIndex; }
+        uint64_t remaining() const { return lastIndex - nextIndex; }
+        uint64_t startIndex() const { return firstIndex; }
+        uint64_t endIndex() const { return lastIndex; }
+        
+    private:
+        const SearchSpace* space;      // Must outlive the cursor
+        uint64_t firstIndex;
+        uint64_t lastIndex;
+        uint64_t nextIndex;
+        uint64_t stepsToPrefixChange;
+        bool started;
+        Permutation current;
+    };
+    
     // Get next block for a thread (thread-safe) - returns full block
     std::vector<std::unique_ptr<Mapping>> getNextBlock(int threadId);
     
+    // Get next block for a thread as a lazy cursor (thread-safe); empty cursor when done
+    BlockCursor getNextBlockCursor(int threadId);
+    
+    // Claim the next block as a global index range [startIndex, endIndex) without building
+    // mappings (thread-safe). Same block accounting as getNextBlock; returns false when done.
+    bool claimBlockRange(int threadId, uint64_t& startIndex, uint64_t& endIndex);
+    
+    // Claim a block whose range may be split across threads (thread-safe). Unlike the claims
+    // above it does not complete the thread's previous block and stays PENDING until
+    // completeSharedBlock is called with the claiming thread id, so a thread can hold several.
+    bool claimSharedBlock(int threadId, uint64_t& blockIndex, uint64_t& startIndex, uint64_t& endIndex) override;
+    void completeSharedBlock(int claimingThreadId, uint64_t blockIndex) override;
+    
+    // Give an open shared claim back without completing it (e.g. its cluster lease expired).
+    // The block stays PENDING, unassigned, and is handed to the next claim of any thread.
+    // Returns false if the thread holds no such claim.
+    bool releaseSharedBlock(int claimingThreadId, uint64_t blockIndex);
+    
+    // Allocation-free index -> permutation conversion of the full space (SearchSpace::full).
+    // Uses the same 64-bit factorials as the original implementation, so indices map to
+    // exactly the same mappings (only the last TAIL_LENGTH positions vary lexicographically).
+    static void unrankPermutation(uint64_t index, Permutation& permutation);
+    
+    // Number of consecutive indices starting at index whose permutations share the leading
+    // (non-lexicographic) positions; within that run each step is a lexicographic next
+    // permutation of the tail.
+    static uint64_t stepsUntilPrefixChange(uint64_t index);
+    
+    static constexpr int TAIL_LENGTH = SearchSpace::FULL_TAIL_LENGTH;   // Positions unranked with exact (non-overflowing) factorials
+    
     
     // Check if generation is complete
     bool isGenerationComplete() const;
@@ -117,9 +266,13 @@ public:
     // Get current statistics
     GeneratorState getCurrentState() const;
     
-    // Get total possible combinations
+    // Get total possible combinations of the full space
     static uint64_t getTotalCombinations() { return TOTAL_COMBINATIONS; }
     
+    // Indices this generator hands out (the size of its search space)
+    uint64_t getCombinationCount() const { return config.searchSpace.getSize(); }
+    const SearchSpace& getSearchSpace() const { return config.searchSpace; }
+    
     // Get progress percentage
     double getProgressPercentage() const;
     
@@ -129,6 +282,11 @@ public:
     // Force save current state to file
     bool saveCurrentState() const;
     
+    // Run after every successful checkpoint write, on the checkpointing thread, so data kept
+    // beside the state file (such as the best results so far) is saved at the same moments.
+    // Pass nullptr to detach before the listener's owner goes away.
+    void setCheckpointListener(std::function<void()> listener);
+    
     // Get estimated remaining mappings
     uint64_t getRemainingMappings() const;
     
@@ -0,0 +1,302 @@
+#include "MetricsExporter.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <ctime>
+
+namespace {
+    const int ACCEPT_TIMEOUT_MS = 200;       // How often the HTTP loop checks for stop()
+    const int REQUEST_TIMEOUT_MS = 2000;     // Longest wait for a request's header lines
+    
+    std::string formatNumber(double value) {
+        std::ostringstream out;
+        out << std::setprecision(10) << value;
+        return out.str();
+    }
+    
+    std::string escapeJson(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped.push_back('\\');
+            }
+            if (static_cast<unsigned char>(c) >= 0x20) {
+                escaped.push_back(c);
+            }
+        }
+        return escaped;
+    }
+    
+    double hitRate(const MetricsExporter::Metrics& metrics) {
+        return metrics.lexiconProbes > 0 ? static_cast<double>(metrics.lexiconHits) / metrics.lexiconProbes : 0.0;
+    }
+    
+    // Prometheus metric with its HELP and TYPE lines
+    void appendMetric(std::ostringstream& out, const std::string& name, const char* type, const char* help,
+                      const std::string& value) {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " " << type << "\n";
+        out << name << " " << value << "\n";
+    }
+}
+
+MetricsExporter::MetricsExporter(const ExporterConfig& config, Collector collector)
+    : config(config), collector(std::move(collector)), stopping(false),
+      hasPreviousSample(false), previousGpuKernelMs(0.0) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    if (exporterThread.joinable() || config.mode == Mode::DISABLED) {
+        return exporterThread.joinable();
+    }
+    
+    if (config.mode == Mode::JSON_LINES) {
+        file.open(config.filePath, std::ios::app);
+        if (!file.is_open()) {
+            std::wcerr << L"Metrics: cannot open " << config.filePath.c_str() << std::endl;
+            return false;
+        }
+    } else if (!listener.listen(config.port)) {
+        std::wcerr << L"Metrics: cannot listen on port " << config.port << std::endl;
+        return false;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = false;
+    }
+    if (config.mode == Mode::JSON_LINES) {
+        exporterThread = std::thread(&MetricsExporter::runJsonLines, this);
+        std::wcout << L"Metrics: appending JSON lines to " << config.filePath.c_str()
+                   << L" every " << config.intervalMs << L" ms" << std::endl;
+    } else {
+        exporterThread = std::thread(&MetricsExporter::runHttp, this);
+        std::wcout << L"Metrics: serving http://0.0.0.0:" << listener.getPort() << L"/metrics" << std::endl;
+    }
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!exporterThread.joinable()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopCondition.notify_all();
+    exporterThread.join();
+    
+    listener.close();
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+MetricsExporter::Metrics MetricsExporter::collect() {
+    Metrics metrics = collector();
+    
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    auto now = std::chrono::steady_clock::now();
+    double wallMs = hasPreviousSample ? std::chrono::duration<double, std::milli>(now - previousSampleTime).count()
+                                      : metrics.uptimeSeconds * 1000.0;
+    double kernelMs = metrics.gpuKernelMs - (hasPreviousSample ? previousGpuKernelMs : 0.0);
+    if (metrics.gpuDevices > 0 && wallMs > 0.0) {
+        // Chunks of one worker's streams overlap, so the ratio is capped at a fully busy device
+        metrics.gpuUtilization = std::min(1.0, std::max(0.0, kernelMs / (wallMs * metrics.gpuDevices)));
+    }
+    
+    hasPreviousSample = true;
+    previousSampleTime = now;
+    previousGpuKernelMs = metrics.gpuKernelMs;
+    return metrics;
+}
+
+void MetricsExporter::runJsonLines() {
+    std::unique_lock<std::mutex> lock(stopMutex);
+    bool last = false;
+    while (!last) {
+        last = stopCondition.wait_for(lock, std::chrono::milliseconds(config.intervalMs), [this] { return stopping; });
+        
+        lock.unlock();
+        file << toJsonLine(collect()) << "\n";
+        file.flush();
+        lock.lock();
+    }
+}
+
+void MetricsExporter::runHttp() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            if (stopping) {
+                return;
+            }
+        }
+        
+        auto connection = listener.accept(ACCEPT_TIMEOUT_MS);
+        if (connection) {
+            serveRequest(*connection);
+        }
+    }
+}
+
+void MetricsExporter::serveRequest(TcpConnection& connection) {
+    // Request line, then header lines up to the blank line (the body of a GET is empty)
+    std::string requestLine;
+    if (!connection.receiveLine(requestLine, REQUEST_TIMEOUT_MS)) {
+        return;
+    }
+    std::string header;
+    do {
+        if (!connection.receiveLine(header, REQUEST_TIMEOUT_MS)) {
+            return;
+        }
+    } while (!header.empty());
+    
+    auto tokens = splitMessage(requestLine);
+    std::string path = tokens.size() > 1 ? tokens[1] : "";
+    bool found = tokens.size() > 1 && tokens[0] == "GET" && (path == "/metrics" || path == "/");
+    
+    std::string body = found ? toPrometheusText(collect()) : "Not found\n";
+    std::ostringstream response;
+    response << (found ? "HTTP/1.1 200 OK" : "HTTP/1.1 404 Not Found") << "\r\n"
+             << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    connection.sendRaw(response.str());
+    connection.close();
+}
+
+std::string MetricsExporter::toJsonLine(const Metrics& metrics) {
+    std::ostringstream out;
+    out << "{\"time\":" << static_cast<long long>(std::time(nullptr))
+        << ",\"node\":\"" << escapeJson(metrics.nodeName) << "\""
+        << ",\"uptime_s\":" << formatNumber(metrics.uptimeSeconds)
+        << ",\"mappings_processed\":" << metrics.mappingsProcessed
+        << ",\"mappings_per_second\":" << formatNumber(metrics.mappingsPerSecond)
+        << ",\"words_validated\":" << metrics.wordsValidated
+        << ",\"highest_score\":" << formatNumber(metrics.highestScore)
+        << ",\"high_scores\":" << metrics.highScoreCount
+        << ",\"active_threads\":" << metrics.activeThreads;
+    
+    out << ",\"lexicon\":{\"probes\":" << metrics.lexiconProbes << ",\"hits\":" << metrics.lexiconHits
+        << ",\"hit_rate\":" << formatNumber(hitRate(metrics)) << "}";
+    
+    out << ",\"piece_latency_ms\":{\"bounds\":[";
+    for (size_t i = 0; i + 1 < StatsProvider::PIECE_LATENCY_BUCKET_COUNT; ++i) {
+        out << (i > 0 ? "," : "") << formatNumber(StatsProvider::PIECE_LATENCY_BOUNDS_MS[i]);
+    }
+    out << "],\"counts\":[";
+    for (size_t i = 0; i < metrics.pieceLatencyCounts.size(); ++i) {
+        out << (i > 0 ? "," : "") << metrics.pieceLatencyCounts[i];
+    }
+    out << "],\"count\":" << metrics.piecesCompleted << ",\"sum\":" << formatNumber(metrics.pieceLatencySumMs) << "}";
+    
+    if (metrics.hasGenerator) {
+        out << ",\"generator\":{\"window_size\":" << metrics.generatorWindowSize
+            << ",\"pending_blocks\":" << metrics.pendingBlocks
+            << ",\"completed_blocks\":" << metrics.completedBlocks
+            << ",\"next_block\":" << metrics.nextBlockToGenerate << "}";
+    } else {
+        out << ",\"generator\":null";
+    }
+    
+    out << ",\"gpu\":{\"devices\":" << metrics.gpuDevices
+        << ",\"chunks\":" << metrics.gpuChunksScored
+        << ",\"kernel_ms\":" << formatNumber(metrics.gpuKernelMs)
+        << ",\"transfer_ms\":" << formatNumber(metrics.gpuTransferMs)
+        << ",\"utilization\":" << formatNumber(metrics.gpuUtilization) << "}";
+    
+    out << ",\"threads\":[";
+    for (size_t i = 0; i < metrics.threads.size(); ++i) {
+        const auto& thread = metrics.threads[i];
+        out << (i > 0 ? "," : "") << "{\"id\":" << thread.threadId
+            << ",\"mappings_processed\":" << thread.mappingsProcessed
+            << ",\"mappings_per_second\":" << formatNumber(thread.mappingsPerSecond)
+            << ",\"pieces\":" << thread.piecesCompleted
+            << ",\"avg_piece_ms\":" << formatNumber(thread.averagePieceMs)
+            << ",\"highest_score\":" << formatNumber(thread.highestScore) << "}";
+    }
+    out << "]}";
+    return out.str();
+}
+
+std::string MetricsExporter::toPrometheusText(const Metrics& metrics) {
+    std::ostringstream out;
+    appendMetric(out, "voynich_uptime_seconds", "gauge", "Time since the stats provider started.",
+                 formatNumber(metrics.uptimeSeconds));
+    appendMetric(out, "voynich_mappings_processed_total", "counter", "Mappings scored by all workers.",
+                 std::to_string(metrics.mappingsProcessed));
+    appendMetric(out, "voynich_mappings_per_second", "gauge", "Scoring rate over the last sampling interval.",
+                 formatNumber(metrics.mappingsPerSecond));
+    appendMetric(out, "voynich_words_validated_total", "counter", "Translated words checked against the lexicon.",
+                 std::to_string(metrics.wordsValidated));
+    appendMetric(out, "voynich_highest_score", "gauge", "Best mapping score so far.",
+                 formatNumber(metrics.highestScore));
+    appendMetric(out, "voynich_high_scores_total", "counter", "Mappings at or above the score threshold.",
+                 std::to_string(metrics.highScoreCount));
+    appendMetric(out, "voynich_active_threads", "gauge", "Worker threads currently running.",
+                 std::to_string(metrics.activeThreads));
+    
+    out << "# HELP voynich_thread_mappings_processed_total Mappings scored per worker thread.\n"
+        << "# TYPE voynich_thread_mappings_processed_total counter\n";
+    for (const auto& thread : metrics.threads) {
+        out << "voynich_thread_mappings_processed_total{thread=\"" << thread.threadId << "\"} " << thread.mappingsProcessed << "\n";
+    }
+    out << "# HELP voynich_thread_mappings_per_second Scoring rate per worker thread over the last sampling interval.\n"
+        << "# TYPE voynich_thread_mappings_per_second gauge\n";
+    for (const auto& thread : metrics.threads) {
+        out << "voynich_thread_mappings_per_second{thread=\"" << thread.threadId << "\"} " << formatNumber(thread.mappingsPerSecond) << "\n";
+    }
+    
+    appendMetric(out, "voynich_lexicon_probes_total", "counter", "Lexicon lookups of translated words.",
+                 std::to_string(metrics.lexiconProbes));
+    appendMetric(out, "voynich_lexicon_hits_total", "counter", "Lexicon lookups that found a Hebrew word.",
+                 std::to_string(metrics.lexiconHits));
+    appendMetric(out, "voynich_lexicon_hit_ratio", "gauge", "Share of lexicon lookups that found a word.",
+                 formatNumber(hitRate(metrics)));
+    
+    // Histogram buckets are cumulative in the exposition format
+    out << "# HELP voynich_piece_duration_seconds Wall time of the work-stealing scheduler's pieces.\n"
+        << "# TYPE voynich_piece_duration_seconds histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < metrics.pieceLatencyCounts.size(); ++i) {
+        cumulative += metrics.pieceLatencyCounts[i];
+        std::string bound = i + 1 < metrics.pieceLatencyCounts.size()
+            ? formatNumber(StatsProvider::PIECE_LATENCY_BOUNDS_MS[i] / 1000.0) : "+Inf";
+        out << "voynich_piece_duration_seconds_bucket{le=\"" << bound << "\"} " << cumulative << "\n";
+    }
+    out << "voynich_piece_duration_seconds_sum " << formatNumber(metrics.pieceLatencySumMs / 1000.0) << "\n";
+    out << "voynich_piece_duration_seconds_count " << metrics.piecesCompleted << "\n";
+    
+    if (metrics.hasGenerator) {
+        appendMetric(out, "voynich_generator_window_size", "gauge", "Blocks tracked in the generator window.",
+                     std::to_string(metrics.generatorWindowSize));
+        appendMetric(out, "voynich_generator_pending_blocks", "gauge", "Generator blocks handed out and not yet completed.",
+                     std::to_string(metrics.pendingBlocks));
+        appendMetric(out, "voynich_generator_completed_blocks", "gauge", "Completed blocks still tracked in the window.",
+                     std::to_string(metrics.completedBlocks));
+        appendMetric(out, "voynich_generator_next_block", "gauge", "Index of the next block to generate.",
+                     std::to_string(metrics.nextBlockToGenerate));
+    }
+    
+    appendMetric(out, "voynich_gpu_devices", "gauge", "CUDA devices visible to this process.",
+                 std::to_string(metrics.gpuDevices));
+    appendMetric(out, "voynich_gpu_chunks_total", "counter", "Fused scoring chunks completed on the GPU.",
+                 std::to_string(metrics.gpuChunksScored));
+    appendMetric(out, "voynich_gpu_kernel_seconds_total", "counter", "Device time of the scoring kernels.",
+                 formatNumber(metrics.gpuKernelMs / 1000.0));
+    appendMetric(out, "voynich_gpu_transfer_seconds_total", "counter", "Device time of the result downloads.",
+                 formatNumber(metrics.gpuTransferMs / 1000.0));
+    appendMetric(out, "voynich_gpu_utilization_ratio", "gauge", "Kernel time per device since the previous sample.",
+                 formatNumber(metrics.gpuUtilization));
+    return out.str();
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "StatsProvider.h"
+#include "NetworkConnection.h"
+#include <string>
+#include <vector>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+
+// Machine-readable counterpart of the StatsProvider status lines. A collector callback (see
+// ThreadManager::collectMetrics) gathers a Metrics sample, which is either appended to a
+// JSON-lines file on a fixed interval or served in the Prometheus text format to whoever
+// requests GET /metrics. Collection only reads counters published by the workers, so neither
+// mode slows down scoring.
+class MetricsExporter {
+public:
+    enum class Mode {
+        DISABLED,
+        JSON_LINES,   // One JSON object per line, appended every intervalMs
+        HTTP          // Prometheus text exposition on http://<host>:<port>/metrics
+    };
+    
+    struct ExporterConfig {
+        Mode mode;
+        std::string filePath;        // JSON_LINES output
+        uint16_t port;               // HTTP listen port (0 picks a free one, see getPort)
+        size_t intervalMs;           // JSON_LINES sampling interval
+        
+        ExporterConfig() : mode(Mode::DISABLED), filePath("voynich_metrics.jsonl"), port(9464), intervalMs(10000) {}
+    };
+    
+    struct ThreadMetrics {
+        int threadId;
+        uint64_t mappingsProcessed;
+        double mappingsPerSecond;    // Over the stats provider's last sampling interval
+        uint64_t piecesCompleted;
+        double averagePieceMs;
+        double highestScore;
+    };
+    
+    struct Metrics {
+        std::string nodeName;
+        double uptimeSeconds;
+        uint64_t mappingsProcessed;
+        double mappingsPerSecond;
+        uint64_t wordsValidated;
+        double highestScore;
+        uint64_t highScoreCount;
+        size_t activeThreads;
+        std::vector<ThreadMetrics> threads;
+        
+        // Lexicon lookups of translated words and how many found a Hebrew word
+        uint64_t lexiconProbes;
+        uint64_t lexiconHits;
+        
+        // Piece (scheduler work item) wall times, StatsProvider::PIECE_LATENCY_BOUNDS_MS buckets
+        std::array<uint64_t, StatsProvider::PIECE_LATENCY_BUCKET_COUNT> pieceLatencyCounts;
+        uint64_t piecesCompleted;
+        double pieceLatencySumMs;
+        
+        // MappingGenerator::getBlockStatus (standalone runs only)
+        bool hasGenerator;
+        size_t generatorWindowSize;
+        size_t pendingBlocks;
+        size_t completedBlocks;
+        uint64_t nextBlockToGenerate;
+        
+        // CUDA path: device time of the fused scoring chunks of every GPU worker
+        int gpuDevices;
+        uint64_t gpuChunksScored;
+        double gpuKernelMs;
+        double gpuTransferMs;
+        double gpuUtilization;       // Kernel time per device and wall time since the previous sample (set by collect)
+        
+        Metrics() : uptimeSeconds(0.0), mappingsProcessed(0), mappingsPerSecond(0.0), wordsValidated(0),
+                    highestScore(0.0), highScoreCount(0), activeThreads(0), lexiconProbes(0), lexiconHits(0),
+                    pieceLatencyCounts{}, piecesCompleted(0), pieceLatencySumMs(0.0), hasGenerator(false),
+                    generatorWindowSize(0), pendingBlocks(0), completedBlocks(0), nextBlockToGenerate(0),
+                    gpuDevices(0), gpuChunksScored(0), gpuKernelMs(0.0), gpuTransferMs(0.0), gpuUtilization(0.0) {}
+    };
+    
+    using Collector = std::function<Metrics()>;
+
+private:
+    ExporterConfig config;
+    Collector collector;
+    
+    std::thread exporterThread;
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool stopping;
+    
+    TcpListener listener;
+    std::ofstream file;
+    
+    // Previous sample, for rates between samples (collect may run on any thread)
+    std::mutex sampleMutex;
+    bool hasPreviousSample;
+    std::chrono::steady_clock::time_point previousSampleTime;
+    double previousGpuKernelMs;
+    
+    void runJsonLines();
+    void runHttp();
+    void serveRequest(TcpConnection& connection);
+
+public:
+    MetricsExporter(const ExporterConfig& config, Collector collector);
+    ~MetricsExporter();
+    
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    
+    // Open the file or the listening socket and start the exporter thread; false if that failed
+    bool start();
+    
+    // Stop the thread (JSON_LINES writes one last sample first)
+    void stop();
+    
+    // Current sample with the rates derived from the previous one
+    Metrics collect();
+    
+    uint16_t getPort() const { return listener.getPort(); }
+    
+    static std::string toJsonLine(const Metrics& metrics);
+    static std::string toPrometheusText(const Metrics& metrics);
+};
@@ -0,0 +1,286 @@
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
+
+#include "NetworkConnection.h"
+#include <sstream>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+    const NativeSocket NATIVE_INVALID = INVALID_SOCKET;
+    
+    void closeNative(NativeSocket s) { closesocket(s); }
+    
+    // Winsock must be started once per process before any socket call
+    bool ensureNetworkStarted() {
+        static const bool started = []() {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return started;
+    }
+    
+    const int SEND_FLAGS = 0;
+    const int SHUTDOWN_BOTH = SD_BOTH;
+#else
+    using NativeSocket = int;
+    const NativeSocket NATIVE_INVALID = -1;
+    
+    void closeNative(NativeSocket s) { ::close(s); }
+    bool ensureNetworkStarted() { return true; }
+    
+    // A peer that went away must surface as a send error, not SIGPIPE
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    const int SEND_FLAGS = 0;
+#endif
+    const int SHUTDOWN_BOTH = SHUT_RDWR;
+#endif
+
+    NativeSocket toNative(TcpConnection::SocketHandle handle) {
+        return handle == TcpConnection::INVALID_HANDLE ? NATIVE_INVALID : static_cast<NativeSocket>(handle);
+    }
+    
+    TcpConnection::SocketHandle fromNative(NativeSocket s) {
+        return s == NATIVE_INVALID ? TcpConnection::INVALID_HANDLE : static_cast<TcpConnection::SocketHandle>(s);
+    }
+    
+    // Wait until the socket is readable; false on timeout or error
+    bool waitReadable(NativeSocket s, int timeoutMs, bool& timedOut) {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(s, &readSet);
+        
+        timeval timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_usec = (timeoutMs % 1000) * 1000;
+        
+        int ready = select(static_cast<int>(s) + 1, &readSet, nullptr, nullptr, timeoutMs < 0 ? nullptr : &timeout);
+        timedOut = (ready == 0);
+        return ready > 0;
+    }
+    
+    void disableNagle(NativeSocket s) {
+        // Request/response lines are tiny; do not hold them back waiting for more data
+        int enable = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&enable), sizeof(enable));
+    }
+}
+
+TcpConnection::~TcpConnection() {
+    close();
+}
+
+std::unique_ptr<TcpConnection> TcpConnection::connect(const std::string& host, uint16_t port) {
+    if (!ensureNetworkStarted()) {
+        return nullptr;
+    }
+    
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return nullptr;
+    }
+    
+    NativeSocket connected = NATIVE_INVALID;
+    for (addrinfo* address = addresses; address && connected == NATIVE_INVALID; address = address->ai_next) {
+        NativeSocket s = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (s == NATIVE_INVALID) continue;
+        
+        if (::connect(s, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+            connected = s;
+        } else {
+            closeNative(s);
+        }
+    }
+    freeaddrinfo(addresses);
+    
+    if (connected == NATIVE_INVALID) {
+        return nullptr;
+    }
+    disableNagle(connected);
+    return std::make_unique<TcpConnection>(fromNative(connected));
+}
+
+bool TcpConnection::sendLine(const std::string& line) {
+    return sendRaw(line + "\n");
+}
+
+bool TcpConnection::sendRaw(const std::string& message) {
+    if (!isOpen()) {
+        return false;
+    }
+    
+    size_t sent = 0;
+    while (sent < message.size()) {
+        int result = send(toNative(handle), message.data() + sent, static_cast<int>(message.size() - sent), SEND_FLAGS);
+        if (result <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool TcpConnection::receiveLine(std::string& line, int timeoutMs, bool* timedOut) {
+    if (timedOut) {
+        *timedOut = false;
+    }
+    
+    while (true) {
+        size_t newline = receiveBuffer.find('\n');
+        if (newline != std::string::npos) {
+            line = receiveBuffer.substr(0, newline);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            receiveBuffer.erase(0, newline + 1);
+            return true;
+        }
+        
+        if (!isOpen()) {
+            return false;
+        }
+        
+        bool waitTimedOut = false;
+        if (!waitReadable(toNative(handle), timeoutMs, waitTimedOut)) {
+            if (timedOut) {
+                *timedOut = waitTimedOut;
+            }
+            return false;
+        }
+        
+        char chunk[4096];
+        int received = recv(toNative(handle), chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false; // Closed by the peer or failed
+        }
+        receiveBuffer.append(chunk, static_cast<size_t>(received));
+    }
+}
+
+void TcpConnection::shutdown() {
+    if (isOpen()) {
+        ::shutdown(toNative(handle), SHUTDOWN_BOTH);
+    }
+}
+
+void TcpConnection::close() {
+    if (isOpen()) {
+        closeNative(toNative(handle));
+        handle = INVALID_HANDLE;
+    }
+}
+
+TcpListener::~TcpListener() {
+    close();
+}
+
+bool TcpListener::listen(uint16_t requestedPort) {
+    if (!ensureNetworkStarted()) {
+        return false;
+    }
+    close();
+    
+    NativeSocket s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == NATIVE_INVALID) {
+        return false;
+    }
+    
+    // Allow a restarted coordinator to rebind while old connections linger in TIME_WAIT
+    int enable = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&enable), sizeof(enable));
+    
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(requestedPort);
+    
+    if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(s, SOMAXCONN) != 0) {
+        closeNative(s);
+        return false;
+    }
+    
+    // Report the port actually bound (requestedPort may be 0)
+    socklen_t length = sizeof(address);
+    getsockname(s, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+    handle = fromNative(s);
+    return true;
+}
+
+std::unique_ptr<TcpConnection> TcpListener::accept(int timeoutMs) {
+    if (handle == TcpConnection::INVALID_HANDLE) {
+        return nullptr;
+    }
+    
+    bool timedOut = false;
+    if (!waitReadable(toNative(handle), timeoutMs, timedOut)) {
+        return nullptr;
+    }
+    
+    NativeSocket s = ::accept(toNative(handle), nullptr, nullptr);
+    if (s == NATIVE_INVALID) {
+        return nullptr;
+    }
+    disableNagle(s);
+    return std::make_unique<TcpConnection>(fromNative(s));
+}
+
+void TcpListener::close() {
+    if (handle != TcpConnection::INVALID_HANDLE) {
+        closeNative(toNative(handle));
+        handle = TcpConnection::INVALID_HANDLE;
+    }
+}
+
+std::vector<std::string> splitMessage(const std::string& line) {
+    std::vector<std::string> tokens;
+    std::istringstream stream(line);
+    std::string token;
+    while (stream >> token) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+bool parseHostPort(const std::string& address, std::string& host, uint16_t& port) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0 || colon + 1 >= address.size()) {
+        return false;
+    }
+    
+    try {
+        unsigned long value = std::stoul(address.substr(colon + 1));
+        if (value == 0 || value > 65535) {
+            return false;
+        }
+        host = address.substr(0, colon);
+        port = static_cast<uint16_t>(value);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Minimal blocking TCP transport for the cluster protocol (Winsock or BSD sockets).
+// Messages are single text lines of space-separated tokens.
+class TcpConnection {
+public:
+    using SocketHandle = std::uintptr_t;
+    static constexpr SocketHandle INVALID_HANDLE = ~static_cast<SocketHandle>(0);
+    
+    explicit TcpConnection(SocketHandle handle = INVALID_HANDLE) : handle(handle) {}
+    ~TcpConnection();
+    
+    TcpConnection(const TcpConnection&) = delete;
+    TcpConnection& operator=(const TcpConnection&) = delete;
+    
+    // Connect to host:port; nullptr if the host cannot be reached
+    static std::unique_ptr<TcpConnection> connect(const std::string& host, uint16_t port);
+    
+    // Send one message (a trailing newline is added)
+    bool sendLine(const std::string& line);
+    
+    // Send bytes as they are (for protocols other than the line protocol)
+    bool sendRaw(const std::string& data);
+    
+    // Receive one message without its newline. timeoutMs < 0 waits indefinitely; false on
+    // timeout (timedOut set), or when the peer closed the connection or it failed.
+    bool receiveLine(std::string& line, int timeoutMs, bool* timedOut = nullptr);
+    
+    bool isOpen() const { return handle != INVALID_HANDLE; }
+    
+    // Unblock a thread waiting in receiveLine (the connection can only be closed afterwards)
+    void shutdown();
+    void close();
+
+private:
+    SocketHandle handle;
+    std::string receiveBuffer;   // Bytes received past the last complete line
+};
+
+class TcpListener {
+public:
+    TcpListener() : handle(TcpConnection::INVALID_HANDLE), port(0) {}
+    ~TcpListener();
+    
+    TcpListener(const TcpListener&) = delete;
+    TcpListener& operator=(const TcpListener&) = delete;
+    
+    // Listen on all interfaces; port 0 picks a free port (see getPort)
+    bool listen(uint16_t port);
+    uint16_t getPort() const { return port; }
+    
+    // Next incoming connection, or nullptr when none arrived within timeoutMs
+    std::unique_ptr<TcpConnection> accept(int timeoutMs);
+    void close();
+
+private:
+    TcpConnection::SocketHandle handle;
+    uint16_t port;
+};
+
+// Split a protocol message into its tokens
+std::vector<std::string> splitMessage(const std::string& line);
+
+// Parse "host:port"; false if the port is missing or invalid
+bool parseHostPort(const std::string& address, std::string& host, uint16_t& port);
@@ -0,0 +1,176 @@
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "NumaTopology.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace {
+#ifndef _WIN32
+    // CPUs this process may run on (empty if the mask cannot be read)
+    std::vector<int> allowedCpus() {
+        std::vector<int> cpus;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &mask)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        return cpus;
+    }
+#endif
+}
+
+NumaTopology::NumaTopology(std::vector<Node> nodes) {
+    for (Node& node : nodes) {
+        if (!node.cpus.empty()) {
+            this->nodes.push_back(std::move(node));
+        }
+    }
+    std::sort(this->nodes.begin(), this->nodes.end(), [](const Node& a, const Node& b) { return a.id < b.id; });
+}
+
+NumaTopology NumaTopology::detect() {
+    std::vector<Node> nodes;
+
+#ifdef _WIN32
+    ULONG highestNode = 0;
+    if (GetNumaHighestNodeNumber(&highestNode)) {
+        for (ULONG id = 0; id <= highestNode; ++id) {
+            GROUP_AFFINITY affinity = {};
+            if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(id), &affinity)) {
+                continue;
+            }
+            Node node{ static_cast<int>(id), {} };
+            for (int bit = 0; bit < 64; ++bit) {
+                if (affinity.Mask & (static_cast<KAFFINITY>(1) << bit)) {
+                    node.cpus.push_back(affinity.Group * 64 + bit);
+                }
+            }
+            nodes.push_back(std::move(node));
+        }
+    }
+    std::vector<int> allowed;
+#else
+    // /sys/devices/system/node/nodeN/cpulist, restricted to the process's affinity mask
+    std::vector<int> allowed = allowedCpus();
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        if (!std::getline(file, list)) {
+            continue;
+        }
+
+        Node node{ std::stoi(name.substr(4)), {} };
+        for (int cpu : parseCpuList(list)) {
+            if (allowed.empty() || std::binary_search(allowed.begin(), allowed.end(), cpu)) {
+                node.cpus.push_back(cpu);
+            }
+        }
+        nodes.push_back(std::move(node));
+    }
+#endif
+
+    NumaTopology topology(std::move(nodes));
+    if (topology.nodeCount() > 0) {
+        return topology;
+    }
+
+    // No NUMA information: one node with every CPU the process may use
+    Node single{ 0, allowed };
+    if (single.cpus.empty()) {
+        unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < hardwareThreads; ++cpu) {
+            single.cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return NumaTopology({ single });
+}
+
+size_t NumaTopology::cpuCount() const {
+    size_t count = 0;
+    for (const Node& node : nodes) {
+        count += node.cpus.size();
+    }
+    return count;
+}
+
+std::string NumaTopology::describe() const {
+    std::ostringstream out;
+    out << nodes.size() << " NUMA node(s)";
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        out << (i == 0 ? ": " : ", ") << "node " << nodes[i].id << " " << nodes[i].cpus.size() << " CPUs";
+    }
+    return out.str();
+}
+
+std::vector<int> NumaTopology::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        int first = 0, last = 0;
+        char dash = 0;
+        std::istringstream range(part);
+        if (!(range >> first)) {
+            continue;
+        }
+        last = first;
+        if (range >> dash) {
+            if (dash != '-' || !(range >> last) || last < first) {
+                continue;
+            }
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+bool NumaTopology::pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+
+#ifdef _WIN32
+    GROUP_AFFINITY affinity = {};
+    affinity.Group = static_cast<WORD>(cpus.front() / 64);
+    for (int cpu : cpus) {
+        if (cpu / 64 == affinity.Group) {
+            affinity.Mask |= static_cast<KAFFINITY>(1) << (cpu % 64);
+        }
+    }
+    return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &mask);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#endif
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// NUMA nodes of this host and the logical CPUs of each (sysfs on Linux, the NUMA API on
+// Windows), limited to the CPUs this process may run on. Hosts without NUMA information
+// report a single node holding every CPU. Memory a pinned thread touches first is placed
+// on that thread's node, which is how per-node replicas end up node-local.
+class NumaTopology {
+public:
+    struct Node {
+        int id;
+        std::vector<int> cpus;   // Logical CPU numbers (Windows: processor group * 64 + bit)
+    };
+
+private:
+    std::vector<Node> nodes;
+
+public:
+    // Topology with the given nodes (nodes without CPUs are dropped)
+    explicit NumaTopology(std::vector<Node> nodes);
+
+    // Nodes of this host
+    static NumaTopology detect();
+
+    const std::vector<Node>& getNodes() const { return nodes; }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t cpuCount() const;
+    std::string describe() const;
+
+    // Parse a Linux CPU list such as "0-3,8,10-11"; malformed parts are skipped
+    static std::vector<int> parseCpuList(const std::string& list);
+
+    // Restrict the calling thread to the given CPUs; false if the OS refused or cpus is empty.
+    // On Windows all CPUs must share the processor group of the first one.
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+};
@@ -0,0 +1,92 @@
+#include "PerfectHashSet.h"
+#include <algorithm>
+#include <stdexcept>
+
+void PerfectHashSet::build(const std::vector<uint32_t>& inputKeys) {
+    std::vector<uint32_t> uniqueKeys;
+    uniqueKeys.reserve(inputKeys.size());
+    for (uint32_t key : inputKeys) {
+        if (key != 0) uniqueKeys.push_back(key);
+    }
+    std::sort(uniqueKeys.begin(), uniqueKeys.end());
+    uniqueKeys.erase(std::unique(uniqueKeys.begin(), uniqueKeys.end()), uniqueKeys.end());
+
+    seeds.clear();
+    keys.clear();
+    bucketCount = 0;
+    slotCount = static_cast<uint32_t>(uniqueKeys.size());
+    if (slotCount == 0) {
+        return;
+    }
+
+    const uint32_t MAX_SEED_ATTEMPTS = 1u << 24;
+
+    // Fewer keys per bucket makes placement easier; fall back to smaller buckets if a seed search stalls
+    for (uint32_t keysPerBucket : { 4u, 2u, 1u }) {
+        bucketCount = slotCount / keysPerBucket + 1;
+        seeds.assign(bucketCount, 0);
+        keys.assign(slotCount, 0);
+
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (uint32_t key : uniqueKeys) {
+            buckets[reduce(mix(key, 0), bucketCount)].push_back(key);
+        }
+
+        // Place the largest buckets first while most slots are still free
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t i = 0; i < bucketCount; i++) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        std::vector<uint32_t> slots;
+        bool success = true;
+        for (uint32_t bucketIndex : order) {
+            const auto& bucket = buckets[bucketIndex];
+            if (bucket.empty()) break;
+
+            bool placed = false;
+            for (uint32_t seed = 1; seed < MAX_SEED_ATTEMPTS && !placed; seed++) {
+                slots.clear();
+                placed = true;
+                for (uint32_t key : bucket) {
+                    uint32_t slot = reduce(mix(key, seed), slotCount);
+                    if (keys[slot] != 0 || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                        placed = false;
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (placed) {
+                    seeds[bucketIndex] = seed;
+                    for (size_t i = 0; i < bucket.size(); i++) {
+                        keys[slots[i]] = bucket[i];
+                    }
+                }
+            }
+
+            if (!placed) {
+                success = false;
+                break;
+            }
+        }
+
+        if (success) {
+            return;
+        }
+    }
+
+    throw std::runtime_error("Failed to build perfect hash set");
+}
+
+bool PerfectHashSet::assign(std::vector<uint32_t> bucketSeeds, std::vector<uint32_t> slotKeys) {
+    // A lookup indexes seeds by bucket and keys by slot, so both must be present together
+    if (bucketSeeds.empty() != slotKeys.empty()) {
+        return false;
+    }
+    seeds = std::move(bucketSeeds);
+    keys = std::move(slotKeys);
+    bucketCount = static_cast<uint32_t>(seeds.size());
+    slotCount = static_cast<uint32_t>(keys.size());
+    return true;
+}
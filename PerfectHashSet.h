@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Static minimal perfect hash set for non-zero 32-bit keys (hash-and-displace construction).
+// Every key owns exactly one slot, so a lookup is two hashes, two loads and one compare
+// with no probing or collision handling. The key set is fixed at build time.
+class PerfectHashSet {
+private:
+    std::vector<uint32_t> seeds;   // Displacement seed per bucket
+    std::vector<uint32_t> keys;    // One slot per key, 0 = unused
+    uint32_t bucketCount;
+    uint32_t slotCount;
+
+    static inline uint32_t mix(uint32_t key, uint32_t seed) {
+        // murmur3 finalizer over the seeded key
+        uint32_t h = key ^ (seed * 0x9E3779B9u);
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // Map a 32-bit hash onto [0, range) without division
+    static inline uint32_t reduce(uint32_t hash, uint32_t range) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(hash) * range) >> 32);
+    }
+
+public:
+    PerfectHashSet() : bucketCount(0), slotCount(0) {}
+
+    // Build from a list of non-zero keys (duplicates are ignored)
+    void build(const std::vector<uint32_t>& inputKeys);
+
+    // Adopt tables produced by an earlier build (lexicon images); false if they are inconsistent
+    bool assign(std::vector<uint32_t> bucketSeeds, std::vector<uint32_t> slotKeys);
+    const std::vector<uint32_t>& getSeeds() const { return seeds; }
+    const std::vector<uint32_t>& getKeys() const { return keys; }
+
+    inline bool contains(uint32_t key) const {
+        if (slotCount == 0) return false;
+        uint32_t seed = seeds[reduce(mix(key, 0), bucketCount)];
+        return (keys[reduce(mix(key, seed), slotCount)] == key) & (key != 0);
+    }
+
+    size_t size() const { return slotCount; }
+    size_t memoryBytes() const { return (seeds.size() + keys.size()) * sizeof(uint32_t); }
+};
\ No newline at end of file
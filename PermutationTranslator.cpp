@@ -0,0 +1,77 @@
+#include "PermutationTranslator.h"
+#include "StaticTranslator.h"
+#include "BitUtils.h"
+
+void PermutationTranslator::buildLookupTable(const Permutation& permutation, LookupTable& table) {
+    for (int n = 0; n < NIBBLE_COUNT; ++n) {
+        table.nibbleLookup[n][0] = 0;
+        
+        // Each entry extends the entry without its lowest bit by one mapped letter
+        for (uint32_t v = 1; v < 16; ++v) {
+            int letter = n * 4 + BitUtils::countTrailingZeros(v);
+            uint32_t bit = (letter < Word::ALPHABET_SIZE) ? (1u << permutation[letter]) : 0u;
+            table.nibbleLookup[n][v] = table.nibbleLookup[n][v & (v - 1)] | bit;
+        }
+    }
+}
+
+void PermutationTranslator::buildLookupTable(const Mapping& mapping, LookupTable& table) {
+    // Works for any mapping matrix, not only permutations: rows are ORed together
+    for (int n = 0; n < NIBBLE_COUNT; ++n) {
+        table.nibbleLookup[n][0] = 0;
+        
+        for (uint32_t v = 1; v < 16; ++v) {
+            int letter = n * 4 + BitUtils::countTrailingZeros(v);
+            uint32_t row = (letter < Word::ALPHABET_SIZE) ? mapping.getRowMask(letter) : 0u;
+            table.nibbleLookup[n][v] = table.nibbleLookup[n][v & (v - 1)] | row;
+        }
+    }
+}
+
+Permutation PermutationTranslator::identityPermutation() {
+    Permutation permutation;
+    for (int i = 0; i < Word::ALPHABET_SIZE; ++i) {
+        permutation[i] = static_cast<uint8_t>(i);
+    }
+    return permutation;
+}
+
+bool PermutationTranslator::permutationFromMapping(const Mapping& mapping, Permutation& permutation) {
+    uint32_t usedTargets = 0;
+    
+    for (int i = 0; i < Word::ALPHABET_SIZE; ++i) {
+        uint32_t row = mapping.getRowMask(i);
+        
+        // Every EVA letter must map to exactly one Hebrew letter, and no letter may be reused
+        if (BitUtils::popCount(row) != 1 || (usedTargets & row)) {
+            return false;
+        }
+        
+        usedTargets |= row;
+        permutation[i] = static_cast<uint8_t>(BitUtils::countTrailingZeros(row));
+    }
+    
+    return true;
+}
+
+void PermutationTranslator::permutationToMapping(const Permutation& permutation, Mapping& mapping) {
+    for (int i = 0; i < Word::ALPHABET_SIZE; ++i) {
+        mapping.setMapping(i, permutation[i]);
+    }
+}
+
+void PermutationTranslator::translateMasks(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        hebrewMasks[i] = translateMask(table, evaMasks[i]);
+    }
+}
+
+WordSet PermutationTranslator::translateWordSet(const WordSet& evaWords, const Mapping& mapping) {
+    LookupTable table;
+    buildLookupTable(mapping, table);
+    
+    std::vector<uint32_t> hebrewMasks(evaWords.size());
+    translateMasks(table, evaWords.maskData(), hebrewMasks.data(), evaWords.size());
+    
+    return StaticTranslator::masksToWordSet(hebrewMasks, Alphabet::HEBREW);
+}
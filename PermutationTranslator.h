@@ -0,0 +1,49 @@
+#pragma once
+
+#include "WordSet.h"
+#include "Mapping.h"
+#include <array>
+#include <vector>
+#include <cstdint>
+
+// EVA->Hebrew permutation: entry i is the Hebrew letter index assigned to EVA letter i
+using Permutation = std::array<uint8_t, Word::ALPHABET_SIZE>;
+
+// Static permutation translator - replaces the 27x27 matrix multiply with table lookups.
+// A mapping is compiled once into nibble-split lookup tables, after which translating a
+// packed EVA mask costs seven loads and ORs regardless of how many letters the word has.
+class PermutationTranslator {
+public:
+    static constexpr int NIBBLE_COUNT = (Word::ALPHABET_SIZE + 3) / 4;   // 7 nibbles cover 27 bits
+    
+    // nibbleLookup[n][v] = Hebrew mask produced by the EVA letters 4n..4n+3 selected by v
+    struct LookupTable {
+        uint32_t nibbleLookup[NIBBLE_COUNT][16];
+    };
+    
+    // Table construction (once per mapping)
+    static void buildLookupTable(const Permutation& permutation, LookupTable& table);
+    static void buildLookupTable(const Mapping& mapping, LookupTable& table);
+    
+    // Permutation helpers
+    static Permutation identityPermutation();
+    static bool permutationFromMapping(const Mapping& mapping, Permutation& permutation);
+    static void permutationToMapping(const Permutation& permutation, Mapping& mapping);
+    
+    // Translate a single packed EVA mask
+    static inline uint32_t translateMask(const LookupTable& table, uint32_t evaMask) {
+        return table.nibbleLookup[0][evaMask & 0xF] |
+               table.nibbleLookup[1][(evaMask >> 4) & 0xF] |
+               table.nibbleLookup[2][(evaMask >> 8) & 0xF] |
+               table.nibbleLookup[3][(evaMask >> 12) & 0xF] |
+               table.nibbleLookup[4][(evaMask >> 16) & 0xF] |
+               table.nibbleLookup[5][(evaMask >> 20) & 0xF] |
+               table.nibbleLookup[6][(evaMask >> 24) & 0xF];
+    }
+    
+    // Translate a contiguous array of packed EVA masks
+    static void translateMasks(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count);
+    
+    // WordSet convenience wrapper (materialises Hebrew words, not for hot loops)
+    static WordSet translateWordSet(const WordSet& evaWords, const Mapping& mapping);
+};
@@ -0,0 +1,403 @@
+#include "PrefixSearch.h"
+#include "BitUtils.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+    const char STATE_FILE_MAGIC[4] = { 'V', 'D', 'P', 'S' };
+    const uint64_t STOP_CHECK_NODES = 4096;
+    
+    uint64_t fnv1a(const char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+    
+    void appendInteger(std::string& buffer, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+    
+    struct ByteReader {
+        const std::string& data;
+        size_t position;
+        bool ok;
+        
+        explicit ByteReader(const std::string& data) : data(data), position(0), ok(true) {}
+        
+        uint64_t read(int bytes) {
+            if (!ok || position + bytes > data.size()) {
+                ok = false;
+                return 0;
+            }
+            uint64_t value = 0;
+            for (int i = 0; i < bytes; ++i) {
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(data[position + i])) << (8 * i);
+            }
+            position += bytes;
+            return value;
+        }
+    };
+}
+
+PrefixSearch::PrefixSearch(const WordSet& words, std::shared_ptr<const HebrewLexicon> lexicon, const SearchConfig& config)
+    : config(config), lexicon(std::move(lexicon)), totalWords(words.size()), rootCount(1), nextRoot(0), rootsCompleted(0),
+      resumed(false), lastCheckpoint(std::chrono::steady_clock::now()) {
+    // Letters by the number of words containing them; the most frequent decide words soonest
+    WordSet::MaskTable table = words.buildMaskTable();
+    uint64_t letterWords[Word::ALPHABET_SIZE] = {};
+    for (size_t i = 0; i < table.masks.size(); ++i) {
+        for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+            letterWords[letter] += ((table.masks[i] >> letter) & 1) * table.weights[i];
+        }
+    }
+    for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+        (letterWords[letter] > 0 ? letterOrder : unusedLetters).push_back(static_cast<uint8_t>(letter));
+    }
+    std::stable_sort(letterOrder.begin(), letterOrder.end(), [&letterWords](uint8_t a, uint8_t b) {
+        return letterWords[a] > letterWords[b];
+    });
+    
+    int depthOfLetter[Word::ALPHABET_SIZE];
+    for (size_t depth = 0; depth < letterOrder.size(); ++depth) {
+        depthOfLetter[letterOrder[depth]] = static_cast<int>(depth);
+    }
+    
+    // Each mask is decided where its last letter is assigned
+    completions.resize(letterOrder.size());
+    remainingFrom.assign(letterOrder.size() + 1, 0);
+    for (size_t i = 0; i < table.masks.size(); ++i) {
+        uint32_t mask = table.masks[i];
+        if (mask == 0) {
+            continue;  // Never a lexicon word
+        }
+        int lastDepth = 0;
+        for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+            if ((mask >> letter) & 1) {
+                lastDepth = std::max(lastDepth, depthOfLetter[letter]);
+            }
+        }
+        completions[lastDepth].push_back(Completion{ mask & ~(1u << letterOrder[lastDepth]), table.weights[i] });
+        for (int depth = 0; depth <= lastDepth; ++depth) {
+            remainingFrom[depth] += table.weights[i];
+        }
+    }
+    
+    // Root p-th digit chooses among the 27 - p Hebrew letters still free
+    this->config.rootDepth = std::min(config.rootDepth, letterOrder.size());
+    for (size_t p = 0; p < this->config.rootDepth; ++p) {
+        rootCount *= Word::ALPHABET_SIZE - p;
+    }
+    roots.assign(rootCount, RootState::PENDING);
+    
+    if (!this->config.stateFilePath.empty() && loadState()) {
+        resumed = true;
+        std::wcout << L"Loaded prefix search state: " << rootsCompleted << L" of " << rootCount
+                   << L" subtrees completed" << std::endl;
+    }
+}
+
+uint32_t PrefixSearch::translate(uint32_t evaLetters, const Permutation& permutation) const {
+    uint32_t hebrewMask = 0;
+    while (evaLetters) {
+        hebrewMask |= 1u << permutation[BitUtils::countTrailingZeros(evaLetters)];
+        evaLetters &= evaLetters - 1;
+    }
+    return hebrewMask;
+}
+
+uint32_t PrefixSearch::gainOf(size_t depth, const Walk& walk, int hebrewLetter) const {
+    const std::vector<Completion>& decided = completions[depth];
+    const std::vector<uint32_t>& partial = walk.partial[depth];
+    uint32_t gain = 0;
+    for (size_t j = 0; j < decided.size(); ++j) {
+        gain += lexicon->contains(partial[j] | (1u << hebrewLetter)) ? decided[j].weight : 0;
+    }
+    return gain;
+}
+
+bool PrefixSearch::searchSubtree(uint64_t root, const BoundFunction& requiredMatched, const LeafCallback& onLeaf,
+                                 const std::function<bool()>& shouldStop, SubtreeStats& stats) const {
+    Walk walk{ PermutationTranslator::identityPermutation(), Word::FULL_MASK, {}, requiredMatched, onLeaf, shouldStop, stats };
+    walk.partial.resize(letterOrder.size());
+    for (size_t depth = 0; depth < letterOrder.size(); ++depth) {
+        walk.partial[depth].resize(completions[depth].size());
+    }
+    
+    // Root digits, most significant first, pick the free Hebrew letters in ascending order
+    uint64_t weight = rootCount;
+    size_t matched = 0;
+    for (size_t depth = 0; depth < config.rootDepth; ++depth) {
+        weight /= Word::ALPHABET_SIZE - depth;
+        uint64_t digit = (root / weight) % (Word::ALPHABET_SIZE - depth);
+        uint32_t candidates = walk.freeHebrew;
+        for (uint64_t skipped = 0; skipped < digit; ++skipped) {
+            candidates &= candidates - 1;
+        }
+        int hebrewLetter = BitUtils::countTrailingZeros(candidates);
+        
+        for (size_t j = 0; j < completions[depth].size(); ++j) {
+            walk.partial[depth][j] = translate(completions[depth][j].otherLetters, walk.permutation);
+        }
+        matched += gainOf(depth, walk, hebrewLetter);
+        walk.permutation[letterOrder[depth]] = static_cast<uint8_t>(hebrewLetter);
+        walk.freeHebrew &= ~(1u << hebrewLetter);
+    }
+    
+    if (matched + remainingFrom[config.rootDepth] < requiredMatched()) {
+        stats.nodesPruned++;
+        return true;
+    }
+    return descend(config.rootDepth, matched, walk);
+}
+
+bool PrefixSearch::descend(size_t depth, size_t matched, Walk& walk) const {
+    SubtreeStats& stats = walk.stats;
+    if (depth == letterOrder.size()) {
+        // Unused letters take the left-over Hebrew letters in ascending order
+        uint32_t leftOver = walk.freeHebrew;
+        for (uint8_t letter : unusedLetters) {
+            walk.permutation[letter] = static_cast<uint8_t>(BitUtils::countTrailingZeros(leftOver));
+            leftOver &= leftOver - 1;
+        }
+        stats.leavesScored++;
+        return walk.onLeaf(walk.permutation, matched);
+    }
+    
+    stats.nodesVisited++;
+    if (walk.shouldStop && stats.nodesVisited % STOP_CHECK_NODES == 0 && walk.shouldStop()) {
+        return false;
+    }
+    
+    // The other letters of the masks decided here are already assigned
+    const std::vector<Completion>& decided = completions[depth];
+    for (size_t j = 0; j < decided.size(); ++j) {
+        walk.partial[depth][j] = translate(decided[j].otherLetters, walk.permutation);
+    }
+    
+    // Best immediate gain first: good leaves come early and tighten the caller's bound
+    std::pair<uint32_t, int> candidates[Word::ALPHABET_SIZE];
+    int candidateCount = 0;
+    for (uint32_t free = walk.freeHebrew; free; free &= free - 1) {
+        int hebrewLetter = BitUtils::countTrailingZeros(free);
+        candidates[candidateCount++] = { gainOf(depth, walk, hebrewLetter), hebrewLetter };
+    }
+    std::stable_sort(candidates, candidates + candidateCount, [](const std::pair<uint32_t, int>& a, const std::pair<uint32_t, int>& b) {
+        return a.first > b.first;
+    });
+    
+    const uint8_t evaLetter = letterOrder[depth];
+    for (int c = 0; c < candidateCount; ++c) {
+        // Later candidates gain no more, so once one falls short they all do
+        if (matched + candidates[c].first + remainingFrom[depth + 1] < walk.requiredMatched()) {
+            stats.nodesPruned += candidateCount - c;
+            break;
+        }
+        
+        int hebrewLetter = candidates[c].second;
+        walk.permutation[evaLetter] = static_cast<uint8_t>(hebrewLetter);
+        walk.freeHebrew &= ~(1u << hebrewLetter);
+        bool keepGoing = descend(depth + 1, matched + candidates[c].first, walk);
+        walk.freeHebrew |= 1u << hebrewLetter;
+        if (!keepGoing) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PrefixSearch::claimRoot(uint64_t& root) {
+    std::lock_guard<std::mutex> lock(mutex);
+    while (nextRoot < rootCount && roots[nextRoot] != RootState::PENDING) {
+        nextRoot++;
+    }
+    if (nextRoot == rootCount) {
+        return false;
+    }
+    root = nextRoot++;
+    roots[root] = RootState::CLAIMED;
+    return true;
+}
+
+void PrefixSearch::completeRoot(uint64_t root, const SubtreeStats& stats) {
+    bool wroteCheckpoint = false;
+    std::function<void()> listener;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (root >= rootCount || roots[root] == RootState::COMPLETED) {
+            return;
+        }
+        roots[root] = RootState::COMPLETED;
+        rootsCompleted++;
+        totals.nodesVisited += stats.nodesVisited;
+        totals.nodesPruned += stats.nodesPruned;
+        totals.leavesScored += stats.leavesScored;
+        
+        auto now = std::chrono::steady_clock::now();
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastCheckpoint).count();
+        if (!config.stateFilePath.empty() && (elapsedMs >= static_cast<long long>(config.checkpointIntervalMs) || rootsCompleted == rootCount)) {
+            wroteCheckpoint = writeStateLocked();
+            listener = checkpointListener;
+        }
+    }
+    if (wroteCheckpoint && listener) {
+        listener();
+    }
+}
+
+bool PrefixSearch::isComplete() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return rootsCompleted == rootCount;
+}
+
+PrefixSearch::Progress PrefixSearch::getProgress() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Progress{ rootCount, rootsCompleted, totals };
+}
+
+bool PrefixSearch::saveState() {
+    if (config.stateFilePath.empty()) {
+        return false;
+    }
+    std::function<void()> listener;
+    bool written;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        written = writeStateLocked();
+        listener = checkpointListener;
+    }
+    if (written && listener) {
+        listener();
+    }
+    return written;
+}
+
+void PrefixSearch::setCheckpointListener(std::function<void()> listener) {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkpointListener = std::move(listener);
+}
+
+uint64_t PrefixSearch::leafKey(const Permutation& permutation) {
+    return fnv1a(reinterpret_cast<const char*>(permutation.data()), permutation.size());
+}
+
+bool PrefixSearch::writeStateLocked() {
+    lastCheckpoint = std::chrono::steady_clock::now();
+    
+    std::string buffer(STATE_FILE_MAGIC, sizeof(STATE_FILE_MAGIC));
+    appendInteger(buffer, STATE_FORMAT_VERSION, 4);
+    appendInteger(buffer, config.rootDepth, 4);
+    appendInteger(buffer, letterOrder.size(), 1);
+    for (int p = 0; p < Word::ALPHABET_SIZE; ++p) {
+        appendInteger(buffer, p < static_cast<int>(letterOrder.size()) ? letterOrder[p] : 0xFF, 1);
+    }
+    appendInteger(buffer, rootCount, 8);
+    appendInteger(buffer, totals.nodesVisited, 8);
+    appendInteger(buffer, totals.nodesPruned, 8);
+    appendInteger(buffer, totals.leavesScored, 8);
+    for (uint64_t first = 0; first < rootCount; first += 8) {
+        uint8_t bits = 0;
+        for (uint64_t root = first; root < std::min(first + 8, rootCount); ++root) {
+            if (roots[root] == RootState::COMPLETED) {
+                bits = static_cast<uint8_t>(bits | (1u << (root - first)));
+            }
+        }
+        buffer.push_back(static_cast<char>(bits));
+    }
+    appendInteger(buffer, fnv1a(buffer.data(), buffer.size()), 8);
+    
+    // Written beside the previous checkpoint and renamed over it
+    std::string tempPath = config.stateFilePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.flush();
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(tempPath, config.stateFilePath, error);
+    if (error) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool PrefixSearch::loadState() {
+    std::ifstream file(config.stateFilePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    const size_t checksumSize = sizeof(uint64_t);
+    if (contents.size() < sizeof(STATE_FILE_MAGIC) + checksumSize ||
+        std::memcmp(contents.data(), STATE_FILE_MAGIC, sizeof(STATE_FILE_MAGIC)) != 0) {
+        std::wcerr << L"Prefix search state " << config.stateFilePath.c_str() << L" is not a state file" << std::endl;
+        return false;
+    }
+    size_t payloadSize = contents.size() - checksumSize;
+    ByteReader checksumReader(contents);
+    checksumReader.position = payloadSize;
+    if (checksumReader.read(8) != fnv1a(contents.data(), payloadSize)) {
+        std::wcerr << L"Prefix search state " << config.stateFilePath.c_str() << L" failed its checksum" << std::endl;
+        return false;
+    }
+    
+    ByteReader reader(contents);
+    reader.position = sizeof(STATE_FILE_MAGIC);
+    uint64_t version = reader.read(4);
+    if (version != STATE_FORMAT_VERSION) {
+        std::wcerr << L"Prefix search state " << config.stateFilePath.c_str() << L" has unsupported version " << version << std::endl;
+        return false;
+    }
+    
+    // Roots are only meaningful for the same letter order and root depth
+    bool sameTree = reader.read(4) == config.rootDepth && reader.read(1) == letterOrder.size();
+    for (int p = 0; p < Word::ALPHABET_SIZE; ++p) {
+        uint64_t letter = reader.read(1);
+        sameTree = sameTree && (p >= static_cast<int>(letterOrder.size()) || letter == letterOrder[p]);
+    }
+    sameTree = sameTree && reader.read(8) == rootCount;
+    if (!reader.ok || !sameTree) {
+        std::wcerr << L"Warning: prefix search state " << config.stateFilePath.c_str()
+                   << L" was written for another corpus or root depth; starting a new search" << std::endl;
+        return false;
+    }
+    
+    SubtreeStats savedTotals;
+    savedTotals.nodesVisited = reader.read(8);
+    savedTotals.nodesPruned = reader.read(8);
+    savedTotals.leavesScored = reader.read(8);
+    if (payloadSize - reader.position != (rootCount + 7) / 8) {
+        std::wcerr << L"Prefix search state " << config.stateFilePath.c_str() << L" is malformed" << std::endl;
+        return false;
+    }
+    
+    uint64_t completed = 0;
+    for (uint64_t root = 0; root < rootCount; ++root) {
+        bool done = (static_cast<uint8_t>(contents[reader.position + root / 8]) >> (root % 8)) & 1;
+        roots[root] = done ? RootState::COMPLETED : RootState::PENDING;
+        completed += done ? 1 : 0;
+    }
+    rootsCompleted = completed;
+    totals = savedTotals;
+    return true;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "PermutationTranslator.h"
+#include "HebrewLexicon.h"
+#include "WordSet.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+// Branch-and-bound alternative to flat enumeration. The EVA letters the corpus uses are given
+// Hebrew letters one at a time, most frequent first; a word is scored as soon as the last of
+// its letters is assigned, so every partial assignment has an exact match count for its
+// completed words and an upper bound of that count plus every word still open. Subtrees
+// whose bound falls short of what the caller still wants to see are skipped. Letters the
+// corpus never uses take the left-over Hebrew letters in ascending order, as in SearchSpace.
+//
+// The first rootDepth assignments name a subtree root, the unit of work handed to workers.
+// Completed roots and the search totals are checkpointed, so a stopped search resumes with
+// the roots it had not finished.
+class PrefixSearch {
+public:
+    struct SearchConfig {
+        size_t rootDepth;                 // Letters fixed by each subtree root
+        std::string stateFilePath;        // Checkpoint file ("" = no checkpoints)
+        size_t checkpointIntervalMs;      // Shortest time between checkpoints written on completion
+        
+        SearchConfig() :
+            rootDepth(3),
+            stateFilePath("prefix_search_state.bin"),
+            checkpointIntervalMs(5000) {}
+    };
+    
+    // File layout: "VDPS" | u32 version | u32 rootDepth | u8 letterCount | 27 x u8 letter order |
+    //   u64 rootCount | u64 nodesVisited | u64 nodesPruned | u64 leavesScored |
+    //   ceil(rootCount / 8) bytes of completed-root bits | u64 FNV-1a of the preceding bytes,
+    //   little-endian. The letter order identifies the corpus the roots were numbered for.
+    static constexpr uint32_t STATE_FORMAT_VERSION = 1;
+    
+    // Work done by one subtree search (and, summed, by the whole search)
+    struct SubtreeStats {
+        uint64_t nodesVisited = 0;        // Partial assignments expanded
+        uint64_t nodesPruned = 0;         // Children skipped because their bound fell short
+        uint64_t leavesScored = 0;        // Complete mappings passed to the leaf callback
+    };
+    
+    struct Progress {
+        uint64_t rootCount;
+        uint64_t rootsCompleted;
+        SubtreeStats totals;
+    };
+    
+    // Fewest matches a leaf must be able to reach to be worth visiting (asked again as the
+    // caller's top results improve)
+    using BoundFunction = std::function<size_t()>;
+    
+    // A complete mapping and its exact match count; return false to stop the subtree
+    using LeafCallback = std::function<bool(const Permutation& permutation, size_t matched)>;
+
+private:
+    // A distinct corpus mask that is decided at some depth: the letter assigned there is its
+    // last, otherLetters are the ones assigned before it
+    struct Completion {
+        uint32_t otherLetters;
+        uint32_t weight;
+    };
+    
+    SearchConfig config;
+    std::shared_ptr<const HebrewLexicon> lexicon;
+    size_t totalWords;
+    std::vector<uint8_t> letterOrder;               // Used EVA letters, most frequent first
+    std::vector<uint8_t> unusedLetters;             // Filled with the left-over letters at a leaf
+    std::vector<std::vector<Completion>> completions;  // Masks decided at each depth
+    std::vector<size_t> remainingFrom;              // Words decided at this depth or later
+    uint64_t rootCount;
+    
+    // Work and checkpoint state (guarded by mutex)
+    enum class RootState : uint8_t { PENDING, CLAIMED, COMPLETED };
+    mutable std::mutex mutex;
+    std::vector<RootState> roots;
+    uint64_t nextRoot;                              // Roots below this are claimed or completed
+    uint64_t rootsCompleted;
+    SubtreeStats totals;
+    bool resumed;
+    std::chrono::steady_clock::time_point lastCheckpoint;
+    std::function<void()> checkpointListener;
+    
+    // Per-search scratch: translated masks of each depth's completions, candidate letters
+    struct Walk {
+        Permutation permutation;
+        uint32_t freeHebrew;
+        std::vector<std::vector<uint32_t>> partial;
+        const BoundFunction& requiredMatched;
+        const LeafCallback& onLeaf;
+        const std::function<bool()>& shouldStop;
+        SubtreeStats& stats;
+    };
+    
+    uint32_t translate(uint32_t evaLetters, const Permutation& permutation) const;
+    uint32_t gainOf(size_t depth, const Walk& walk, int hebrewLetter) const;
+    bool descend(size_t depth, size_t matched, Walk& walk) const;
+    bool writeStateLocked();
+    bool loadState();
+
+public:
+    PrefixSearch(const WordSet& words, std::shared_ptr<const HebrewLexicon> lexicon, const SearchConfig& config = SearchConfig());
+    
+    // Shape of the tree
+    const std::vector<uint8_t>& getLetterOrder() const { return letterOrder; }
+    size_t getRootDepth() const { return config.rootDepth; }
+    uint64_t getRootCount() const { return rootCount; }
+    size_t getTotalWords() const { return totalWords; }
+    
+    // Hand out the next unfinished root (false once every root is claimed or completed).
+    // A root that is claimed but never completed is searched again after a resume.
+    bool claimRoot(uint64_t& root);
+    void completeRoot(uint64_t root, const SubtreeStats& stats);
+    bool isComplete() const;
+    
+    // Depth-first search of one subtree, best immediate gain first. shouldStop is polled every
+    // few thousand nodes. Returns false if stopped before the subtree was exhausted.
+    bool searchSubtree(uint64_t root, const BoundFunction& requiredMatched, const LeafCallback& onLeaf,
+                       const std::function<bool()>& shouldStop, SubtreeStats& stats) const;
+    
+    Progress getProgress() const;
+    bool wasResumed() const { return resumed; }
+    
+    // Write a checkpoint now (completeRoot writes one whenever checkpointIntervalMs has passed)
+    bool saveState();
+    
+    // Called after each checkpoint is written, outside the lock (owners save their top results)
+    void setCheckpointListener(std::function<void()> listener);
+    
+    // Mapping index used for prefix-search results: leaves have no generator index, so they
+    // are keyed by an FNV-1a hash of their permutation (stored alongside in results)
+    static uint64_t leafKey(const Permutation& permutation);
+};
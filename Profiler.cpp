@@ -0,0 +1,245 @@
+#include "Profiler.h"
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace {
+    // Single-writer counter update: the owning thread is the only one storing to it
+    void addRelaxed(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    struct TraceEvent {
+        int64_t startNs;                  // Since the profiler epoch (configure)
+        int64_t durationNs;
+        int stage;
+    };
+}
+
+// One cache line per thread at least, so profiled workers never share a line
+struct alignas(64) Profiler::ThreadBuffer {
+    int id = 0;                           // Trace track
+    ThreadState* owner = nullptr;         // Guarded by the registry mutex (null = free for reuse)
+
+    std::atomic<uint64_t> sampledItems{0};
+    std::atomic<uint64_t> nanoseconds[STAGE_COUNT] = {};
+    std::atomic<uint64_t> scopes[STAGE_COUNT] = {};
+
+    // Sized by configure; events [0, traceCount) are complete (published with release)
+    std::vector<TraceEvent> traceEvents;
+    std::atomic<size_t> traceCount{0};
+};
+
+struct Profiler::Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;   // Never freed, reused once released
+
+    std::atomic<uint32_t> sampleInterval{64};
+    std::atomic<bool> tracing{false};
+    int64_t traceWindowNs = 0;
+    size_t maxTraceEvents = 0;
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::atomic<int64_t> traceStartNs{-1};                // First traced scope (-1 = none yet)
+
+    ThreadBuffer* claim(ThreadState& state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& buffer : buffers) {
+            if (!buffer->owner) {
+                buffer->owner = &state;
+                return buffer.get();
+            }
+        }
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer* buffer = buffers.back().get();
+        buffer->id = static_cast<int>(buffers.size() - 1);
+        buffer->owner = &state;
+        if (tracing.load(std::memory_order_relaxed)) {
+            buffer->traceEvents.resize(maxTraceEvents);
+        }
+        return buffer;
+    }
+};
+
+Profiler::Registry& Profiler::registry() {
+    static Registry instance;
+    return instance;
+}
+
+Profiler::ThreadState::~ThreadState() {
+    if (buffer) {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        buffer->owner = nullptr;
+    }
+}
+
+void Profiler::startSample(ThreadState& state) {
+    Registry& r = registry();
+    if (!state.buffer) {
+        state.buffer = r.claim(state);
+    }
+    state.countdown = r.sampleInterval.load(std::memory_order_relaxed) - 1;
+    state.sampling = true;
+    addRelaxed(state.buffer->sampledItems, 1);
+}
+
+void Profiler::ScopedTimer::enter(Stage timedStage) {
+    ThreadState& state = threadState;
+    auto now = std::chrono::steady_clock::now();
+    if (state.activeStage >= 0) {
+        // The enclosing scope's stage pauses while this one runs
+        addRelaxed(state.buffer->nanoseconds[state.activeStage],
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(now - state.segmentStart).count());
+    }
+    stage = static_cast<int>(timedStage);
+    parentStage = state.activeStage;
+    scopeStart = now;
+    state.activeStage = stage;
+    state.segmentStart = now;
+}
+
+void Profiler::ScopedTimer::exit() {
+    ThreadState& state = threadState;
+    ThreadBuffer& buffer = *state.buffer;
+    auto now = std::chrono::steady_clock::now();
+    addRelaxed(buffer.nanoseconds[stage], std::chrono::duration_cast<std::chrono::nanoseconds>(now - state.segmentStart).count());
+    addRelaxed(buffer.scopes[stage], 1);
+    state.activeStage = parentStage;
+    state.segmentStart = now;
+
+    Registry& r = registry();
+    if (!r.tracing.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // The window opens with the first traced scope of any thread
+    int64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(scopeStart - r.epoch).count();
+    int64_t windowStart = r.traceStartNs.load(std::memory_order_relaxed);
+    if (windowStart < 0 && r.traceStartNs.compare_exchange_strong(windowStart, startNs, std::memory_order_relaxed)) {
+        windowStart = startNs;
+    }
+    size_t count = buffer.traceCount.load(std::memory_order_relaxed);
+    if (startNs - windowStart > r.traceWindowNs || count >= buffer.traceEvents.size()) {
+        return;
+    }
+    buffer.traceEvents[count] = { startNs, std::chrono::duration_cast<std::chrono::nanoseconds>(now - scopeStart).count(), stage };
+    buffer.traceCount.store(count + 1, std::memory_order_release);
+}
+
+void Profiler::configure(const ProfilerConfig& config) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.sampleInterval = std::max<uint32_t>(config.sampleInterval, 1);
+    r.tracing = !config.traceFilePath.empty();
+    r.traceWindowNs = static_cast<int64_t>(config.traceWindowMs) * 1000000;
+    r.maxTraceEvents = config.maxTraceEventsPerThread;
+    r.epoch = std::chrono::steady_clock::now();
+    r.traceStartNs = -1;
+
+    for (auto& buffer : r.buffers) {
+        // The owning thread is idle, so its next mapping is sampled under the new interval
+        if (buffer->owner) {
+            buffer->owner->countdown = 0;
+            buffer->owner->sampling = false;
+            buffer->owner->activeStage = -1;
+        }
+        buffer->sampledItems = 0;
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            buffer->nanoseconds[s] = 0;
+            buffer->scopes[s] = 0;
+        }
+        buffer->traceCount = 0;
+        if (r.tracing) {
+            buffer->traceEvents.resize(r.maxTraceEvents);
+        } else {
+            std::vector<TraceEvent>().swap(buffer->traceEvents);
+        }
+    }
+}
+
+Profiler::Breakdown Profiler::getBreakdown() {
+    Registry& r = registry();
+    Breakdown breakdown = {};
+    breakdown.sampleInterval = r.sampleInterval.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (const auto& buffer : r.buffers) {
+        breakdown.sampledItems += buffer->sampledItems.load(std::memory_order_relaxed);
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            breakdown.stages[s].nanoseconds += buffer->nanoseconds[s].load(std::memory_order_relaxed);
+            breakdown.stages[s].scopes += buffer->scopes[s].load(std::memory_order_relaxed);
+        }
+    }
+    return breakdown;
+}
+
+bool Profiler::writeTrace(const std::string& filePath) {
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    file << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"VoynichDecoder\"}}";
+    file << std::fixed << std::setprecision(3);
+    for (const auto& buffer : r.buffers) {
+        size_t count = buffer->traceCount.load(std::memory_order_acquire);
+        if (count == 0) {
+            continue;
+        }
+        file << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->id
+             << ", \"args\": {\"name\": \"profiled thread " << buffer->id << "\"}}";
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->traceEvents[i];
+            file << ",\n{\"name\": \"" << getStageName(static_cast<Stage>(event.stage)) << "\", \"cat\": \"decoder\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                 << buffer->id << ", \"ts\": " << event.startNs / 1000.0 << ", \"dur\": " << event.durationNs / 1000.0 << "}";
+        }
+    }
+    file << "\n]}\n";
+    return file.good();
+}
+
+const char* Profiler::getStageName(Stage stage) {
+    switch (stage) {
+        case Stage::GENERATION: return "generation";
+        case Stage::TRANSLATION: return "translation";
+        case Stage::VALIDATION: return "validation";
+        case Stage::BOOKKEEPING: return "bookkeeping";
+    }
+    return "unknown";
+}
+
+uint64_t Profiler::Breakdown::totalNanoseconds() const {
+    uint64_t total = 0;
+    for (const auto& stage : stages) {
+        total += stage.nanoseconds;
+    }
+    return total;
+}
+
+double Profiler::Breakdown::share(Stage stage) const {
+    uint64_t total = totalNanoseconds();
+    return total > 0 ? static_cast<double>(stages[static_cast<size_t>(stage)].nanoseconds) / total : 0.0;
+}
+
+double Profiler::Breakdown::nanosecondsPerItem(Stage stage) const {
+    return sampledItems > 0 ? static_cast<double>(stages[static_cast<size_t>(stage)].nanoseconds) / sampledItems : 0.0;
+}
+
+Profiler::Breakdown Profiler::Breakdown::since(const Breakdown& earlier) const {
+    if (sampledItems < earlier.sampledItems) {
+        return *this;  // Reset by configure in between
+    }
+    Breakdown difference = *this;
+    difference.sampledItems -= earlier.sampledItems;
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        difference.stages[s].nanoseconds -= std::min(stages[s].nanoseconds, earlier.stages[s].nanoseconds);
+        difference.stages[s].scopes -= std::min(stages[s].scopes, earlier.stages[s].scopes);
+    }
+    return difference;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <array>
+#include <cstdint>
+
+// Sampled hot-path timing: how a scored mapping's time splits between generation, translation,
+// validation and bookkeeping. One mapping in sampleInterval is timed, each thread writes only its
+// own buffer and the stats thread sums the buffers. The PROFILE_* macros below compile to nothing
+// unless VOYNICH_PROFILING is defined, so a normal build pays nothing for the instrumentation.
+class Profiler {
+public:
+    enum class Stage {
+        GENERATION,       // Producing the next permutation (unranking, cursor, swap enumeration)
+        TRANSLATION,      // Lookup tables and EVA -> Hebrew mask translation
+        VALIDATION,       // Lexicon probes and scoring
+        BOOKKEEPING       // Top results, thread stats, batch reports and result callbacks
+    };
+    static constexpr size_t STAGE_COUNT = 4;
+
+    struct ProfilerConfig {
+        uint32_t sampleInterval;          // Time one mapping in this many (1 = every mapping)
+        std::string traceFilePath;        // Chrome trace / Perfetto JSON of the sampled scopes ("" = none)
+        size_t traceWindowMs;             // Scopes are traced for this long after the first sample
+        size_t maxTraceEventsPerThread;   // Trace buffer per thread, allocated when tracing is on
+
+        ProfilerConfig() : sampleInterval(64), traceFilePath(""), traceWindowMs(2000), maxTraceEventsPerThread(100000) {}
+    };
+
+    struct StageTotals {
+        uint64_t nanoseconds;             // Time in this stage, excluding nested scopes of other stages
+        uint64_t scopes;                  // Timed scopes
+    };
+
+    // Sums of every thread's buffer (only sampled mappings are included)
+    struct Breakdown {
+        uint64_t sampledItems;
+        uint32_t sampleInterval;
+        std::array<StageTotals, STAGE_COUNT> stages;
+
+        uint64_t totalNanoseconds() const;
+        double share(Stage stage) const;                          // 0..1 of the timed total
+        double nanosecondsPerItem(Stage stage) const;             // Mean over the sampled mappings
+        Breakdown since(const Breakdown& earlier) const;          // Counts added after `earlier`
+    };
+
+private:
+    struct ThreadBuffer;
+    struct Registry;
+    static Registry& registry();
+
+    // Owning thread only; the buffer is claimed on the thread's first sample
+    struct ThreadState {
+        uint32_t countdown = 0;           // Mappings left before the next sampled one
+        bool sampling = false;            // The current mapping is timed
+        ThreadBuffer* buffer = nullptr;
+        int activeStage = -1;             // Innermost open scope (-1 = none)
+        std::chrono::steady_clock::time_point segmentStart;
+
+        ~ThreadState();                   // Returns the buffer for reuse by a later thread
+    };
+    static thread_local ThreadState threadState;
+
+    static void startSample(ThreadState& state);
+
+public:
+    // Times the enclosing scope when the thread's current mapping is sampled. Time spent in a
+    // nested scope counts only for the nested scope's stage.
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Stage stage) : active(threadState.sampling) {
+            if (active) enter(stage);
+        }
+        ~ScopedTimer() {
+            if (active) exit();
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        bool active;
+        int stage = -1;
+        int parentStage = -1;
+        std::chrono::steady_clock::time_point scopeStart;
+
+        void enter(Stage stage);
+        void exit();
+    };
+
+    // Marks the start of the next mapping on this thread and decides whether it is timed
+    static void beginItem() {
+        ThreadState& state = threadState;
+        if (state.countdown == 0) {
+            startSample(state);
+        } else {
+            state.countdown--;
+            state.sampling = false;
+        }
+    }
+
+    // Resets every total, trace buffer and sampling countdown; call while no thread is profiling
+    static void configure(const ProfilerConfig& config);
+    static Breakdown getBreakdown();
+
+    // Complete ("X") events of the traced window, one track per profiled thread
+    static bool writeTrace(const std::string& filePath);
+
+    static const char* getStageName(Stage stage);
+
+    // Whether this build was compiled with VOYNICH_PROFILING (otherwise no scope records anything)
+    static constexpr bool isCompiledIn() {
+#ifdef VOYNICH_PROFILING
+        return true;
+#else
+        return false;
+#endif
+    }
+};
+
+inline thread_local Profiler::ThreadState Profiler::threadState;
+
+#ifdef VOYNICH_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(stage) Profiler::ScopedTimer PROFILE_CONCAT(profileScope, __LINE__)(stage)
+#define PROFILE_ITEM() Profiler::beginItem()
+#else
+#define PROFILE_SCOPE(stage) ((void)0)
+#define PROFILE_ITEM() ((void)0)
+#endif
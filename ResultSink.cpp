@@ -0,0 +1,386 @@
+#include "ResultSink.h"
+#include <map>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+namespace {
+    const char BINARY_MAGIC[4] = { 'V', 'D', 'R', 'S' };
+    const char* CSV_HEADER = "mapping_id,score,matched_words,total_words,timestamp,permutation,node";
+    const char* TEXT_SEPARATOR = "================================================================================\n";
+    
+    template <typename T>
+    void appendInteger(std::string& out, T value) {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+        }
+    }
+    
+    template <typename T>
+    T readInteger(const unsigned char* bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return static_cast<T>(value);
+    }
+    
+    // Inverse of the "%Y-%m-%d %H:%M:%S" local time written to TEXT and CSV files
+    std::chrono::system_clock::time_point parseTimestamp(const std::string& text) {
+        std::tm tm_buf = {};
+        std::istringstream stream(text);
+        stream >> std::get_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
+        if (stream.fail()) {
+            return std::chrono::system_clock::time_point();
+        }
+        tm_buf.tm_isdst = -1;
+        return std::chrono::system_clock::from_time_t(std::mktime(&tm_buf));
+    }
+    
+    std::string permutationText(const Permutation& permutation) {
+        std::string text;
+        for (size_t i = 0; i < permutation.size(); i++) {
+            if (i > 0) text.push_back(' ');
+            text += std::to_string(permutation[i]);
+        }
+        return text;
+    }
+    
+    bool parsePermutation(const std::string& text, Permutation& permutation) {
+        std::istringstream stream(text);
+        for (auto& letter : permutation) {
+            int value = 0;
+            if (!(stream >> value) || value < 0 || value >= Word::ALPHABET_SIZE) {
+                return false;
+            }
+            letter = static_cast<uint8_t>(value);
+        }
+        return true;
+    }
+}
+
+ResultSink::ResultSink(const std::string& filePath, const SinkConfig& config)
+    : filePath(filePath), config(config), writtenCount(0), flushRequested(false), stopping(false),
+      writeErrorReported(false), cachedSecond(-1) {
+    writerThread = std::thread(&ResultSink::writerLoop, this);
+}
+
+ResultSink::~ResultSink() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        stopping = true;
+    }
+    writerCondition.notify_all();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+std::shared_ptr<ResultSink> ResultSink::acquire(const std::string& filePath, const SinkConfig& config) {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::weak_ptr<ResultSink>> registry;
+    
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry.find(filePath);
+    if (it != registry.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+    
+    auto sink = std::make_shared<ResultSink>(filePath, config);
+    registry[filePath] = sink;
+    return sink;
+}
+
+void ResultSink::submit(Record record) {
+    Node* node = new Node{ std::move(record), pendingHead.load(std::memory_order_relaxed) };
+    while (!pendingHead.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    submittedCount.fetch_add(1, std::memory_order_release);
+    
+    // Otherwise the writer picks the record up on its next timed wake-up
+    if (pendingCount.fetch_add(1, std::memory_order_relaxed) + 1 == config.batchSize) {
+        writerCondition.notify_one();
+    }
+}
+
+void ResultSink::flush() {
+    uint64_t target = submittedCount.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(writerMutex);
+    if (writtenCount >= target) {
+        return;
+    }
+    flushRequested = true;
+    writerCondition.notify_one();
+    writtenCondition.wait(lock, [this, target]() { return writtenCount >= target; });
+}
+
+bool ResultSink::clear() {
+    flush();
+    
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file.is_open()) {
+        file.close();
+    }
+    std::ofstream truncated(filePath, std::ios::trunc);
+    return truncated.is_open();
+}
+
+void ResultSink::writerLoop() {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    while (true) {
+        writerCondition.wait_for(lock, std::chrono::milliseconds(config.flushIntervalMs), [this]() {
+            return stopping || flushRequested || pendingCount.load(std::memory_order_relaxed) >= config.batchSize;
+        });
+        flushRequested = false;
+        bool stopRequested = stopping;
+        
+        lock.unlock();
+        size_t written = writePending();
+        lock.lock();
+        
+        writtenCount += written;
+        writtenCondition.notify_all();
+        if (stopRequested && pendingHead.load(std::memory_order_acquire) == nullptr) {
+            break;
+        }
+    }
+    
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+size_t ResultSink::writePending() {
+    Node* list = pendingHead.exchange(nullptr, std::memory_order_acquire);
+    if (!list) {
+        return 0;
+    }
+    
+    // The stack holds the newest record first; restore submission order
+    Node* ordered = nullptr;
+    size_t count = 0;
+    while (list) {
+        Node* next = list->next;
+        list->next = ordered;
+        ordered = list;
+        list = next;
+        count++;
+    }
+    pendingCount.fetch_sub(count, std::memory_order_relaxed);
+    
+    std::lock_guard<std::mutex> lock(fileMutex);
+    bool writable = openFile();
+    while (ordered) {
+        Node* next = ordered->next;
+        if (writable) {
+            writeRecord(ordered->record);
+        }
+        delete ordered;
+        ordered = next;
+    }
+    
+    // One flush per batch instead of one open/write/close per result
+    if (writable) {
+        file.flush();
+    }
+    if (writable && !file.good() && !writeErrorReported) {
+        std::wcerr << L"Results: writing " << filePath.c_str() << L" failed" << std::endl;
+        writeErrorReported = true;
+    }
+    return count;
+}
+
+bool ResultSink::openFile() {
+    if (file.is_open()) {
+        return true;
+    }
+    
+    file.open(filePath, std::ios::app | std::ios::binary);
+    if (!file.is_open()) {
+        if (!writeErrorReported) {
+            std::wcerr << L"Results: cannot open " << filePath.c_str() << std::endl;
+            writeErrorReported = true;
+        }
+        return false;
+    }
+    
+    // A new file starts with the format's header
+    file.seekp(0, std::ios::end);
+    if (file.tellp() == std::streampos(0)) {
+        if (config.format == Format::CSV) {
+            file << CSV_HEADER << "\n";
+        } else if (config.format == Format::BINARY) {
+            std::string header(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+            appendInteger(header, BINARY_FORMAT_VERSION);
+            file.write(header.data(), header.size());
+        }
+    }
+    return true;
+}
+
+const std::string& ResultSink::formatTimestamp(std::chrono::system_clock::time_point timestamp) {
+    std::time_t seconds = std::chrono::system_clock::to_time_t(timestamp);
+    if (seconds != cachedSecond) {
+        std::tm tm_buf;
+        localtime_s(&tm_buf, &seconds);
+        
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        cachedTimestamp = text;
+        cachedSecond = seconds;
+    }
+    return cachedTimestamp;
+}
+
+void ResultSink::writeRecord(const Record& record) {
+    switch (config.format) {
+        case Format::TEXT: {
+            file << TEXT_SEPARATOR;
+            file << "Date/Time: " << formatTimestamp(record.timestamp) << "\n";
+            if (!record.source.empty()) {
+                file << "Node: " << record.source << "\n";
+            }
+            file << "Mapping ID: " << record.mappingId << "\n";
+            file << "Score: " << std::fixed << std::setprecision(2) << record.score
+                 << "% (" << record.matchedWords << "/" << record.totalWords << " matches)\n";
+            file << TEXT_SEPARATOR;
+            
+            // The mapping table is built here, off the scoring threads
+            if (record.hasPermutation) {
+                Mapping mapping;
+                PermutationTranslator::permutationToMapping(record.permutation, mapping);
+                file << mapping.serializeMappingVisualization() << "\n\n";
+            } else if (!record.mappingText.empty()) {
+                file << record.mappingText << "\n\n";
+            }
+            file << "\n";
+            break;
+        }
+        
+        case Format::CSV:
+            file << record.mappingId << "," << std::fixed << std::setprecision(4) << record.score << ","
+                 << record.matchedWords << "," << record.totalWords << "," << formatTimestamp(record.timestamp) << ","
+                 << (record.hasPermutation ? permutationText(record.permutation) : "") << "," << record.source << "\n";
+            break;
+        
+        case Format::BINARY: {
+            uint64_t scoreBits;
+            std::memcpy(&scoreBits, &record.score, sizeof(scoreBits));
+            
+            std::string bytes;
+            bytes.reserve(BINARY_RECORD_SIZE);
+            appendInteger(bytes, record.mappingId);
+            appendInteger(bytes, scoreBits);
+            appendInteger(bytes, record.matchedWords);
+            appendInteger(bytes, record.totalWords);
+            appendInteger(bytes, static_cast<int64_t>(std::chrono::system_clock::to_time_t(record.timestamp)));
+            bytes.push_back(record.hasPermutation ? 1 : 0);
+            bytes.append(reinterpret_cast<const char*>(record.permutation.data()), record.permutation.size());
+            file.write(bytes.data(), bytes.size());
+            break;
+        }
+    }
+}
+
+bool ResultSink::readRecords(const std::string& filePath, Format format, std::vector<Record>& records) {
+    records.clear();
+    std::ifstream input(filePath, std::ios::binary);
+    if (!input.is_open()) {
+        return false;
+    }
+    
+    if (format == Format::BINARY) {
+        std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        if (bytes.empty()) {
+            return true;
+        }
+        if (bytes.size() < BINARY_HEADER_SIZE || std::memcmp(bytes.data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 ||
+            readInteger<uint32_t>(bytes.data() + 4) != BINARY_FORMAT_VERSION) {
+            return false;
+        }
+        
+        // Fixed-size records: a torn final record from an interrupted write is ignored
+        size_t count = (bytes.size() - BINARY_HEADER_SIZE) / BINARY_RECORD_SIZE;
+        records.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char* data = bytes.data() + BINARY_HEADER_SIZE + i * BINARY_RECORD_SIZE;
+            Record record;
+            record.mappingId = readInteger<uint64_t>(data);
+            uint64_t scoreBits = readInteger<uint64_t>(data + 8);
+            std::memcpy(&record.score, &scoreBits, sizeof(scoreBits));
+            record.matchedWords = readInteger<uint32_t>(data + 16);
+            record.totalWords = readInteger<uint32_t>(data + 20);
+            record.timestamp = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(readInteger<int64_t>(data + 24)));
+            record.hasPermutation = data[32] != 0;
+            std::memcpy(record.permutation.data(), data + 33, record.permutation.size());
+            records.push_back(std::move(record));
+        }
+        return true;
+    }
+    
+    std::string line;
+    if (format == Format::CSV) {
+        while (std::getline(input, line)) {
+            if (line.empty() || line.rfind("mapping_id,", 0) == 0) {
+                continue;
+            }
+            
+            std::vector<std::string> fields;
+            std::istringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, ',')) {
+                fields.push_back(field);
+            }
+            if (fields.size() < 4) {
+                continue;
+            }
+            
+            try {
+                Record record;
+                record.mappingId = std::stoull(fields[0]);
+                record.score = std::stod(fields[1]);
+                record.matchedWords = static_cast<uint32_t>(std::stoul(fields[2]));
+                record.totalWords = static_cast<uint32_t>(std::stoul(fields[3]));
+                if (fields.size() > 4) record.timestamp = parseTimestamp(fields[4]);
+                if (fields.size() > 5) record.hasPermutation = parsePermutation(fields[5], record.permutation);
+                if (fields.size() > 6) record.source = fields[6];
+                records.push_back(std::move(record));
+            } catch (const std::exception&) {
+                // Skip malformed lines
+            }
+        }
+        return true;
+    }
+    
+    // TEXT: a record is complete at its "Score:" line
+    Record record;
+    while (std::getline(input, line)) {
+        if (line.rfind("Date/Time: ", 0) == 0) {
+            record = Record();
+            record.timestamp = parseTimestamp(line.substr(11));
+        } else if (line.rfind("Node: ", 0) == 0) {
+            record.source = line.substr(6);
+        } else if (line.rfind("Mapping ID: ", 0) == 0) {
+            record.mappingId = std::strtoull(line.c_str() + 12, nullptr, 10);
+        } else if (line.rfind("Score: ", 0) == 0) {
+            unsigned long matched = 0, total = 0;
+            record.score = std::strtod(line.c_str() + 7, nullptr);
+            size_t open = line.find('(');
+            if (open != std::string::npos) {
+                std::istringstream counts(line.substr(open + 1));
+                char slash = 0;
+                counts >> matched >> slash >> total;
+            }
+            record.matchedWords = static_cast<uint32_t>(matched);
+            record.totalWords = static_cast<uint32_t>(total);
+            records.push_back(record);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "PermutationTranslator.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+
+// Process-wide writer for high-score results. Every validator (and the cluster coordinator)
+// that saves to the same file shares one sink through acquire(); scoring threads only push a
+// record onto a lock-free queue, and a background thread formats the queued records and writes
+// them in batches to a file it keeps open.
+class ResultSink {
+public:
+    // Results file layouts
+    enum class Format {
+        TEXT,     // Readable blocks with the mapping table (the original results file)
+        CSV,      // One line per result with a header row
+        BINARY    // Fixed-size little-endian records (see BINARY_RECORD_SIZE)
+    };
+    
+    struct Record {
+        uint64_t mappingId;
+        double score;
+        uint32_t matchedWords;
+        uint32_t totalWords;
+        std::chrono::system_clock::time_point timestamp;
+        bool hasPermutation;         // permutation holds the mapping (else mappingText, if any)
+        Permutation permutation;     // Hebrew letter for each EVA letter
+        std::string mappingText;     // TEXT: visualization of a mapping that is not a permutation
+        std::string source;          // Reporting node (cluster coordinator), empty otherwise
+        
+        Record() : mappingId(0), score(0.0), matchedWords(0), totalWords(0), hasPermutation(false), permutation{} {}
+    };
+    
+    struct SinkConfig {
+        Format format;
+        int flushIntervalMs;         // Longest time a queued record waits before it is written
+        size_t batchSize;            // Queued records that wake the writer early
+        
+        SinkConfig() : format(Format::TEXT), flushIntervalMs(200), batchSize(256) {}
+    };
+    
+    // Binary layout: "VDRS" | u32 version, then records of
+    //   u64 mappingId | f64 score | u32 matchedWords | u32 totalWords | i64 unix seconds |
+    //   u8 hasPermutation | 27 x u8 permutation
+    static constexpr uint32_t BINARY_FORMAT_VERSION = 1;
+    static constexpr size_t BINARY_HEADER_SIZE = 8;
+    static constexpr size_t BINARY_RECORD_SIZE = 33 + Word::ALPHABET_SIZE;
+
+private:
+    // Intrusive lock-free stack; the writer takes the whole list at once and reverses it
+    struct Node {
+        Record record;
+        Node* next;
+    };
+    
+    std::string filePath;
+    SinkConfig config;
+    
+    std::atomic<Node*> pendingHead{nullptr};
+    std::atomic<uint64_t> submittedCount{0};
+    std::atomic<size_t> pendingCount{0};
+    
+    std::mutex writerMutex;                   // Guards the wake-up and flush bookkeeping below
+    std::condition_variable writerCondition;
+    std::condition_variable writtenCondition;
+    uint64_t writtenCount;
+    bool flushRequested;
+    bool stopping;
+    std::thread writerThread;
+    
+    std::mutex fileMutex;                     // Writer thread vs clear()
+    std::ofstream file;
+    bool writeErrorReported;
+    std::time_t cachedSecond;                 // Timestamp text is reformatted once per second
+    std::string cachedTimestamp;
+    
+    void writerLoop();
+    size_t writePending();                    // Drain the queue into the file; returns records written
+    bool openFile();
+    void writeRecord(const Record& record);
+    const std::string& formatTimestamp(std::chrono::system_clock::time_point timestamp);
+
+public:
+    ResultSink(const std::string& filePath, const SinkConfig& config = SinkConfig());
+    ~ResultSink();
+    
+    ResultSink(const ResultSink&) = delete;
+    ResultSink& operator=(const ResultSink&) = delete;
+    
+    // Process-wide registry: every caller saving to filePath shares one sink. The first caller
+    // chooses the configuration; the sink flushes and closes when the last user drops it.
+    static std::shared_ptr<ResultSink> acquire(const std::string& filePath, const SinkConfig& config = SinkConfig());
+    
+    // Queue a result (lock-free, never touches the file)
+    void submit(Record record);
+    
+    // Block until every record submitted before this call is written and flushed
+    void flush();
+    
+    // Discard queued and saved results and truncate the file
+    bool clear();
+    
+    Format getFormat() const { return config.format; }
+    const std::string& getFilePath() const { return filePath; }
+    
+    // Read a results file back (TEXT records carry no permutation); false if it cannot be read
+    static bool readRecords(const std::string& filePath, Format format, std::vector<Record>& records);
+};
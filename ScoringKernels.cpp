@@ -0,0 +1,164 @@
+#include "ScoringKernels.h"
+#include "BitUtils.h"
+#include <array>
+#include <utility>
+
+namespace {
+    using LookupTable = ScoringKernels::LookupTable;
+    constexpr int MAX_NIBBLES = PermutationTranslator::NIBBLE_COUNT;
+
+    // Mask bit a permutation target letter sets in each target alphabet
+    template <TargetAlphabet Target>
+    constexpr std::array<uint32_t, Word::ALPHABET_SIZE> makeTargetBits() {
+        std::array<uint32_t, Word::ALPHABET_SIZE> bits = {};
+        for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+            int targetLetter = (Target == TargetAlphabet::HEBREW_22) ? Word::HEBREW_BASE_LETTER[letter] : letter;
+            bits[letter] = 1u << targetLetter;
+        }
+        return bits;
+    }
+
+    template <TargetAlphabet Target>
+    constexpr std::array<uint32_t, Word::ALPHABET_SIZE> TARGET_BITS = makeTargetBits<Target>();
+
+    static_assert(TARGET_BITS<TargetAlphabet::HEBREW_27>[26] == 1u << 26, "27-letter target keeps final forms");
+    static_assert(TARGET_BITS<TargetAlphabet::HEBREW_22>[22] == 1u << 10, "final kaf folds onto kaf");
+
+    template <TargetAlphabet Target, int NibbleCount>
+    void buildTable(const Permutation& permutation, LookupTable& table) {
+        for (int n = 0; n < NibbleCount; ++n) {
+            table.nibbleLookup[n][0] = 0;
+
+            // Each entry extends the entry without its lowest bit by one mapped letter
+            for (uint32_t v = 1; v < 16; ++v) {
+                int letter = n * 4 + BitUtils::countTrailingZeros(v);
+                uint32_t bit = (letter < Word::ALPHABET_SIZE) ? TARGET_BITS<Target>[permutation[letter]] : 0u;
+                table.nibbleLookup[n][v] = table.nibbleLookup[n][v & (v - 1)] | bit;
+            }
+        }
+
+        // No corpus mask has bits there, so only their empty entry is ever read (by the SIMD kernels)
+        for (int n = NibbleCount; n < MAX_NIBBLES; ++n) {
+            table.nibbleLookup[n][0] = 0;
+        }
+    }
+
+    // Expanded by the fold rather than left to the optimizer, which need not unroll the nibble loop
+    template <size_t... Nibbles>
+    inline uint32_t translateNibbles(const LookupTable& table, uint32_t evaMask, std::index_sequence<Nibbles...>) {
+        return (table.nibbleLookup[Nibbles][(evaMask >> (4 * Nibbles)) & 0xF] | ... | 0u);
+    }
+
+    template <int NibbleCount>
+    inline uint32_t translateMask(const LookupTable& table, uint32_t evaMask) {
+        return translateNibbles(table, evaMask, std::make_index_sequence<NibbleCount>());
+    }
+
+    template <int NibbleCount>
+    void translateRange(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            hebrewMasks[i] = translateMask<NibbleCount>(table, evaMasks[i]);
+        }
+    }
+
+    // BucketMasks translated with a constant trip count, then the remainder of count
+    template <int NibbleCount, size_t BucketMasks>
+    void translateBucket(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count) {
+        for (size_t i = 0; i < BucketMasks; ++i) {
+            hebrewMasks[i] = translateMask<NibbleCount>(table, evaMasks[i]);
+        }
+        for (size_t i = BucketMasks; i < count; ++i) {
+            hebrewMasks[i] = translateMask<NibbleCount>(table, evaMasks[i]);
+        }
+    }
+
+    // Dispatch tables; entry k of a nibble table is for k + 1 nibbles, entry b of a bucket
+    // table for (b + 1) * BUCKET_STEP masks
+    template <TargetAlphabet Target, int... Nibbles>
+    constexpr std::array<ScoringKernels::BuildTableKernel, sizeof...(Nibbles)> makeBuildKernels(std::integer_sequence<int, Nibbles...>) {
+        return { { &buildTable<Target, Nibbles + 1>... } };
+    }
+
+    template <int... Nibbles>
+    constexpr std::array<ScoringKernels::TranslateKernel, sizeof...(Nibbles)> makeRangeKernels(std::integer_sequence<int, Nibbles...>) {
+        return { { &translateRange<Nibbles + 1>... } };
+    }
+
+    template <int NibbleCount, size_t... Buckets>
+    constexpr std::array<ScoringKernels::TranslateKernel, sizeof...(Buckets)> makeBucketKernels(std::index_sequence<Buckets...>) {
+        return { { &translateBucket<NibbleCount, (Buckets + 1) * ScoringKernels::BUCKET_STEP>... } };
+    }
+
+    template <int... Nibbles>
+    constexpr std::array<std::array<ScoringKernels::TranslateKernel, ScoringKernels::BUCKET_COUNT>, sizeof...(Nibbles)>
+    makeBucketKernelsPerNibble(std::integer_sequence<int, Nibbles...>) {
+        return { { makeBucketKernels<Nibbles + 1>(std::make_index_sequence<ScoringKernels::BUCKET_COUNT>())... } };
+    }
+
+    using NibbleSequence = std::make_integer_sequence<int, MAX_NIBBLES>;
+
+    constexpr auto BUILD_KERNELS_27 = makeBuildKernels<TargetAlphabet::HEBREW_27>(NibbleSequence());
+    constexpr auto BUILD_KERNELS_22 = makeBuildKernels<TargetAlphabet::HEBREW_22>(NibbleSequence());
+    constexpr auto RANGE_KERNELS = makeRangeKernels(NibbleSequence());
+    constexpr auto BUCKET_KERNELS = makeBucketKernelsPerNibble(NibbleSequence());
+}
+
+int ScoringKernels::nibblesFor(uint32_t letterUnion) {
+    letterUnion &= Word::FULL_MASK;
+    int nibbles = 1;
+    while (nibbles < MAX_NIBBLES && (letterUnion >> (4 * nibbles)) != 0) {
+        ++nibbles;
+    }
+    return nibbles;
+}
+
+ScoringKernels::KernelSet ScoringKernels::select(TargetAlphabet target, uint32_t letterUnion, size_t maskCount) {
+    KernelSet kernels;
+    kernels.target = target;
+    kernels.nibbleCount = nibblesFor(letterUnion);
+
+    size_t nibbleIndex = static_cast<size_t>(kernels.nibbleCount - 1);
+    kernels.buildTable = (target == TargetAlphabet::HEBREW_22) ? BUILD_KERNELS_22[nibbleIndex] : BUILD_KERNELS_27[nibbleIndex];
+    kernels.translateRange = RANGE_KERNELS[nibbleIndex];
+
+    // Largest bucket the corpus fills; beyond the last one the counted loop is as good
+    size_t bucket = maskCount / BUCKET_STEP;
+    if (bucket == 0 || maskCount > MAX_BUCKET_MASKS) {
+        kernels.translateCorpus = kernels.translateRange;
+        kernels.bucketMasks = 0;
+    } else {
+        kernels.translateCorpus = BUCKET_KERNELS[nibbleIndex][bucket - 1];
+        kernels.bucketMasks = bucket * BUCKET_STEP;
+    }
+    return kernels;
+}
+
+void ScoringKernels::foldTable(TargetAlphabet target, LookupTable& table) {
+    if (target != TargetAlphabet::HEBREW_22) {
+        return;
+    }
+    for (auto& nibble : table.nibbleLookup) {
+        for (uint32_t& entry : nibble) {
+            entry = Word::foldFinalForms(entry);
+        }
+    }
+}
+
+std::string ScoringKernels::getTargetAlphabetName(TargetAlphabet target) {
+    switch (target) {
+        case TargetAlphabet::HEBREW_27: return "HEBREW_27";
+        case TargetAlphabet::HEBREW_22: return "HEBREW_22";
+    }
+    return "UNKNOWN";
+}
+
+std::string ScoringKernels::describe(const KernelSet& kernels) {
+    std::string description = getTargetAlphabetName(kernels.target) + " target, " +
+                              std::to_string(kernels.nibbleCount) + " of " + std::to_string(MAX_NIBBLES) + " nibbles, ";
+    if (kernels.bucketMasks > 0) {
+        description += std::to_string(kernels.bucketMasks) + "-mask compiled body";
+    } else {
+        description += "counted loop";
+    }
+    return description;
+}
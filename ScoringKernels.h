@@ -0,0 +1,49 @@
+#pragma once
+
+#include "PermutationTranslator.h"
+#include "Word.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Translation kernels specialised at compile time for what a corpus fixes for a whole run:
+// the target alphabet, how many EVA nibbles its masks use (set by the highest EVA letter it
+// contains) and, rounded down to a bucket, how many distinct masks it has. Each combination is
+// its own instantiation with constant trip counts and constexpr letter tables, so the nibble
+// loop is unrolled, unused nibbles are neither built nor read, and folding final forms costs
+// nothing per word. select() picks the instantiation once, when a decoder is initialized.
+class ScoringKernels {
+public:
+    using LookupTable = PermutationTranslator::LookupTable;
+
+    // Corpora up to MAX_BUCKET_MASKS masks get a body of BUCKET_STEP multiples unrolled at compile
+    // time (the remainder is a short loop); larger corpora use the counted kernel throughout
+    static constexpr size_t BUCKET_STEP = 16;
+    static constexpr size_t BUCKET_COUNT = 16;
+    static constexpr size_t MAX_BUCKET_MASKS = BUCKET_STEP * BUCKET_COUNT;
+
+    using BuildTableKernel = void (*)(const Permutation& permutation, LookupTable& table);
+    using TranslateKernel = void (*)(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count);
+
+    struct KernelSet {
+        BuildTableKernel buildTable;          // Target letters folded in; unused nibbles keep only entry 0
+        TranslateKernel translateCorpus;      // The whole mask table (count = the corpus size it was selected for)
+        TranslateKernel translateRange;       // Any part of it (bounded scoring chunks)
+        TargetAlphabet target;
+        int nibbleCount;                      // Low nibbles of the EVA masks that hold letters
+        size_t bucketMasks;                   // Masks handled by the compile-time body (0 = counted loop only)
+    };
+
+    // Instantiation for a corpus of maskCount masks whose letters are ORed into letterUnion.
+    // Tables it builds may also be passed to the SIMD kernels.
+    static KernelSet select(TargetAlphabet target, uint32_t letterUnion, size_t maskCount);
+
+    // Nibbles needed to cover every letter in letterUnion (at least one)
+    static int nibblesFor(uint32_t letterUnion);
+
+    // Fold a table built for the 27-letter target (Mapping-based tables, not on hot paths)
+    static void foldTable(TargetAlphabet target, LookupTable& table);
+
+    static std::string getTargetAlphabetName(TargetAlphabet target);
+    static std::string describe(const KernelSet& kernels);
+};
@@ -0,0 +1,206 @@
+#include "SearchSpace.h"
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+
+namespace {
+    uint64_t saturatingMultiply(uint64_t a, uint64_t b) {
+        if (a != 0 && b > UINT64_MAX / a) {
+            return UINT64_MAX;
+        }
+        return a * b;
+    }
+    
+    char evaLetterName(int letter) {
+        return letter < 26 ? static_cast<char>('a' + letter) : '_';
+    }
+}
+
+SearchSpace::SearchSpace() : fullOrdering(true), runPosition(Word::ALPHABET_SIZE - FULL_TAIL_LENGTH) {
+    // 64-bit factorials exactly as the original unranking computed them (21! and above wrap)
+    uint64_t factorials[Word::ALPHABET_SIZE + 1];
+    factorials[0] = 1;
+    exactSize = 1.0;
+    for (int n = 1; n <= Word::ALPHABET_SIZE; ++n) {
+        factorials[n] = factorials[n - 1] * static_cast<uint64_t>(n);
+        exactSize *= n;
+    }
+    
+    for (int p = 0; p < Word::ALPHABET_SIZE; ++p) {
+        table.weights[p] = factorials[Word::ALPHABET_SIZE - 1 - p];
+        table.letters[p] = static_cast<uint8_t>(p);
+    }
+    table.rankedCount = Word::ALPHABET_SIZE;
+    size = FULL_INDEX_COUNT;
+}
+
+SearchSpace::SearchSpace(const uint8_t* letters, int usedLetterCount) : fullOrdering(false), runPosition(usedLetterCount - 1) {
+    std::memcpy(table.letters, letters, sizeof(table.letters));
+    table.rankedCount = static_cast<uint8_t>(usedLetterCount);
+    
+    // Position p chooses among 27 - p Hebrew letters, so its weight is the number of ways to
+    // fill the ranked positions after it: (26 - p)! / (27 - k)!
+    const int firstUnusedFactor = Word::ALPHABET_SIZE + 1 - usedLetterCount;
+    for (int p = 0; p < Word::ALPHABET_SIZE; ++p) {
+        uint64_t weight = 1;
+        for (int factor = Word::ALPHABET_SIZE - 1 - p; factor >= firstUnusedFactor; --factor) {
+            weight = saturatingMultiply(weight, static_cast<uint64_t>(factor));
+        }
+        table.weights[p] = p < usedLetterCount ? weight : 1;
+    }
+    
+    // Weights only saturate at leading positions. Every index below UINT64_MAX then gives those
+    // positions digit 0 and the first exact weight a digit still in range, so the indices are
+    // distinct assignments: a prefix of the space with the rarest letters' first choices fixed.
+    size = saturatingMultiply(table.weights[0], Word::ALPHABET_SIZE);
+    exactSize = 1.0;
+    for (int factor = Word::ALPHABET_SIZE; factor >= firstUnusedFactor; --factor) {
+        exactSize *= factor;
+    }
+}
+
+const SearchSpace& SearchSpace::full() {
+    static const SearchSpace fullSpace;
+    return fullSpace;
+}
+
+SearchSpace SearchSpace::forWords(const WordSet& words) {
+    int wordCounts[Word::ALPHABET_SIZE] = {};
+    for (uint32_t mask : words.getLetterMasks()) {
+        for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+            wordCounts[letter] += (mask >> letter) & 1;
+        }
+    }
+    
+    std::vector<uint8_t> used, unused;
+    for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+        (wordCounts[letter] > 0 ? used : unused).push_back(static_cast<uint8_t>(letter));
+    }
+    if (used.empty() || unused.empty()) {
+        return full();
+    }
+    
+    // Rarest letters first: they take the most significant digits
+    std::stable_sort(used.begin(), used.end(), [&wordCounts](uint8_t a, uint8_t b) {
+        return wordCounts[a] < wordCounts[b];
+    });
+    
+    uint8_t letters[Word::ALPHABET_SIZE];
+    std::copy(used.begin(), used.end(), letters);
+    std::copy(unused.begin(), unused.end(), letters + used.size());
+    return SearchSpace(letters, static_cast<int>(used.size()));
+}
+
+bool SearchSpace::fromLetterOrder(const uint8_t* letters, int usedLetterCount, SearchSpace& space) {
+    if (usedLetterCount < 1 || usedLetterCount > Word::ALPHABET_SIZE) {
+        return false;
+    }
+    
+    uint32_t seen = 0;
+    for (int p = 0; p < Word::ALPHABET_SIZE; ++p) {
+        if (letters[p] >= Word::ALPHABET_SIZE || (seen >> letters[p]) & 1) {
+            return false;
+        }
+        seen |= 1u << letters[p];
+    }
+    
+    if (usedLetterCount == Word::ALPHABET_SIZE) {
+        // Only the legacy ordering ranks every letter
+        const SearchSpace& fullSpace = full();
+        if (std::memcmp(letters, fullSpace.table.letters, sizeof(fullSpace.table.letters)) != 0) {
+            return false;
+        }
+        space = fullSpace;
+        return true;
+    }
+    
+    space = SearchSpace(letters, usedLetterCount);
+    return true;
+}
+
+void SearchSpace::unrank(uint64_t index, Permutation& permutation) const {
+    uint8_t available[Word::ALPHABET_SIZE];
+    for (int i = 0; i < Word::ALPHABET_SIZE; ++i) {
+        available[i] = static_cast<uint8_t>(i);
+    }
+    
+    // Mixed-radix digits, including the original clamp for oversized digits
+    uint64_t remaining = index;
+    int availableCount = Word::ALPHABET_SIZE;
+    for (int p = 0; p < table.rankedCount; ++p) {
+        uint64_t weight = table.weights[p];
+        uint64_t chosenIndex = remaining / weight;
+        
+        if (chosenIndex >= static_cast<uint64_t>(availableCount)) {
+            chosenIndex = availableCount - 1;
+        }
+        
+        permutation[table.letters[p]] = available[chosenIndex];
+        for (int i = static_cast<int>(chosenIndex); i + 1 < availableCount; ++i) {
+            available[i] = available[i + 1];
+        }
+        availableCount--;
+        remaining %= weight;
+    }
+    
+    // Unused letters take what is left, in ascending order
+    for (int p = table.rankedCount; p < Word::ALPHABET_SIZE; ++p) {
+        permutation[table.letters[p]] = available[p - table.rankedCount];
+    }
+}
+
+uint64_t SearchSpace::stepsUntilPrefixChange(uint64_t index) const {
+    // A leading digit changes exactly when one of the leading remainders wraps around
+    uint64_t steps = UINT64_MAX;
+    uint64_t remaining = index;
+    for (int p = 0; p < runPosition; ++p) {
+        uint64_t weight = table.weights[p];
+        remaining %= weight;
+        steps = std::min(steps, weight - remaining);
+    }
+    
+    return steps;
+}
+
+void SearchSpace::stepToNext(Permutation& permutation) const {
+    if (fullOrdering) {
+        // Same leading positions: the next index is the next lexicographic tail
+        std::next_permutation(permutation.begin() + runPosition, permutation.end());
+        return;
+    }
+    
+    // The last used letter moves to the next free Hebrew letter, which it swaps with the
+    // unused letter holding it; the unused letters stay in ascending order
+    uint8_t& last = permutation[table.letters[runPosition]];
+    for (int p = table.rankedCount; p < Word::ALPHABET_SIZE; ++p) {
+        uint8_t& filler = permutation[table.letters[p]];
+        if (filler > last) {
+            std::swap(filler, last);
+            return;
+        }
+    }
+}
+
+std::string SearchSpace::describe() const {
+    std::ostringstream out;
+    if (fullOrdering) {
+        out << "full space: 27! permutations, " << size << " indexed";
+        return out.str();
+    }
+    
+    out << "reduced space: " << static_cast<int>(table.rankedCount) << " of " << Word::ALPHABET_SIZE
+        << " EVA letters used (rarest first: ";
+    for (int p = 0; p < table.rankedCount; ++p) {
+        out << evaLetterName(table.letters[p]);
+    }
+    out << "), " << exactSize << " assignments";
+    if (isTruncated()) {
+        out << ", first " << size << " indexed";
+    }
+    return out.str();
+}
+
+bool SearchSpace::operator==(const SearchSpace& other) const {
+    return fullOrdering == other.fullOrdering && table.rankedCount == other.table.rankedCount &&
+           std::memcmp(table.letters, other.table.letters, sizeof(table.letters)) == 0;
+}
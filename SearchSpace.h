@@ -0,0 +1,80 @@
+#pragma once
+
+#include "PermutationTranslator.h"
+#include "WordSet.h"
+#include <string>
+#include <cstdint>
+
+// The set of EVA->Hebrew permutations a search enumerates, and how a generator index is turned
+// into one. A translated word only depends on the Hebrew letters given to the EVA letters it
+// contains, so permutations that differ only in letters the corpus never uses score the same.
+// The full space is the legacy 27! ordering; a reduced space ranks only the injective
+// assignments of the k used letters, 27!/(27-k)! of them, and gives the unused letters the
+// left-over Hebrew letters in ascending order.
+class SearchSpace {
+public:
+    // Positions whose digits the full space steps lexicographically (exact 64-bit factorials)
+    static constexpr int FULL_TAIL_LENGTH = 21;
+    
+    // Indices of the full space: the leading digits of 27!, as the generator always counted them
+    static constexpr uint64_t FULL_INDEX_COUNT = 10888869450418352160ULL;
+    
+    // Everything needed to unrank an index, as a flat copyable block (also passed to the GPU).
+    // Position p assigns EVA letter letters[p]; only the first rankedCount positions take a
+    // digit, the rest receive the remaining Hebrew letters in ascending order.
+    struct UnrankTable {
+        uint64_t weights[Word::ALPHABET_SIZE];    // Index weight of each ranked position
+        uint8_t letters[Word::ALPHABET_SIZE];     // EVA letter at each position
+        uint8_t rankedCount;
+    };
+
+private:
+    UnrankTable table;
+    bool fullOrdering;      // Legacy 27! ordering
+    uint64_t size;          // Indices covered (saturates at UINT64_MAX)
+    double exactSize;       // Assignments in the space, which may exceed the 64-bit index
+    int runPosition;        // First position of the stepped tail (stepsUntilPrefixChange)
+    
+    SearchSpace(const uint8_t* letters, int usedLetterCount);
+
+public:
+    // The full legacy space
+    SearchSpace();
+    static const SearchSpace& full();
+    
+    // Injective assignments of the letters that occur in words. The rarest letters take the
+    // leading digits, so when the space outgrows the 64-bit index it is their choices that
+    // are cut short. A corpus using every letter (or none) gives the full space.
+    static SearchSpace forWords(const WordSet& words);
+    
+    // Rebuild a space from its letter order (state files); false if the order is not a
+    // permutation of the EVA letters or the count is out of range
+    static bool fromLetterOrder(const uint8_t* letters, int usedLetterCount, SearchSpace& space);
+    
+    bool isFull() const { return fullOrdering; }
+    int getUsedLetterCount() const { return table.rankedCount; }
+    const uint8_t* getLetterOrder() const { return table.letters; }
+    const UnrankTable& getUnrankTable() const { return table; }
+    
+    // Number of generator indices, and the true number of assignments (larger when truncated)
+    uint64_t getSize() const { return size; }
+    double getExactSize() const { return exactSize; }
+    bool isTruncated() const { return exactSize > static_cast<double>(size); }
+    
+    // Allocation-free index -> permutation conversion. For the full space this is exactly
+    // MappingGenerator's legacy ordering, including its wrapped factorials and digit clamp.
+    void unrank(uint64_t index, Permutation& permutation) const;
+    
+    // Number of consecutive indices starting at index that stepToNext can walk from the
+    // permutation of index without unranking again
+    uint64_t stepsUntilPrefixChange(uint64_t index) const;
+    
+    // Turn the permutation of an index into that of the next index of the same run
+    void stepToNext(Permutation& permutation) const;
+    
+    // One-line summary for startup output and logs
+    std::string describe() const;
+    
+    bool operator==(const SearchSpace& other) const;
+    bool operator!=(const SearchSpace& other) const { return !(*this == other); }
+};
@@ -1,6 +1,9 @@
 #include "StaticTranslator.h"
 #include <atomic>
 #include <sstream>
+#include <mutex>
+#include <map>
+#include <algorithm>
 
 #ifdef __NVCC__
 #include <cuda_runtime.h>
@@ -19,11 +22,35 @@ namespace {
     thread_local size_t g_poolSizeTransform = 0;
     thread_local size_t g_poolSizeResult = 0;
     
+    // Device-resident lexicon bitset for fused scoring, one per CUDA device (shared by all
+    // threads bound to that device)
+    struct DeviceLexicon {
+        std::weak_ptr<const HebrewLexicon> owner;
+        uint64_t* bits = nullptr;
+    };
+    std::mutex g_deviceLexiconMutex;
+    std::map<int, DeviceLexicon> g_deviceLexicons;
+    
+    // Grow-only device buffers for the matrix batch path (no cudaMalloc/cudaFree per call)
+    thread_local void* g_deviceTransformBatchPool = nullptr;
+    thread_local void* g_deviceResultBatchPool = nullptr;
+    thread_local size_t g_poolSizeTransformBatch = 0;
+    thread_local size_t g_poolSizeResultBatch = 0;
+    
     // Maximum batch size for optimal GPU utilization
     constexpr size_t MAX_BATCH_WORDS = 10000;     // Process up to 10K words at once
     constexpr size_t MAX_BATCH_MAPPINGS = 50000; // Process up to 50K mappings at once (reasonable GPU memory usage)
     constexpr size_t MATRIX_DIM = 27;
     
+    // Fused scoring layout: one thread block per mapping, one flattened lookup table per mapping
+    constexpr int SCORE_THREADS_PER_MAPPING = 128;
+    constexpr int SCORE_STREAM_COUNT = 2;        // Fused scoring chunks in flight per thread
+    constexpr int TABLE_ENTRIES = PermutationTranslator::NIBBLE_COUNT * 16;
+    constexpr uint32_t LETTER_MASK = (1u << MATRIX_DIM) - 1;
+    constexpr size_t LEXICON_BITSET_WORDS = (static_cast<size_t>(1) << MATRIX_DIM) / 64;
+    static_assert(sizeof(PermutationTranslator::LookupTable) == TABLE_ENTRIES * sizeof(uint32_t),
+                  "Lookup tables are uploaded as flat uint32_t arrays");
+    
     // Simplified CUDA kernel without shared memory to debug the issue
     __global__ void binaryMatrixMultiplyKernel(
         const int* __restrict__ inputMatrix,      // N x 27 matrix (flattened)
@@ -86,6 +113,161 @@ namespace {
         resultBatch[resultIndex] = (sum > 0) ? 1 : 0;
     }
     
+    // Count the words of one mapping found in the lexicon; called by every thread of the block.
+    // The masks are translated through the mapping's lookup table staged in shared memory, and
+    // each match counts the number of words its mask stands for.
+    __device__ uint32_t countLexiconMatches(
+        const uint32_t* table,                        // TABLE_ENTRIES entries (shared memory)
+        const uint32_t* __restrict__ evaMasks,
+        const uint32_t* __restrict__ maskWeights,
+        int numWords,
+        const uint64_t* __restrict__ lexiconBits
+    ) {
+        __shared__ uint32_t blockMatched;
+        if (threadIdx.x == 0) {
+            blockMatched = 0;
+        }
+        __syncthreads();
+        
+        uint32_t matched = 0;
+        for (int word = threadIdx.x; word < numWords; word += blockDim.x) {
+            // Same nibble walk as PermutationTranslator::translateMasks
+            uint32_t remaining = evaMasks[word];
+            uint32_t mask = 0;
+            for (int n = 0; n < PermutationTranslator::NIBBLE_COUNT; ++n) {
+                mask |= table[n * 16 + (remaining & 15)];
+                remaining >>= 4;
+            }
+            
+            // Same probe as the BITSET backend: mask 0 is never set, stray bits are rejected
+            uint32_t index = mask & LETTER_MASK;
+            uint32_t isMatch = static_cast<uint32_t>(((lexiconBits[index >> 6] >> (index & 63)) & 1) & (index == mask));
+            matched += isMatch * maskWeights[word];
+        }
+        
+        // One shared-memory add per thread instead of a barrier per word group
+        atomicAdd(&blockMatched, matched);
+        __syncthreads();
+        return blockMatched;
+    }
+    
+    // Thread 0 writes the mapping's count and appends it to the high-score list if it qualifies
+    __device__ void storeMappingScore(
+        int mappingId,
+        uint32_t matched,
+        uint32_t minMatched,
+        uint32_t* __restrict__ matchedCounts,
+        uint32_t* __restrict__ highScoreIndices,
+        uint32_t* __restrict__ highScoreCount
+    ) {
+        if (threadIdx.x == 0) {
+            matchedCounts[mappingId] = matched;
+            if (matched >= minMatched) {
+                highScoreIndices[atomicAdd(highScoreCount, 1u)] = static_cast<uint32_t>(mappingId);
+            }
+        }
+    }
+    
+    // Fused translate + validate kernel: each block translates every word through its mapping's
+    // uploaded lookup table and probes the lexicon bitset. Only the per-mapping matched count
+    // and the indices reaching minMatched are written out.
+    __global__ void fusedTranslateScoreKernel(
+        const uint32_t* __restrict__ evaMasks,        // numWords packed EVA masks
+        const uint32_t* __restrict__ maskWeights,     // Words per mask
+        int numWords,
+        const uint32_t* __restrict__ tables,          // numMappings x TABLE_ENTRIES lookup entries
+        int numMappings,
+        const uint64_t* __restrict__ lexiconBits,     // One bit per 27-bit Hebrew mask
+        uint32_t minMatched,
+        uint32_t* __restrict__ matchedCounts,         // numMappings matched-word counts
+        uint32_t* __restrict__ highScoreIndices,      // Mapping indices with >= minMatched matches
+        uint32_t* __restrict__ highScoreCount         // Number of entries in highScoreIndices
+    ) {
+        __shared__ uint32_t table[TABLE_ENTRIES];
+        
+        int mappingId = blockIdx.x;
+        if (mappingId >= numMappings) return;  // Uniform across the block
+        
+        const uint32_t* mappingTable = &tables[static_cast<size_t>(mappingId) * TABLE_ENTRIES];
+        for (int i = threadIdx.x; i < TABLE_ENTRIES; i += blockDim.x) {
+            table[i] = mappingTable[i];
+        }
+        __syncthreads();
+        
+        uint32_t matched = countLexiconMatches(table, evaMasks, maskWeights, numWords, lexiconBits);
+        storeMappingScore(mappingId, matched, minMatched, matchedCounts, highScoreIndices, highScoreCount);
+    }
+    
+    // Fused kernel that also generates the mappings: block b scores global permutation index
+    // startIndex + b. The index is unranked exactly like SearchSpace::unrank (for the full
+    // space: legacy wrapping 64-bit factorials and digit clamp), so block accounting is unchanged.
+    __global__ void fusedUnrankScoreKernel(
+        const uint32_t* __restrict__ evaMasks,        // numWords packed EVA masks
+        const uint32_t* __restrict__ maskWeights,     // Words per mask
+        int numWords,
+        uint64_t startIndex,                          // Global index of the first mapping
+        int numMappings,
+        SearchSpace::UnrankTable space,               // Digit weights and letter order of the space
+        const uint64_t* __restrict__ lexiconBits,     // One bit per 27-bit Hebrew mask
+        uint32_t minMatched,
+        uint32_t* __restrict__ matchedCounts,         // numMappings matched-word counts
+        uint32_t* __restrict__ highScoreIndices,      // Offsets from startIndex with >= minMatched matches
+        uint32_t* __restrict__ highScoreCount         // Number of entries in highScoreIndices
+    ) {
+        __shared__ uint8_t permutation[MATRIX_DIM];
+        __shared__ uint32_t table[TABLE_ENTRIES];
+        
+        int mappingId = blockIdx.x;
+        if (mappingId >= numMappings) return;  // Uniform across the block
+        
+        // Unranking is inherently sequential but only 27 digits long
+        if (threadIdx.x == 0) {
+            uint8_t available[MATRIX_DIM];
+            for (int i = 0; i < static_cast<int>(MATRIX_DIM); ++i) {
+                available[i] = static_cast<uint8_t>(i);
+            }
+            
+            uint64_t remaining = startIndex + static_cast<uint64_t>(mappingId);
+            int availableCount = static_cast<int>(MATRIX_DIM);
+            for (int p = 0; p < space.rankedCount; ++p) {
+                uint64_t weight = space.weights[p];
+                uint64_t chosenIndex = remaining / weight;
+                if (chosenIndex >= static_cast<uint64_t>(availableCount)) {
+                    chosenIndex = availableCount - 1;
+                }
+                
+                permutation[space.letters[p]] = available[chosenIndex];
+                for (int i = static_cast<int>(chosenIndex); i + 1 < availableCount; ++i) {
+                    available[i] = available[i + 1];
+                }
+                availableCount--;
+                remaining %= weight;
+            }
+            for (int p = space.rankedCount; p < static_cast<int>(MATRIX_DIM); ++p) {
+                permutation[space.letters[p]] = available[p - space.rankedCount];
+            }
+        }
+        __syncthreads();
+        
+        // Each table entry is the OR of the mapped bits of the letters in its nibble value
+        for (int i = threadIdx.x; i < TABLE_ENTRIES; i += blockDim.x) {
+            int nibble = i / 16;
+            uint32_t value = static_cast<uint32_t>(i % 16);
+            uint32_t entry = 0;
+            for (int bit = 0; bit < 4; ++bit) {
+                int letter = nibble * 4 + bit;
+                if (((value >> bit) & 1) && letter < static_cast<int>(MATRIX_DIM)) {
+                    entry |= 1u << permutation[letter];
+                }
+            }
+            table[i] = entry;
+        }
+        __syncthreads();
+        
+        uint32_t matched = countLexiconMatches(table, evaMasks, maskWeights, numWords, lexiconBits);
+        storeMappingScore(mappingId, matched, minMatched, matchedCounts, highScoreIndices, highScoreCount);
+    }
+    
     void initializeCudaResources() {
         if (g_isInitialized.load()) return;
         
@@ -143,10 +325,213 @@ namespace {
             g_deviceResultPool = nullptr;
             g_poolSizeResult = 0;
         }
+        cudaFree(g_deviceTransformBatchPool);
+        cudaFree(g_deviceResultBatchPool);
+        g_deviceTransformBatchPool = nullptr;
+        g_deviceResultBatchPool = nullptr;
+        g_poolSizeTransformBatch = 0;
+        g_poolSizeResultBatch = 0;
+    }
+    
+    void throwOnCudaError(cudaError_t error, const char* what) {
+        if (error != cudaSuccess) {
+            throw std::runtime_error(std::string(what) + ": " + cudaGetErrorString(error));
+        }
+    }
+    
+    int currentDevice() {
+        int device = 0;
+        throwOnCudaError(cudaGetDevice(&device), "CUDA device query failed");
+        return device;
+    }
+    
+    // Upload the lexicon to the current device as a flat bitset the first time it is used there
+    // (or when it changes)
+    const uint64_t* ensureDeviceLexicon(const std::shared_ptr<const HebrewLexicon>& lexicon) {
+        std::lock_guard<std::mutex> lock(g_deviceLexiconMutex);
+        DeviceLexicon& deviceLexicon = g_deviceLexicons[currentDevice()];
+        if (deviceLexicon.bits && deviceLexicon.owner.lock() == lexicon) {
+            return deviceLexicon.bits;
+        }
+        
+        std::vector<uint64_t> bits(LEXICON_BITSET_WORDS, 0);
+        for (uint32_t mask : lexicon->getDistinctMasks()) {
+            bits[mask >> 6] |= static_cast<uint64_t>(1) << (mask & 63);
+        }
+        
+        if (!deviceLexicon.bits) {
+            throwOnCudaError(cudaMalloc(&deviceLexicon.bits, LEXICON_BITSET_WORDS * sizeof(uint64_t)),
+                             "CUDA lexicon allocation failed");
+        }
+        throwOnCudaError(cudaMemcpy(deviceLexicon.bits, bits.data(), LEXICON_BITSET_WORDS * sizeof(uint64_t), cudaMemcpyHostToDevice),
+                         "CUDA lexicon copy failed");
+        
+        // A pageable upload may still be in flight on return; scoring streams do not wait for it
+        throwOnCudaError(cudaDeviceSynchronize(), "CUDA lexicon copy failed");
+        deviceLexicon.owner = lexicon;
+        return deviceLexicon.bits;
+    }
+    
+    // One in-flight chunk of fused scoring: its stream, device outputs and pinned host copies
+    struct ScoringSlot {
+        cudaStream_t stream = nullptr;
+        uint32_t* deviceMatchedCounts = nullptr;
+        uint32_t* deviceHighScoreIndices = nullptr;
+        uint32_t* deviceHighScoreCount = nullptr;
+        uint32_t* hostMatchedCounts = nullptr;         // Pinned, so downloads run asynchronously
+        uint32_t* hostHighScoreIndices = nullptr;      // Pinned
+        uint32_t* hostHighScoreCount = nullptr;        // Pinned
+        size_t capacity = 0;                           // Mappings per chunk the buffers hold
+        uint64_t chunkStart = 0;
+        size_t chunkCount = 0;
+        bool inFlight = false;
+        bool timed = false;                            // Events below were recorded for this chunk
+        cudaEvent_t issuedEvent = nullptr;             // Before the counter reset
+        cudaEvent_t scoredEvent = nullptr;             // After the kernel, before the downloads
+        cudaEvent_t downloadedEvent = nullptr;         // After the downloads
+        
+        void releaseChunkBuffers() {
+            cudaFree(deviceMatchedCounts);
+            cudaFree(deviceHighScoreIndices);
+            cudaFreeHost(hostMatchedCounts);
+            cudaFreeHost(hostHighScoreIndices);
+            deviceMatchedCounts = nullptr;
+            deviceHighScoreIndices = nullptr;
+            hostMatchedCounts = nullptr;
+            hostHighScoreIndices = nullptr;
+            capacity = 0;
+        }
+    };
+    
+    // Persistent per-thread fused scoring state. Streams and buffers are created on first use
+    // and only grow, so steady-state batches allocate nothing and never touch pageable memory.
+    struct ScoringContext {
+        int device = -1;                               // Device the streams and buffers live on
+        ScoringSlot slots[SCORE_STREAM_COUNT];
+        uint32_t* deviceEvaMasks = nullptr;
+        uint32_t* deviceMaskWeights = nullptr;         // Words per mask, parallel to deviceEvaMasks
+        uint32_t* deviceTables = nullptr;
+        size_t wordCapacity = 0;
+        size_t tableCapacity = 0;
+        
+        ~ScoringContext() {
+            release();
+        }
+        
+        void ensureSlots(size_t chunkCapacity) {
+            for (ScoringSlot& slot : slots) {
+                if (!slot.stream) {
+                    // Non-blocking, so other threads' default-stream work never serializes with it
+                    throwOnCudaError(cudaStreamCreateWithFlags(&slot.stream, cudaStreamNonBlocking), "CUDA stream creation failed");
+                }
+                if (!slot.issuedEvent) {
+                    throwOnCudaError(cudaEventCreate(&slot.issuedEvent), "CUDA event creation failed");
+                    throwOnCudaError(cudaEventCreate(&slot.scoredEvent), "CUDA event creation failed");
+                    throwOnCudaError(cudaEventCreate(&slot.downloadedEvent), "CUDA event creation failed");
+                }
+                if (!slot.deviceHighScoreCount) {
+                    throwOnCudaError(cudaMalloc(&slot.deviceHighScoreCount, sizeof(uint32_t)), "CUDA counter allocation failed");
+                    throwOnCudaError(cudaMallocHost(&slot.hostHighScoreCount, sizeof(uint32_t)), "CUDA pinned counter allocation failed");
+                }
+                if (slot.capacity < chunkCapacity) {
+                    slot.releaseChunkBuffers();
+                    throwOnCudaError(cudaMalloc(&slot.deviceMatchedCounts, chunkCapacity * sizeof(uint32_t)), "CUDA count buffer allocation failed");
+                    throwOnCudaError(cudaMalloc(&slot.deviceHighScoreIndices, chunkCapacity * sizeof(uint32_t)), "CUDA index buffer allocation failed");
+                    throwOnCudaError(cudaMallocHost(&slot.hostMatchedCounts, chunkCapacity * sizeof(uint32_t)), "CUDA pinned count allocation failed");
+                    throwOnCudaError(cudaMallocHost(&slot.hostHighScoreIndices, chunkCapacity * sizeof(uint32_t)), "CUDA pinned index allocation failed");
+                    slot.capacity = chunkCapacity;
+                }
+            }
+        }
+        
+        void ensureWords(size_t numWords) {
+            if (wordCapacity < numWords) {
+                cudaFree(deviceEvaMasks);
+                cudaFree(deviceMaskWeights);
+                deviceEvaMasks = nullptr;
+                deviceMaskWeights = nullptr;
+                wordCapacity = 0;
+                throwOnCudaError(cudaMalloc(&deviceEvaMasks, numWords * sizeof(uint32_t)), "CUDA word buffer allocation failed");
+                throwOnCudaError(cudaMalloc(&deviceMaskWeights, numWords * sizeof(uint32_t)), "CUDA weight buffer allocation failed");
+                wordCapacity = numWords;
+            }
+        }
+        
+        // Lookup tables are only uploaded when the host generated the mappings
+        void ensureTables(size_t numMappings) {
+            if (tableCapacity < numMappings) {
+                cudaFree(deviceTables);
+                deviceTables = nullptr;
+                tableCapacity = 0;
+                throwOnCudaError(cudaMalloc(&deviceTables, numMappings * TABLE_ENTRIES * sizeof(uint32_t)), "CUDA table buffer allocation failed");
+                tableCapacity = numMappings;
+            }
+        }
+        
+        // Wait out chunks abandoned by an early stop or an exception
+        void drain() {
+            for (ScoringSlot& slot : slots) {
+                if (slot.inFlight) {
+                    cudaStreamSynchronize(slot.stream);
+                    slot.inFlight = false;
+                    slot.timed = false;
+                }
+            }
+        }
+        
+        void release() {
+            drain();
+            for (ScoringSlot& slot : slots) {
+                slot.releaseChunkBuffers();
+                cudaFree(slot.deviceHighScoreCount);
+                cudaFreeHost(slot.hostHighScoreCount);
+                slot.deviceHighScoreCount = nullptr;
+                slot.hostHighScoreCount = nullptr;
+                if (slot.stream) {
+                    cudaStreamDestroy(slot.stream);
+                    slot.stream = nullptr;
+                }
+                if (slot.issuedEvent) {
+                    cudaEventDestroy(slot.issuedEvent);
+                    cudaEventDestroy(slot.scoredEvent);
+                    cudaEventDestroy(slot.downloadedEvent);
+                    slot.issuedEvent = slot.scoredEvent = slot.downloadedEvent = nullptr;
+                }
+            }
+            cudaFree(deviceEvaMasks);
+            cudaFree(deviceMaskWeights);
+            cudaFree(deviceTables);
+            deviceEvaMasks = nullptr;
+            deviceMaskWeights = nullptr;
+            deviceTables = nullptr;
+            wordCapacity = 0;
+            tableCapacity = 0;
+            device = -1;
+        }
+    };
+    
+    thread_local ScoringContext g_scoringContext;
+    thread_local StaticTranslator::CudaTimings g_cudaTimings = {};
+    
+    // Grow a device pool to at least the requested size, keeping it between calls
+    void ensureDevicePool(void*& pool, size_t& poolSize, size_t requiredSize, const char* what) {
+        if (poolSize < requiredSize) {
+            cudaFree(pool);
+            pool = nullptr;
+            poolSize = 0;
+            throwOnCudaError(cudaMalloc(&pool, requiredSize), what);
+            poolSize = requiredSize;
+        }
     }
     
     void cleanupCudaResources() {
         cleanupMemoryPools();
+        g_scoringContext.release();
+        for (auto& entry : g_deviceLexicons) {
+            cudaSetDevice(entry.first);
+            cudaFree(entry.second.bits);
+        }
+        g_deviceLexicons.clear();
         if (g_cublasHandle) {
             cublasDestroy(g_cublasHandle);
             g_cublasHandle = nullptr;
@@ -287,22 +672,14 @@ void StaticTranslator::performBatchMatrixMultiplicationCuda(
     size_t resultBatchSize = numMappings * numWords * MATRIX_DIM * sizeof(int);
     
     // Ensure memory pools are large enough for batch processing
-    ensureMemoryPools(std::max(numWords, numMappings * numWords));
-    
-    // Allocate additional memory for transform and result batches if needed
-    void* d_transformBatch = nullptr;
-    void* d_resultBatch = nullptr;
-    
-    cudaError_t error = cudaMalloc(&d_transformBatch, transformBatchSize);
-    if (error != cudaSuccess) {
-        throw std::runtime_error("CUDA transform batch allocation failed: " + std::string(cudaGetErrorString(error)));
-    }
+    ensureMemoryPools(numWords);
     
-    error = cudaMalloc(&d_resultBatch, resultBatchSize);
-    if (error != cudaSuccess) {
-        cudaFree(d_transformBatch);
-        throw std::runtime_error("CUDA result batch allocation failed: " + std::string(cudaGetErrorString(error)));
-    }
+    // Transform and result batches live in grow-only pools instead of per-call allocations
+    ensureDevicePool(g_deviceTransformBatchPool, g_poolSizeTransformBatch, transformBatchSize, "CUDA transform batch allocation failed");
+    ensureDevicePool(g_deviceResultBatchPool, g_poolSizeResultBatch, resultBatchSize, "CUDA result batch allocation failed");
+    void* d_transformBatch = g_deviceTransformBatchPool;
+    void* d_resultBatch = g_deviceResultBatchPool;
+    cudaError_t error = cudaSuccess;
     
     // Prepare host data (reuse thread-local vectors for efficiency)
     static thread_local std::vector<int> flatInput, flatTransforms, flatResults;
@@ -328,15 +705,11 @@ void StaticTranslator::performBatchMatrixMultiplicationCuda(
     // Copy data to device
     error = cudaMemcpy(g_deviceInputPool, flatInput.data(), inputSize, cudaMemcpyHostToDevice);
     if (error != cudaSuccess) {
-        cudaFree(d_transformBatch);
-        cudaFree(d_resultBatch);
         throw std::runtime_error("CUDA input copy failed: " + std::string(cudaGetErrorString(error)));
     }
     
     error = cudaMemcpy(d_transformBatch, flatTransforms.data(), transformBatchSize, cudaMemcpyHostToDevice);
     if (error != cudaSuccess) {
-        cudaFree(d_transformBatch);
-        cudaFree(d_resultBatch);
         throw std::runtime_error("CUDA transform batch copy failed: " + std::string(cudaGetErrorString(error)));
     }
     
@@ -360,31 +733,21 @@ void StaticTranslator::performBatchMatrixMultiplicationCuda(
     // Check for kernel launch errors
     error = cudaGetLastError();
     if (error != cudaSuccess) {
-        cudaFree(d_transformBatch);
-        cudaFree(d_resultBatch);
         throw std::runtime_error("CUDA batch kernel launch failed: " + std::string(cudaGetErrorString(error)));
     }
     
     // Synchronize to wait for completion
     error = cudaDeviceSynchronize();
     if (error != cudaSuccess) {
-        cudaFree(d_transformBatch);
-        cudaFree(d_resultBatch);
         throw std::runtime_error("CUDA batch kernel execution failed: " + std::string(cudaGetErrorString(error)));
     }
     
     // Copy results back to host
     error = cudaMemcpy(flatResults.data(), d_resultBatch, resultBatchSize, cudaMemcpyDeviceToHost);
     if (error != cudaSuccess) {
-        cudaFree(d_transformBatch);
-        cudaFree(d_resultBatch);
         throw std::runtime_error("CUDA batch result copy failed: " + std::string(cudaGetErrorString(error)));
     }
     
-    // Clean up temporary device memory
-    cudaFree(d_transformBatch);
-    cudaFree(d_resultBatch);
-    
     // Unflatten results for each mapping
     resultMatrices.resize(numMappings);
     for (size_t mapping = 0; mapping < numMappings; ++mapping) {
@@ -400,6 +763,238 @@ void StaticTranslator::performBatchMatrixMultiplicationCuda(
     }
 }
 
+namespace {
+    // Shared setup of both fused scoring modes: validate sizes, upload the lexicon (once),
+    // make sure the thread's streams and buffers exist and upload the word masks and weights
+    const uint64_t* prepareFusedScoring(
+        const std::vector<uint32_t>& evaMasks,
+        const std::vector<uint32_t>& maskWeights,
+        size_t chunkCapacity,
+        const std::shared_ptr<const HebrewLexicon>& lexicon
+    ) {
+        size_t numWords = evaMasks.size();
+        if (!lexicon) {
+            throw std::runtime_error("Fused CUDA scoring requires a loaded lexicon");
+        }
+        if (!maskWeights.empty() && maskWeights.size() != numWords) {
+            throw std::runtime_error("Fused CUDA scoring needs one weight per word mask");
+        }
+        if (numWords > MAX_BATCH_WORDS) {
+            throw std::runtime_error("Word count exceeds maximum CUDA batch size");
+        }
+        if (chunkCapacity > MAX_BATCH_MAPPINGS) {
+            throw std::runtime_error("Mapping count exceeds maximum CUDA batch size");
+        }
+        
+        initializeCudaResources();
+        const uint64_t* d_lexiconBits = ensureDeviceLexicon(lexicon);
+        
+        // Streams and buffers belong to one device; rebuild them if the thread moved
+        ScoringContext& context = g_scoringContext;
+        int device = currentDevice();
+        if (context.device != device) {
+            context.release();
+            context.device = device;
+        }
+        context.drain();
+        context.ensureSlots(chunkCapacity);
+        context.ensureWords(numWords);
+        
+        cudaStream_t stream = context.slots[0].stream;
+        throwOnCudaError(cudaMemcpyAsync(context.deviceEvaMasks, evaMasks.data(), numWords * sizeof(uint32_t), cudaMemcpyHostToDevice, stream),
+                         "CUDA word copy failed");
+        std::vector<uint32_t> unitWeights;
+        if (maskWeights.empty()) {
+            unitWeights.assign(numWords, 1);
+        }
+        const std::vector<uint32_t>& weights = maskWeights.empty() ? unitWeights : maskWeights;
+        throwOnCudaError(cudaMemcpyAsync(context.deviceMaskWeights, weights.data(), numWords * sizeof(uint32_t), cudaMemcpyHostToDevice, stream),
+                         "CUDA weight copy failed");
+        throwOnCudaError(cudaStreamSynchronize(stream), "CUDA word copy failed");
+        return d_lexiconBits;
+    }
+    
+    // Queue the downloads of a chunk's counts into the slot's pinned buffers
+    void queueScoreDownload(ScoringSlot& slot) {
+        throwOnCudaError(cudaGetLastError(), "CUDA scoring kernel launch failed");
+        if (slot.timed) {
+            throwOnCudaError(cudaEventRecord(slot.scoredEvent, slot.stream), "CUDA event record failed");
+        }
+        throwOnCudaError(cudaMemcpyAsync(slot.hostMatchedCounts, slot.deviceMatchedCounts, slot.chunkCount * sizeof(uint32_t),
+                                         cudaMemcpyDeviceToHost, slot.stream),
+                         "CUDA count copy failed");
+        throwOnCudaError(cudaMemcpyAsync(slot.hostHighScoreCount, slot.deviceHighScoreCount, sizeof(uint32_t),
+                                         cudaMemcpyDeviceToHost, slot.stream),
+                         "CUDA counter copy failed");
+        if (slot.timed) {
+            throwOnCudaError(cudaEventRecord(slot.downloadedEvent, slot.stream), "CUDA event record failed");
+        }
+        slot.inFlight = true;
+    }
+    
+    // Issue one device-generated chunk on its slot's stream: reset, score, start downloads
+    void issueRangeChunk(ScoringSlot& slot, const uint64_t* d_lexiconBits, int numWords,
+                         uint64_t chunkStart, size_t chunkCount, uint32_t minMatched,
+                         const SearchSpace::UnrankTable& space) {
+        slot.chunkStart = chunkStart;
+        slot.chunkCount = chunkCount;
+        slot.timed = true;
+        throwOnCudaError(cudaEventRecord(slot.issuedEvent, slot.stream), "CUDA event record failed");
+        throwOnCudaError(cudaMemsetAsync(slot.deviceHighScoreCount, 0, sizeof(uint32_t), slot.stream), "CUDA counter reset failed");
+        
+        // Nothing per mapping is uploaded: the device unranks chunkStart + blockIdx.x itself
+        fusedUnrankScoreKernel<<<static_cast<unsigned int>(chunkCount), SCORE_THREADS_PER_MAPPING, 0, slot.stream>>>(
+            g_scoringContext.deviceEvaMasks, g_scoringContext.deviceMaskWeights, numWords,
+            chunkStart, static_cast<int>(chunkCount), space,
+            d_lexiconBits, minMatched,
+            slot.deviceMatchedCounts, slot.deviceHighScoreIndices, slot.deviceHighScoreCount
+        );
+        queueScoreDownload(slot);
+    }
+    
+    // Wait for a chunk, then fetch its (usually tiny) list of high scores
+    void collectScores(ScoringSlot& slot, std::vector<uint32_t>& highScoreIndices) {
+        throwOnCudaError(cudaStreamSynchronize(slot.stream), "CUDA scoring kernel execution failed");
+        slot.inFlight = false;
+        
+        if (slot.timed) {
+            float kernelMs = 0.0f, transferMs = 0.0f;
+            if (cudaEventElapsedTime(&kernelMs, slot.issuedEvent, slot.scoredEvent) == cudaSuccess &&
+                cudaEventElapsedTime(&transferMs, slot.scoredEvent, slot.downloadedEvent) == cudaSuccess) {
+                g_cudaTimings.chunksScored++;
+                g_cudaTimings.kernelMs += kernelMs;
+                g_cudaTimings.transferMs += transferMs;
+            }
+            slot.timed = false;
+        }
+        
+        highScoreIndices.clear();
+        uint32_t highScoreCount = *slot.hostHighScoreCount;
+        if (highScoreCount > 0) {
+            throwOnCudaError(cudaMemcpyAsync(slot.hostHighScoreIndices, slot.deviceHighScoreIndices, highScoreCount * sizeof(uint32_t),
+                                             cudaMemcpyDeviceToHost, slot.stream),
+                             "CUDA index copy failed");
+            throwOnCudaError(cudaStreamSynchronize(slot.stream), "CUDA index copy failed");
+            highScoreIndices.assign(slot.hostHighScoreIndices, slot.hostHighScoreIndices + highScoreCount);
+            
+            // Blocks finish in any order
+            std::sort(highScoreIndices.begin(), highScoreIndices.end());
+        }
+    }
+}
+
+void StaticTranslator::scoreLookupTablesCuda(
+    const std::vector<uint32_t>& evaMasks,
+    const std::vector<PermutationTranslator::LookupTable>& tables,
+    const std::shared_ptr<const HebrewLexicon>& lexicon,
+    uint32_t minMatched,
+    std::vector<uint32_t>& matchedCounts,
+    std::vector<uint32_t>& highScoreIndices
+) {
+    size_t numWords = evaMasks.size();
+    size_t numMappings = tables.size();
+    
+    matchedCounts.assign(numMappings, 0);
+    highScoreIndices.clear();
+    if (numWords == 0 || numMappings == 0) return;
+    
+    const uint64_t* d_lexiconBits = prepareFusedScoring(evaMasks, {}, numMappings, lexicon);
+    ScoringContext& context = g_scoringContext;
+    ScoringSlot& slot = context.slots[0];
+    
+    // Upload 448 bytes of lookup entries per mapping
+    context.ensureTables(numMappings);
+    throwOnCudaError(cudaMemcpyAsync(context.deviceTables, tables.data(), numMappings * TABLE_ENTRIES * sizeof(uint32_t),
+                                     cudaMemcpyHostToDevice, slot.stream),
+                     "CUDA table copy failed");
+    throwOnCudaError(cudaMemsetAsync(slot.deviceHighScoreCount, 0, sizeof(uint32_t), slot.stream), "CUDA counter reset failed");
+    
+    slot.chunkStart = 0;
+    slot.chunkCount = numMappings;
+    fusedTranslateScoreKernel<<<static_cast<unsigned int>(numMappings), SCORE_THREADS_PER_MAPPING, 0, slot.stream>>>(
+        context.deviceEvaMasks, context.deviceMaskWeights, static_cast<int>(numWords),
+        context.deviceTables, static_cast<int>(numMappings),
+        d_lexiconBits, minMatched,
+        slot.deviceMatchedCounts, slot.deviceHighScoreIndices, slot.deviceHighScoreCount
+    );
+    queueScoreDownload(slot);
+    collectScores(slot, highScoreIndices);
+    std::copy(slot.hostMatchedCounts, slot.hostMatchedCounts + numMappings, matchedCounts.begin());
+}
+
+void StaticTranslator::scorePermutationRangeCuda(
+    const std::vector<uint32_t>& evaMasks,
+    uint64_t startIndex,
+    size_t count,
+    const std::shared_ptr<const HebrewLexicon>& lexicon,
+    uint32_t minMatched,
+    std::vector<uint32_t>& matchedCounts,
+    std::vector<uint32_t>& highScoreIndices
+) {
+    matchedCounts.assign(count, 0);
+    highScoreIndices.clear();
+    
+    // Chunked through the pipeline, with offsets made relative to the whole range
+    scorePermutationRangePipelinedCuda(evaMasks, {}, startIndex, count, MAX_BATCH_MAPPINGS, lexicon, minMatched,
+        [&](uint64_t chunkStart, const uint32_t* chunkCounts, size_t chunkCount, const std::vector<uint32_t>& chunkHighScores) {
+            size_t offset = static_cast<size_t>(chunkStart - startIndex);
+            std::copy(chunkCounts, chunkCounts + chunkCount, matchedCounts.begin() + offset);
+            for (uint32_t index : chunkHighScores) {
+                highScoreIndices.push_back(static_cast<uint32_t>(offset + index));
+            }
+            return true;
+        });
+}
+
+bool StaticTranslator::scorePermutationRangePipelinedCuda(
+    const std::vector<uint32_t>& evaMasks,
+    const std::vector<uint32_t>& maskWeights,
+    uint64_t startIndex,
+    uint64_t count,
+    size_t chunkSize,
+    const std::shared_ptr<const HebrewLexicon>& lexicon,
+    uint32_t minMatched,
+    const FusedChunkCallback& onChunk,
+    const SearchSpace& space
+) {
+    if (evaMasks.empty() || count == 0) return true;
+    
+    chunkSize = std::min(std::max<size_t>(chunkSize, 1), MAX_BATCH_MAPPINGS);
+    const uint64_t* d_lexiconBits = prepareFusedScoring(evaMasks, maskWeights, chunkSize, lexicon);
+    ScoringContext& context = g_scoringContext;
+    int numWords = static_cast<int>(evaMasks.size());
+    
+    uint64_t nextStart = startIndex;
+    uint64_t endIndex = startIndex + count;
+    auto issueNext = [&](ScoringSlot& slot) {
+        size_t chunkCount = static_cast<size_t>(std::min<uint64_t>(chunkSize, endIndex - nextStart));
+        issueRangeChunk(slot, d_lexiconBits, numWords, nextStart, chunkCount, minMatched, space.getUnrankTable());
+        nextStart += chunkCount;
+    };
+    
+    // Fill the pipeline, then keep every stream busy: while the callback consumes one chunk
+    // the device is already scoring the next, and a slot is refilled as soon as it is consumed
+    for (int s = 0; s < SCORE_STREAM_COUNT && nextStart < endIndex; ++s) {
+        issueNext(context.slots[s]);
+    }
+    
+    std::vector<uint32_t> highScoreIndices;
+    for (int oldest = 0; context.slots[oldest].inFlight; oldest = (oldest + 1) % SCORE_STREAM_COUNT) {
+        ScoringSlot& slot = context.slots[oldest];
+        collectScores(slot, highScoreIndices);
+        
+        if (!onChunk(slot.chunkStart, slot.hostMatchedCounts, slot.chunkCount, highScoreIndices)) {
+            context.drain();
+            return false;
+        }
+        
+        if (nextStart < endIndex) {
+            issueNext(slot);
+        }
+    }
+    return true;
+}
+
 // Helper functions for CUDA availability and device info
 bool isCudaAvailable_impl() {
     int deviceCount = 0;
@@ -407,13 +1002,30 @@ bool isCudaAvailable_impl() {
     return (error == cudaSuccess && deviceCount > 0);
 }
 
-std::string getCudaDeviceInfo_impl() {
-    if (!isCudaAvailable_impl()) {
+int getCudaDeviceCount_impl() {
+    int deviceCount = 0;
+    cudaError_t error = cudaGetDeviceCount(&deviceCount);
+    return error == cudaSuccess ? deviceCount : 0;
+}
+
+StaticTranslator::CudaTimings getCudaTimings_impl() {
+    return g_cudaTimings;
+}
+
+void selectCudaDevice_impl(int device) {
+    cudaError_t error = cudaSetDevice(device);
+    if (error != cudaSuccess) {
+        throw std::runtime_error("Failed to select CUDA device " + std::to_string(device) + ": " + cudaGetErrorString(error));
+    }
+}
+
+std::string getCudaDeviceInfo_impl(int device) {
+    if (device < 0 || device >= getCudaDeviceCount_impl()) {
         return "CUDA not available";
     }
     
     cudaDeviceProp prop;
-    cudaGetDeviceProperties(&prop, 0);
+    cudaGetDeviceProperties(&prop, device);
     
     std::ostringstream info;
     info << "Device: " << prop.name 
@@ -424,6 +1036,10 @@ std::string getCudaDeviceInfo_impl() {
     return info.str();
 }
 
+std::string getCudaDeviceInfo_impl() {
+    return getCudaDeviceInfo_impl(0);
+}
+
 // Register cleanup function to be called at program exit
 static struct CudaCleanup {
     ~CudaCleanup() {
@@ -441,10 +1057,71 @@ void StaticTranslator::performMatrixMultiplicationCuda(
     throw std::runtime_error("CUDA support was not compiled into this binary");
 }
 
+void StaticTranslator::performBatchMatrixMultiplicationCuda(
+    const std::vector<std::vector<int>>&,
+    const std::vector<std::vector<std::vector<int>>>&,
+    std::vector<std::vector<std::vector<int>>>&
+) {
+    throw std::runtime_error("CUDA support was not compiled into this binary");
+}
+
+void StaticTranslator::scoreLookupTablesCuda(
+    const std::vector<uint32_t>&,
+    const std::vector<PermutationTranslator::LookupTable>&,
+    const std::shared_ptr<const HebrewLexicon>&,
+    uint32_t,
+    std::vector<uint32_t>&,
+    std::vector<uint32_t>&
+) {
+    throw std::runtime_error("CUDA support was not compiled into this binary");
+}
+
+void StaticTranslator::scorePermutationRangeCuda(
+    const std::vector<uint32_t>&,
+    uint64_t,
+    size_t,
+    const std::shared_ptr<const HebrewLexicon>&,
+    uint32_t,
+    std::vector<uint32_t>&,
+    std::vector<uint32_t>&
+) {
+    throw std::runtime_error("CUDA support was not compiled into this binary");
+}
+
+bool StaticTranslator::scorePermutationRangePipelinedCuda(
+    const std::vector<uint32_t>&,
+    const std::vector<uint32_t>&,
+    uint64_t,
+    uint64_t,
+    size_t,
+    const std::shared_ptr<const HebrewLexicon>&,
+    uint32_t,
+    const FusedChunkCallback&,
+    const SearchSpace&
+) {
+    throw std::runtime_error("CUDA support was not compiled into this binary");
+}
+
 bool isCudaAvailable_impl() {
     return false;
 }
 
+int getCudaDeviceCount_impl() {
+    return 0;
+}
+
+StaticTranslator::CudaTimings getCudaTimings_impl() {
+    return StaticTranslator::CudaTimings{};
+}
+
+void selectCudaDevice_impl(int) {
+    throw std::runtime_error("CUDA support was not compiled into this binary");
+}
+
+std::string getCudaDeviceInfo_impl(int) {
+    return "CUDA not compiled";
+}
+
 std::string getCudaDeviceInfo_impl() {
     return "CUDA not compiled";
 }
@@ -0,0 +1,185 @@
+#include "StaticTranslator.h"
+#include <algorithm>
+
+// x86 SIMD kernels for packed mask translation. They are compiled for AVX2/AVX-512 per
+// function (no global /arch flag), so the binary still runs on older CPUs and picks a
+// kernel at runtime.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define VOYNICH_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#else
+#include <cpuid.h>
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+namespace {
+    using LookupTable = PermutationTranslator::LookupTable;
+    constexpr int NIBBLE_COUNT = PermutationTranslator::NIBBLE_COUNT;
+    
+    void translateScalar(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count) {
+        PermutationTranslator::translateMasks(table, evaMasks, hebrewMasks, count);
+    }
+
+#ifdef VOYNICH_SIMD_X86
+    void cpuid(int leaf, int subleaf, int registers[4]) {
+#ifdef _MSC_VER
+        __cpuidex(registers, leaf, subleaf);
+#else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        __cpuid_count(leaf, subleaf, eax, ebx, ecx, edx);
+        registers[0] = static_cast<int>(eax);
+        registers[1] = static_cast<int>(ebx);
+        registers[2] = static_cast<int>(ecx);
+        registers[3] = static_cast<int>(edx);
+#endif
+    }
+    
+    uint64_t readXcr0() {
+#ifdef _MSC_VER
+        return _xgetbv(0);
+#else
+        unsigned int eax = 0, edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+    
+    StaticTranslator::SimdLevel detectSimdLevel() {
+        int registers[4];
+        cpuid(0, 0, registers);
+        if (registers[0] < 7) {
+            return StaticTranslator::SimdLevel::SCALAR;
+        }
+        
+        // The OS must save the wider registers on context switches (OSXSAVE + XCR0 bits)
+        cpuid(1, 0, registers);
+        bool osxsave = (registers[2] & (1 << 27)) != 0;
+        bool avx = (registers[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) {
+            return StaticTranslator::SimdLevel::SCALAR;
+        }
+        uint64_t xcr0 = readXcr0();
+        bool ymmState = (xcr0 & 0x6) == 0x6;
+        bool zmmState = (xcr0 & 0xE6) == 0xE6;
+        
+        cpuid(7, 0, registers);
+        bool avx2 = (registers[1] & (1 << 5)) != 0;
+        bool avx512f = (registers[1] & (1 << 16)) != 0;
+        
+        if (avx512f && zmmState) {
+            return StaticTranslator::SimdLevel::AVX512;
+        }
+        if (avx2 && ymmState) {
+            return StaticTranslator::SimdLevel::AVX2;
+        }
+        return StaticTranslator::SimdLevel::SCALAR;
+    }
+    
+    SIMD_TARGET_AVX2
+    void translateAvx2(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count) {
+        // Each 16-entry nibble table is split into two 8-entry halves held in registers
+        __m256i lowHalf[NIBBLE_COUNT];
+        __m256i highHalf[NIBBLE_COUNT];
+        for (int n = 0; n < NIBBLE_COUNT; ++n) {
+            lowHalf[n] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&table.nibbleLookup[n][0]));
+            highHalf[n] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&table.nibbleLookup[n][8]));
+        }
+        
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i remaining = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(evaMasks + i));
+            __m256i result = _mm256_setzero_si256();
+            
+            for (int n = 0; n < NIBBLE_COUNT; ++n) {
+                // The permute reads the low 3 index bits; bit 3 (moved to the sign) picks the half
+                __m256i fromLow = _mm256_permutevar8x32_epi32(lowHalf[n], remaining);
+                __m256i fromHigh = _mm256_permutevar8x32_epi32(highHalf[n], remaining);
+                __m256i selectHigh = _mm256_slli_epi32(remaining, 28);
+                __m256 selected = _mm256_blendv_ps(_mm256_castsi256_ps(fromLow), _mm256_castsi256_ps(fromHigh),
+                                                   _mm256_castsi256_ps(selectHigh));
+                result = _mm256_or_si256(result, _mm256_castps_si256(selected));
+                remaining = _mm256_srli_epi32(remaining, 4);
+            }
+            
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(hebrewMasks + i), result);
+        }
+        
+        translateScalar(table, evaMasks + i, hebrewMasks + i, count - i);
+    }
+    
+    SIMD_TARGET_AVX512
+    void translateAvx512(const LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count) {
+        // A whole 16-entry nibble table fits one register; the permute reads the low 4 index bits
+        __m512i tables[NIBBLE_COUNT];
+        for (int n = 0; n < NIBBLE_COUNT; ++n) {
+            tables[n] = _mm512_loadu_si512(&table.nibbleLookup[n][0]);
+        }
+        
+        size_t i = 0;
+        while (i < count) {
+            // The final partial group uses masked loads and stores instead of a scalar tail
+            size_t lanes = (count - i < 16) ? (count - i) : 16;
+            __mmask16 laneMask = static_cast<__mmask16>((1u << lanes) - 1u);
+            
+            __m512i remaining = _mm512_maskz_loadu_epi32(laneMask, evaMasks + i);
+            __m512i result = _mm512_setzero_si512();
+            for (int n = 0; n < NIBBLE_COUNT; ++n) {
+                result = _mm512_or_si512(result, _mm512_permutexvar_epi32(remaining, tables[n]));
+                remaining = _mm512_srli_epi32(remaining, 4);
+            }
+            
+            _mm512_mask_storeu_epi32(hebrewMasks + i, laneMask, result);
+            i += lanes;
+        }
+    }
+#endif
+}
+
+StaticTranslator::SimdLevel StaticTranslator::getSimdLevel() {
+#ifdef VOYNICH_SIMD_X86
+    static const SimdLevel detected = detectSimdLevel();
+    return detected;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+std::string StaticTranslator::getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX512:
+            return "AVX-512";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::SCALAR:
+        default:
+            return "Scalar";
+    }
+}
+
+void StaticTranslator::translateMasksSimd(const PermutationTranslator::LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count) {
+    translateMasksSimd(table, evaMasks, hebrewMasks, count, getSimdLevel());
+}
+
+void StaticTranslator::translateMasksSimd(const PermutationTranslator::LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count, SimdLevel maxLevel) {
+    // Never run a kernel the CPU does not support, whatever the caller asked for
+    SimdLevel level = std::min(maxLevel, getSimdLevel());
+
+#ifdef VOYNICH_SIMD_X86
+    if (level == SimdLevel::AVX512) {
+        translateAvx512(table, evaMasks, hebrewMasks, count);
+        return;
+    }
+    if (level == SimdLevel::AVX2) {
+        translateAvx2(table, evaMasks, hebrewMasks, count);
+        return;
+    }
+#endif
+
+    translateScalar(table, evaMasks, hebrewMasks, count);
+}
@@ -11,6 +11,13 @@ WordSet StaticTranslator::translateWordSet(const WordSet& evaWords, const Mappin
         std::wcerr << L"Warning: Some words are not in EVA alphabet" << std::endl;
     }
     
+    // CPU path works directly on the packed letter masks
+    if (!useCuda || !isCudaAvailable()) {
+        std::vector<uint32_t> hebrewMasks;
+        translateMasks(evaWords.getLetterMasks(), mapping, hebrewMasks);
+        return masksToWordSet(hebrewMasks, Alphabet::HEBREW);
+    }
+    
     // Get mapping matrix
     const auto& mappingMatrix = mapping.getMappingMatrix();
     
@@ -20,12 +27,8 @@ WordSet StaticTranslator::translateWordSet(const WordSet& evaWords, const Mappin
     // Prepare result matrix
     std::vector<std::vector<int>> resultMatrix(inputMatrix.size(), std::vector<int>(27, 0));
     
-    // Perform matrix multiplication using CPU or CUDA
-    if (useCuda && isCudaAvailable()) {
-        performMatrixMultiplicationCuda(inputMatrix, mappingMatrix, resultMatrix);
-    } else {
-        performMatrixMultiplicationCpu(inputMatrix, mappingMatrix, resultMatrix);
-    }
+    // Perform matrix multiplication using CUDA
+    performMatrixMultiplicationCuda(inputMatrix, mappingMatrix, resultMatrix);
     
     // Convert back to WordSet
     return matrixToWordSet(resultMatrix, evaWords, Alphabet::HEBREW);
@@ -61,11 +64,31 @@ bool StaticTranslator::validateInputAlphabet(const WordSet& words) {
 // Forward declarations - implementations are in StaticCudaTranslator.cu
 extern bool isCudaAvailable_impl();
 extern std::string getCudaDeviceInfo_impl();
+extern std::string getCudaDeviceInfo_impl(int device);
+extern int getCudaDeviceCount_impl();
+extern void selectCudaDevice_impl(int device);
+extern StaticTranslator::CudaTimings getCudaTimings_impl();
 
 std::string StaticTranslator::getCudaDeviceInfo() {
     return getCudaDeviceInfo_impl();
 }
 
+std::string StaticTranslator::getCudaDeviceInfo(int device) {
+    return getCudaDeviceInfo_impl(device);
+}
+
+int StaticTranslator::getCudaDeviceCount() {
+    return getCudaDeviceCount_impl();
+}
+
+void StaticTranslator::selectCudaDevice(int device) {
+    selectCudaDevice_impl(device);
+}
+
+StaticTranslator::CudaTimings StaticTranslator::getCudaTimings() {
+    return getCudaTimings_impl();
+}
+
 bool StaticTranslator::isCudaAvailable() {
     return isCudaAvailable_impl();
 }
@@ -81,6 +104,28 @@ std::vector<std::vector<int>> StaticTranslator::wordSetToMatrix(const WordSet& w
     return matrix;
 }
 
+void StaticTranslator::translateMasks(
+    const std::vector<uint32_t>& evaMasks,
+    const Mapping& mapping,
+    std::vector<uint32_t>& hebrewMasks
+) {
+    hebrewMasks.resize(evaMasks.size());
+    
+    for (size_t i = 0; i < evaMasks.size(); ++i) {
+        hebrewMasks[i] = mapping.applyMappingToMask(evaMasks[i]);
+    }
+}
+
+WordSet StaticTranslator::masksToWordSet(const std::vector<uint32_t>& masks, Alphabet targetAlphabet) {
+    WordSet result;
+    
+    for (uint32_t mask : masks) {
+        result.addWord(Word(maskToHebrewText(mask), targetAlphabet));
+    }
+    
+    return result;
+}
+
 WordSet StaticTranslator::matrixToWordSet(
     const std::vector<std::vector<int>>& matrix,
     const WordSet& originalWords,
@@ -107,7 +152,7 @@ WordSet StaticTranslator::matrixToWordSet(
     return result;
 }
 
-std::wstring StaticTranslator::binaryToHebrewText(const std::vector<int>& binaryVector) {
+namespace {
     const wchar_t hebrewChars[] = {
         0x05D0, // aleph א
         0x05D1, // bet ב
@@ -137,16 +182,22 @@ std::wstring StaticTranslator::binaryToHebrewText(const std::vector<int>& binary
         0x05E3, // pe final ף
         0x05E5  // tsadi final ץ
     };
-    
+}
+
+std::wstring StaticTranslator::binaryToHebrewText(const std::vector<int>& binaryVector) {
+    return maskToHebrewText(Word::binaryVectorToMask(binaryVector));
+}
+
+std::wstring StaticTranslator::maskToHebrewText(uint32_t mask) {
     std::wstring result;
     
-    for (size_t i = 0; i < std::min(binaryVector.size(), size_t(27)); ++i) {
-        if (binaryVector[i]) {
+    for (int i = 0; i < Word::ALPHABET_SIZE; ++i) {
+        if ((mask >> i) & 1u) {
             result += hebrewChars[i];
         }
     }
     
-    return result.empty() ? L"" : result;
+    return result;
 }
 
 size_t StaticTranslator::getOptimalThreadCount() {
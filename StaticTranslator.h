@@ -2,8 +2,14 @@
 
 #include "WordSet.h"
 #include "Mapping.h"
+#include "PermutationTranslator.h"
+#include "SearchSpace.h"
+#include "HebrewLexicon.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <functional>
+#include <cstdint>
 
 // Static translator interface - no instances needed, all methods are static
 class StaticTranslator {
@@ -24,8 +30,48 @@ public:
     // Utility methods
     static bool validateInputAlphabet(const WordSet& words);
     static std::string getCudaDeviceInfo();
+    static std::string getCudaDeviceInfo(int device);
     static bool isCudaAvailable();
     
+    // Multi-GPU support: device enumeration and binding of the calling thread to one device
+    // (all later CUDA work of that thread, including its streams and buffers, runs there)
+    static int getCudaDeviceCount();
+    static void selectCudaDevice(int device);
+    
+    // Device time spent on the calling thread's fused scoring chunks since it started, measured
+    // with stream events: kernel time (reset + score) and the time of each chunk's downloads
+    struct CudaTimings {
+        uint64_t chunksScored;
+        double kernelMs;
+        double transferMs;
+    };
+    static CudaTimings getCudaTimings();
+    
+    // Packed mask translation: each EVA letter mask becomes the OR of its letters' mapped Hebrew bits
+    static void translateMasks(
+        const std::vector<uint32_t>& evaMasks,
+        const Mapping& mapping,
+        std::vector<uint32_t>& hebrewMasks
+    );
+    static WordSet masksToWordSet(const std::vector<uint32_t>& masks, Alphabet targetAlphabet);
+    
+    // Instruction sets usable by the SIMD mask kernel, best first available at runtime
+    enum class SimdLevel {
+        SCALAR,   // Portable table walk (PermutationTranslator::translateMasks)
+        AVX2,     // 8 words per iteration, two 8-entry permutes per nibble table
+        AVX512    // 16 words per iteration, one 16-entry permute per nibble table
+    };
+    
+    // SIMD translation of packed masks through a compiled permutation table: each nibble of
+    // 8 or 16 EVA masks indexes its 16-entry table with in-register permutes and the results
+    // are ORed into the Hebrew masks in registers. Dispatches on the CPU detected at runtime;
+    // the overload taking a level uses at most that level (for tests and benchmarks).
+    static void translateMasksSimd(const PermutationTranslator::LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count);
+    static void translateMasksSimd(const PermutationTranslator::LookupTable& table, const uint32_t* evaMasks, uint32_t* hebrewMasks, size_t count, SimdLevel maxLevel);
+    static SimdLevel getSimdLevel();
+    static std::string getSimdLevelName(SimdLevel level);
+    static std::wstring maskToHebrewText(uint32_t mask);
+    
     // Matrix conversion utilities (public for batch processing)
     static std::vector<std::vector<int>> wordSetToMatrix(const WordSet& words);
     static WordSet matrixToWordSet(
@@ -40,6 +86,56 @@ public:
         const std::vector<std::vector<std::vector<int>>>& transformMatrices,
         std::vector<std::vector<std::vector<int>>>& resultMatrices
     );
+    
+    // Fused GPU scoring: each mapping's lookup table translates the EVA masks on the device and
+    // every translated word is probed in a device-resident lexicon bitset (uploaded once per
+    // lexicon). Only one matched count per mapping comes back, plus the sorted indices of the
+    // mappings with at least minMatched matches.
+    static void scoreLookupTablesCuda(
+        const std::vector<uint32_t>& evaMasks,
+        const std::vector<PermutationTranslator::LookupTable>& tables,
+        const std::shared_ptr<const HebrewLexicon>& lexicon,
+        uint32_t minMatched,
+        std::vector<uint32_t>& matchedCounts,
+        std::vector<uint32_t>& highScoreIndices
+    );
+    
+    // Same fused scoring, but the device also generates the mappings: it scores the global
+    // permutation indices [startIndex, startIndex + count), unranked in MappingGenerator order,
+    // so only the word masks are uploaded. High-score indices are offsets from startIndex.
+    static void scorePermutationRangeCuda(
+        const std::vector<uint32_t>& evaMasks,
+        uint64_t startIndex,
+        size_t count,
+        const std::shared_ptr<const HebrewLexicon>& lexicon,
+        uint32_t minMatched,
+        std::vector<uint32_t>& matchedCounts,
+        std::vector<uint32_t>& highScoreIndices
+    );
+    
+    // Receives one scored chunk of a pipelined range: the matched counts of its count indices
+    // from chunkStart and the sorted offsets (from chunkStart) of its high scores. The count
+    // buffer is reused once the callback returns. Return false to stop the range.
+    using FusedChunkCallback = std::function<bool(uint64_t chunkStart, const uint32_t* matchedCounts, size_t count,
+                                                  const std::vector<uint32_t>& highScoreIndices)>;
+    
+    // Pipelined device-generated scoring of [startIndex, startIndex + count) in chunks of
+    // chunkSize. Chunks are issued round-robin on the calling thread's persistent streams and
+    // downloaded into pinned buffers, so the device scores the next chunk while the callback
+    // consumes the previous one. Indices unrank in the given search space. maskWeights gives the
+    // number of words each mask stands for (empty: one each). Returns false if the callback
+    // stopped the range.
+    static bool scorePermutationRangePipelinedCuda(
+        const std::vector<uint32_t>& evaMasks,
+        const std::vector<uint32_t>& maskWeights,
+        uint64_t startIndex,
+        uint64_t count,
+        size_t chunkSize,
+        const std::shared_ptr<const HebrewLexicon>& lexicon,
+        uint32_t minMatched,
+        const FusedChunkCallback& onChunk,
+        const SearchSpace& space = SearchSpace::full()
+    );
 
 private:
     // Internal utility methods
@@ -1,8 +1,34 @@
 #include "StatsProvider.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
-StatsProvider::StatsProvider(const StatsConfig& config) : config(config) {
+namespace {
+    // Single-writer counter update: the owning thread is the only one storing to it
+    void addRelaxed(std::atomic<uint64_t>& counter, uint64_t amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    
+    void raiseRelaxed(std::atomic<double>& value, double candidate) {
+        if (candidate > value.load(std::memory_order_relaxed)) {
+            value.store(candidate, std::memory_order_relaxed);
+        }
+    }
+    
+    // Share of the timed total and mean time per sampled mapping, stage by stage
+    void printStageShares(const Profiler::Breakdown& breakdown, const wchar_t* separator) {
+        for (size_t s = 0; s < Profiler::STAGE_COUNT; ++s) {
+            auto stage = static_cast<Profiler::Stage>(s);
+            std::wcout << (s > 0 ? separator : L"") << Profiler::getStageName(stage) << L" "
+                       << std::fixed << std::setprecision(1) << breakdown.share(stage) * 100.0 << L"% ("
+                       << std::setprecision(0) << breakdown.nanosecondsPerItem(stage) << L" ns)";
+        }
+        std::wcout << std::endl;
+    }
+}
+
+StatsProvider::StatsProvider(const StatsConfig& config)
+    : config(config), threadCounters(new ThreadCounters[config.threadCount]) {
     startTime = std::chrono::steady_clock::now();
     lastStatusTime = startTime;
 }
@@ -18,16 +44,31 @@ void StatsProvider::start() {
     
     shouldStop = false;
     startTime = std::chrono::steady_clock::now();
-    lastStatusTime = startTime;
     
-    // Reset statistics
-    totalMappingsProcessed = 0;
-    totalWordsValidated = 0;
-    highestScore = 0.0;
+    // Reset statistics (workers are not running yet)
+    for (size_t i = 0; i < config.threadCount; ++i) {
+        ThreadCounters& counters = threadCounters[i];
+        counters.mappingsProcessed = 0;
+        counters.wordsValidated = 0;
+        counters.highestScore = 0.0;
+        counters.piecesCompleted = 0;
+        counters.pieceMicroseconds = 0;
+        for (auto& bucket : counters.pieceLatencyCounts) {
+            bucket = 0;
+        }
+        counters.sampledMappings = 0;
+        counters.sampledRate = 0.0;
+    }
     highScoreCount = 0;
     activeThreads = 0;
-    lastMappingsCount = 0;
-    recentMappingsPerSecond = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(sampleMutex);
+        lastStatusTime = startTime;
+        lastMappingsCount = 0;
+        recentMappingsPerSecond = 0.0;
+    }
+    startStageBreakdown = Profiler::getBreakdown();
+    lastStageBreakdown = startStageBreakdown;
     
     // Start message processing thread
     statsThread = std::thread(&StatsProvider::processMessages, this);
@@ -41,13 +82,7 @@ void StatsProvider::stop() {
     }
     
     shouldStop = true;
-    
-    // Send shutdown message
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        messageQueue.push(std::make_unique<StatsMessage>(MessageType::SHUTDOWN));
-    }
-    queueCondition.notify_one();
+    postMessage(std::make_unique<StatsMessage>(MessageType::SHUTDOWN));
     
     // Wait for processing thread to finish
     if (statsThread.joinable()) {
@@ -57,52 +92,63 @@ void StatsProvider::stop() {
     printFinalResults();
 }
 
-void StatsProvider::submitMappingProcessed(int threadId, uint64_t mappingId, uint64_t wordsValidated, double score) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        messageQueue.push(std::make_unique<MappingProcessedMessage>(threadId, mappingId, wordsValidated, score));
-    }
-    queueCondition.notify_one();
+void StatsProvider::submitMappingProcessed(int threadId, uint64_t wordsValidated, double score) {
+    ThreadCounters* counters = countersFor(threadId);
+    if (!counters) return;
+    
+    addRelaxed(counters->mappingsProcessed, 1);
+    addRelaxed(counters->wordsValidated, wordsValidated);
+    raiseRelaxed(counters->highestScore, score);
 }
 
 void StatsProvider::submitBatchStats(int threadId, uint64_t mappingsProcessed, uint64_t wordsValidated, double highestScore, bool hasHighScore) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        messageQueue.push(std::make_unique<BatchStatsMessage>(threadId, mappingsProcessed, wordsValidated, highestScore, hasHighScore));
+    ThreadCounters* counters = countersFor(threadId);
+    if (!counters) return;
+    
+    addRelaxed(counters->mappingsProcessed, mappingsProcessed);
+    addRelaxed(counters->wordsValidated, wordsValidated);
+    if (hasHighScore) {
+        raiseRelaxed(counters->highestScore, highestScore);
     }
-    queueCondition.notify_one();
 }
 
-void StatsProvider::submitHighScore(int threadId, uint64_t mappingId, double score, size_t matchedWords, size_t totalWords, double matchPercentage) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        messageQueue.push(std::make_unique<HighScoreMessage>(threadId, mappingId, score, matchedWords, totalWords, matchPercentage));
+void StatsProvider::submitPieceCompleted(int threadId, double seconds) {
+    ThreadCounters* counters = countersFor(threadId);
+    if (!counters) return;
+    
+    addRelaxed(counters->piecesCompleted, 1);
+    addRelaxed(counters->pieceMicroseconds, static_cast<uint64_t>(seconds * 1e6));
+    
+    double milliseconds = seconds * 1000.0;
+    size_t bucket = 0;
+    while (bucket < PIECE_LATENCY_BUCKET_COUNT - 1 && milliseconds > PIECE_LATENCY_BOUNDS_MS[bucket]) {
+        bucket++;
     }
-    queueCondition.notify_one();
+    addRelaxed(counters->pieceLatencyCounts[bucket], 1);
 }
 
-void StatsProvider::submitThreadStarted(int threadId) {
+void StatsProvider::postMessage(std::unique_ptr<StatsMessage> message) {
     {
         std::lock_guard<std::mutex> lock(queueMutex);
-        messageQueue.push(std::make_unique<ThreadLifecycleMessage>(MessageType::THREAD_STARTED, threadId));
+        messageQueue.push(std::move(message));
     }
     queueCondition.notify_one();
 }
 
+void StatsProvider::submitHighScore(int threadId, uint64_t mappingId, double score, size_t matchedWords, size_t totalWords, double matchPercentage) {
+    postMessage(std::make_unique<HighScoreMessage>(threadId, mappingId, score, matchedWords, totalWords, matchPercentage));
+}
+
+void StatsProvider::submitThreadStarted(int threadId) {
+    postMessage(std::make_unique<ThreadLifecycleMessage>(MessageType::THREAD_STARTED, threadId));
+}
+
 void StatsProvider::submitThreadCompleted(int threadId, uint64_t localMappingsProcessed) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        messageQueue.push(std::make_unique<ThreadLifecycleMessage>(MessageType::THREAD_COMPLETED, threadId, localMappingsProcessed));
-    }
-    queueCondition.notify_one();
+    postMessage(std::make_unique<ThreadLifecycleMessage>(MessageType::THREAD_COMPLETED, threadId, localMappingsProcessed));
 }
 
 void StatsProvider::requestStatusUpdate() {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        messageQueue.push(std::make_unique<StatsMessage>(MessageType::STATUS_UPDATE_REQUEST));
-    }
-    queueCondition.notify_one();
+    postMessage(std::make_unique<StatsMessage>(MessageType::STATUS_UPDATE_REQUEST));
 }
 
 void StatsProvider::processMessages() {
@@ -122,14 +168,6 @@ void StatsProvider::processMessages() {
                 lock.unlock(); // Release lock while processing message
                 
                 switch (message->type) {
-                    case MessageType::MAPPING_PROCESSED:
-                        handleMappingProcessed(static_cast<const MappingProcessedMessage&>(*message));
-                        break;
-                        
-                    case MessageType::BATCH_STATS:
-                        handleBatchStats(static_cast<const BatchStatsMessage&>(*message));
-                        break;
-                        
                     case MessageType::HIGH_SCORE_FOUND:
                         handleHighScore(static_cast<const HighScoreMessage&>(*message));
                         break;
@@ -151,12 +189,12 @@ void StatsProvider::processMessages() {
             }
         }
         
-        // Periodic status update
+        // Periodic sample of the worker counters
         auto now = std::chrono::steady_clock::now();
         if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastStatusUpdate).count() >= 
             static_cast<long long>(config.statusUpdateIntervalMs)) {
             lock.unlock();
-            updateMappingsPerSecond();
+            sampleCounters();
             printStatus();
             lastStatusUpdate = now;
             lock.lock();
@@ -164,32 +202,6 @@ void StatsProvider::processMessages() {
     }
 }
 
-void StatsProvider::handleMappingProcessed(const MappingProcessedMessage& msg) {
-    totalMappingsProcessed.fetch_add(1);
-    totalWordsValidated.fetch_add(msg.wordsValidated);
-    
-    // Update highest score (thread-safe)
-    double currentHighest = highestScore.load();
-    while (msg.score > currentHighest && 
-           !highestScore.compare_exchange_weak(currentHighest, msg.score)) {
-        // Loop until we successfully update or find a higher score
-    }
-}
-
-void StatsProvider::handleBatchStats(const BatchStatsMessage& msg) {
-    totalMappingsProcessed.fetch_add(msg.mappingsProcessed);
-    totalWordsValidated.fetch_add(msg.wordsValidated);
-    
-    // Update highest score if this batch has a higher score
-    if (msg.hasHighScore) {
-        double currentHighest = highestScore.load();
-        while (msg.highestScore > currentHighest && 
-               !highestScore.compare_exchange_weak(currentHighest, msg.highestScore)) {
-            // Loop until we successfully update or find a higher score
-        }
-    }
-}
-
 void StatsProvider::handleHighScore(const HighScoreMessage& msg) {
     highScoreCount.fetch_add(1);
     
@@ -211,17 +223,26 @@ void StatsProvider::handleThreadLifecycle(const ThreadLifecycleMessage& msg) {
     }
 }
 
-void StatsProvider::updateMappingsPerSecond() {
-    uint64_t currentMappings = totalMappingsProcessed.load();
+void StatsProvider::sampleCounters() {
     auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(sampleMutex);
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastStatusTime).count();
+    if (elapsed <= 0) {
+        return;
+    }
     
-    if (elapsed > 0) {
-        uint64_t mappingsDelta = currentMappings - lastMappingsCount;
-        recentMappingsPerSecond = (mappingsDelta * 1000.0) / elapsed;
-        lastMappingsCount = currentMappings;
-        lastStatusTime = now;
+    uint64_t currentMappings = 0;
+    for (size_t i = 0; i < config.threadCount; ++i) {
+        ThreadCounters& counters = threadCounters[i];
+        uint64_t mappings = counters.mappingsProcessed.load(std::memory_order_relaxed);
+        counters.sampledRate = ((mappings - counters.sampledMappings) * 1000.0) / elapsed;
+        counters.sampledMappings = mappings;
+        currentMappings += mappings;
     }
+    
+    recentMappingsPerSecond = ((currentMappings - lastMappingsCount) * 1000.0) / elapsed;
+    lastMappingsCount = currentMappings;
+    lastStatusTime = now;
 }
 
 void StatsProvider::printStatus() {
@@ -234,6 +255,15 @@ void StatsProvider::printStatus() {
                << L" (" << std::fixed << std::setprecision(1) << mappingsPerSec << L"/sec), "
                << L"Highest Score: " << std::fixed << std::setprecision(2) << snapshot.highestScore
                << L", Active Threads: " << snapshot.activeThreads << std::endl;
+    
+    // Sampled mappings only; nothing is timed unless the build defines VOYNICH_PROFILING
+    auto stageBreakdown = Profiler::getBreakdown();
+    auto recent = stageBreakdown.since(lastStageBreakdown);
+    lastStageBreakdown = stageBreakdown;
+    if (recent.sampledItems > 0) {
+        std::wcout << L"  Stages (1 in " << recent.sampleInterval << L" mappings timed): ";
+        printStageShares(recent, L", ");
+    }
 }
 
 void StatsProvider::printFinalResults() {
@@ -253,6 +283,21 @@ void StatsProvider::printFinalResults() {
     std::wcout << L"Highest score achieved: " << std::fixed << std::setprecision(2) << finalStats.highestScore << std::endl;
     std::wcout << L"High-scoring results: " << finalStats.highScoreCount << std::endl;
     
+    for (const auto& thread : getThreadSnapshots()) {
+        double threadRate = (elapsed > 0) ? (thread.mappingsProcessed * 1000.0 / elapsed) : 0.0;
+        std::wcout << L"  Thread " << thread.threadId << L": " << thread.mappingsProcessed << L" mappings ("
+                   << std::fixed << std::setprecision(1) << threadRate << L"/sec), "
+                   << thread.piecesCompleted << L" pieces, avg " << std::setprecision(1) << thread.averagePieceMs << L" ms/piece, "
+                   << L"best " << std::setprecision(2) << thread.highestScore << std::endl;
+    }
+    
+    auto stageBreakdown = Profiler::getBreakdown().since(startStageBreakdown);
+    if (stageBreakdown.sampledItems > 0) {
+        std::wcout << L"Stage breakdown (" << stageBreakdown.sampledItems << L" mappings timed, 1 in "
+                   << stageBreakdown.sampleInterval << L"):" << std::endl << L"  ";
+        printStageShares(stageBreakdown, L"\n  ");
+    }
+    
     if (finalStats.highScoreCount > 0) {
         std::wcout << L"Results saved to: " << config.resultsFilePath.c_str() << std::endl;
     }
@@ -262,14 +307,49 @@ void StatsProvider::printFinalResults() {
 
 StatsProvider::StatsSnapshot StatsProvider::getCurrentSnapshot() const {
     StatsSnapshot snapshot;
-    snapshot.totalMappingsProcessed = totalMappingsProcessed.load();
-    snapshot.totalWordsValidated = totalWordsValidated.load();
-    snapshot.highestScore = highestScore.load();
+    snapshot.totalMappingsProcessed = 0;
+    snapshot.totalWordsValidated = 0;
+    snapshot.highestScore = 0.0;
+    for (size_t i = 0; i < config.threadCount; ++i) {
+        const ThreadCounters& counters = threadCounters[i];
+        snapshot.totalMappingsProcessed += counters.mappingsProcessed.load(std::memory_order_relaxed);
+        snapshot.totalWordsValidated += counters.wordsValidated.load(std::memory_order_relaxed);
+        snapshot.highestScore = std::max(snapshot.highestScore, counters.highestScore.load(std::memory_order_relaxed));
+    }
     snapshot.highScoreCount = highScoreCount.load();
     snapshot.activeThreads = activeThreads.load();
     snapshot.startTime = startTime;
+    
+    std::lock_guard<std::mutex> lock(sampleMutex);
     snapshot.lastUpdateTime = lastStatusTime;
     snapshot.lastMappingsProcessed = lastMappingsCount;
     snapshot.recentMappingsPerSecond = recentMappingsPerSecond;
     return snapshot;
-}
\ No newline at end of file
+}
+
+std::vector<StatsProvider::ThreadSnapshot> StatsProvider::getThreadSnapshots() const {
+    std::vector<ThreadSnapshot> snapshots;
+    std::lock_guard<std::mutex> lock(sampleMutex);
+    for (size_t i = 0; i < config.threadCount; ++i) {
+        const ThreadCounters& counters = threadCounters[i];
+        if (counters.mappingsProcessed.load(std::memory_order_relaxed) == 0 &&
+            counters.piecesCompleted.load(std::memory_order_relaxed) == 0) {
+            continue; // Thread id never used
+        }
+        
+        ThreadSnapshot snapshot;
+        snapshot.threadId = static_cast<int>(i);
+        snapshot.mappingsProcessed = counters.mappingsProcessed.load(std::memory_order_relaxed);
+        snapshot.wordsValidated = counters.wordsValidated.load(std::memory_order_relaxed);
+        snapshot.highestScore = counters.highestScore.load(std::memory_order_relaxed);
+        snapshot.piecesCompleted = counters.piecesCompleted.load(std::memory_order_relaxed);
+        uint64_t pieceMicroseconds = counters.pieceMicroseconds.load(std::memory_order_relaxed);
+        snapshot.averagePieceMs = snapshot.piecesCompleted > 0 ? pieceMicroseconds / 1000.0 / snapshot.piecesCompleted : 0.0;
+        snapshot.mappingsPerSecond = counters.sampledRate;
+        for (size_t b = 0; b < PIECE_LATENCY_BUCKET_COUNT; ++b) {
+            snapshot.pieceLatencyCounts[b] = counters.pieceLatencyCounts[b].load(std::memory_order_relaxed);
+        }
+        snapshots.push_back(snapshot);
+    }
+    return snapshots;
+}
@@ -9,13 +9,14 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <vector>
+#include <array>
+#include "Profiler.h"
 
 class StatsProvider {
 public:
-    // Message types for the stats queue
+    // Rare events still go through the message queue; counts and rates do not
     enum class MessageType {
-        MAPPING_PROCESSED,
-        BATCH_STATS,
         HIGH_SCORE_FOUND,
         THREAD_STARTED,
         THREAD_COMPLETED,
@@ -35,16 +36,6 @@ public:
     };
     
     // Specific message types
-    struct MappingProcessedMessage : public StatsMessage {
-        uint64_t mappingId;
-        uint64_t wordsValidated;
-        double score;
-        
-        MappingProcessedMessage(int threadId, uint64_t mappingId, uint64_t wordsValidated, double score)
-            : StatsMessage(MessageType::MAPPING_PROCESSED, threadId), mappingId(mappingId), 
-              wordsValidated(wordsValidated), score(score) {}
-    };
-    
     struct HighScoreMessage : public StatsMessage {
         uint64_t mappingId;
         double score;
@@ -64,26 +55,16 @@ public:
             : StatsMessage(type, threadId), localMappingsProcessed(localMappings) {}
     };
     
-    struct BatchStatsMessage : public StatsMessage {
-        uint64_t mappingsProcessed;
-        uint64_t wordsValidated;
-        double highestScore;
-        bool hasHighScore;
-        
-        BatchStatsMessage(int threadId, uint64_t mappings, uint64_t words, double score, bool hasHigh)
-            : StatsMessage(MessageType::BATCH_STATS, threadId), mappingsProcessed(mappings),
-              wordsValidated(words), highestScore(score), hasHighScore(hasHigh) {}
-    };
-    
     // Configuration for stats provider
     struct StatsConfig {
         size_t statusUpdateIntervalMs;
         std::string resultsFilePath;
         double scoreThreshold;
         size_t maxMappingsToProcess;
+        size_t threadCount;           // Worker threads with their own counters (ids 0 .. threadCount-1)
         
         StatsConfig() : statusUpdateIntervalMs(5000), resultsFilePath("voynich_decoder_results.txt"),
-                       scoreThreshold(25.0), maxMappingsToProcess(0) {}
+                       scoreThreshold(25.0), maxMappingsToProcess(0), threadCount(64) {}
     };
     
     // Statistics snapshot
@@ -108,39 +89,78 @@ public:
             return static_cast<double>(elapsed);
         }
     };
+    
+    // Upper bounds (ms) of the piece latency histogram; the last bucket has none
+    static constexpr size_t PIECE_LATENCY_BUCKET_COUNT = 10;
+    static constexpr double PIECE_LATENCY_BOUNDS_MS[PIECE_LATENCY_BUCKET_COUNT - 1] = {
+        10.0, 50.0, 100.0, 250.0, 500.0, 1000.0, 2500.0, 5000.0, 10000.0
+    };
+    
+    // One worker's counters as last sampled by the stats thread
+    struct ThreadSnapshot {
+        int threadId;
+        uint64_t mappingsProcessed;
+        uint64_t wordsValidated;
+        double highestScore;
+        uint64_t piecesCompleted;
+        double averagePieceMs;        // Mean wall time of the worker's completed pieces
+        double mappingsPerSecond;     // Rate over the last sampling interval
+        std::array<uint64_t, PIECE_LATENCY_BUCKET_COUNT> pieceLatencyCounts;  // Pieces per bucket (not cumulative)
+    };
 
 private:
+    // Written only by the owning worker (plain load + store, no read-modify-write) and read by
+    // whoever samples; one cache line per thread so workers never share a line
+    struct alignas(64) ThreadCounters {
+        std::atomic<uint64_t> mappingsProcessed{0};
+        std::atomic<uint64_t> wordsValidated{0};
+        std::atomic<double> highestScore{0.0};
+        std::atomic<uint64_t> piecesCompleted{0};
+        std::atomic<uint64_t> pieceMicroseconds{0};
+        std::atomic<uint64_t> pieceLatencyCounts[PIECE_LATENCY_BUCKET_COUNT] = {};
+        
+        // Stats thread only: previous sample, for per-thread rates
+        uint64_t sampledMappings{0};
+        double sampledRate{0.0};
+    };
+    
     StatsConfig config;
+    std::unique_ptr<ThreadCounters[]> threadCounters;
     
-    // Message queue and processing
+    // Rare-event queue (high scores, thread lifecycle) and its processing thread
     std::queue<std::unique_ptr<StatsMessage>> messageQueue;
     mutable std::mutex queueMutex;
     std::condition_variable queueCondition;
-    
-    // Stats processing thread
     std::thread statsThread;
     std::atomic<bool> shouldStop{false};
     
-    // Statistics data
-    std::atomic<uint64_t> totalMappingsProcessed{0};
-    std::atomic<uint64_t> totalWordsValidated{0};
-    std::atomic<double> highestScore{0.0};
     std::atomic<uint64_t> highScoreCount{0};
     std::atomic<size_t> activeThreads{0};
     std::chrono::steady_clock::time_point startTime;
+    
+    // Sampled by the stats thread on its interval (guarded by sampleMutex)
+    mutable std::mutex sampleMutex;
     std::chrono::steady_clock::time_point lastStatusTime;
     uint64_t lastMappingsCount{0};
     double recentMappingsPerSecond{0.0};
     
+    // Profiler totals at start and at the previous status line (stats thread), so the status
+    // shows the last interval and the final report this run only
+    Profiler::Breakdown startStageBreakdown{};
+    Profiler::Breakdown lastStageBreakdown{};
+    
+    ThreadCounters* countersFor(int threadId) {
+        return (threadId >= 0 && static_cast<size_t>(threadId) < config.threadCount) ? &threadCounters[threadId] : nullptr;
+    }
+    
     // Internal message processing
     void processMessages();
-    void handleMappingProcessed(const MappingProcessedMessage& msg);
-    void handleBatchStats(const BatchStatsMessage& msg);
     void handleHighScore(const HighScoreMessage& msg);
     void handleThreadLifecycle(const ThreadLifecycleMessage& msg);
+    void postMessage(std::unique_ptr<StatsMessage> message);
     void printStatus();
     void printFinalResults();
-    void updateMappingsPerSecond();
+    void sampleCounters();
     
 public:
     explicit StatsProvider(const StatsConfig& config = StatsConfig());
@@ -150,16 +170,20 @@ public:
     void start();
     void stop();
     
-    // Message submission (thread-safe)
-    void submitMappingProcessed(int threadId, uint64_t mappingId, uint64_t wordsValidated, double score);
+    // Counter updates: lock- and allocation-free, each thread may only pass its own threadId
+    void submitMappingProcessed(int threadId, uint64_t wordsValidated, double score);
     void submitBatchStats(int threadId, uint64_t mappingsProcessed, uint64_t wordsValidated, double highestScore, bool hasHighScore);
+    void submitPieceCompleted(int threadId, double seconds);
+    
+    // Rare events (queued for the stats thread, thread-safe)
     void submitHighScore(int threadId, uint64_t mappingId, double score, size_t matchedWords, size_t totalWords, double matchPercentage);
     void submitThreadStarted(int threadId);
     void submitThreadCompleted(int threadId, uint64_t localMappingsProcessed);
     void requestStatusUpdate();
     
-    // Statistics access
+    // Statistics access (totals are summed from the live counters)
     StatsSnapshot getCurrentSnapshot() const;
+    std::vector<ThreadSnapshot> getThreadSnapshots() const;
     bool isRunning() const { return !shouldStop.load(); }
     
     // Configuration access
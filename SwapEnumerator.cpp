@@ -0,0 +1,154 @@
+#include "SwapEnumerator.h"
+#include <algorithm>
+
+SwapEnumerator::SwapEnumerator(uint64_t startIndex, uint64_t endIndex, int maxHeapDepth)
+    : endIndex(endIndex), position(0), startIndex(startIndex), lexIndex(startIndex), stepsToPrefixChange(0),
+      inChunk(false), heapDepth(1), chunkSize(1), chunkStart(0), chunkStepsLeft(0), heapLevel(1) {
+    
+    // Largest Heap depth whose chunk still fits at least twice into the range
+    uint64_t rangeSize = (endIndex > startIndex) ? endIndex - startIndex : 0;
+    int depthLimit = std::min(maxHeapDepth, MappingGenerator::TAIL_LENGTH);
+    while (heapDepth < depthLimit && chunkSize * (heapDepth + 1) * 2 <= rangeSize) {
+        heapDepth++;
+        chunkSize *= heapDepth;
+    }
+    
+    Step step;
+    resetTo(startIndex, step);
+}
+
+uint64_t SwapEnumerator::currentIndex() const {
+    if (!inChunk) {
+        return lexIndex;
+    }
+    
+    // Lexicographic rank of the chunk suffix among its own elements
+    const int base = Word::ALPHABET_SIZE - heapDepth;
+    uint64_t rank = 0;
+    for (int k = 0; k < heapDepth; ++k) {
+        uint64_t smallerAfter = 0;
+        for (int l = k + 1; l < heapDepth; ++l) {
+            if (permutation[base + l] < permutation[base + k]) smallerAfter++;
+        }
+        rank = rank * (heapDepth - k) + smallerAfter;
+    }
+    
+    return chunkStart + rank;
+}
+
+bool SwapEnumerator::advance(Step& step) {
+    step.swapCount = 0;
+    step.reset = false;
+    
+    if (position + 1 >= endIndex - startIndex) {
+        return false;
+    }
+    position++;
+    
+    if (inChunk) {
+        if (chunkStepsLeft > 0) {
+            heapStep(step);
+            chunkStepsLeft--;
+        } else {
+            // Chunk finished in Heap order; continue from the first index after it
+            resetTo(chunkStart + chunkSize, step);
+        }
+        return true;
+    }
+    
+    uint64_t nextIndex = lexIndex + 1;
+    if (stepsToPrefixChange <= 1 || !lexicographicStep(step)) {
+        // The leading positions change here, so this is not a tail step
+        resetTo(nextIndex, step);
+        return true;
+    }
+    
+    lexIndex = nextIndex;
+    stepsToPrefixChange--;
+    
+    if (canStartChunkAt(lexIndex, stepsToPrefixChange)) {
+        startChunk(lexIndex);
+    }
+    return true;
+}
+
+void SwapEnumerator::resetTo(uint64_t index, Step& step) {
+    MappingGenerator::unrankPermutation(index, permutation);
+    step.reset = true;
+    step.swapCount = 0;
+    
+    lexIndex = index;
+    stepsToPrefixChange = MappingGenerator::stepsUntilPrefixChange(index);
+    inChunk = false;
+    
+    if (canStartChunkAt(index, stepsToPrefixChange)) {
+        startChunk(index);
+    }
+}
+
+bool SwapEnumerator::canStartChunkAt(uint64_t index, uint64_t stepsToPrefixChange) const {
+    if (heapDepth < 2 || index + chunkSize > endIndex || stepsToPrefixChange < chunkSize) {
+        return false;
+    }
+    
+    // Chunk-aligned tail rank <=> the last heapDepth positions are in ascending order
+    for (int i = Word::ALPHABET_SIZE - heapDepth; i + 1 < Word::ALPHABET_SIZE; ++i) {
+        if (permutation[i] > permutation[i + 1]) return false;
+    }
+    return true;
+}
+
+void SwapEnumerator::startChunk(uint64_t index) {
+    inChunk = true;
+    chunkStart = index;
+    chunkStepsLeft = chunkSize - 1;
+    heapLevel = 1;
+    std::fill(std::begin(heapCounters), std::end(heapCounters), static_cast<uint8_t>(0));
+}
+
+bool SwapEnumerator::lexicographicStep(Step& step) {
+    const int tailStart = Word::ALPHABET_SIZE - MappingGenerator::TAIL_LENGTH;
+    const int last = Word::ALPHABET_SIZE - 1;
+    
+    int pivot = last - 1;
+    while (pivot >= tailStart && permutation[pivot] > permutation[pivot + 1]) {
+        pivot--;
+    }
+    if (pivot < tailStart) {
+        return false; // Tail exhausted (cannot happen before a prefix change)
+    }
+    
+    int successor = last;
+    while (permutation[successor] < permutation[pivot]) {
+        successor--;
+    }
+    
+    addSwap(step, permutation, pivot, successor);
+    for (int i = pivot + 1, j = last; i < j; ++i, --j) {
+        addSwap(step, permutation, i, j);
+    }
+    return true;
+}
+
+void SwapEnumerator::heapStep(Step& step) {
+    // Iterative Heap's algorithm over the last heapDepth positions
+    const int base = Word::ALPHABET_SIZE - heapDepth;
+    while (heapLevel < heapDepth) {
+        if (heapCounters[heapLevel] < heapLevel) {
+            int other = (heapLevel % 2 == 0) ? 0 : heapCounters[heapLevel];
+            addSwap(step, permutation, base + other, base + heapLevel);
+            heapCounters[heapLevel]++;
+            heapLevel = 1;
+            return;
+        }
+        heapCounters[heapLevel] = 0;
+        heapLevel++;
+    }
+}
+
+void SwapEnumerator::addSwap(Step& step, Permutation& permutation, int a, int b) {
+    std::swap(permutation[a], permutation[b]);
+    step.first[step.swapCount] = static_cast<uint8_t>(a);
+    step.second[step.swapCount] = static_cast<uint8_t>(b);
+    step.swapCount++;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "PermutationTranslator.h"
+#include "MappingGenerator.h"
+#include <cstdint>
+
+// Enumerates every mapping in a global index range [startIndex, endIndex) so that consecutive
+// mappings differ by as few transpositions as possible.
+//
+// The range is split into chunks of d! indices whose permutations differ only in the last d
+// positions (d = heap depth); each chunk is walked with Heap's algorithm (exactly one swap per
+// step). The unaligned edges of the range are walked in lexicographic order, expressed as the
+// swaps std::next_permutation would perform. The range covers the same set of mappings as the
+// indexed generator, only the order within the range differs.
+class SwapEnumerator {
+public:
+    // One swap plus the suffix reversal of a lexicographic step over the tail
+    static constexpr int MAX_SWAPS_PER_STEP = 1 + MappingGenerator::TAIL_LENGTH / 2;
+
+    // Transpositions that turn the previous permutation into the current one.
+    // When reset is set the permutation was recomputed and should be rescored from scratch.
+    struct Step {
+        int swapCount;
+        bool reset;
+        uint8_t first[MAX_SWAPS_PER_STEP];
+        uint8_t second[MAX_SWAPS_PER_STEP];
+    };
+
+    SwapEnumerator(uint64_t startIndex, uint64_t endIndex, int maxHeapDepth = 9);
+
+    // Current mapping as an EVA -> Hebrew permutation
+    const Permutation& current() const { return permutation; }
+
+    // Global generator index of the current mapping (computed on demand inside Heap chunks)
+    uint64_t currentIndex() const;
+
+    // Move to the next mapping; returns false once the range is exhausted
+    bool advance(Step& step);
+
+    // Mappings still to be produced after the current one
+    uint64_t remaining() const { return (endIndex - startIndex) - position - 1; }
+
+    // Heap depth used for chunks of this range
+    int getHeapDepth() const { return heapDepth; }
+
+private:
+    Permutation permutation;
+    uint64_t endIndex;
+    uint64_t position;          // Enumeration position within the range (0-based from startIndex)
+    uint64_t startIndex;
+
+    // Lexicographic state
+    uint64_t lexIndex;          // Global index of the current permutation when not in a chunk
+    uint64_t stepsToPrefixChange;
+
+    // Heap chunk state
+    bool inChunk;
+    int heapDepth;
+    uint64_t chunkSize;
+    uint64_t chunkStart;
+    uint64_t chunkStepsLeft;
+    int heapLevel;
+    uint8_t heapCounters[Word::ALPHABET_SIZE];
+
+    void resetTo(uint64_t index, Step& step);
+    bool canStartChunkAt(uint64_t index, uint64_t stepsToPrefixChange) const;
+    void startChunk(uint64_t index);
+    bool lexicographicStep(Step& step);
+    void heapStep(Step& step);
+    static void addSwap(Step& step, Permutation& permutation, int a, int b);
+};
\ No newline at end of file
@@ -2,8 +2,14 @@
 #include "../StaticTranslator.h"
 #include "../Mapping.h"
 #include "../WordSet.h"
+#include "../HebrewValidator.h"
+#include "../PermutationTranslator.h"
+#include "../MappingGenerator.h"
 #include <vector>
 #include <chrono>
+#include <numeric>
+#include <random>
+#include <algorithm>
 
 class BatchCudaTests {
 public:
@@ -184,6 +190,185 @@ public:
             // This is acceptable - we're testing memory limits
         }
     }
+    
+    void testHighScoreMatchThreshold() {
+        // The fused kernel flags high scores by matched count; the count bound must agree with buildResult
+        HebrewValidator::ValidatorConfig config;
+        config.hebrewLexiconPath = "resources/Tanah2.txt";
+        config.enableResultsSaving = false;
+        HebrewValidator validator(config);
+        
+        for (size_t totalWords : { static_cast<size_t>(5), static_cast<size_t>(100), static_cast<size_t>(1000) }) {
+            size_t minMatched = validator.getMinMatchedForHighScore(totalWords);
+            ASSERT_TRUE(minMatched > 0 && minMatched <= totalWords);
+            ASSERT_TRUE(validator.buildResult(totalWords, minMatched).isHighScore);
+            ASSERT_FALSE(validator.buildResult(totalWords, minMatched - 1).isHighScore);
+        }
+        
+        validator.updateScoreThreshold(101.0);
+        ASSERT_EQ(static_cast<size_t>(101), validator.getMinMatchedForHighScore(100));
+    }
+    
+    void testFusedScoringMatchesCpu() {
+        if (!StaticTranslator::isCudaAvailable()) {
+            std::cout << "⚠ Skipping fused CUDA scoring test - CUDA not available" << std::endl;
+            return;
+        }
+        
+        WordSet voynichWords;
+        voynichWords.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+        auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::HASH_SET);
+        ASSERT_TRUE(voynichWords.size() > 0);
+        
+        // Random permutations, scored on the device and by the CPU lexicon
+        const size_t NUM_MAPPINGS = 2000;
+        std::mt19937 rng(7);
+        std::vector<PermutationTranslator::LookupTable> tables(NUM_MAPPINGS);
+        std::vector<uint32_t> expectedCounts(NUM_MAPPINGS);
+        std::vector<uint32_t> hebrewMasks(voynichWords.size());
+        for (size_t i = 0; i < NUM_MAPPINGS; ++i) {
+            Permutation permutation;
+            std::iota(permutation.begin(), permutation.end(), 0);
+            std::shuffle(permutation.begin(), permutation.end(), rng);
+            PermutationTranslator::buildLookupTable(permutation, tables[i]);
+            PermutationTranslator::translateMasks(tables[i], voynichWords.maskData(), hebrewMasks.data(), hebrewMasks.size());
+            expectedCounts[i] = static_cast<uint32_t>(lexicon->countMatches(hebrewMasks.data(), hebrewMasks.size()));
+        }
+        
+        // Flag roughly the better half so the index list is exercised
+        std::vector<uint32_t> sortedCounts(expectedCounts);
+        std::sort(sortedCounts.begin(), sortedCounts.end());
+        uint32_t minMatched = sortedCounts[NUM_MAPPINGS / 2];
+        
+        try {
+            std::vector<uint32_t> matchedCounts;
+            std::vector<uint32_t> highScoreIndices;
+            StaticTranslator::scoreLookupTablesCuda(voynichWords.getLetterMasks(), tables, lexicon, minMatched,
+                                                    matchedCounts, highScoreIndices);
+            
+            ASSERT_TRUE(matchedCounts == expectedCounts);
+            
+            std::vector<uint32_t> expectedIndices;
+            for (size_t i = 0; i < NUM_MAPPINGS; ++i) {
+                if (expectedCounts[i] >= minMatched) {
+                    expectedIndices.push_back(static_cast<uint32_t>(i));
+                }
+            }
+            ASSERT_TRUE(highScoreIndices == expectedIndices);
+            
+            std::cout << "✓ Fused CUDA scoring matches CPU (" << highScoreIndices.size() << " of "
+                      << NUM_MAPPINGS << " flagged)" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "✗ Fused CUDA scoring failed: " << e.what() << std::endl;
+            ASSERT_TRUE(false);
+        }
+    }
+    
+    void testDeviceUnrankingMatchesGenerator() {
+        if (!StaticTranslator::isCudaAvailable()) {
+            std::cout << "⚠ Skipping device unranking test - CUDA not available" << std::endl;
+            return;
+        }
+        
+        WordSet voynichWords;
+        voynichWords.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+        auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::HASH_SET);
+        ASSERT_TRUE(voynichWords.size() > 0);
+        
+        // Ranges at the start, across a 20! digit boundary and at the top of the index space
+        const size_t RANGE_SIZE = 1000;
+        const uint64_t starts[] = { 0ULL, 2432902008176640000ULL - 500ULL,
+                                    MappingGenerator::getTotalCombinations() - RANGE_SIZE };
+        
+        try {
+            for (uint64_t startIndex : starts) {
+                std::vector<uint32_t> expectedCounts(RANGE_SIZE);
+                std::vector<uint32_t> hebrewMasks(voynichWords.size());
+                for (size_t i = 0; i < RANGE_SIZE; ++i) {
+                    Permutation permutation;
+                    PermutationTranslator::LookupTable table;
+                    MappingGenerator::unrankPermutation(startIndex + i, permutation);
+                    PermutationTranslator::buildLookupTable(permutation, table);
+                    PermutationTranslator::translateMasks(table, voynichWords.maskData(), hebrewMasks.data(), hebrewMasks.size());
+                    expectedCounts[i] = static_cast<uint32_t>(lexicon->countMatches(hebrewMasks.data(), hebrewMasks.size()));
+                }
+                
+                std::vector<uint32_t> matchedCounts;
+                std::vector<uint32_t> highScoreIndices;
+                StaticTranslator::scorePermutationRangeCuda(voynichWords.getLetterMasks(), startIndex, RANGE_SIZE, lexicon, 1,
+                                                            matchedCounts, highScoreIndices);
+                ASSERT_TRUE(matchedCounts == expectedCounts);
+                
+                std::vector<uint32_t> expectedIndices;
+                for (size_t i = 0; i < RANGE_SIZE; ++i) {
+                    if (expectedCounts[i] >= 1) {
+                        expectedIndices.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+                ASSERT_TRUE(highScoreIndices == expectedIndices);
+            }
+            
+            std::cout << "✓ Device unranking matches MappingGenerator order" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "✗ Device unranking failed: " << e.what() << std::endl;
+            ASSERT_TRUE(false);
+        }
+    }
+    
+    void testPipelinedScoringMatchesSingleBatch() {
+        if (!StaticTranslator::isCudaAvailable()) {
+            std::cout << "⚠ Skipping pipelined CUDA scoring test - CUDA not available" << std::endl;
+            return;
+        }
+        
+        WordSet voynichWords;
+        voynichWords.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+        auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::HASH_SET);
+        
+        const uint64_t START_INDEX = 123456789ULL;
+        const size_t RANGE_SIZE = 5000;
+        
+        try {
+            std::vector<uint32_t> expectedCounts;
+            std::vector<uint32_t> expectedIndices;
+            StaticTranslator::scorePermutationRangeCuda(voynichWords.getLetterMasks(), START_INDEX, RANGE_SIZE, lexicon, 1,
+                                                        expectedCounts, expectedIndices);
+            
+            // Uneven chunks keep both streams busy and leave a short final chunk
+            std::vector<uint32_t> pipelinedCounts;
+            std::vector<uint32_t> pipelinedIndices;
+            std::vector<uint64_t> chunkStarts;
+            bool completed = StaticTranslator::scorePermutationRangePipelinedCuda(
+                voynichWords.getLetterMasks(), {}, START_INDEX, RANGE_SIZE, 700, lexicon, 1,
+                [&](uint64_t chunkStart, const uint32_t* matchedCounts, size_t count, const std::vector<uint32_t>& highScoreIndices) {
+                    chunkStarts.push_back(chunkStart);
+                    for (uint32_t index : highScoreIndices) {
+                        pipelinedIndices.push_back(static_cast<uint32_t>(chunkStart - START_INDEX + index));
+                    }
+                    pipelinedCounts.insert(pipelinedCounts.end(), matchedCounts, matchedCounts + count);
+                    return true;
+                });
+            
+            ASSERT_TRUE(completed);
+            ASSERT_EQ(static_cast<size_t>(8), chunkStarts.size());
+            ASSERT_TRUE(std::is_sorted(chunkStarts.begin(), chunkStarts.end()));
+            ASSERT_TRUE(pipelinedCounts == expectedCounts);
+            ASSERT_TRUE(pipelinedIndices == expectedIndices);
+            
+            // Stopping from the callback drains the in-flight chunk and reports the stop
+            size_t chunksSeen = 0;
+            bool stopped = !StaticTranslator::scorePermutationRangePipelinedCuda(
+                voynichWords.getLetterMasks(), {}, START_INDEX, RANGE_SIZE, 700, lexicon, 1,
+                [&](uint64_t, const uint32_t*, size_t, const std::vector<uint32_t>&) { return ++chunksSeen < 2; });
+            ASSERT_TRUE(stopped);
+            ASSERT_EQ(static_cast<size_t>(2), chunksSeen);
+            
+            std::cout << "✓ Pipelined CUDA scoring matches single batch" << std::endl;
+        } catch (const std::exception& e) {
+            std::cout << "✗ Pipelined CUDA scoring failed: " << e.what() << std::endl;
+            ASSERT_TRUE(false);
+        }
+    }
 };
 
 void testBatchCudaAvailability() {
@@ -211,10 +396,34 @@ void testBatchCudaMemoryLimits() {
     tests.testBatchCudaMemoryLimits();
 }
 
+void testBatchCudaHighScoreThreshold() {
+    BatchCudaTests tests;
+    tests.testHighScoreMatchThreshold();
+}
+
+void testBatchCudaFusedScoring() {
+    BatchCudaTests tests;
+    tests.testFusedScoringMatchesCpu();
+}
+
+void testBatchCudaDeviceUnranking() {
+    BatchCudaTests tests;
+    tests.testDeviceUnrankingMatchesGenerator();
+}
+
+void testBatchCudaPipelinedScoring() {
+    BatchCudaTests tests;
+    tests.testPipelinedScoringMatchesSingleBatch();
+}
+
 void registerBatchCudaTests(TestFramework& framework) {
     framework.addTest("Batch CUDA Availability", testBatchCudaAvailability);
     framework.addTest("Batch CUDA Matrix Conversion", testBatchCudaMatrixConversion);
     framework.addTest("Batch CUDA Processing", testBatchCudaProcessing);
     framework.addTest("Batch CUDA Performance", testBatchCudaPerformance);
     framework.addTest("Batch CUDA Memory Limits", testBatchCudaMemoryLimits);
+    framework.addTest("Batch CUDA High Score Threshold", testBatchCudaHighScoreThreshold);
+    framework.addTest("Batch CUDA Fused Scoring", testBatchCudaFusedScoring);
+    framework.addTest("Batch CUDA Device Unranking", testBatchCudaDeviceUnranking);
+    framework.addTest("Batch CUDA Pipelined Scoring", testBatchCudaPipelinedScoring);
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "TestFramework.h"
+#include "TestSupport.h"
+#include "../VoynichDecoder.h"
+#include "../HebrewValidator.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+
+void testMinMatchedInvertsScore() {
+    auto validatorConfig = TestSupport::createValidatorConfig(HebrewValidator::LexiconBackend::HASH_SET);
+    validatorConfig.scoreThreshold = 45.0;
+    HebrewValidator validator(validatorConfig);
+    
+    // The partition point against a linear scan, including scores no count reaches
+    for (size_t totalWords : { 1, 7, 100, 1000 }) {
+        for (double minScore : { -1.0, 0.0, 3.5, 12.0, 44.9, 45.0, 99.0, 100.0 }) {
+            size_t expected = totalWords + 1;
+            for (size_t matched = 0; matched <= totalWords; ++matched) {
+                if (validator.buildResult(totalWords, matched).score > minScore) {
+                    expected = matched;
+                    break;
+                }
+            }
+            ASSERT_EQ(static_cast<uint64_t>(expected), static_cast<uint64_t>(validator.getMinMatchedAbove(totalWords, minScore)));
+        }
+        ASSERT_TRUE(validator.getMinMatchedForHighScore(totalWords) >= validator.getMinMatchedAbove(totalWords, 44.9));
+    }
+}
+
+void testBoundedScoringKeepsResults() {
+    const std::string boundedPath = "test_bounded_scoring_results.txt";
+    const std::string fullPath = "test_full_scoring_results.txt";
+    std::remove(boundedPath.c_str());
+    std::remove(fullPath.c_str());
+    
+    auto boundedConfig = TestSupport::createDecoderConfig(VoynichDecoder::TranslatorType::PERMUTATION, boundedPath);
+    boundedConfig.scoreThreshold = 45.0;
+    boundedConfig.topResultsCount = 8;
+    boundedConfig.boundedScoring = true;
+    auto fullConfig = boundedConfig;
+    fullConfig.resultsFilePath = fullPath;
+    fullConfig.boundedScoring = false;
+    
+    VoynichDecoder bounded(boundedConfig);
+    VoynichDecoder full(fullConfig);
+    ASSERT_TRUE(bounded.initialize());
+    ASSERT_TRUE(full.initialize());
+    
+    // Partial scores stay below the bound, so high scores and the top-K come out the same
+    const uint64_t START_INDEX = 3000000, END_INDEX = 3020000;
+    std::vector<uint64_t> boundedHighScores, fullHighScores;
+    uint64_t boundedProbed = 0, boundedScoredMatched = 0, boundedScored = 0;
+    uint64_t index = START_INDEX;
+    ASSERT_TRUE(bounded.processMappingRange(START_INDEX, END_INDEX, 0,
+        [&](const VoynichDecoder::ProcessingResult& result) {
+            if (result.isHighScore) boundedHighScores.push_back(index);
+            index++;
+            boundedProbed += result.wordsProbed;
+            if (!result.exitedEarly) {
+                boundedScored++;
+                boundedScoredMatched += result.matchedWords;
+            }
+        },
+        [](int, uint64_t, uint64_t, double, bool) {}));
+    index = START_INDEX;
+    ASSERT_TRUE(full.processMappingRange(START_INDEX, END_INDEX, 0,
+        [&](const VoynichDecoder::ProcessingResult& result) { if (result.isHighScore) fullHighScores.push_back(index); index++; },
+        [](int, uint64_t, uint64_t, double, bool) {}));
+    ASSERT_TRUE(boundedHighScores == fullHighScores);
+    
+    auto boundedTop = bounded.getTopResults().getSorted();
+    auto fullTop = full.getTopResults().getSorted();
+    ASSERT_EQ(static_cast<uint64_t>(fullTop.size()), static_cast<uint64_t>(boundedTop.size()));
+    for (size_t i = 0; i < fullTop.size(); ++i) {
+        ASSERT_EQ(fullTop[i].mappingIndex, boundedTop[i].mappingIndex);
+        ASSERT_EQ(static_cast<int>(fullTop[i].matchedWords), static_cast<int>(boundedTop[i].matchedWords));
+    }
+    
+    // Nearly every mapping scores close to zero and is dropped part-way
+    uint64_t boundedReported = 0, fullReported = 0;
+    bounded.reportBatchStatsIfNeeded([&](int, uint64_t, uint64_t words, double, bool) { boundedReported = words; }, 0, true);
+    full.reportBatchStatsIfNeeded([&](int, uint64_t, uint64_t words, double, bool) { fullReported = words; }, 0, true);
+    auto boundedMetrics = bounded.getMetrics();
+    auto fullMetrics = full.getMetrics();
+    uint64_t exited = boundedMetrics.mappingsExitedEarly;
+    std::cout << "  " << exited << " of " << (END_INDEX - START_INDEX) << " mappings exited early, "
+              << boundedHighScores.size() << " high scores" << std::endl;
+    ASSERT_TRUE(exited > (END_INDEX - START_INDEX) / 2);
+    ASSERT_EQ(0ULL, fullMetrics.mappingsExitedEarly);
+    ASSERT_EQ(0ULL, fullMetrics.wordsPruned);
+    
+    // Only the words actually looked up are counted, and dropped mappings stay out of the hit stats
+    const uint64_t corpusWords = bounded.getVoynichWords().size();
+    ASSERT_EQ((END_INDEX - START_INDEX) * corpusWords, fullReported);
+    ASSERT_EQ(fullReported, fullMetrics.wordsProbed);
+    ASSERT_EQ(boundedProbed, boundedReported);
+    ASSERT_TRUE(boundedReported < fullReported);
+    ASSERT_EQ(boundedReported, boundedMetrics.wordsProbed + boundedMetrics.wordsPruned);
+    ASSERT_EQ(boundedScored * corpusWords, boundedMetrics.wordsProbed);
+    ASSERT_EQ(boundedScoredMatched, boundedMetrics.wordsMatched);
+    
+    std::remove(boundedPath.c_str());
+    std::remove(fullPath.c_str());
+}
+
+void registerBoundedScoringTests(TestFramework& framework) {
+    framework.addTest("Min Matched Inverts Score", testMinMatchedInvertsScore);
+    framework.addTest("Bounded Scoring Keeps Results", testBoundedScoringKeepsResults);
+}
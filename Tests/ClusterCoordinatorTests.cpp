@@ -0,0 +1,263 @@
+#include "TestFramework.h"
+#include "../ClusterCoordinator.h"
+#include "../ClusterClient.h"
+#include "../WorkStealingScheduler.h"
+#include "../NetworkConnection.h"
+#include "../VoynichDecoder.h"
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <atomic>
+
+namespace {
+    ClusterCoordinator::CoordinatorConfig testCoordinatorConfig(size_t blockSize) {
+        ClusterCoordinator::CoordinatorConfig config;
+        config.port = 0;  // Any free port
+        config.blockSize = blockSize;
+        config.enableStateFile = false;
+        config.resultsFilePath = "test_cluster_results.txt";
+        config.reaperIntervalMs = 50;
+        return config;
+    }
+    
+    ClusterClient::ClientConfig testClientConfig(uint16_t port, const std::string& name) {
+        ClusterClient::ClientConfig config;
+        config.host = "127.0.0.1";
+        config.port = port;
+        config.nodeName = name;
+        config.threads = 1;
+        config.heartbeatIntervalMs = 50;
+        config.waitRetryMs = 20;
+        return config;
+    }
+    
+    // A raw protocol connection, for nodes that deliberately stop sending heartbeats
+    std::string exchange(TcpConnection& connection, const std::string& message) {
+        std::string reply;
+        if (!connection.sendLine(message) || !connection.receiveLine(reply, 5000)) {
+            return "";
+        }
+        return reply;
+    }
+}
+
+void testClusterLeaseAndComplete() {
+    ClusterCoordinator coordinator(testCoordinatorConfig(100));
+    ASSERT_TRUE(coordinator.start());
+    
+    ClusterClient client(testClientConfig(coordinator.getPort(), "alpha node"));
+    ASSERT_TRUE(client.connect());
+    ASSERT_EQ(100ULL, client.getBlockSize());
+    
+    uint64_t blockIndex = 0, startIndex = 0, endIndex = 0;
+    ASSERT_TRUE(client.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+    ASSERT_EQ(0ULL, blockIndex);
+    ASSERT_EQ(0ULL, startIndex);
+    ASSERT_EQ(100ULL, endIndex);
+    
+    // The lease is an ordinary PENDING block in the coordinator's window
+    auto window = coordinator.getGenerator().getWindowSnapshot();
+    ASSERT_EQ(1ULL, static_cast<uint64_t>(window.size()));
+    ASSERT_TRUE(window[0].state == MappingGenerator::BlockState::PENDING);
+    ASSERT_EQ(client.getNodeId(), window[0].assignedThreadId);
+    
+    client.completeSharedBlock(0, blockIndex);
+    ASSERT_EQ(1ULL, coordinator.getGenerator().getCurrentState().totalBlocksCompleted);
+    ASSERT_EQ(1ULL, coordinator.getStats().blocksCompleted);
+    
+    auto nodes = coordinator.getNodes();
+    ASSERT_EQ(1ULL, static_cast<uint64_t>(nodes.size()));
+    ASSERT_TRUE(nodes[0].name == "alpha_node");
+    
+    client.disconnect();
+    coordinator.stop();
+}
+
+void testClusterExpiredLeaseIsReassigned() {
+    auto config = testCoordinatorConfig(100);
+    config.leaseTimeoutMs = 200;
+    ClusterCoordinator coordinator(config);
+    ASSERT_TRUE(coordinator.start());
+    
+    // A node that leases a block and then goes silent
+    auto silent = TcpConnection::connect("127.0.0.1", coordinator.getPort());
+    ASSERT_TRUE(silent != nullptr);
+    ASSERT_TRUE(exchange(*silent, "HELLO silent 4").rfind("WELCOME", 0) == 0);
+    ASSERT_TRUE(exchange(*silent, "LEASE") == "BLOCK 0 0 100");
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    ASSERT_EQ(1ULL, coordinator.getStats().leasesExpired);
+    
+    // The released block goes to the next node before any fresh block
+    ClusterClient client(testClientConfig(coordinator.getPort(), "beta"));
+    ASSERT_TRUE(client.connect());
+    uint64_t blockIndex = 99, startIndex = 0, endIndex = 0;
+    ASSERT_TRUE(client.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+    ASSERT_EQ(0ULL, blockIndex);
+    
+    // The silent node's late report is ignored; the new owner's completes the block
+    ASSERT_TRUE(exchange(*silent, "COMPLETE 0") == "STALE");
+    ASSERT_EQ(0ULL, coordinator.getGenerator().getCurrentState().totalBlocksCompleted);
+    client.completeSharedBlock(0, blockIndex);
+    ASSERT_EQ(1ULL, coordinator.getGenerator().getCurrentState().totalBlocksCompleted);
+    
+    // The heartbeating client keeps its next lease past the timeout
+    ASSERT_TRUE(client.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    ASSERT_EQ(1ULL, coordinator.getStats().leasesExpired);
+    
+    client.disconnect();
+    coordinator.stop();
+}
+
+void testClusterDisconnectReleasesLeasesAndGathersResults() {
+    auto config = testCoordinatorConfig(100);
+    std::remove(config.resultsFilePath.c_str());
+    ClusterCoordinator coordinator(config);
+    ASSERT_TRUE(coordinator.start());
+    
+    {
+        ClusterClient client(testClientConfig(coordinator.getPort(), "gamma"));
+        ASSERT_TRUE(client.connect());
+        uint64_t blockIndex = 0, startIndex = 0, endIndex = 0;
+        ASSERT_TRUE(client.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+        ASSERT_TRUE(client.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+        ASSERT_TRUE(client.submitResult(12345ULL, PermutationTranslator::identityPermutation(), 51.5, 103, 200));
+        
+        // A letter assigned twice is not a mapping
+        Permutation repeated = PermutationTranslator::identityPermutation();
+        repeated[1] = repeated[0];
+        ASSERT_FALSE(client.submitResult(12346ULL, repeated, 51.5, 103, 200));
+    }
+    
+    // Leaving gives both leases back, unassigned but still PENDING
+    for (int i = 0; i < 100 && coordinator.getStats().nodesConnected > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(2ULL, coordinator.getStats().leasesExpired);
+    auto window = coordinator.getGenerator().getWindowSnapshot();
+    ASSERT_EQ(2ULL, static_cast<uint64_t>(window.size()));
+    ASSERT_EQ(-1, window[0].assignedThreadId);
+    ASSERT_EQ(-1, window[1].assignedThreadId);
+    
+    coordinator.flushResults();
+    std::ifstream results(config.resultsFilePath);
+    std::stringstream contents;
+    contents << results.rdbuf();
+    results.close();
+    ASSERT_TRUE(contents.str().find("Mapping ID: 12345") != std::string::npos);
+    ASSERT_TRUE(contents.str().find("Node: gamma") != std::string::npos);
+    ASSERT_TRUE(contents.str().find("103/200") != std::string::npos);
+    std::remove(config.resultsFilePath.c_str());
+    
+    coordinator.stop();
+}
+
+void testClusterResultIsTheScoredMapping() {
+    auto config = testCoordinatorConfig(100);
+    std::remove(config.resultsFilePath.c_str());
+    ClusterCoordinator coordinator(config);
+    ASSERT_TRUE(coordinator.start());
+    
+    ClusterClient client(testClientConfig(coordinator.getPort(), "epsilon"));
+    ASSERT_TRUE(client.connect());
+    uint64_t blockIndex = 0, startIndex = 0, endIndex = 0;
+    ASSERT_TRUE(client.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+    ASSERT_TRUE(client.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+    ASSERT_EQ(100ULL, startIndex);
+    
+    // Every mapping is a high score, reported the way ThreadManager forwards them
+    VoynichDecoder::DecoderConfig decoderConfig;
+    decoderConfig.translatorType = VoynichDecoder::TranslatorType::PERMUTATION;
+    decoderConfig.scoreThreshold = 0.0;
+    decoderConfig.resultsFilePath = "test_cluster_node_results.txt";
+    std::vector<VoynichDecoder::ProcessingResult> reported;
+    {
+        VoynichDecoder decoder(decoderConfig);
+        ASSERT_TRUE(decoder.initialize());
+        ASSERT_TRUE(decoder.processMappingRange(startIndex + 40, startIndex + 44, 0,
+            [&](const VoynichDecoder::ProcessingResult& result) {
+                if (result.isHighScore && result.hasPermutation &&
+                    client.submitResult(result.mappingIndex, result.permutation, result.score, result.matchedWords, result.totalWords)) {
+                    reported.push_back(result);
+                }
+            },
+            [](int, uint64_t, uint64_t, double, bool) {}));
+    }
+    std::remove(decoderConfig.resultsFilePath.c_str());
+    ASSERT_EQ(4ULL, static_cast<uint64_t>(reported.size()));
+    
+    // Each coordinator record names the generator index and the permutation scored there
+    coordinator.flushResults();
+    std::ifstream results(config.resultsFilePath);
+    std::stringstream contents;
+    contents << results.rdbuf();
+    results.close();
+    for (size_t i = 0; i < reported.size(); ++i) {
+        uint64_t mappingIndex = startIndex + 40 + i;
+        ASSERT_EQ(mappingIndex, reported[i].mappingIndex);
+        Permutation scored;
+        MappingGenerator::unrankPermutation(mappingIndex, scored);
+        ASSERT_TRUE(reported[i].permutation == scored);
+        
+        Mapping mapping;
+        PermutationTranslator::permutationToMapping(scored, mapping);
+        std::string record = "Mapping ID: " + std::to_string(mappingIndex) + "\n";
+        size_t position = contents.str().find(record);
+        ASSERT_TRUE(position != std::string::npos);
+        ASSERT_TRUE(contents.str().find(mapping.serializeMappingVisualization(), position) != std::string::npos);
+    }
+    std::remove(config.resultsFilePath.c_str());
+    
+    client.disconnect();
+    coordinator.stop();
+}
+
+void testClusterSchedulerCoversLeasedBlocks() {
+    ClusterCoordinator coordinator(testCoordinatorConfig(1000));
+    ASSERT_TRUE(coordinator.start());
+    
+    ClusterClient client(testClientConfig(coordinator.getPort(), "delta"));
+    ASSERT_TRUE(client.connect());
+    
+    // The node's worker threads split leased blocks exactly as they split local ones
+    WorkStealingScheduler::SchedulerConfig config;
+    config.chunkSize = 128;
+    config.minStealSize = 32;
+    config.mappingBudget = 3000;
+    const int workerCount = 3;
+    WorkStealingScheduler scheduler(client, workerCount, config);
+    
+    std::atomic<uint64_t> scored(0);
+    std::vector<std::thread> workers;
+    for (int workerId = 0; workerId < workerCount; workerId++) {
+        workers.emplace_back([&, workerId]() {
+            WorkStealingScheduler::WorkItem item;
+            while (scheduler.acquire(workerId, item)) {
+                scored += item.size();
+                scheduler.complete(item);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    ASSERT_EQ(3000ULL, scored.load());
+    ASSERT_EQ(3ULL, coordinator.getStats().blocksCompleted);
+    ASSERT_EQ(3ULL, coordinator.getGenerator().getCurrentState().totalBlocksCompleted);
+    
+    client.disconnect();
+    coordinator.stop();
+}
+
+void registerClusterCoordinatorTests(TestFramework& framework) {
+    framework.addTest("Cluster Lease And Complete", testClusterLeaseAndComplete);
+    framework.addTest("Cluster Expired Lease Is Reassigned", testClusterExpiredLeaseIsReassigned);
+    framework.addTest("Cluster Disconnect Releases Leases And Gathers Results", testClusterDisconnectReleasesLeasesAndGathersResults);
+    framework.addTest("Cluster Result Is The Scored Mapping", testClusterResultIsTheScoredMapping);
+    framework.addTest("Cluster Scheduler Covers Leased Blocks", testClusterSchedulerCoversLeasedBlocks);
+}
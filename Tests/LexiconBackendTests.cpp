@@ -0,0 +1,177 @@
+#include "TestFramework.h"
+#include "TestSupport.h"
+#include "../HebrewValidator.h"
+#include "../HebrewLexicon.h"
+#include "../PerfectHashSet.h"
+#include "../WordSet.h"
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+
+class LexiconBackendTests {
+private:
+    // Mix of real lexicon masks and random (mostly absent) masks
+    static std::vector<uint32_t> createProbeMasks() {
+        WordSet hebrewWords;
+        hebrewWords.readFromFile("resources/Tanah2.txt", Alphabet::HEBREW);
+
+        std::vector<uint32_t> probes;
+        std::mt19937 rng(42);
+        for (uint32_t mask : hebrewWords.getLetterMasks()) {
+            probes.push_back(mask);
+            probes.push_back(rng() & Word::FULL_MASK);
+        }
+        probes.push_back(0);
+        probes.push_back(0xFFFFFFFFu);
+        return probes;
+    }
+
+public:
+    void testPerfectHashSet() {
+        std::mt19937 rng(1);
+        std::vector<uint32_t> keys;
+        std::set<uint32_t> reference;
+        for (int i = 0; i < 5000; i++) {
+            uint32_t key = (rng() & Word::FULL_MASK) | 1u;
+            keys.push_back(key);
+            keys.push_back(key); // Duplicates are ignored
+            reference.insert(key);
+        }
+
+        PerfectHashSet set;
+        set.build(keys);
+        ASSERT_EQ(static_cast<uint64_t>(reference.size()), static_cast<uint64_t>(set.size()));
+
+        for (uint32_t key : reference) {
+            ASSERT_TRUE(set.contains(key));
+        }
+        for (int i = 0; i < 20000; i++) {
+            uint32_t key = rng();
+            ASSERT_TRUE(set.contains(key) == (reference.count(key) > 0));
+        }
+        ASSERT_FALSE(set.contains(0));
+
+        PerfectHashSet empty;
+        empty.build(std::vector<uint32_t>());
+        ASSERT_FALSE(empty.contains(1));
+
+        std::cout << "✓ PerfectHashSet test passed (" << set.size() << " keys, "
+                  << set.memoryBytes() << " bytes)" << std::endl;
+    }
+
+    void testBackendsAgree() {
+        HebrewValidator hashValidator(TestSupport::createValidatorConfig(HebrewValidator::LexiconBackend::HASH_SET));
+        HebrewValidator bitsetValidator(TestSupport::createValidatorConfig(HebrewValidator::LexiconBackend::BITSET));
+        HebrewValidator perfectValidator(TestSupport::createValidatorConfig(HebrewValidator::LexiconBackend::PERFECT_HASH));
+
+        auto hashStats = hashValidator.getLexiconStats();
+        if (hashStats.uniqueMasks == 0) {
+            std::cout << "⚠ resources/Tanah2.txt not found - lexicon backend comparison skipped" << std::endl;
+            return;
+        }
+        ASSERT_EQ(static_cast<uint64_t>(hashStats.uniqueMasks), static_cast<uint64_t>(bitsetValidator.getLexiconStats().uniqueMasks));
+        ASSERT_EQ(static_cast<uint64_t>(hashStats.uniqueMasks), static_cast<uint64_t>(perfectValidator.getLexiconStats().uniqueMasks));
+
+        std::vector<uint32_t> probes = createProbeMasks();
+        for (size_t i = 0; i < probes.size(); i++) {
+            size_t expected = hashValidator.validateMasks(&probes[i], 1).matchedWords;
+            ASSERT_EQ(static_cast<uint64_t>(expected), static_cast<uint64_t>(bitsetValidator.validateMasks(&probes[i], 1).matchedWords));
+            ASSERT_EQ(static_cast<uint64_t>(expected), static_cast<uint64_t>(perfectValidator.validateMasks(&probes[i], 1).matchedWords));
+        }
+
+        auto expected = hashValidator.validateTranslation(probes);
+        ASSERT_TRUE(expected.score == bitsetValidator.validateTranslation(probes).score);
+        ASSERT_TRUE(expected.score == perfectValidator.validateTranslation(probes).score);
+
+        std::cout << "✓ Lexicon backends agree on " << probes.size() << " probes" << std::endl;
+    }
+
+    void testSharedLexicon() {
+        auto config = TestSupport::createValidatorConfig(HebrewValidator::LexiconBackend::PERFECT_HASH);
+        
+        // Validators with the same path and backend attach to one lexicon instance
+        HebrewValidator first(config);
+        HebrewValidator second(config);
+        ASSERT_TRUE(first.getLexicon() == second.getLexicon());
+        ASSERT_TRUE(first.getLexicon() == HebrewLexicon::acquire(config.hebrewLexiconPath, config.lexiconBackend));
+        
+        // A different backend is a different lexicon
+        HebrewValidator bitsetValidator(TestSupport::createValidatorConfig(HebrewValidator::LexiconBackend::BITSET));
+        ASSERT_TRUE(bitsetValidator.getLexicon() != first.getLexicon());
+        
+        // An explicitly supplied lexicon is used as-is
+        HebrewValidator injected(config, bitsetValidator.getLexicon());
+        ASSERT_TRUE(injected.getLexicon() == bitsetValidator.getLexicon());
+        
+        // Missing files yield an empty (but ready) lexicon that matches nothing
+        HebrewValidator::ValidatorConfig missingConfig;
+        missingConfig.hebrewLexiconPath = "does_not_exist_lexicon.txt";
+        missingConfig.enableResultsSaving = false;
+        HebrewValidator missing(missingConfig);
+        ASSERT_TRUE(missing.isLexiconReady());
+        uint32_t mask = 1;
+        ASSERT_EQ(static_cast<uint64_t>(0), static_cast<uint64_t>(missing.validateMasks(&mask, 1).matchedWords));
+        
+        std::cout << "✓ Shared lexicon test passed" << std::endl;
+    }
+    
+    void testBackendBenchmark() {
+        std::vector<uint32_t> probes = createProbeMasks();
+        HebrewValidator::LexiconBackend backends[] = {
+            HebrewValidator::LexiconBackend::HASH_SET,
+            HebrewValidator::LexiconBackend::BITSET,
+            HebrewValidator::LexiconBackend::PERFECT_HASH
+        };
+        const char* names[] = { "HASH_SET", "BITSET", "PERFECT_HASH" };
+        const int rounds = 20;
+
+        size_t expectedMatches = 0;
+        for (int b = 0; b < 3; b++) {
+            HebrewValidator validator(TestSupport::createValidatorConfig(backends[b]));
+            size_t matches = 0;
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int round = 0; round < rounds; round++) {
+                matches += validator.validateTranslation(probes).matchedWords;
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            if (b == 0) expectedMatches = matches;
+            ASSERT_EQ(static_cast<uint64_t>(expectedMatches), static_cast<uint64_t>(matches));
+
+            auto ms = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+            std::cout << "  " << names[b] << ": " << ms << " ms for " << (probes.size() * rounds) << " probes, "
+                      << validator.getLexiconStats().memoryBytes << " bytes" << std::endl;
+        }
+
+        std::cout << "✓ Lexicon backend benchmark completed" << std::endl;
+    }
+};
+
+void testLexiconPerfectHashSet() {
+    LexiconBackendTests tests;
+    tests.testPerfectHashSet();
+}
+
+void testLexiconBackendsAgree() {
+    LexiconBackendTests tests;
+    tests.testBackendsAgree();
+}
+
+void testLexiconSharedAcrossValidators() {
+    LexiconBackendTests tests;
+    tests.testSharedLexicon();
+}
+
+void testLexiconBackendBenchmark() {
+    LexiconBackendTests tests;
+    tests.testBackendBenchmark();
+}
+
+void registerLexiconBackendTests(TestFramework& framework) {
+    framework.addTest("Lexicon Perfect Hash Set", testLexiconPerfectHashSet);
+    framework.addTest("Lexicon Backends Agree", testLexiconBackendsAgree);
+    framework.addTest("Lexicon Shared Across Validators", testLexiconSharedAcrossValidators);
+    framework.addTest("Lexicon Backend Benchmark", testLexiconBackendBenchmark);
+}
\ No newline at end of file
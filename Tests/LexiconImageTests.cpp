@@ -0,0 +1,143 @@
+#include "TestFramework.h"
+#include "../HebrewLexicon.h"
+#include "../MappedFile.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    // The first lineCount lines of the real lexicon, as a separate word file
+    bool writeWordFile(const std::string& filePath, size_t lineCount) {
+        std::ifstream source("resources/Tanah2.txt", std::ios::binary);
+        std::ofstream target(filePath, std::ios::binary | std::ios::trunc);
+        std::string line;
+        for (size_t i = 0; i < lineCount && std::getline(source, line); ++i) {
+            target << line << '\n';
+        }
+        return source.is_open() && target.good();
+    }
+
+    bool sameLexicon(const HebrewLexicon& expected, const HebrewLexicon& actual) {
+        if (expected.getWordCount() != actual.getWordCount() || expected.getDistinctMasks() != actual.getDistinctMasks()) {
+            return false;
+        }
+
+        // Lexicon masks, near misses and random masks all give the same answer
+        std::mt19937 rng(26);
+        std::vector<uint32_t> probes;
+        for (uint32_t mask : expected.getDistinctMasks()) {
+            probes.push_back(mask);
+            probes.push_back(mask ^ (1u << (rng() % Word::ALPHABET_SIZE)));
+            probes.push_back(rng() & Word::FULL_MASK);
+        }
+        for (uint32_t mask : probes) {
+            if (expected.contains(mask) != actual.contains(mask)) {
+                return false;
+            }
+        }
+        return expected.countMatches(probes.data(), probes.size()) == actual.countMatches(probes.data(), probes.size());
+    }
+}
+
+void testLexiconImageRoundTrip() {
+    const std::string imagePath = "test_lexicon_image.bin";
+    WordSet hebrewWords;
+    hebrewWords.readFromFile("resources/Tanah2.txt", Alphabet::HEBREW);
+    if (hebrewWords.size() == 0) {
+        std::cout << "⚠ resources not found - lexicon image test skipped" << std::endl;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    HebrewLexicon parsed(hebrewWords, HebrewLexicon::Backend::PERFECT_HASH);
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_TRUE(parsed.saveImage(imagePath, "resources/Tanah2.txt"));
+
+    // Every backend is rebuilt from the image and probes like the parsed lexicon
+    for (auto backend : { HebrewLexicon::Backend::HASH_SET, HebrewLexicon::Backend::BITSET, HebrewLexicon::Backend::PERFECT_HASH }) {
+        start = std::chrono::steady_clock::now();
+        auto mapped = HebrewLexicon::loadImage(imagePath, "resources/Tanah2.txt", backend);
+        double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        ASSERT_TRUE(mapped != nullptr);
+        ASSERT_TRUE(mapped->getBackend() == backend);
+        ASSERT_TRUE(sameLexicon(HebrewLexicon(hebrewWords, backend), *mapped));
+        if (backend == HebrewLexicon::Backend::PERFECT_HASH) {
+            std::cout << "  perfect hash: built in " << buildMs << " ms (after parsing), mapped in " << loadMs << " ms" << std::endl;
+        }
+    }
+    std::remove(imagePath.c_str());
+}
+
+void testLexiconImageRebuiltWhenStale() {
+    const std::string wordsPath = "test_lexicon_words.txt";
+    const std::string imagePath = "test_lexicon_words.bin";
+    std::remove(imagePath.c_str());
+    ASSERT_TRUE(writeWordFile(wordsPath, 500));
+
+    // The first acquire parses the words and writes the image the next one maps
+    {
+        auto parsed = HebrewLexicon::acquire(wordsPath, HebrewLexicon::Backend::PERFECT_HASH, imagePath);
+        ASSERT_TRUE(!parsed->empty());
+        auto mapped = HebrewLexicon::loadImage(imagePath, wordsPath, HebrewLexicon::Backend::PERFECT_HASH);
+        ASSERT_TRUE(mapped != nullptr);
+        ASSERT_TRUE(sameLexicon(*parsed, *mapped));
+    }
+
+    // A changed word file makes the image stale; the next acquire replaces it
+    ASSERT_TRUE(writeWordFile(wordsPath, 800));
+    ASSERT_TRUE(HebrewLexicon::loadImage(imagePath, wordsPath, HebrewLexicon::Backend::PERFECT_HASH) == nullptr);
+    {
+        auto reparsed = HebrewLexicon::acquire(wordsPath, HebrewLexicon::Backend::BITSET, imagePath);
+        ASSERT_EQ(800ULL, static_cast<uint64_t>(reparsed->getWordCount()));
+        auto mapped = HebrewLexicon::loadImage(imagePath, wordsPath, HebrewLexicon::Backend::BITSET);
+        ASSERT_TRUE(mapped != nullptr);
+        ASSERT_TRUE(sameLexicon(*reparsed, *mapped));
+    }
+
+    // Without its word file the image is used as is
+    std::remove(wordsPath.c_str());
+    auto shipped = HebrewLexicon::loadImage(imagePath, wordsPath, HebrewLexicon::Backend::HASH_SET);
+    ASSERT_TRUE(shipped != nullptr);
+    ASSERT_EQ(800ULL, static_cast<uint64_t>(shipped->getWordCount()));
+
+    // A damaged image is rejected
+    {
+        std::fstream file(imagePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(40);
+        file.put('\x5A');
+    }
+    ASSERT_TRUE(HebrewLexicon::loadImage(imagePath, wordsPath, HebrewLexicon::Backend::HASH_SET) == nullptr);
+    std::remove(imagePath.c_str());
+}
+
+void testMappedFile() {
+    const std::string filePath = "test_mapped_file.bin";
+    MappedFile file;
+    std::remove(filePath.c_str());
+    ASSERT_FALSE(file.open(filePath));
+    ASSERT_FALSE(file.isOpen());
+
+    { std::ofstream empty(filePath, std::ios::binary | std::ios::trunc); }
+    ASSERT_TRUE(file.open(filePath));
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(file.size()));
+
+    {
+        std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+        out << "VDLX lexicon";
+    }
+    ASSERT_TRUE(file.open(filePath));
+    ASSERT_EQ(12ULL, static_cast<uint64_t>(file.size()));
+    ASSERT_TRUE(std::string(reinterpret_cast<const char*>(file.data()), file.size()) == "VDLX lexicon");
+    file.close();
+    ASSERT_FALSE(file.isOpen());
+    std::remove(filePath.c_str());
+}
+
+void registerLexiconImageTests(TestFramework& framework) {
+    framework.addTest("Lexicon Image Round Trip", testLexiconImageRoundTrip);
+    framework.addTest("Lexicon Image Rebuilt When Stale", testLexiconImageRebuiltWhenStale);
+    framework.addTest("Mapped File", testMappedFile);
+}
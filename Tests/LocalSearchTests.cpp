@@ -0,0 +1,193 @@
+#include "TestFramework.h"
+#include "TestSupport.h"
+#include "../LocalSearch.h"
+#include "../PrefixSearch.h"
+#include "../VoynichDecoder.h"
+#include "../PermutationTranslator.h"
+#include <vector>
+#include <cstdio>
+
+void testLocalSearchReportsExactImprovements() {
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    if (voynich.size() == 0) {
+        std::cout << "⚠ resources not found - local search test skipped" << std::endl;
+        return;
+    }
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    
+    // Annealing and hill climbing: reported counts are exact and rise until a restart
+    LocalSearch::SearchConfig config;
+    config.movesPerRound = 20000;
+    config.randomSeed = 25;
+    for (double temperature : { 2.0, 0.0 }) {
+        config.initialTemperature = temperature;
+        LocalSearch search(voynich, lexicon, config);
+        auto chain = search.createChain(0);
+        const uint64_t probedAtCreation = chain->scorer.getWordsProbed();
+        size_t previous = chain->bestMatched;
+        uint64_t reported = 0;
+        LocalSearch::RoundStats stats;
+        for (int round = 0; round < 10; ++round) {
+            uint64_t restartsBefore = stats.restarts;
+            size_t startMatched = chain->bestMatched;
+            ASSERT_TRUE(search.runRound(*chain, [&](const Permutation& permutation, size_t matched) {
+                ASSERT_TRUE(matched > previous);
+                ASSERT_EQ(static_cast<uint64_t>(TestSupport::countMatches(*lexicon, voynich, permutation)), static_cast<uint64_t>(matched));
+                previous = matched;
+                reported++;
+            }, nullptr, stats));
+            ASSERT_TRUE(chain->bestMatched >= startMatched || stats.restarts > restartsBefore);
+            previous = chain->bestMatched;
+            
+            // The incremental score follows the chain's current permutation
+            ASSERT_EQ(static_cast<uint64_t>(TestSupport::countMatches(*lexicon, voynich, chain->scorer.getPermutation())),
+                      static_cast<uint64_t>(chain->scorer.getMatchedWords()));
+        }
+        ASSERT_EQ(200000ULL, stats.movesEvaluated);
+        ASSERT_TRUE(stats.movesAccepted <= stats.movesEvaluated);
+        ASSERT_TRUE(reported > 0);
+        
+        // Probes are the words the scorer actually looked up, fewer than a full rescoring per move
+        ASSERT_EQ(chain->scorer.getWordsProbed() - probedAtCreation, stats.wordsProbed);
+        ASSERT_TRUE(stats.wordsProbed > stats.movesEvaluated);
+        ASSERT_TRUE(stats.wordsProbed < stats.movesEvaluated * voynich.size());
+        ASSERT_TRUE(stats.wordsProbedMatched <= stats.wordsProbed);
+        
+        auto progress = search.getProgress();
+        ASSERT_EQ(stats.movesEvaluated, progress.totals.movesEvaluated);
+        ASSERT_EQ(stats.wordsProbed, progress.totals.wordsProbed);
+        ASSERT_TRUE(progress.bestMatched > 0);
+        std::cout << "  temperature " << temperature << ": best " << progress.bestMatched << " of " << voynich.size()
+                  << " words after " << progress.secondsToBest << " s, " << stats.restarts << " restarts" << std::endl;
+    }
+}
+
+void testLocalSearchBudgetAndTarget() {
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    
+    LocalSearch::SearchConfig baseConfig;
+    baseConfig.movesPerRound = 20000;
+    baseConfig.initialTemperature = 2.0;
+    baseConfig.randomSeed = 25;
+    
+    // Rounds share the budget; the last one gets what is left
+    LocalSearch::SearchConfig config = baseConfig;
+    config.moveBudget = 50000;
+    LocalSearch budgeted(voynich, lexicon, config);
+    auto first = budgeted.createChain(0);
+    auto second = budgeted.createChain(1);
+    LocalSearch::RoundStats stats;
+    ASSERT_TRUE(budgeted.runRound(*first, nullptr, nullptr, stats));
+    ASSERT_TRUE(budgeted.runRound(*second, nullptr, nullptr, stats));
+    ASSERT_TRUE(budgeted.runRound(*first, nullptr, nullptr, stats));
+    ASSERT_FALSE(budgeted.runRound(*second, nullptr, nullptr, stats));
+    ASSERT_TRUE(budgeted.isFinished());
+    ASSERT_EQ(50000ULL, stats.movesEvaluated);
+    
+    // Reaching the target ends the search at once
+    config = baseConfig;
+    LocalSearch probe(voynich, lexicon, config);
+    config.targetMatched = probe.createChain(0)->bestMatched + 1;
+    LocalSearch targeted(voynich, lexicon, config);
+    auto chain = targeted.createChain(0);
+    stats = LocalSearch::RoundStats();
+    for (int round = 0; round < 50 && targeted.runRound(*chain, nullptr, nullptr, stats); ++round) {
+    }
+    ASSERT_TRUE(targeted.isFinished());
+    ASSERT_TRUE(targeted.getProgress().bestMatched >= config.targetMatched);
+    ASSERT_TRUE(stats.movesEvaluated < 50ULL * config.movesPerRound);
+    
+    // A stop request ends the round early without finishing the search
+    LocalSearch stopped(voynich, lexicon, baseConfig);
+    auto stoppedChain = stopped.createChain(0);
+    stats = LocalSearch::RoundStats();
+    ASSERT_FALSE(stopped.runRound(*stoppedChain, nullptr, []() { return true; }, stats));
+    ASSERT_FALSE(stopped.isFinished());
+    ASSERT_TRUE(stats.movesEvaluated < 20000ULL);
+}
+
+void testLocalSearchExchangesBest() {
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    
+    LocalSearch::SearchConfig baseConfig;
+    baseConfig.movesPerRound = 20000;
+    baseConfig.initialTemperature = 1.0;
+    baseConfig.randomSeed = 25;
+    
+    // Restarting every round, always from the shared best
+    LocalSearch::SearchConfig config = baseConfig;
+    config.stuckRounds = 0;
+    config.adoptBestProbability = 1.0;
+    LocalSearch search(voynich, lexicon, config);
+    auto first = search.createChain(0);
+    auto second = search.createChain(1);
+    LocalSearch::RoundStats stats;
+    ASSERT_TRUE(search.runRound(*first, nullptr, nullptr, stats));
+    ASSERT_TRUE(search.runRound(*second, nullptr, nullptr, stats));
+    auto progress = search.getProgress();
+    ASSERT_EQ(2ULL, progress.chains);
+    ASSERT_EQ(2ULL, progress.totals.restarts);
+    ASSERT_EQ(static_cast<uint64_t>(progress.bestMatched), static_cast<uint64_t>(second->scorer.getMatchedWords()));
+    ASSERT_EQ(static_cast<uint64_t>(progress.bestMatched), static_cast<uint64_t>(second->bestMatched));
+    
+    // Seeded chains start where they are told
+    config = baseConfig;
+    config.seedPermutations.push_back(second->best);
+    LocalSearch seeded(voynich, lexicon, config);
+    auto seededChain = seeded.createChain(3);
+    ASSERT_TRUE(seededChain->scorer.getPermutation() == second->best);
+    ASSERT_EQ(static_cast<uint64_t>(progress.bestMatched), static_cast<uint64_t>(seededChain->bestMatched));
+}
+
+void testDecoderLocalSearchResults() {
+    const std::string resultsPath = "test_local_search_results.txt";
+    std::remove(resultsPath.c_str());
+    VoynichDecoder::DecoderConfig config;
+    config.translatorType = VoynichDecoder::TranslatorType::PERMUTATION;
+    config.scoreThreshold = 101.0;
+    config.topResultsCount = 8;
+    config.resultsFilePath = resultsPath;
+    VoynichDecoder decoder(config);
+    ASSERT_TRUE(decoder.initialize());
+    
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    LocalSearch::SearchConfig searchConfig;
+    searchConfig.movesPerRound = 20000;
+    searchConfig.randomSeed = 25;
+    LocalSearch search(voynich, lexicon, searchConfig);
+    auto chain = search.createChain(0);
+    
+    uint64_t reported = 0;
+    for (int round = 0; round < 5; ++round) {
+        ASSERT_TRUE(decoder.processLocalSearchRound(search, *chain, 0,
+            [&reported](const VoynichDecoder::ProcessingResult&) { reported++; },
+            [](int, uint64_t, uint64_t, double, bool) {}));
+    }
+    ASSERT_TRUE(reported > 0);
+    
+    // Kept entries are keyed by their permutation and rescore to the same count
+    auto top = decoder.getTopResults().getSorted();
+    ASSERT_TRUE(!top.empty());
+    ASSERT_TRUE(top.front().matchedWords <= search.getProgress().bestMatched);  // Scores clamp at 100, so ties are kept in arrival order
+    for (const auto& entry : top) {
+        ASSERT_EQ(PrefixSearch::leafKey(entry.permutation), entry.mappingIndex);
+        Mapping mapping;
+        PermutationTranslator::permutationToMapping(entry.permutation, mapping);
+        ASSERT_EQ(static_cast<int>(decoder.processMapping(mapping).matchedWords), static_cast<int>(entry.matchedWords));
+    }
+    std::remove(resultsPath.c_str());
+}
+
+void registerLocalSearchTests(TestFramework& framework) {
+    framework.addTest("Local Search Reports Exact Improvements", testLocalSearchReportsExactImprovements);
+    framework.addTest("Local Search Budget And Target", testLocalSearchBudgetAndTarget);
+    framework.addTest("Local Search Exchanges Best", testLocalSearchExchangesBest);
+    framework.addTest("Decoder Local Search Results", testDecoderLocalSearchResults);
+}
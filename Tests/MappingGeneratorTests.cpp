@@ -1,7 +1,14 @@
 #include "TestFramework.h"
 #include "../MappingGenerator.h"
+#include "../PermutationTranslator.h"
 #include <memory>
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 
 void testMappingGeneratorConstruction() {
     MappingGenerator::GeneratorConfig config;
@@ -190,7 +197,8 @@ void testGeneratorConfigStructure() {
     MappingGenerator::GeneratorConfig config;
     
     ASSERT_EQ(1000000ULL, config.blockSize);
-    ASSERT_TRUE(config.stateFilePath == "mapping_generator_state.json");
+    ASSERT_TRUE(config.stateFilePath == "mapping_generator_state.bin");
+    ASSERT_TRUE(config.stateFormat == MappingGenerator::StateFileFormat::BINARY);
     ASSERT_TRUE(config.enableStateFile);
 }
 
@@ -274,6 +282,298 @@ void testStateConsistency() {
     ASSERT_EQ(10ULL, block.size());
 }
 
+void testBlockCursorMatchesGetNextBlock() {
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 500;
+    config.enableStateFile = false;
+    
+    MappingGenerator materialized(config);
+    MappingGenerator streaming(config);
+    
+    // Three consecutive blocks yield the same permutations in the same order
+    for (int blockNumber = 0; blockNumber < 3; blockNumber++) {
+        auto block = materialized.getNextBlock(0);
+        auto cursor = streaming.getNextBlockCursor(0);
+        ASSERT_EQ(static_cast<uint64_t>(block.size()), cursor.size());
+        ASSERT_EQ(static_cast<uint64_t>(blockNumber) * 500ULL, cursor.startIndex());
+        
+        Permutation permutation;
+        Permutation expected;
+        uint64_t globalIndex = 0;
+        size_t position = 0;
+        while (cursor.next(permutation, globalIndex)) {
+            ASSERT_EQ(cursor.startIndex() + position, globalIndex);
+            ASSERT_TRUE(PermutationTranslator::permutationFromMapping(*block[position], expected));
+            ASSERT_TRUE(expected == permutation);
+            position++;
+        }
+        ASSERT_EQ(static_cast<uint64_t>(block.size()), static_cast<uint64_t>(position));
+        ASSERT_EQ(0ULL, cursor.remaining());
+        
+        materialized.completeBlockForTesting(0);
+        streaming.completeBlockForTesting(0);
+    }
+    
+    ASSERT_EQ(materialized.getCurrentState().totalBlocksCompleted, streaming.getCurrentState().totalBlocksCompleted);
+    ASSERT_EQ(3ULL, streaming.getCurrentState().totalBlocksCompleted);
+}
+
+void testBlockCursorAcrossPrefixChange() {
+    // 25! wraps in 64 bits; the leading positions change there, so the cursor must re-unrank
+    uint64_t boundary = 1;
+    for (int i = 2; i <= 25; i++) boundary *= i;
+    
+    MappingGenerator::BlockCursor cursor(boundary - 300, boundary + 300);
+    Permutation permutation;
+    Permutation expected;
+    uint64_t globalIndex = 0;
+    uint64_t count = 0;
+    while (cursor.next(permutation, globalIndex)) {
+        ASSERT_EQ(boundary - 300 + count, globalIndex);
+        MappingGenerator::unrankPermutation(globalIndex, expected);
+        ASSERT_TRUE(expected == permutation);
+        count++;
+    }
+    ASSERT_EQ(600ULL, count);
+    
+    MappingGenerator::BlockCursor emptyCursor;
+    ASSERT_TRUE(emptyCursor.empty());
+    ASSERT_FALSE(emptyCursor.next(permutation, globalIndex));
+}
+
+void testConcurrentBlockClaims() {
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 7;
+    config.enableStateFile = false;
+    
+    MappingGenerator generator(config);
+    
+    // Many threads claim and complete small blocks concurrently
+    const int threadCount = 8;
+    const int blocksPerThread = 250;
+    std::vector<std::vector<uint64_t>> claimed(threadCount);
+    std::vector<std::thread> threads;
+    for (int threadId = 0; threadId < threadCount; threadId++) {
+        threads.emplace_back([&generator, &claimed, threadId]() {
+            for (int i = 0; i < blocksPerThread; i++) {
+                uint64_t startIndex = 0;
+                uint64_t endIndex = 0;
+                if (generator.claimBlockRange(threadId, startIndex, endIndex)) {
+                    claimed[threadId].push_back(startIndex);
+                    generator.completeBlockForTesting(threadId);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    // Every block was handed out exactly once, with no gaps
+    std::vector<uint64_t> all;
+    for (const auto& starts : claimed) {
+        all.insert(all.end(), starts.begin(), starts.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * blocksPerThread), static_cast<uint64_t>(all.size()));
+    for (size_t i = 0; i < all.size(); i++) {
+        ASSERT_EQ(static_cast<uint64_t>(i) * 7ULL, all[i]);
+    }
+    
+    auto state = generator.getCurrentState();
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * blocksPerThread), state.totalBlocksGenerated);
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * blocksPerThread), state.totalBlocksCompleted);
+    ASSERT_EQ(state.nextBlockToGenerate, state.oldestTrackedBlock);
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(generator.getBlockStatus().windowSize));
+}
+
+void testBackgroundCheckpoint() {
+    const std::string stateFile = "test_checkpoint_generator_state.json";
+    std::remove(stateFile.c_str());
+    
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 11;
+    config.stateFilePath = stateFile;
+    config.checkpointIntervalMs = 20;
+    
+    {
+        MappingGenerator generator(config);
+        uint64_t startIndex = 0;
+        uint64_t endIndex = 0;
+        ASSERT_TRUE(generator.claimBlockRange(0, startIndex, endIndex));
+        generator.completeBlockForTesting(0);
+        ASSERT_TRUE(generator.claimBlockRange(1, startIndex, endIndex));
+        
+        // The checkpointer persists the claims without any explicit save
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        MappingGenerator::GeneratorConfig readConfig = config;
+        readConfig.checkpointIntervalMs = 0;
+        MappingGenerator reader(readConfig);
+        auto saved = reader.getCurrentState();
+        ASSERT_EQ(2ULL, saved.nextBlockToGenerate);
+        ASSERT_EQ(1ULL, saved.totalBlocksCompleted);
+    }
+    
+    // The unfinished block is handed out again after a restart
+    {
+        MappingGenerator resumed(config);
+        uint64_t startIndex = 0;
+        uint64_t endIndex = 0;
+        ASSERT_TRUE(resumed.claimBlockRange(5, startIndex, endIndex));
+        ASSERT_EQ(11ULL, startIndex);
+        ASSERT_TRUE(resumed.claimBlockRange(6, startIndex, endIndex));
+        ASSERT_EQ(22ULL, startIndex);
+    }
+    
+    std::remove(stateFile.c_str());
+}
+
+void testSharedBlockClaims() {
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 5;
+    config.enableStateFile = false;
+    
+    MappingGenerator generator(config);
+    
+    // A thread can hold several shared claims; claiming again does not complete the first
+    uint64_t blockIndex = 0;
+    uint64_t startIndex = 0;
+    uint64_t endIndex = 0;
+    ASSERT_TRUE(generator.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+    ASSERT_EQ(0ULL, blockIndex);
+    ASSERT_TRUE(generator.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+    ASSERT_EQ(1ULL, blockIndex);
+    ASSERT_EQ(5ULL, startIndex);
+    ASSERT_EQ(10ULL, endIndex);
+    ASSERT_EQ(0ULL, generator.getCurrentState().totalBlocksCompleted);
+    ASSERT_EQ(2ULL, static_cast<uint64_t>(generator.getBlockStatus().activeBlocks));
+    
+    // Completion can come in any order (here from another thread's work on the claim)
+    generator.completeSharedBlock(0, 1);
+    auto window = generator.getWindowSnapshot();
+    ASSERT_EQ(2ULL, static_cast<uint64_t>(window.size()));
+    ASSERT_TRUE(window[0].state == MappingGenerator::BlockState::PENDING);
+    ASSERT_TRUE(window[1].state == MappingGenerator::BlockState::COMPLETED);
+    
+    generator.completeSharedBlock(0, 0);
+    generator.completeSharedBlock(0, 0);  // Already completed: ignored
+    auto state = generator.getCurrentState();
+    ASSERT_EQ(2ULL, state.totalBlocksCompleted);
+    ASSERT_EQ(2ULL, state.oldestTrackedBlock);
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(generator.getBlockStatus().windowSize));
+}
+
+namespace {
+    bool fileExists(const std::string& path) {
+        return std::ifstream(path).good();
+    }
+    
+    // Claim three blocks, complete the middle one: window = PENDING 0, COMPLETED 1, PENDING 2
+    void writeMixedWindowState(const MappingGenerator::GeneratorConfig& config) {
+        MappingGenerator generator(config);
+        uint64_t blockIndex = 0, startIndex = 0, endIndex = 0;
+        ASSERT_TRUE(generator.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+        ASSERT_TRUE(generator.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+        ASSERT_TRUE(generator.claimSharedBlock(0, blockIndex, startIndex, endIndex));
+        generator.completeSharedBlock(0, 1);
+        ASSERT_TRUE(generator.saveCurrentState());
+    }
+    
+    void assertMixedWindowResumed(const MappingGenerator::GeneratorConfig& config) {
+        MappingGenerator resumed(config);
+        auto state = resumed.getCurrentState();
+        ASSERT_EQ(3ULL, state.nextBlockToGenerate);
+        ASSERT_EQ(1ULL, state.totalBlocksCompleted);
+        
+        auto window = resumed.getWindowSnapshot();
+        ASSERT_EQ(3ULL, static_cast<uint64_t>(window.size()));
+        ASSERT_TRUE(window[0].state == MappingGenerator::BlockState::PENDING);
+        ASSERT_TRUE(window[1].state == MappingGenerator::BlockState::COMPLETED);
+        ASSERT_TRUE(window[2].state == MappingGenerator::BlockState::PENDING);
+        
+        // Pending blocks are served again before any new block
+        uint64_t startIndex = 0, endIndex = 0;
+        ASSERT_TRUE(resumed.claimBlockRange(0, startIndex, endIndex));
+        ASSERT_EQ(0ULL, startIndex);
+        ASSERT_TRUE(resumed.claimBlockRange(0, startIndex, endIndex));
+        ASSERT_EQ(14ULL, startIndex);
+        ASSERT_TRUE(resumed.claimBlockRange(0, startIndex, endIndex));
+        ASSERT_EQ(21ULL, startIndex);
+    }
+}
+
+void testBinaryStateRoundTrip() {
+    const std::string stateFile = "test_binary_generator_state.bin";
+    std::remove(stateFile.c_str());
+    
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 7;
+    config.stateFilePath = stateFile;
+    config.checkpointIntervalMs = 0;
+    
+    writeMixedWindowState(config);
+    
+    // The checkpoint is binary and no temporary file is left behind
+    std::ifstream file(stateFile, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    ASSERT_TRUE(contents.compare(0, 4, "VDGS") == 0);
+    ASSERT_FALSE(fileExists(stateFile + ".tmp"));
+    
+    assertMixedWindowResumed(config);
+    std::remove(stateFile.c_str());
+}
+
+void testJsonStateFormatAndLegacyResume() {
+    const std::string jsonFile = "test_legacy_generator_state.json";
+    const std::string binaryFile = "test_legacy_generator_state.bin";
+    std::remove(jsonFile.c_str());
+    std::remove(binaryFile.c_str());
+    
+    // A JSON checkpoint, as written before the binary format existed
+    MappingGenerator::GeneratorConfig jsonConfig;
+    jsonConfig.blockSize = 7;
+    jsonConfig.stateFilePath = jsonFile;
+    jsonConfig.checkpointIntervalMs = 0;
+    jsonConfig.stateFormat = MappingGenerator::StateFileFormat::JSON;
+    writeMixedWindowState(jsonConfig);
+    
+    // A binary-configured generator with no .bin file resumes from the .json beside it
+    MappingGenerator::GeneratorConfig binaryConfig = jsonConfig;
+    binaryConfig.stateFilePath = binaryFile;
+    binaryConfig.stateFormat = MappingGenerator::StateFileFormat::BINARY;
+    assertMixedWindowResumed(binaryConfig);
+    ASSERT_TRUE(fileExists(binaryFile));
+    
+    std::remove(jsonFile.c_str());
+    std::remove(binaryFile.c_str());
+}
+
+void testCorruptBinaryStateIsRejected() {
+    const std::string stateFile = "test_corrupt_generator_state.bin";
+    std::remove(stateFile.c_str());
+    
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 7;
+    config.stateFilePath = stateFile;
+    config.checkpointIntervalMs = 0;
+    writeMixedWindowState(config);
+    
+    // Flip one byte of the window records
+    std::fstream file(stateFile, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(70);
+    file.put('\x5A');
+    file.close();
+    
+    // The checksum catches it and the generator starts clean instead of trusting the data
+    MappingGenerator generator(config);
+    auto state = generator.getCurrentState();
+    ASSERT_EQ(0ULL, state.nextBlockToGenerate);
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(generator.getWindowSnapshot().size()));
+    
+    std::remove(stateFile.c_str());
+}
+
 void registerMappingGeneratorTests(TestFramework& framework) {
     framework.addTest("MappingGenerator Construction", testMappingGeneratorConstruction);
     framework.addTest("MappingGenerator Default Construction", testMappingGeneratorDefaultConstruction);
@@ -291,4 +591,12 @@ void registerMappingGeneratorTests(TestFramework& framework) {
     framework.addTest("Thread Safety Basic", testThreadSafety);
     framework.addTest("Block Window Management", testBlockWindowManagement);
     framework.addTest("State Consistency", testStateConsistency);
+    framework.addTest("Block Cursor Matches Get Next Block", testBlockCursorMatchesGetNextBlock);
+    framework.addTest("Block Cursor Across Prefix Change", testBlockCursorAcrossPrefixChange);
+    framework.addTest("Concurrent Block Claims", testConcurrentBlockClaims);
+    framework.addTest("Background Checkpoint", testBackgroundCheckpoint);
+    framework.addTest("Shared Block Claims", testSharedBlockClaims);
+    framework.addTest("Binary State Round Trip", testBinaryStateRoundTrip);
+    framework.addTest("JSON State Format And Legacy Resume", testJsonStateFormatAndLegacyResume);
+    framework.addTest("Corrupt Binary State Is Rejected", testCorruptBinaryStateIsRejected);
 }
\ No newline at end of file
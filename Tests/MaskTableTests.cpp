@@ -0,0 +1,120 @@
+#include "TestFramework.h"
+#include "TestSupport.h"
+#include "../WordSet.h"
+#include "../HebrewLexicon.h"
+#include "../IncrementalScorer.h"
+#include "../PermutationTranslator.h"
+#include "../VoynichDecoder.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <cstdio>
+
+namespace {
+    std::vector<uint32_t> translate(const std::vector<uint32_t>& evaMasks, const Permutation& permutation) {
+        PermutationTranslator::LookupTable table;
+        PermutationTranslator::buildLookupTable(permutation, table);
+        std::vector<uint32_t> hebrewMasks(evaMasks.size());
+        PermutationTranslator::translateMasks(table, evaMasks.data(), hebrewMasks.data(), evaMasks.size());
+        return hebrewMasks;
+    }
+}
+
+void testMaskTableCollapsesLetterSets() {
+    WordSet words;
+    words.addWord(Word(L"daiin", Alphabet::EVA));
+    words.addWord(Word(L"qokeedy", Alphabet::EVA));
+    words.addWord(Word(L"dain", Alphabet::EVA));
+    words.addWord(Word(L"nida", Alphabet::EVA));
+    words.addWord(Word(L"qokedy", Alphabet::EVA));
+    
+    // Masks in order of first occurrence, each counting the words that share it
+    WordSet::MaskTable table = words.buildMaskTable();
+    ASSERT_EQ(2ULL, static_cast<uint64_t>(table.masks.size()));
+    ASSERT_EQ(static_cast<uint64_t>(table.masks.size()), static_cast<uint64_t>(table.weights.size()));
+    ASSERT_TRUE(table.masks[0] == words.getLetterMasks()[0]);
+    ASSERT_TRUE(table.masks[1] == words.getLetterMasks()[1]);
+    ASSERT_EQ(3, static_cast<int>(table.weights[0]));
+    ASSERT_EQ(2, static_cast<int>(table.weights[1]));
+    
+    // The real corpus: every word is accounted for once
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    WordSet::MaskTable voynichTable = voynich.buildMaskTable();
+    ASSERT_TRUE(voynichTable.masks.size() <= voynich.size());
+    ASSERT_EQ(static_cast<uint64_t>(voynich.size()),
+              std::accumulate(voynichTable.weights.begin(), voynichTable.weights.end(), uint64_t(0)));
+    std::cout << "  " << voynich.size() << " words, " << voynichTable.masks.size() << " distinct letter sets" << std::endl;
+}
+
+void testWeightedMatchesEqualPerWord() {
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    if (voynich.size() == 0) {
+        std::cout << "⚠ resources not found - weighted match comparison skipped" << std::endl;
+        return;
+    }
+    WordSet::MaskTable table = voynich.buildMaskTable();
+    
+    std::mt19937 rng(22);
+    for (auto backend : { HebrewLexicon::Backend::HASH_SET, HebrewLexicon::Backend::BITSET, HebrewLexicon::Backend::PERFECT_HASH }) {
+        auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", backend);
+        for (int i = 0; i < 200; i++) {
+            Permutation permutation = TestSupport::randomPermutation(rng);
+            std::vector<uint32_t> perWord = translate(voynich.getLetterMasks(), permutation);
+            std::vector<uint32_t> distinct = translate(table.masks, permutation);
+            ASSERT_EQ(static_cast<uint64_t>(lexicon->countMatches(perWord.data(), perWord.size())),
+                      static_cast<uint64_t>(lexicon->countMatches(distinct.data(), table.weights.data(), distinct.size())));
+        }
+    }
+    
+    // Swaps rescore only the affected distinct masks, still counting each by its weight
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    IncrementalScorer perWordScorer(voynich.getLetterMasks(), lexicon);
+    IncrementalScorer distinctScorer(table.masks, lexicon, table.weights);
+    Permutation permutation = PermutationTranslator::identityPermutation();
+    perWordScorer.reset(permutation);
+    distinctScorer.reset(permutation);
+    ASSERT_EQ(static_cast<uint64_t>(voynich.size()), static_cast<uint64_t>(distinctScorer.getTotalWords()));
+    for (int i = 0; i < 2000; i++) {
+        int a = rng() % Word::ALPHABET_SIZE;
+        int b = rng() % Word::ALPHABET_SIZE;
+        perWordScorer.applySwap(a, b);
+        distinctScorer.applySwap(a, b);
+        ASSERT_EQ(static_cast<uint64_t>(perWordScorer.getMatchedWords()), static_cast<uint64_t>(distinctScorer.getMatchedWords()));
+    }
+}
+
+void testDecoderScoresUnchangedByCollapsing() {
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    
+    for (auto translatorType : { VoynichDecoder::TranslatorType::CPU, VoynichDecoder::TranslatorType::PERMUTATION }) {
+        VoynichDecoder::DecoderConfig config;
+        config.translatorType = translatorType;
+        config.scoreThreshold = 101.0;
+        config.resultsFilePath = "test_mask_table_results.txt";
+        VoynichDecoder decoder(config);
+        ASSERT_TRUE(decoder.initialize());
+        
+        // The own-corpus path scores distinct masks; the WordSet overload still scores per word
+        std::mt19937 rng(7);
+        for (int i = 0; i < 100; i++) {
+            Mapping mapping;
+            PermutationTranslator::permutationToMapping(TestSupport::randomPermutation(rng), mapping);
+            auto collapsed = decoder.processMapping(mapping);
+            auto perWord = decoder.processMapping(voynich, mapping, false);
+            ASSERT_EQ(static_cast<uint64_t>(perWord.totalWords), static_cast<uint64_t>(collapsed.totalWords));
+            ASSERT_EQ(static_cast<uint64_t>(perWord.matchedWords), static_cast<uint64_t>(collapsed.matchedWords));
+            ASSERT_TRUE(perWord.score == collapsed.score);
+        }
+    }
+    std::remove("test_mask_table_results.txt");
+}
+
+void registerMaskTableTests(TestFramework& framework) {
+    framework.addTest("Mask Table Collapses Letter Sets", testMaskTableCollapsesLetterSets);
+    framework.addTest("Weighted Matches Equal Per Word", testWeightedMatchesEqualPerWord);
+    framework.addTest("Decoder Scores Unchanged By Collapsing", testDecoderScoresUnchangedByCollapsing);
+}
@@ -0,0 +1,153 @@
+#include "TestFramework.h"
+#include "../MetricsExporter.h"
+#include "../NetworkConnection.h"
+#include "../VoynichDecoder.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+
+namespace {
+    MetricsExporter::Metrics sampleMetrics() {
+        MetricsExporter::Metrics metrics;
+        metrics.nodeName = "test-node";
+        metrics.mappingsProcessed = 1234;
+        metrics.mappingsPerSecond = 500.0;
+        metrics.lexiconProbes = 1000;
+        metrics.lexiconHits = 250;
+        metrics.pieceLatencyCounts[0] = 2;     // <= 10 ms
+        metrics.pieceLatencyCounts[4] = 3;     // <= 500 ms
+        metrics.pieceLatencyCounts[StatsProvider::PIECE_LATENCY_BUCKET_COUNT - 1] = 1;
+        metrics.piecesCompleted = 6;
+        metrics.pieceLatencySumMs = 12000.0;
+        metrics.hasGenerator = true;
+        metrics.generatorWindowSize = 16;
+        metrics.pendingBlocks = 4;
+        
+        MetricsExporter::ThreadMetrics thread = {};
+        thread.threadId = 3;
+        thread.mappingsProcessed = 1234;
+        thread.mappingsPerSecond = 500.0;
+        metrics.threads.push_back(thread);
+        return metrics;
+    }
+    
+    bool contains(const std::string& text, const std::string& part) {
+        return text.find(part) != std::string::npos;
+    }
+}
+
+void testMetricsExporterFormats() {
+    auto metrics = sampleMetrics();
+    
+    std::string text = MetricsExporter::toPrometheusText(metrics);
+    ASSERT_TRUE(contains(text, "# TYPE voynich_mappings_processed_total counter\nvoynich_mappings_processed_total 1234\n"));
+    ASSERT_TRUE(contains(text, "voynich_thread_mappings_per_second{thread=\"3\"} 500\n"));
+    ASSERT_TRUE(contains(text, "voynich_lexicon_hit_ratio 0.25\n"));
+    ASSERT_TRUE(contains(text, "voynich_generator_pending_blocks 4\n"));
+    
+    // Buckets are cumulative and end with +Inf = count
+    ASSERT_TRUE(contains(text, "voynich_piece_duration_seconds_bucket{le=\"0.01\"} 2\n"));
+    ASSERT_TRUE(contains(text, "voynich_piece_duration_seconds_bucket{le=\"0.5\"} 5\n"));
+    ASSERT_TRUE(contains(text, "voynich_piece_duration_seconds_bucket{le=\"10\"} 5\n"));
+    ASSERT_TRUE(contains(text, "voynich_piece_duration_seconds_bucket{le=\"+Inf\"} 6\n"));
+    ASSERT_TRUE(contains(text, "voynich_piece_duration_seconds_sum 12\n"));
+    
+    std::string line = MetricsExporter::toJsonLine(metrics);
+    ASSERT_TRUE(line.front() == '{' && line.back() == '}');
+    ASSERT_FALSE(contains(line, "\n"));
+    ASSERT_TRUE(contains(line, "\"node\":\"test-node\""));
+    ASSERT_TRUE(contains(line, "\"counts\":[2,0,0,0,3,0,0,0,0,1]"));
+    ASSERT_TRUE(contains(line, "\"pending_blocks\":4"));
+    ASSERT_TRUE(contains(line, "\"threads\":[{\"id\":3,\"mappings_processed\":1234"));
+    
+    metrics.hasGenerator = false;
+    ASSERT_TRUE(contains(MetricsExporter::toJsonLine(metrics), "\"generator\":null"));
+    ASSERT_FALSE(contains(MetricsExporter::toPrometheusText(metrics), "voynich_generator_"));
+}
+
+void testMetricsExporterServesHttp() {
+    MetricsExporter::ExporterConfig config;
+    config.mode = MetricsExporter::Mode::HTTP;
+    config.port = 0;
+    MetricsExporter exporter(config, []() { return sampleMetrics(); });
+    ASSERT_TRUE(exporter.start());
+    
+    const char* paths[] = { "/metrics", "/other" };
+    for (int i = 0; i < 2; i++) {
+        auto connection = TcpConnection::connect("127.0.0.1", exporter.getPort());
+        ASSERT_TRUE(connection != nullptr);
+        ASSERT_TRUE(connection->sendRaw(std::string("GET ") + paths[i] + " HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+        
+        // The exporter closes the connection after its response
+        std::string response, line;
+        while (connection->receiveLine(line, 5000)) {
+            response += line + "\n";
+        }
+        if (i == 0) {
+            ASSERT_TRUE(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+            ASSERT_TRUE(contains(response, "voynich_mappings_processed_total 1234\n"));
+        } else {
+            ASSERT_TRUE(response.compare(0, 22, "HTTP/1.1 404 Not Found") == 0);
+        }
+    }
+    exporter.stop();
+}
+
+void testMetricsExporterWritesJsonLines() {
+    const std::string path = "test_metrics.jsonl";
+    std::remove(path.c_str());
+    
+    MetricsExporter::ExporterConfig config;
+    config.mode = MetricsExporter::Mode::JSON_LINES;
+    config.filePath = path;
+    config.intervalMs = 20;
+    {
+        MetricsExporter exporter(config, []() { return sampleMetrics(); });
+        ASSERT_TRUE(exporter.start());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        exporter.stop();
+    }
+    
+    // Several interval samples plus the final one written by stop()
+    std::ifstream file(path);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(file, line)) {
+        ASSERT_TRUE(line.front() == '{' && contains(line, "\"mappings_processed\":1234"));
+        lines++;
+    }
+    file.close();
+    ASSERT_TRUE(lines >= 2);
+    std::remove(path.c_str());
+}
+
+void testDecoderPublishesLexiconProbes() {
+    VoynichDecoder::DecoderConfig config;
+    config.translatorType = VoynichDecoder::TranslatorType::CPU;
+    config.scoreThreshold = 101.0;
+    config.resultsFilePath = "test_metrics_decoder.txt";
+    VoynichDecoder decoder(config);
+    ASSERT_TRUE(decoder.initialize());
+    
+    uint64_t words = 0, matched = 0;
+    auto batchStats = [](int, uint64_t, uint64_t, double, bool) {};
+    ASSERT_TRUE(decoder.processMappingRange(0, 500, 0,
+        [&](const VoynichDecoder::ProcessingResult& result) { words += result.totalWords; matched += result.matchedWords; },
+        batchStats));
+    decoder.reportBatchStatsIfNeeded(batchStats, 0, true);
+    
+    auto metrics = decoder.getMetrics();
+    ASSERT_EQ(words, metrics.wordsProbed);
+    ASSERT_EQ(matched, metrics.wordsMatched);
+    ASSERT_TRUE(metrics.wordsMatched > 0);
+    ASSERT_EQ(0ULL, metrics.gpuChunksScored);
+}
+
+void registerMetricsExporterTests(TestFramework& framework) {
+    framework.addTest("Metrics Exporter Formats", testMetricsExporterFormats);
+    framework.addTest("Metrics Exporter Serves HTTP", testMetricsExporterServesHttp);
+    framework.addTest("Metrics Exporter Writes JSON Lines", testMetricsExporterWritesJsonLines);
+    framework.addTest("Decoder Publishes Lexicon Probes", testDecoderPublishesLexiconProbes);
+}
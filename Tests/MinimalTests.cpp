@@ -3,6 +3,12 @@
 #include "../HebrewValidator.h"
 #include "../Mapping.h"
 #include "../WordSet.h"
+#include "../VoynichDecoder.h"
+#include "../PermutationTranslator.h"
+#include <fstream>
+#include <random>
+#include <algorithm>
+#include <cstdio>
 
 class MinimalTests {
 public:
@@ -78,6 +84,96 @@ public:
         
         std::cout << "✓ Binary vector validation test passed" << std::endl;
     }
+    
+    void testPackedLetterMasks() {
+        Word word(L"daiin", Alphabet::EVA);
+        uint32_t expectedMask = (1u << 3) | (1u << 0) | (1u << 8) | (1u << 13);
+        ASSERT_TRUE(word.getLetterMask() == expectedMask);
+        ASSERT_TRUE(Word::binaryVectorToMask(word.getBinaryMatrix()) == expectedMask);
+        
+        // WordSet keeps the masks contiguous and in word order
+        WordSet testWords;
+        testWords.addWord(word);
+        testWords.addWord(Word(L"ol", Alphabet::EVA));
+        ASSERT_TRUE(testWords.getLetterMasks().size() == 2);
+        ASSERT_TRUE(testWords.maskData()[1] == ((1u << 14) | (1u << 11)));
+        
+        // Mask translation must agree with the matrix multiplication path
+        Mapping mapping;
+        mapping.createEvaToHebrewMapping();
+        std::vector<uint32_t> hebrewMasks;
+        StaticTranslator::translateMasks(testWords.getLetterMasks(), mapping, hebrewMasks);
+        ASSERT_TRUE(hebrewMasks[0] == Word::binaryVectorToMask(mapping.applyMapping(word.getBinaryMatrix())));
+        
+        std::cout << "✓ Packed letter mask test passed" << std::endl;
+    }
+    
+    void testFusedDecoderScoring() {
+        const std::string lexiconFile = "test_fused_lexicon.txt";
+        const std::string voynichFile = "test_fused_voynich.txt";
+        const std::string resultsFile = "test_fused_results.txt";
+        
+        // Tiny lexicon and corpus: under the identity mapping "ab", "dc" and "abd" are words
+        {
+            std::ofstream lexicon(lexiconFile, std::ios::out | std::ios::binary);
+            lexicon << "\xD7\x90\xD7\x91\n" << "\xD7\x92\xD7\x93\n" << "\xD7\x93\xD7\x91\xD7\x90\n";
+            std::ofstream voynich(voynichFile);
+            voynich << "ab\n" << "dc\n" << "abd\n" << "xq\n" << "ba\n";
+        }
+        
+        HebrewValidator::ValidatorConfig validatorConfig;
+        validatorConfig.hebrewLexiconPath = lexiconFile;
+        validatorConfig.enableResultsSaving = false;
+        HebrewValidator referenceValidator(validatorConfig);
+        
+        WordSet voynichWords;
+        voynichWords.readFromFile(voynichFile, Alphabet::EVA);
+        
+        std::vector<Mapping> mappings(20);
+        std::mt19937 rng(99);
+        for (size_t i = 0; i < mappings.size(); i++) {
+            Permutation permutation = PermutationTranslator::identityPermutation();
+            if (i > 0) {
+                std::shuffle(permutation.begin(), permutation.end(), rng);
+            }
+            PermutationTranslator::permutationToMapping(permutation, mappings[i]);
+        }
+        
+        // All CPU engines must score exactly like the WordSet-based reference path
+        VoynichDecoder::TranslatorType types[] = { VoynichDecoder::TranslatorType::CPU, VoynichDecoder::TranslatorType::PERMUTATION,
+                                                   VoynichDecoder::TranslatorType::SIMD };
+        for (auto type : types) {
+            VoynichDecoder::DecoderConfig config;
+            config.hebrewLexiconPath = lexiconFile;
+            config.voynichWordsPath = voynichFile;
+            config.resultsFilePath = resultsFile;
+            config.scoreThreshold = 101.0; // Nothing is saved
+            config.translatorType = type;
+            
+            VoynichDecoder decoder(config);
+            ASSERT_TRUE(decoder.initialize());
+            
+            for (size_t i = 0; i < mappings.size(); i++) {
+                auto result = decoder.processMapping(mappings[i]);
+                auto expected = referenceValidator.validateTranslation(
+                    StaticTranslator::translateWordSet(voynichWords, mappings[i], false));
+                
+                ASSERT_EQ(static_cast<uint64_t>(i), result.mappingId);
+                ASSERT_EQ(static_cast<uint64_t>(expected.matchedWords), static_cast<uint64_t>(result.matchedWords));
+                ASSERT_TRUE(expected.score == result.score);
+                ASSERT_FALSE(result.isHighScore);
+            }
+            
+            // Identity mapping matches "ab", "dc", "abd" and "ba"
+            ASSERT_EQ(static_cast<uint64_t>(4), static_cast<uint64_t>(decoder.processMapping(mappings[0]).matchedWords));
+        }
+        
+        std::remove(lexiconFile.c_str());
+        std::remove(voynichFile.c_str());
+        std::remove(resultsFile.c_str());
+        
+        std::cout << "✓ Fused decoder scoring test passed" << std::endl;
+    }
 };
 
 void testMinimalTranslatorCreation() {
@@ -110,6 +206,16 @@ void testMinimalBinaryVectorValidation() {
     tests.testBinaryVectorValidation();
 }
 
+void testMinimalPackedLetterMasks() {
+    MinimalTests tests;
+    tests.testPackedLetterMasks();
+}
+
+void testMinimalFusedDecoderScoring() {
+    MinimalTests tests;
+    tests.testFusedDecoderScoring();
+}
+
 void registerMinimalTests(TestFramework& framework) {
     framework.addTest("Minimal StaticTranslator Methods", testMinimalTranslatorCreation);
     framework.addTest("Minimal StaticTranslator Translation", testMinimalTranslatorWithMapping);
@@ -117,4 +223,6 @@ void registerMinimalTests(TestFramework& framework) {
     framework.addTest("Minimal HebrewValidator Config", testMinimalHebrewValidatorConfig);
     framework.addTest("Minimal Mapping Basic Operations", testMinimalMappingBasicOperations);
     framework.addTest("Minimal Binary Vector Validation", testMinimalBinaryVectorValidation);
+    framework.addTest("Minimal Packed Letter Masks", testMinimalPackedLetterMasks);
+    framework.addTest("Minimal Fused Decoder Scoring", testMinimalFusedDecoderScoring);
 }
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "TestFramework.h"
+#include "../PermutationTranslator.h"
+#include "../StaticTranslator.h"
+#include "../Mapping.h"
+#include "../WordSet.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+
+class PermutationTranslatorTests {
+private:
+    static WordSet createTestWords() {
+        WordSet words;
+        const wchar_t* evaWords[] = { L"daiin", L"ol", L"chedy", L"qokeey", L"shey", L"otaiin", L"chol", L"ar", L"y" };
+        for (const wchar_t* text : evaWords) {
+            words.addWord(Word(text, Alphabet::EVA));
+        }
+        return words;
+    }
+
+public:
+    void testPermutationRoundTrip() {
+        std::mt19937 rng(12345);
+        Permutation permutation = PermutationTranslator::identityPermutation();
+        std::shuffle(permutation.begin(), permutation.end(), rng);
+
+        Mapping mapping;
+        PermutationTranslator::permutationToMapping(permutation, mapping);
+
+        Permutation recovered;
+        ASSERT_TRUE(PermutationTranslator::permutationFromMapping(mapping, recovered));
+        ASSERT_TRUE(recovered == permutation);
+
+        // A mapping with two EVA letters on the same Hebrew letter is not a permutation
+        mapping.setMapping(0, permutation[1]);
+        ASSERT_FALSE(PermutationTranslator::permutationFromMapping(mapping, recovered));
+
+        std::cout << "✓ Permutation round trip test passed" << std::endl;
+    }
+
+    void testLookupTableMatchesMatrixMultiply() {
+        WordSet words = createTestWords();
+        std::mt19937 rng(2024);
+
+        for (int trial = 0; trial < 50; trial++) {
+            Permutation permutation = PermutationTranslator::identityPermutation();
+            std::shuffle(permutation.begin(), permutation.end(), rng);
+            Mapping mapping;
+            PermutationTranslator::permutationToMapping(permutation, mapping);
+
+            PermutationTranslator::LookupTable table;
+            PermutationTranslator::buildLookupTable(permutation, table);
+
+            for (const Word& word : words) {
+                uint32_t expected = Word::binaryVectorToMask(mapping.applyMapping(word.getBinaryMatrix()));
+                ASSERT_TRUE(PermutationTranslator::translateMask(table, word.getLetterMask()) == expected);
+            }
+        }
+
+        // Tables built from a Mapping must agree with tables built from the permutation
+        Mapping evaToHebrew;
+        evaToHebrew.createEvaToHebrewMapping();
+        PermutationTranslator::LookupTable table;
+        PermutationTranslator::buildLookupTable(evaToHebrew, table);
+        for (uint32_t evaMask : words.getLetterMasks()) {
+            ASSERT_TRUE(PermutationTranslator::translateMask(table, evaMask) == evaToHebrew.applyMappingToMask(evaMask));
+        }
+
+        std::cout << "✓ Lookup table vs matrix multiply test passed" << std::endl;
+    }
+
+    void testTranslateWordSetMatchesStaticTranslator() {
+        WordSet words = createTestWords();
+        Mapping mapping;
+        mapping.createEvaToHebrewMapping();
+
+        WordSet expected = StaticTranslator::translateWordSet(words, mapping, false);
+        WordSet actual = PermutationTranslator::translateWordSet(words, mapping);
+
+        ASSERT_EQ(static_cast<uint64_t>(expected.size()), static_cast<uint64_t>(actual.size()));
+        ASSERT_TRUE(expected.getLetterMasks() == actual.getLetterMasks());
+
+        std::cout << "✓ PermutationTranslator::translateWordSet test passed" << std::endl;
+    }
+
+    void testSimdKernelsMatchScalar() {
+        std::mt19937 rng(4242);
+        std::uniform_int_distribution<uint32_t> maskDistribution(0, (1u << Word::ALPHABET_SIZE) - 1);
+
+        // Counts around the 8- and 16-word widths exercise both full groups and tails
+        std::vector<uint32_t> evaMasks(67);
+        for (auto& mask : evaMasks) {
+            mask = maskDistribution(rng);
+        }
+        evaMasks[0] = 0;
+        evaMasks[1] = (1u << Word::ALPHABET_SIZE) - 1;
+
+        StaticTranslator::SimdLevel levels[] = { StaticTranslator::SimdLevel::SCALAR, StaticTranslator::SimdLevel::AVX2,
+                                                 StaticTranslator::SimdLevel::AVX512 };
+        for (int trial = 0; trial < 20; trial++) {
+            Permutation permutation = PermutationTranslator::identityPermutation();
+            std::shuffle(permutation.begin(), permutation.end(), rng);
+            PermutationTranslator::LookupTable table;
+            PermutationTranslator::buildLookupTable(permutation, table);
+
+            std::vector<uint32_t> expected(evaMasks.size());
+            PermutationTranslator::translateMasks(table, evaMasks.data(), expected.data(), evaMasks.size());
+
+            for (auto level : levels) {
+                for (size_t count : { size_t(0), size_t(1), size_t(7), size_t(8), size_t(9), size_t(16), size_t(31), evaMasks.size() }) {
+                    // Words past count must be left untouched
+                    std::vector<uint32_t> actual(evaMasks.size(), 0xFFFFFFFFu);
+                    StaticTranslator::translateMasksSimd(table, evaMasks.data(), actual.data(), count, level);
+                    for (size_t i = 0; i < evaMasks.size(); i++) {
+                        ASSERT_TRUE(actual[i] == (i < count ? expected[i] : 0xFFFFFFFFu));
+                    }
+                }
+            }
+        }
+
+        std::cout << "✓ SIMD kernels match scalar translation (detected: "
+                  << StaticTranslator::getSimdLevelName(StaticTranslator::getSimdLevel()) << ")" << std::endl;
+    }
+
+    void testPermutationTranslatorBenchmark() {
+        WordSet words = createTestWords();
+        std::mt19937 rng(7);
+        const int mappingCount = 2000;
+
+        std::vector<Mapping> mappings(mappingCount);
+        for (auto& mapping : mappings) {
+            Permutation permutation = PermutationTranslator::identityPermutation();
+            std::shuffle(permutation.begin(), permutation.end(), rng);
+            PermutationTranslator::permutationToMapping(permutation, mapping);
+        }
+
+        // Baseline: current StaticTranslator CPU path
+        uint64_t checksumBaseline = 0;
+        auto baselineStart = std::chrono::high_resolution_clock::now();
+        for (const auto& mapping : mappings) {
+            WordSet translated = StaticTranslator::translateWordSet(words, mapping, false);
+            checksumBaseline += translated.maskData()[0];
+        }
+        auto baselineEnd = std::chrono::high_resolution_clock::now();
+
+        // Permutation table path (table built per mapping, as the decoder does)
+        uint64_t checksumTable = 0;
+        std::vector<uint32_t> hebrewMasks(words.size());
+        auto tableStart = std::chrono::high_resolution_clock::now();
+        for (const auto& mapping : mappings) {
+            PermutationTranslator::LookupTable table;
+            PermutationTranslator::buildLookupTable(mapping, table);
+            PermutationTranslator::translateMasks(table, words.maskData(), hebrewMasks.data(), words.size());
+            checksumTable += hebrewMasks[0];
+        }
+        auto tableEnd = std::chrono::high_resolution_clock::now();
+
+        // SIMD kernel on the same tables
+        uint64_t checksumSimd = 0;
+        auto simdStart = std::chrono::high_resolution_clock::now();
+        for (const auto& mapping : mappings) {
+            PermutationTranslator::LookupTable table;
+            PermutationTranslator::buildLookupTable(mapping, table);
+            StaticTranslator::translateMasksSimd(table, words.maskData(), hebrewMasks.data(), words.size());
+            checksumSimd += hebrewMasks[0];
+        }
+        auto simdEnd = std::chrono::high_resolution_clock::now();
+
+        ASSERT_EQ(checksumBaseline, checksumTable);
+        ASSERT_EQ(checksumBaseline, checksumSimd);
+
+        auto baselineMs = std::chrono::duration_cast<std::chrono::microseconds>(baselineEnd - baselineStart).count() / 1000.0;
+        auto tableMs = std::chrono::duration_cast<std::chrono::microseconds>(tableEnd - tableStart).count() / 1000.0;
+        auto simdMs = std::chrono::duration_cast<std::chrono::microseconds>(simdEnd - simdStart).count() / 1000.0;
+        std::cout << "✓ Benchmark (" << mappingCount << " mappings): StaticTranslator CPU " << baselineMs
+                  << " ms, PermutationTranslator " << tableMs << " ms";
+        if (tableMs > 0) {
+            std::cout << " (" << (baselineMs / tableMs) << "x)";
+        }
+        std::cout << ", SIMD " << StaticTranslator::getSimdLevelName(StaticTranslator::getSimdLevel()) << " " << simdMs << " ms";
+        std::cout << std::endl;
+    }
+};
+
+void testPermutationRoundTrip() {
+    PermutationTranslatorTests tests;
+    tests.testPermutationRoundTrip();
+}
+
+void testPermutationLookupTableMatchesMatrixMultiply() {
+    PermutationTranslatorTests tests;
+    tests.testLookupTableMatchesMatrixMultiply();
+}
+
+void testPermutationTranslateWordSet() {
+    PermutationTranslatorTests tests;
+    tests.testTranslateWordSetMatchesStaticTranslator();
+}
+
+void testPermutationSimdKernels() {
+    PermutationTranslatorTests tests;
+    tests.testSimdKernelsMatchScalar();
+}
+
+void testPermutationTranslatorBenchmark() {
+    PermutationTranslatorTests tests;
+    tests.testPermutationTranslatorBenchmark();
+}
+
+void registerPermutationTranslatorTests(TestFramework& framework) {
+    framework.addTest("Permutation Round Trip", testPermutationRoundTrip);
+    framework.addTest("Permutation Lookup Table vs Matrix Multiply", testPermutationLookupTableMatchesMatrixMultiply);
+    framework.addTest("Permutation Translate WordSet", testPermutationTranslateWordSet);
+    framework.addTest("Permutation SIMD Kernels Match Scalar", testPermutationSimdKernels);
+    framework.addTest("Permutation Translator Benchmark", testPermutationTranslatorBenchmark);
+}
\ No newline at end of file
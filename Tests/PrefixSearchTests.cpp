@@ -0,0 +1,245 @@
+#include "TestFramework.h"
+#include "TestSupport.h"
+#include "../PrefixSearch.h"
+#include "../VoynichDecoder.h"
+#include "../PermutationTranslator.h"
+#include "../BitUtils.h"
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+
+namespace {
+    // Three EVA letters (d, a, i), so the tree has 27 * 26 * 25 leaves
+    WordSet createSmallCorpus() {
+        WordSet words;
+        for (const wchar_t* word : { L"da", L"dai", L"ai", L"ida", L"a", L"dad", L"ii" }) {
+            words.addWord(Word(word, Alphabet::EVA));
+        }
+        return words;
+    }
+    
+    // Every assignment of the used letters, unused letters ascending, keyed like the search's leaves
+    std::map<uint64_t, size_t> scoreExhaustively(const HebrewLexicon& lexicon, const WordSet& words,
+                                                 const std::vector<uint8_t>& letterOrder) {
+        std::map<uint64_t, size_t> matches;
+        std::vector<int> choice(letterOrder.size(), 0);
+        while (true) {
+            Permutation permutation{};
+            uint32_t freeHebrew = Word::FULL_MASK;
+            for (size_t depth = 0; depth < letterOrder.size(); ++depth) {
+                uint32_t candidates = freeHebrew;
+                for (int skipped = 0; skipped < choice[depth]; ++skipped) {
+                    candidates &= candidates - 1;
+                }
+                int hebrewLetter = BitUtils::countTrailingZeros(candidates);
+                permutation[letterOrder[depth]] = static_cast<uint8_t>(hebrewLetter);
+                freeHebrew &= ~(1u << hebrewLetter);
+            }
+            uint8_t usedLetters[Word::ALPHABET_SIZE] = {};
+            for (uint8_t letter : letterOrder) {
+                usedLetters[letter] = 1;
+            }
+            for (int letter = 0; letter < Word::ALPHABET_SIZE; ++letter) {
+                if (!usedLetters[letter]) {
+                    permutation[letter] = static_cast<uint8_t>(BitUtils::countTrailingZeros(freeHebrew));
+                    freeHebrew &= freeHebrew - 1;
+                }
+            }
+            matches[PrefixSearch::leafKey(permutation)] = TestSupport::countMatches(lexicon, words, permutation);
+            
+            // Mixed-radix increment, digit d among 27 - d letters
+            int depth = static_cast<int>(letterOrder.size()) - 1;
+            while (depth >= 0 && ++choice[depth] == Word::ALPHABET_SIZE - depth) {
+                choice[depth--] = 0;
+            }
+            if (depth < 0) {
+                return matches;
+            }
+        }
+    }
+    
+    // Leaves of every root, with the match count the search reported for each
+    std::map<uint64_t, size_t> searchAll(PrefixSearch& search, size_t requiredMatched, PrefixSearch::SubtreeStats& stats) {
+        std::map<uint64_t, size_t> leaves;
+        uint64_t root = 0;
+        while (search.claimRoot(root)) {
+            PrefixSearch::SubtreeStats subtreeStats;
+            ASSERT_TRUE(search.searchSubtree(root, [requiredMatched]() { return requiredMatched; },
+                [&leaves](const Permutation& permutation, size_t matched) {
+                    ASSERT_TRUE(leaves.emplace(PrefixSearch::leafKey(permutation), matched).second);
+                    return true;
+                }, nullptr, subtreeStats));
+            search.completeRoot(root, subtreeStats);
+            stats.nodesVisited += subtreeStats.nodesVisited;
+            stats.nodesPruned += subtreeStats.nodesPruned;
+            stats.leavesScored += subtreeStats.leavesScored;
+        }
+        return leaves;
+    }
+}
+
+void testPrefixSearchVisitsEveryLeaf() {
+    WordSet words = createSmallCorpus();
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    PrefixSearch::SearchConfig config;
+    config.rootDepth = 2;
+    config.stateFilePath = "";
+    PrefixSearch search(words, lexicon, config);
+    ASSERT_EQ(3, static_cast<int>(search.getLetterOrder().size()));
+    ASSERT_EQ(27ULL * 26ULL, search.getRootCount());
+    
+    // With nothing required no subtree is pruned, and each leaf's count is its exact score
+    PrefixSearch::SubtreeStats stats;
+    std::map<uint64_t, size_t> leaves = searchAll(search, 0, stats);
+    std::map<uint64_t, size_t> expected = scoreExhaustively(*lexicon, words, search.getLetterOrder());
+    ASSERT_EQ(27ULL * 26ULL * 25ULL, static_cast<uint64_t>(leaves.size()));
+    ASSERT_EQ(static_cast<uint64_t>(leaves.size()), stats.leavesScored);
+    ASSERT_EQ(0ULL, stats.nodesPruned);
+    ASSERT_TRUE(leaves == expected);
+    ASSERT_TRUE(search.isComplete());
+}
+
+void testPrefixSearchPrunesOnlyHopelessSubtrees() {
+    WordSet words = createSmallCorpus();
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    PrefixSearch::SearchConfig config;
+    config.rootDepth = 1;
+    config.stateFilePath = "";
+    PrefixSearch probe(words, lexicon, config);
+    std::map<uint64_t, size_t> expected = scoreExhaustively(*lexicon, words, probe.getLetterOrder());
+    size_t best = 0;
+    for (const auto& leaf : expected) {
+        best = std::max(best, leaf.second);
+    }
+    
+    // Every leaf reaching the bound is still found, and fewer leaves are scored
+    for (size_t required = 1; required <= best + 1; ++required) {
+        PrefixSearch search(words, lexicon, config);
+        PrefixSearch::SubtreeStats stats;
+        std::map<uint64_t, size_t> leaves = searchAll(search, required, stats);
+        size_t reached = 0;
+        for (const auto& leaf : expected) {
+            if (leaf.second >= required) {
+                reached++;
+                ASSERT_TRUE(leaves.count(leaf.first) == 1);
+            }
+        }
+        for (const auto& leaf : leaves) {
+            ASSERT_EQ(static_cast<uint64_t>(expected.at(leaf.first)), static_cast<uint64_t>(leaf.second));
+        }
+        ASSERT_TRUE(leaves.size() >= reached);
+        ASSERT_TRUE(leaves.size() < expected.size());
+        ASSERT_TRUE(stats.nodesPruned > 0);
+    }
+}
+
+void testPrefixSearchResumesCompletedRoots() {
+    const std::string statePath = "test_prefix_search_state.bin";
+    std::remove(statePath.c_str());
+    WordSet words = createSmallCorpus();
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    PrefixSearch::SearchConfig config;
+    config.rootDepth = 1;
+    config.stateFilePath = statePath;
+    
+    {
+        PrefixSearch search(words, lexicon, config);
+        ASSERT_TRUE(!search.wasResumed());
+        PrefixSearch::SubtreeStats stats;
+        stats.leavesScored = 10;
+        uint64_t root = 0;
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_TRUE(search.claimRoot(root));
+            search.completeRoot(root, stats);
+        }
+        ASSERT_TRUE(search.claimRoot(root));  // Claimed but unfinished: searched again on resume
+        ASSERT_TRUE(search.saveState());
+    }
+    
+    {
+        PrefixSearch search(words, lexicon, config);
+        ASSERT_TRUE(search.wasResumed());
+        auto progress = search.getProgress();
+        ASSERT_EQ(27ULL, progress.rootCount);
+        ASSERT_EQ(5ULL, progress.rootsCompleted);
+        ASSERT_EQ(50ULL, progress.totals.leavesScored);
+        uint64_t root = 0;
+        ASSERT_TRUE(search.claimRoot(root));
+        ASSERT_EQ(5ULL, root);
+    }
+    
+    // Another root depth or corpus numbers its roots differently
+    PrefixSearch::SearchConfig deeperConfig = config;
+    deeperConfig.rootDepth = 2;
+    ASSERT_TRUE(!PrefixSearch(words, lexicon, deeperConfig).wasResumed());
+    WordSet otherWords = createSmallCorpus();
+    otherWords.addWord(Word(L"qok", Alphabet::EVA));
+    ASSERT_TRUE(!PrefixSearch(otherWords, lexicon, config).wasResumed());
+    
+    // A damaged file is ignored
+    {
+        std::fstream file(statePath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(12);
+        file.put('\x7F');
+    }
+    ASSERT_TRUE(!PrefixSearch(words, lexicon, config).wasResumed());
+    std::remove(statePath.c_str());
+}
+
+void testDecoderPrefixSubtreeResults() {
+    const std::string resultsPath = "test_prefix_search_results.txt";
+    std::remove(resultsPath.c_str());
+    VoynichDecoder::DecoderConfig config;
+    config.translatorType = VoynichDecoder::TranslatorType::PERMUTATION;
+    config.scoreThreshold = 101.0;
+    config.topResultsCount = 8;
+    config.resultsFilePath = resultsPath;
+    VoynichDecoder decoder(config);
+    ASSERT_TRUE(decoder.initialize());
+    
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    if (voynich.size() == 0) {
+        std::cout << "⚠ resources not found - prefix subtree test skipped" << std::endl;
+        return;
+    }
+    auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+    PrefixSearch::SearchConfig searchConfig;
+    searchConfig.rootDepth = 3;
+    searchConfig.stateFilePath = "";
+    PrefixSearch search(voynich, lexicon, searchConfig);
+    
+    // Stopped part-way: the subtree is left unfinished, the leaves so far are kept
+    int polls = 0;
+    uint64_t reported = 0;
+    PrefixSearch::SubtreeStats stats;
+    bool completed = decoder.processPrefixSubtree(search, 0, 0,
+        [&reported](const VoynichDecoder::ProcessingResult&) { reported++; },
+        [](int, uint64_t, uint64_t, double, bool) {},
+        [&polls]() { return ++polls > 20; }, stats);
+    ASSERT_TRUE(!completed);
+    ASSERT_EQ(stats.leavesScored, reported);
+    ASSERT_TRUE(stats.nodesPruned > 0);
+    
+    // Kept entries are keyed by their permutation and rescore to the same count
+    auto top = decoder.getTopResults().getSorted();
+    ASSERT_EQ(8, static_cast<int>(top.size()));
+    for (const auto& entry : top) {
+        ASSERT_EQ(PrefixSearch::leafKey(entry.permutation), entry.mappingIndex);
+        Mapping mapping;
+        PermutationTranslator::permutationToMapping(entry.permutation, mapping);
+        ASSERT_EQ(static_cast<int>(decoder.processMapping(mapping).matchedWords), static_cast<int>(entry.matchedWords));
+    }
+    std::cout << "  " << stats.leavesScored << " mappings scored, " << stats.nodesVisited << " nodes expanded, "
+              << stats.nodesPruned << " pruned; best " << top.front().matchedWords << " of " << voynich.size() << std::endl;
+    std::remove(resultsPath.c_str());
+}
+
+void registerPrefixSearchTests(TestFramework& framework) {
+    framework.addTest("Prefix Search Visits Every Leaf", testPrefixSearchVisitsEveryLeaf);
+    framework.addTest("Prefix Search Prunes Only Hopeless Subtrees", testPrefixSearchPrunesOnlyHopelessSubtrees);
+    framework.addTest("Prefix Search Resumes Completed Roots", testPrefixSearchResumesCompletedRoots);
+    framework.addTest("Decoder Prefix Subtree Results", testDecoderPrefixSubtreeResults);
+}
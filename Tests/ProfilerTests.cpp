@@ -0,0 +1,128 @@
+#include "TestFramework.h"
+#include "../Profiler.h"
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    // Busy wait, so the timed scopes have a known minimum length
+    void spinMicroseconds(int microseconds) {
+        auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(microseconds);
+        while (std::chrono::steady_clock::now() < end) {
+        }
+    }
+
+    uint64_t stageNanoseconds(const Profiler::Breakdown& breakdown, Profiler::Stage stage) {
+        return breakdown.stages[static_cast<size_t>(stage)].nanoseconds;
+    }
+
+    uint64_t stageScopes(const Profiler::Breakdown& breakdown, Profiler::Stage stage) {
+        return breakdown.stages[static_cast<size_t>(stage)].scopes;
+    }
+}
+
+void testProfilerNestedScopesAreExclusive() {
+    Profiler::ProfilerConfig config;
+    config.sampleInterval = 1;
+    Profiler::configure(config);
+
+    auto outerStart = std::chrono::steady_clock::now();
+    for (int item = 0; item < 10; ++item) {
+        Profiler::beginItem();
+        Profiler::ScopedTimer translation(Profiler::Stage::TRANSLATION);
+        spinMicroseconds(100);
+        {
+            Profiler::ScopedTimer validation(Profiler::Stage::VALIDATION);
+            spinMicroseconds(100);
+        }
+    }
+    uint64_t outerNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - outerStart).count();
+
+    auto breakdown = Profiler::getBreakdown();
+    ASSERT_EQ(10ULL, breakdown.sampledItems);
+    ASSERT_EQ(10ULL, stageScopes(breakdown, Profiler::Stage::TRANSLATION));
+    ASSERT_EQ(10ULL, stageScopes(breakdown, Profiler::Stage::VALIDATION));
+    ASSERT_EQ(0ULL, stageScopes(breakdown, Profiler::Stage::GENERATION));
+    ASSERT_TRUE(stageNanoseconds(breakdown, Profiler::Stage::TRANSLATION) >= 1000000ULL);
+    ASSERT_TRUE(stageNanoseconds(breakdown, Profiler::Stage::VALIDATION) >= 1000000ULL);
+
+    // The nested stage's time is not counted again for the enclosing one
+    ASSERT_TRUE(breakdown.totalNanoseconds() <= outerNanoseconds);
+    ASSERT_TRUE(breakdown.share(Profiler::Stage::TRANSLATION) > 0.0 && breakdown.share(Profiler::Stage::TRANSLATION) < 1.0);
+    ASSERT_TRUE(breakdown.nanosecondsPerItem(Profiler::Stage::VALIDATION) >= 100000.0);
+
+    // Counts since an earlier breakdown cover only the later scopes
+    Profiler::beginItem();
+    {
+        Profiler::ScopedTimer bookkeeping(Profiler::Stage::BOOKKEEPING);
+        spinMicroseconds(10);
+    }
+    auto recent = Profiler::getBreakdown().since(breakdown);
+    ASSERT_EQ(1ULL, recent.sampledItems);
+    ASSERT_EQ(1ULL, stageScopes(recent, Profiler::Stage::BOOKKEEPING));
+    ASSERT_EQ(0ULL, stageScopes(recent, Profiler::Stage::TRANSLATION));
+}
+
+void testProfilerSamplesOneItemPerInterval() {
+    Profiler::ProfilerConfig config;
+    config.sampleInterval = 8;
+    Profiler::configure(config);
+
+    for (int item = 0; item < 64; ++item) {
+        Profiler::beginItem();
+        Profiler::ScopedTimer generation(Profiler::Stage::GENERATION);
+    }
+
+    auto breakdown = Profiler::getBreakdown();
+    ASSERT_EQ(8ULL, breakdown.sampledItems);
+    ASSERT_EQ(8, static_cast<int>(breakdown.sampleInterval));
+    ASSERT_EQ(8ULL, stageScopes(breakdown, Profiler::Stage::GENERATION));
+
+    // A new configuration starts from zero
+    Profiler::configure(config);
+    ASSERT_EQ(0ULL, Profiler::getBreakdown().sampledItems);
+}
+
+void testProfilerWritesChromeTrace() {
+    const std::string filePath = "test_profile_trace.json";
+    Profiler::ProfilerConfig config;
+    config.sampleInterval = 1;
+    config.traceFilePath = filePath;
+    config.maxTraceEventsPerThread = 5;
+    Profiler::configure(config);
+
+    for (int item = 0; item < 4; ++item) {
+        Profiler::beginItem();
+        Profiler::ScopedTimer bookkeeping(Profiler::Stage::BOOKKEEPING);
+        Profiler::ScopedTimer validation(Profiler::Stage::VALIDATION);
+    }
+    ASSERT_TRUE(Profiler::writeTrace(filePath));
+
+    std::ifstream file(filePath);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    std::string trace = contents.str();
+    file.close();
+    std::remove(filePath.c_str());
+
+    // Eight scopes ran; the buffer keeps the first five
+    size_t events = 0;
+    for (size_t position = trace.find("\"ph\": \"X\""); position != std::string::npos; position = trace.find("\"ph\": \"X\"", position + 1)) {
+        ++events;
+    }
+    ASSERT_EQ(5, static_cast<int>(events));
+    ASSERT_TRUE(trace.find("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [") == 0);
+    ASSERT_TRUE(trace.find("\"name\": \"validation\"") != std::string::npos);
+    ASSERT_TRUE(trace.find("\"name\": \"bookkeeping\"") != std::string::npos);
+    ASSERT_TRUE(trace.find("\"thread_name\"") != std::string::npos);
+
+    Profiler::configure(Profiler::ProfilerConfig());
+}
+
+void registerProfilerTests(TestFramework& framework) {
+    framework.addTest("Profiler Nested Scopes Are Exclusive", testProfilerNestedScopesAreExclusive);
+    framework.addTest("Profiler Samples One Item Per Interval", testProfilerSamplesOneItemPerInterval);
+    framework.addTest("Profiler Writes Chrome Trace", testProfilerWritesChromeTrace);
+}
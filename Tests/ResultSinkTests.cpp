@@ -0,0 +1,137 @@
+#include "TestFramework.h"
+#include "../ResultSink.h"
+#include "../HebrewValidator.h"
+#include "../PermutationTranslator.h"
+#include <vector>
+#include <thread>
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cmath>
+
+namespace {
+    HebrewValidator::ValidatorConfig resultsConfig(const std::string& path, HebrewValidator::ResultFormat format) {
+        HebrewValidator::ValidatorConfig config;
+        config.hebrewLexiconPath = "does_not_exist_lexicon.txt";
+        config.resultsFilePath = path;
+        config.resultsFormat = format;
+        return config;
+    }
+    
+    Permutation reversedPermutation() {
+        Permutation permutation;
+        for (int i = 0; i < Word::ALPHABET_SIZE; i++) {
+            permutation[i] = static_cast<uint8_t>(Word::ALPHABET_SIZE - 1 - i);
+        }
+        return permutation;
+    }
+}
+
+void testResultSinkConcurrentValidators() {
+    const std::string path = "test_results_concurrent.txt";
+    std::remove(path.c_str());
+    
+    // Validators for the same file share one writer, whichever thread owns them
+    HebrewValidator first(resultsConfig(path, HebrewValidator::ResultFormat::TEXT));
+    HebrewValidator second(resultsConfig(path, HebrewValidator::ResultFormat::TEXT));
+    
+    const int threadCount = 4;
+    const int resultsPerThread = 250;
+    Mapping mapping;
+    PermutationTranslator::permutationToMapping(PermutationTranslator::identityPermutation(), mapping);
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            HebrewValidator& validator = (t % 2 == 0) ? first : second;
+            auto result = validator.buildResult(100, 60);
+            for (int i = 0; i < resultsPerThread; i++) {
+                validator.recordHighScore(result, static_cast<uint64_t>(t * resultsPerThread + i), mapping);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    auto summary = first.getHighScoresSummary();
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * resultsPerThread), static_cast<uint64_t>(summary.totalResults));
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * resultsPerThread * 100), static_cast<uint64_t>(summary.totalWordsValidated));
+    
+    // Every result arrives exactly once, with its mapping table
+    std::vector<ResultSink::Record> records;
+    ASSERT_TRUE(ResultSink::readRecords(path, ResultSink::Format::TEXT, records));
+    std::set<uint64_t> ids;
+    for (const auto& record : records) {
+        ids.insert(record.mappingId);
+        ASSERT_EQ(60ULL, static_cast<uint64_t>(record.matchedWords));
+    }
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * resultsPerThread), static_cast<uint64_t>(ids.size()));
+    
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    file.close();
+    ASSERT_TRUE(contents.str().find(mapping.serializeMappingVisualization()) != std::string::npos);
+    
+    ASSERT_TRUE(first.clearResults());
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(second.getHighScoresSummary().totalResults));
+    std::remove(path.c_str());
+}
+
+void testResultSinkBinaryAndCsvRoundTrip() {
+    const ResultSink::Format formats[] = { ResultSink::Format::BINARY, ResultSink::Format::CSV };
+    const char* paths[] = { "test_results_records.bin", "test_results_records.csv" };
+    
+    for (int f = 0; f < 2; f++) {
+        std::remove(paths[f]);
+        {
+            HebrewValidator validator(resultsConfig(paths[f], formats[f]));
+            Mapping mapping;
+            PermutationTranslator::permutationToMapping(reversedPermutation(), mapping);
+            validator.recordHighScore(validator.buildResult(200, 90), 7ULL, mapping);
+            validator.recordHighScore(validator.buildResult(200, 150), 8ULL, mapping);
+            
+            auto summary = validator.getHighScoresSummary();
+            ASSERT_EQ(2ULL, static_cast<uint64_t>(summary.totalResults));
+            ASSERT_EQ(400ULL, static_cast<uint64_t>(summary.totalWordsValidated));
+            ASSERT_TRUE(std::abs(summary.highestScore - validator.buildResult(200, 150).score) < 1e-3);  // CSV keeps 4 decimals
+        }
+        
+        // The last validator released the sink, so the file is complete and closed
+        std::vector<ResultSink::Record> records;
+        ASSERT_TRUE(ResultSink::readRecords(paths[f], formats[f], records));
+        ASSERT_EQ(2ULL, static_cast<uint64_t>(records.size()));
+        ASSERT_EQ(7ULL, records[0].mappingId);
+        ASSERT_EQ(150ULL, static_cast<uint64_t>(records[1].matchedWords));
+        ASSERT_EQ(200ULL, static_cast<uint64_t>(records[1].totalWords));
+        ASSERT_TRUE(records[1].hasPermutation);
+        ASSERT_TRUE(records[1].permutation == reversedPermutation());
+        std::remove(paths[f]);
+    }
+    
+    // Binary records are fixed-size: header plus one record per result
+    const std::string path = "test_results_size.bin";
+    std::remove(path.c_str());
+    {
+        ResultSink::SinkConfig config;
+        config.format = ResultSink::Format::BINARY;
+        ResultSink sink(path, config);
+        for (int i = 0; i < 3; i++) {
+            ResultSink::Record record;
+            record.mappingId = i;
+            sink.submit(record);
+        }
+    }
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    ASSERT_EQ(static_cast<uint64_t>(ResultSink::BINARY_HEADER_SIZE + 3 * ResultSink::BINARY_RECORD_SIZE),
+              static_cast<uint64_t>(file.tellg()));
+    file.close();
+    std::remove(path.c_str());
+}
+
+void registerResultSinkTests(TestFramework& framework) {
+    framework.addTest("Result Sink Concurrent Validators", testResultSinkConcurrentValidators);
+    framework.addTest("Result Sink Binary And CSV Round Trip", testResultSinkBinaryAndCsvRoundTrip);
+}
@@ -0,0 +1,185 @@
+#include "TestFramework.h"
+#include "TestSupport.h"
+#include "../ScoringKernels.h"
+#include "../StaticTranslator.h"
+#include "../HebrewLexicon.h"
+#include "../VoynichDecoder.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    // maskCount random EVA masks using only the letters of the low nibbleCount nibbles
+    std::vector<uint32_t> randomCorpus(std::mt19937& rng, int nibbleCount, size_t maskCount) {
+        uint32_t letters = (nibbleCount * 4 >= Word::ALPHABET_SIZE) ? Word::FULL_MASK : (1u << (nibbleCount * 4)) - 1;
+        std::vector<uint32_t> masks(maskCount);
+        for (uint32_t& mask : masks) {
+            mask = rng() & letters;
+        }
+        masks.back() |= 1u << (nibbleCount * 4 - 1);  // The corpus reaches its last nibble
+        return masks;
+    }
+}
+
+void testScoringKernelsMatchPermutationTranslator() {
+    std::mt19937 rng(30);
+    for (int nibbleCount = 1; nibbleCount <= PermutationTranslator::NIBBLE_COUNT; ++nibbleCount) {
+        for (size_t maskCount : { 5, 16, 87, 256, 300 }) {
+            std::vector<uint32_t> masks = randomCorpus(rng, nibbleCount, maskCount);
+            uint32_t letterUnion = 0;
+            for (uint32_t mask : masks) {
+                letterUnion |= mask;
+            }
+            auto kernels = ScoringKernels::select(TargetAlphabet::HEBREW_27, letterUnion, masks.size());
+            ASSERT_EQ(nibbleCount, kernels.nibbleCount);
+
+            for (int trial = 0; trial < 4; ++trial) {
+                Permutation permutation = TestSupport::randomPermutation(rng);
+                PermutationTranslator::LookupTable expectedTable, table;
+                PermutationTranslator::buildLookupTable(permutation, expectedTable);
+                kernels.buildTable(permutation, table);
+
+                std::vector<uint32_t> expected(masks.size()), corpus(masks.size()), range(masks.size(), 0), simd(masks.size());
+                PermutationTranslator::translateMasks(expectedTable, masks.data(), expected.data(), masks.size());
+                kernels.translateCorpus(table, masks.data(), corpus.data(), masks.size());
+                kernels.translateRange(table, masks.data() + 1, range.data() + 1, masks.size() - 1);
+                StaticTranslator::translateMasksSimd(table, masks.data(), simd.data(), masks.size());
+                ASSERT_TRUE(corpus == expected);
+                ASSERT_TRUE(simd == expected);
+                ASSERT_EQ(0, static_cast<int>(range[0]));
+                ASSERT_TRUE(std::equal(range.begin() + 1, range.end(), expected.begin() + 1));
+            }
+        }
+    }
+
+    // Only corpora that fill a bucket get a compiled body
+    ASSERT_EQ(80ULL, static_cast<uint64_t>(ScoringKernels::select(TargetAlphabet::HEBREW_27, 0xFFFF, 87).bucketMasks));
+    ASSERT_EQ(256ULL, static_cast<uint64_t>(ScoringKernels::select(TargetAlphabet::HEBREW_27, 0xFFFF, 256).bucketMasks));
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(ScoringKernels::select(TargetAlphabet::HEBREW_27, 0xFFFF, 15).bucketMasks));
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(ScoringKernels::select(TargetAlphabet::HEBREW_27, 0xFFFF, 257).bucketMasks));
+    ASSERT_EQ(1, ScoringKernels::nibblesFor(0));
+    ASSERT_EQ(1, ScoringKernels::nibblesFor(1u << 3));
+    ASSERT_EQ(2, ScoringKernels::nibblesFor(1u << 4));
+    ASSERT_EQ(7, ScoringKernels::nibblesFor(1u << 26));
+}
+
+void testScoringKernelsFoldFinalForms() {
+    // Final kaf, mem, nun, pe and tsadi land on their base letters; nothing else moves
+    ASSERT_EQ(static_cast<int>(1u << 10), static_cast<int>(Word::foldFinalForms(1u << 22)));
+    ASSERT_EQ(static_cast<int>((1u << 16) | (1u << 17)), static_cast<int>(Word::foldFinalForms((1u << 25) | (1u << 26))));
+    ASSERT_EQ(static_cast<int>((1u << 22) - 1), static_cast<int>(Word::foldFinalForms(Word::FULL_MASK)));
+    ASSERT_EQ(static_cast<int>(1u << 21), static_cast<int>(Word::foldFinalForms(1u << 21)));
+
+    std::mt19937 rng(22);
+    std::vector<uint32_t> masks = randomCorpus(rng, PermutationTranslator::NIBBLE_COUNT, 120);
+    auto kernels = ScoringKernels::select(TargetAlphabet::HEBREW_22, Word::FULL_MASK, masks.size());
+    for (int trial = 0; trial < 20; ++trial) {
+        Permutation permutation = TestSupport::randomPermutation(rng);
+        PermutationTranslator::LookupTable expectedTable, table, mappingTable;
+        PermutationTranslator::buildLookupTable(permutation, expectedTable);
+        kernels.buildTable(permutation, table);
+
+        // Tables built from a Mapping are folded after the fact
+        Mapping mapping;
+        PermutationTranslator::permutationToMapping(permutation, mapping);
+        PermutationTranslator::buildLookupTable(mapping, mappingTable);
+        ScoringKernels::foldTable(TargetAlphabet::HEBREW_22, mappingTable);
+
+        std::vector<uint32_t> folded(masks.size());
+        kernels.translateCorpus(table, masks.data(), folded.data(), masks.size());
+        for (size_t i = 0; i < masks.size(); ++i) {
+            uint32_t expected = Word::foldFinalForms(PermutationTranslator::translateMask(expectedTable, masks[i]));
+            ASSERT_TRUE(folded[i] == expected);
+            ASSERT_TRUE(PermutationTranslator::translateMask(mappingTable, masks[i]) == expected);
+        }
+    }
+}
+
+void testHebrewLexiconFoldedTo() {
+    // "melech" with a final kaf and the same letters with a plain kaf become one letter set
+    WordSet hebrewWords;
+    for (const wchar_t* text : { L"מלך", L"מלכ", L"שלום" }) {
+        hebrewWords.addWord(Word(text, Alphabet::HEBREW));
+    }
+    HebrewLexicon lexicon(hebrewWords, HebrewLexicon::Backend::PERFECT_HASH);
+    ASSERT_EQ(3ULL, static_cast<uint64_t>(lexicon.getUniqueMaskCount()));
+    ASSERT_TRUE(lexicon.getTargetAlphabet() == TargetAlphabet::HEBREW_27);
+
+    auto folded = lexicon.foldedTo(TargetAlphabet::HEBREW_22);
+    ASSERT_TRUE(folded->getTargetAlphabet() == TargetAlphabet::HEBREW_22);
+    ASSERT_TRUE(folded->getBackend() == HebrewLexicon::Backend::PERFECT_HASH);
+    ASSERT_EQ(2ULL, static_cast<uint64_t>(folded->getUniqueMaskCount()));
+    ASSERT_EQ(3ULL, static_cast<uint64_t>(folded->getWordCount()));
+    for (uint32_t mask : lexicon.getDistinctMasks()) {
+        ASSERT_TRUE(folded->contains(Word::foldFinalForms(mask)));
+    }
+    ASSERT_FALSE(folded->contains((1u << 12) | (1u << 11) | (1u << 22)));
+    ASSERT_FALSE(folded->saveImage("test_folded_lexicon.bin", "resources/Tanah2.txt"));
+
+    // The registry keeps one instance per target
+    auto acquired27 = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::BITSET);
+    auto acquired22 = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::BITSET, "", TargetAlphabet::HEBREW_22);
+    if (acquired27->empty()) {
+        std::cout << "⚠ resources not found - lexicon registry check skipped" << std::endl;
+        return;
+    }
+    ASSERT_TRUE(acquired22 != acquired27);
+    ASSERT_TRUE(acquired22 == HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::BITSET, "", TargetAlphabet::HEBREW_22));
+    ASSERT_TRUE(acquired22->getUniqueMaskCount() < acquired27->getUniqueMaskCount());
+}
+
+void testDecoderScoresHebrew22Target() {
+    using TranslatorType = VoynichDecoder::TranslatorType;
+    auto config = TestSupport::createDecoderConfig(TranslatorType::PERMUTATION, "test_scoring_kernels_results.txt");
+    config.scoreThreshold = 101.0;  // Nothing is saved
+    VoynichDecoder full(config);
+    config.targetAlphabet = TargetAlphabet::HEBREW_22;
+    VoynichDecoder permutation(config);
+    config.translatorType = TranslatorType::CPU;
+    VoynichDecoder cpu(config);
+    config.translatorType = TranslatorType::SIMD;
+    VoynichDecoder simd(config);
+    ASSERT_TRUE(full.initialize());
+    ASSERT_TRUE(cpu.initialize());
+    ASSERT_TRUE(permutation.initialize());
+    ASSERT_TRUE(simd.initialize());
+
+    // Every translator folds alike, and folding both sides never loses a match
+    const uint64_t START_INDEX = 5000000, END_INDEX = 5002000;
+    std::vector<size_t> fullMatched, cpuMatched, permutationMatched, simdMatched;
+    auto collect = [](std::vector<size_t>& matched) {
+        return [&matched](const VoynichDecoder::ProcessingResult& result) { matched.push_back(result.matchedWords); };
+    };
+    auto noStats = [](int, uint64_t, uint64_t, double, bool) {};
+    ASSERT_TRUE(full.processMappingRange(START_INDEX, END_INDEX, 0, collect(fullMatched), noStats));
+    ASSERT_TRUE(cpu.processMappingRange(START_INDEX, END_INDEX, 0, collect(cpuMatched), noStats));
+    ASSERT_TRUE(permutation.processMappingRange(START_INDEX, END_INDEX, 0, collect(permutationMatched), noStats));
+    ASSERT_TRUE(simd.processMappingRange(START_INDEX, END_INDEX, 0, collect(simdMatched), noStats));
+    ASSERT_TRUE(cpuMatched == permutationMatched);
+    ASSERT_TRUE(simdMatched == permutationMatched);
+    ASSERT_EQ(static_cast<uint64_t>(fullMatched.size()), static_cast<uint64_t>(permutationMatched.size()));
+
+    size_t gained = 0;
+    for (size_t i = 0; i < fullMatched.size(); ++i) {
+        ASSERT_TRUE(permutationMatched[i] >= fullMatched[i]);
+        gained += permutationMatched[i] - fullMatched[i];
+    }
+    std::cout << "  " << gained << " more word matches over " << fullMatched.size() << " mappings with final forms folded" << std::endl;
+
+    // The single-mapping entry points fold as well
+    Permutation first;
+    MappingGenerator::unrankPermutation(START_INDEX, first);
+    Mapping mapping;
+    PermutationTranslator::permutationToMapping(first, mapping);
+    ASSERT_EQ(static_cast<uint64_t>(permutationMatched[0]), static_cast<uint64_t>(cpu.processMapping(mapping).matchedWords));
+    ASSERT_EQ(static_cast<uint64_t>(permutationMatched[0]), static_cast<uint64_t>(simd.processMapping(mapping).matchedWords));
+    std::remove("test_scoring_kernels_results.txt");
+}
+
+void registerScoringKernelsTests(TestFramework& framework) {
+    framework.addTest("Scoring Kernels Match Permutation Translator", testScoringKernelsMatchPermutationTranslator);
+    framework.addTest("Scoring Kernels Fold Final Forms", testScoringKernelsFoldFinalForms);
+    framework.addTest("Hebrew Lexicon Folded To 22 Letters", testHebrewLexiconFoldedTo);
+    framework.addTest("Decoder Scores Hebrew 22 Target", testDecoderScoresHebrew22Target);
+}
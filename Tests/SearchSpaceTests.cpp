@@ -0,0 +1,251 @@
+#include "TestFramework.h"
+#include "../SearchSpace.h"
+#include "../MappingGenerator.h"
+#include "../VoynichDecoder.h"
+#include <vector>
+#include <set>
+#include <random>
+#include <filesystem>
+#include <cstdio>
+
+namespace {
+    // Three used letters: c occurs in one word, a and b in two each
+    WordSet makeSmallCorpus() {
+        WordSet words;
+        words.addWord(Word(L"ab", Alphabet::EVA));
+        words.addWord(Word(L"ba", Alphabet::EVA));
+        words.addWord(Word(L"c", Alphabet::EVA));
+        return words;
+    }
+    
+    bool isPermutation(const Permutation& permutation) {
+        uint32_t seen = 0;
+        for (uint8_t letter : permutation) {
+            if (letter >= Word::ALPHABET_SIZE) return false;
+            seen |= 1u << letter;
+        }
+        return seen == Word::FULL_MASK;
+    }
+    
+    void checkCursorMatchesUnrank(const SearchSpace& space, uint64_t startIndex, uint64_t endIndex) {
+        MappingGenerator::BlockCursor cursor(startIndex, endIndex, space);
+        Permutation permutation, expected;
+        uint64_t globalIndex = 0, visited = 0;
+        while (cursor.next(permutation, globalIndex)) {
+            ASSERT_EQ(startIndex + visited, globalIndex);
+            space.unrank(globalIndex, expected);
+            ASSERT_TRUE(permutation == expected);
+            visited++;
+        }
+        ASSERT_EQ(endIndex - startIndex, visited);
+    }
+}
+
+void testSearchSpaceReducedAssignments() {
+    WordSet corpus = makeSmallCorpus();
+    SearchSpace space = SearchSpace::forWords(corpus);
+    ASSERT_FALSE(space.isFull());
+    ASSERT_EQ(3, space.getUsedLetterCount());
+    ASSERT_EQ(27ULL * 26 * 25, space.getSize());
+    ASSERT_FALSE(space.isTruncated());
+    
+    // Rarest letter first, then the unused letters in ascending order
+    ASSERT_EQ(2, static_cast<int>(space.getLetterOrder()[0]));
+    ASSERT_EQ(0, static_cast<int>(space.getLetterOrder()[1]));
+    ASSERT_EQ(1, static_cast<int>(space.getLetterOrder()[2]));
+    ASSERT_EQ(3, static_cast<int>(space.getLetterOrder()[3]));
+    
+    // Every index is a distinct assignment of the used letters; the rest take what is left in order
+    std::set<uint32_t> assignments;
+    Permutation permutation;
+    for (uint64_t index = 0; index < space.getSize(); ++index) {
+        space.unrank(index, permutation);
+        ASSERT_TRUE(isPermutation(permutation));
+        assignments.insert(permutation[0] | (permutation[1] << 8) | (permutation[2] << 16));
+        for (int letter = 4; letter < Word::ALPHABET_SIZE; ++letter) {
+            ASSERT_TRUE(permutation[letter - 1] < permutation[letter]);
+        }
+    }
+    ASSERT_EQ(space.getSize(), static_cast<uint64_t>(assignments.size()));
+    
+    // A corpus using every letter needs no reduction; the real corpus outgrows the 64-bit index
+    WordSet everyLetter;
+    everyLetter.addWord(Word(L"abcdefghijklmnopqrstuvwxyz ", Alphabet::EVA));
+    ASSERT_TRUE(SearchSpace::forWords(everyLetter) == SearchSpace::full());
+    ASSERT_EQ(MappingGenerator::getTotalCombinations(), SearchSpace::full().getSize());
+    
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    SearchSpace voynichSpace = SearchSpace::forWords(voynich);
+    ASSERT_FALSE(voynichSpace.isFull());
+    ASSERT_TRUE(voynichSpace.getUsedLetterCount() < Word::ALPHABET_SIZE);
+    
+    // Letter orders round-trip; a repeated letter is rejected
+    SearchSpace restored;
+    ASSERT_TRUE(SearchSpace::fromLetterOrder(voynichSpace.getLetterOrder(), voynichSpace.getUsedLetterCount(), restored));
+    ASSERT_TRUE(restored == voynichSpace);
+    uint8_t broken[Word::ALPHABET_SIZE];
+    std::copy(space.getLetterOrder(), space.getLetterOrder() + Word::ALPHABET_SIZE, broken);
+    broken[5] = broken[4];
+    ASSERT_FALSE(SearchSpace::fromLetterOrder(broken, 3, restored));
+}
+
+void testSearchSpaceTruncatedIndicesAreDistinct() {
+    // The corpus uses 16 letters: 27!/11! assignments, more than the 64-bit index holds
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    SearchSpace space = SearchSpace::forWords(voynich);
+    ASSERT_FALSE(space.isFull());
+    ASSERT_EQ(16, space.getUsedLetterCount());
+    ASSERT_TRUE(space.isTruncated());
+    ASSERT_EQ(UINT64_MAX, space.getSize());
+    ASSERT_TRUE(space.getExactSize() > 2.7e20 && space.getExactSize() < 2.8e20);
+    
+    // Consecutive indices, including the last ones, are distinct assignments of the used letters;
+    // the unused letters only ever take the left-over Hebrew letters in ascending order
+    const uint8_t* order = space.getLetterOrder();
+    const int usedLetterCount = space.getUsedLetterCount();
+    std::set<std::vector<uint8_t>> assignments;
+    std::mt19937_64 rng(16);
+    const uint64_t RUN_LENGTH = 5000;
+    std::vector<uint64_t> starts = { 0, rng() % (space.getSize() - RUN_LENGTH), space.getSize() - RUN_LENGTH };
+    Permutation permutation;
+    for (uint64_t start : starts) {
+        for (uint64_t index = start; index < start + RUN_LENGTH; ++index) {
+            space.unrank(index, permutation);
+            ASSERT_TRUE(isPermutation(permutation));
+            std::vector<uint8_t> assignment;
+            for (int p = 0; p < usedLetterCount; ++p) {
+                assignment.push_back(permutation[order[p]]);
+            }
+            ASSERT_TRUE(assignments.insert(assignment).second);
+            for (int p = usedLetterCount + 1; p < Word::ALPHABET_SIZE; ++p) {
+                ASSERT_TRUE(permutation[order[p - 1]] < permutation[order[p]]);
+            }
+        }
+    }
+    ASSERT_EQ(3 * RUN_LENGTH, static_cast<uint64_t>(assignments.size()));
+    
+    // A generator over the space checkpoints it and resumes from its state file
+    const std::string path = "test_truncated_space_state.bin";
+    std::remove(path.c_str());
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 10000;
+    config.stateFilePath = path;
+    config.checkpointIntervalMs = 0;
+    config.searchSpace = space;
+    {
+        MappingGenerator generator(config);
+        ASSERT_EQ(space.getSize(), generator.getCombinationCount());
+        uint64_t startIndex = 0, endIndex = 0;
+        ASSERT_TRUE(generator.claimBlockRange(0, startIndex, endIndex));
+        ASSERT_TRUE(generator.saveCurrentState());
+    }
+    {
+        MappingGenerator resumed(config);
+        ASSERT_EQ(1ULL, resumed.getCurrentState().nextBlockToGenerate);
+    }
+    std::remove(path.c_str());
+}
+
+void testSearchSpaceCursorMatchesUnrank() {
+    WordSet corpus = makeSmallCorpus();
+    SearchSpace small = SearchSpace::forWords(corpus);
+    checkCursorMatchesUnrank(small, 0, small.getSize());
+    checkCursorMatchesUnrank(small, 601, 1399);
+    
+    // Across run boundaries of the corpus space, including its last indices
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    SearchSpace space = SearchSpace::forWords(voynich);
+    std::mt19937_64 rng(21);
+    std::vector<uint64_t> starts = { 0, space.getSize() - 5000 };
+    for (int i = 0; i < 20; i++) starts.push_back(rng() % (space.getSize() - 5000));
+    for (uint64_t start : starts) {
+        checkCursorMatchesUnrank(space, start, start + 5000);
+    }
+}
+
+void testGeneratorStateRecordsSearchSpace() {
+    const std::string path = "test_search_space_state.bin";
+    std::remove(path.c_str());
+    
+    WordSet corpus = makeSmallCorpus();
+    MappingGenerator::GeneratorConfig config;
+    config.blockSize = 10000;
+    config.stateFilePath = path;
+    config.checkpointIntervalMs = 0;
+    config.searchSpace = SearchSpace::forWords(corpus);
+    
+    // Blocks cover the reduced space and end with it
+    {
+        MappingGenerator generator(config);
+        ASSERT_EQ(config.searchSpace.getSize(), generator.getCombinationCount());
+        uint64_t startIndex = 0, endIndex = 0;
+        ASSERT_TRUE(generator.claimBlockRange(0, startIndex, endIndex));
+        ASSERT_TRUE(generator.claimBlockRange(0, startIndex, endIndex));
+        ASSERT_EQ(config.searchSpace.getSize(), endIndex);
+        ASSERT_FALSE(generator.claimBlockRange(0, startIndex, endIndex));
+        ASSERT_TRUE(generator.saveCurrentState());
+    }
+    
+    // The same space resumes in either format; any other space starts over
+    for (auto format : { MappingGenerator::StateFileFormat::BINARY, MappingGenerator::StateFileFormat::JSON }) {
+        config.stateFormat = format;
+        {
+            MappingGenerator resumed(config);
+            ASSERT_EQ(2ULL, resumed.getCurrentState().nextBlockToGenerate);
+            ASSERT_TRUE(resumed.saveCurrentState());
+        }
+        
+        // On a copy, since the fresh generator checkpoints over its state file
+        const std::string copyPath = path + ".copy";
+        std::filesystem::copy_file(path, copyPath, std::filesystem::copy_options::overwrite_existing);
+        MappingGenerator::GeneratorConfig fullConfig = config;
+        fullConfig.stateFilePath = copyPath;
+        fullConfig.searchSpace = SearchSpace::full();
+        {
+            MappingGenerator fresh(fullConfig);
+            ASSERT_EQ(0ULL, fresh.getCurrentState().nextBlockToGenerate);
+        }
+        std::remove(copyPath.c_str());
+    }
+    std::remove(path.c_str());
+}
+
+void testDecoderUnranksInSearchSpace() {
+    WordSet voynich;
+    voynich.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+    
+    // Adjacent swaps only walk the full space, so the decoder enumerates by index instead
+    VoynichDecoder::DecoderConfig config;
+    config.translatorType = VoynichDecoder::TranslatorType::PERMUTATION;
+    config.enumerationMode = VoynichDecoder::EnumerationMode::ADJACENT_SWAP;
+    config.scoreThreshold = 101.0;
+    config.resultsFilePath = "test_search_space_decoder.txt";
+    config.topResultsCount = 4;
+    config.searchSpace = SearchSpace::forWords(voynich);
+    
+    VoynichDecoder decoder(config);
+    ASSERT_TRUE(decoder.initialize());
+    uint64_t scored = 0;
+    ASSERT_TRUE(decoder.processMappingRange(5000, 7000, 0,
+        [&scored](const VoynichDecoder::ProcessingResult&) { scored++; },
+        [](int, uint64_t, uint64_t, double, bool) {}));
+    ASSERT_EQ(2000ULL, scored);
+    
+    for (const auto& entry : decoder.getTopResults().getSorted()) {
+        Permutation expected;
+        config.searchSpace.unrank(entry.mappingIndex, expected);
+        ASSERT_TRUE(entry.permutation == expected);
+    }
+    std::remove(config.resultsFilePath.c_str());
+}
+
+void registerSearchSpaceTests(TestFramework& framework) {
+    framework.addTest("Search Space Reduced Assignments", testSearchSpaceReducedAssignments);
+    framework.addTest("Search Space Truncated Indices Are Distinct", testSearchSpaceTruncatedIndicesAreDistinct);
+    framework.addTest("Search Space Cursor Matches Unrank", testSearchSpaceCursorMatchesUnrank);
+    framework.addTest("Generator State Records Search Space", testGeneratorStateRecordsSearchSpace);
+    framework.addTest("Decoder Unranks In Search Space", testDecoderUnranksInSearchSpace);
+}
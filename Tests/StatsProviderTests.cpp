@@ -0,0 +1,89 @@
+#include "TestFramework.h"
+#include "../StatsProvider.h"
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+void testStatsProviderPerThreadCounters() {
+    const int threadCount = 4;
+    const uint64_t batchesPerThread = 1000;
+    
+    StatsProvider::StatsConfig config;
+    config.statusUpdateIntervalMs = 60000;
+    config.threadCount = threadCount;
+    StatsProvider stats(config);
+    stats.start();
+    
+    // Each worker updates only its own counters; no update blocks or allocates
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&stats, t, batchesPerThread]() {
+            for (uint64_t i = 0; i < batchesPerThread; i++) {
+                stats.submitBatchStats(t, 10, 100, static_cast<double>(t * 10 + i % 7), true);
+            }
+            stats.submitMappingProcessed(t, 5, 1.0);
+            stats.submitPieceCompleted(t, 0.002);
+            stats.submitPieceCompleted(t, 0.004);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    // Totals are summed straight from the counters, without waiting for the stats thread
+    auto snapshot = stats.getCurrentSnapshot();
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * (batchesPerThread * 10 + 1)), snapshot.totalMappingsProcessed);
+    ASSERT_EQ(static_cast<uint64_t>(threadCount * (batchesPerThread * 100 + 5)), snapshot.totalWordsValidated);
+    ASSERT_TRUE(snapshot.highestScore == 36.0);
+    
+    auto perThread = stats.getThreadSnapshots();
+    ASSERT_EQ(static_cast<uint64_t>(threadCount), static_cast<uint64_t>(perThread.size()));
+    for (const auto& thread : perThread) {
+        ASSERT_EQ(batchesPerThread * 10 + 1, thread.mappingsProcessed);
+        ASSERT_TRUE(thread.highestScore == thread.threadId * 10 + 6.0);
+        ASSERT_EQ(2ULL, thread.piecesCompleted);
+        ASSERT_TRUE(thread.averagePieceMs > 2.9 && thread.averagePieceMs < 3.1);
+    }
+    
+    // Ids outside the configured range are ignored rather than written out of bounds
+    stats.submitBatchStats(threadCount, 1, 1, 99.0, true);
+    stats.submitBatchStats(-1, 1, 1, 99.0, true);
+    ASSERT_EQ(snapshot.totalMappingsProcessed, stats.getCurrentSnapshot().totalMappingsProcessed);
+    ASSERT_TRUE(stats.getCurrentSnapshot().highestScore == 36.0);
+    
+    stats.stop();
+}
+
+void testStatsProviderRareEvents() {
+    StatsProvider::StatsConfig config;
+    config.statusUpdateIntervalMs = 60000;
+    config.threadCount = 2;
+    StatsProvider stats(config);
+    stats.start();
+    
+    stats.submitThreadStarted(0);
+    stats.submitThreadStarted(1);
+    stats.submitHighScore(1, 42, 80.0, 8, 10, 80.0);
+    stats.submitThreadCompleted(0, 0);
+    
+    // High scores and lifecycle events are still delivered through the stats thread
+    for (int i = 0; i < 200 && (stats.getCurrentSnapshot().highScoreCount < 1 || stats.getCurrentSnapshot().activeThreads != 1); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    auto snapshot = stats.getCurrentSnapshot();
+    ASSERT_EQ(1ULL, snapshot.highScoreCount);
+    ASSERT_EQ(1ULL, static_cast<uint64_t>(snapshot.activeThreads));
+    
+    // Restarting resets the counters
+    stats.submitBatchStats(0, 5, 5, 1.0, true);
+    stats.stop();
+    stats.start();
+    ASSERT_EQ(0ULL, stats.getCurrentSnapshot().totalMappingsProcessed);
+    ASSERT_TRUE(stats.getThreadSnapshots().empty());
+    stats.stop();
+}
+
+void registerStatsProviderTests(TestFramework& framework) {
+    framework.addTest("Stats Provider Per-Thread Counters", testStatsProviderPerThreadCounters);
+    framework.addTest("Stats Provider Rare Events", testStatsProviderRareEvents);
+}
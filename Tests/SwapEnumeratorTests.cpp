@@ -0,0 +1,222 @@
+#include "TestFramework.h"
+#include "../MappingGenerator.h"
+#include "../SwapEnumerator.h"
+#include "../IncrementalScorer.h"
+#include "../VoynichDecoder.h"
+#include <vector>
+#include <set>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+
+class SwapEnumeratorTests {
+private:
+    // Copy of the original vector-based unranking, kept as the compatibility reference
+    static std::vector<int> legacyIndexToPermutation(uint64_t index) {
+        std::vector<int> result;
+        std::vector<int> available;
+        for (int i = 0; i < 27; ++i) {
+            available.push_back(i);
+        }
+
+        uint64_t remaining = index;
+        for (int position = 27; position > 0; --position) {
+            uint64_t factorialValue = 1;
+            for (int i = 2; i <= position - 1; ++i) factorialValue *= i;
+            int chosenIndex = static_cast<int>(remaining / factorialValue);
+            if (chosenIndex >= static_cast<int>(available.size())) {
+                chosenIndex = static_cast<int>(available.size()) - 1;
+            }
+            result.push_back(available[chosenIndex]);
+            available.erase(available.begin() + chosenIndex);
+            remaining %= factorialValue;
+        }
+        return result;
+    }
+
+    static uint64_t wrappedFactorial(int n) {
+        uint64_t result = 1;
+        for (int i = 2; i <= n; ++i) result *= i;
+        return result;
+    }
+
+    // Enumerate a range and check it visits every index exactly once with consistent indices
+    static void checkRangeCoverage(uint64_t startIndex, uint64_t endIndex, size_t& swapSteps, size_t& resetSteps) {
+        SwapEnumerator enumerator(startIndex, endIndex);
+        SwapEnumerator::Step step;
+        std::set<uint64_t> visited;
+        Permutation previous = enumerator.current();
+
+        do {
+            uint64_t index = enumerator.currentIndex();
+            ASSERT_TRUE(index >= startIndex && index < endIndex);
+            ASSERT_TRUE(visited.insert(index).second);
+
+            Permutation expected;
+            MappingGenerator::unrankPermutation(index, expected);
+            ASSERT_TRUE(expected == enumerator.current());
+
+            if (visited.size() > 1) {
+                if (step.reset) {
+                    resetSteps++;
+                } else {
+                    // Replaying the reported swaps on the previous permutation gives the current one
+                    for (int i = 0; i < step.swapCount; ++i) {
+                        std::swap(previous[step.first[i]], previous[step.second[i]]);
+                    }
+                    ASSERT_TRUE(previous == enumerator.current());
+                    if (step.swapCount == 1) swapSteps++;
+                }
+            }
+            previous = enumerator.current();
+        } while (enumerator.advance(step));
+
+        ASSERT_EQ(endIndex - startIndex, static_cast<uint64_t>(visited.size()));
+    }
+
+public:
+    void testUnrankMatchesLegacy() {
+        std::vector<uint64_t> indices;
+        for (uint64_t i = 0; i < 500; i++) indices.push_back(i);
+
+        // Around the first wrapped-factorial boundary, where the leading positions change
+        const uint64_t boundary = wrappedFactorial(25);
+        for (uint64_t i = boundary - 5; i < boundary + 5; i++) indices.push_back(i);
+        indices.push_back(MappingGenerator::getTotalCombinations() - 1);
+
+        std::mt19937_64 rng(3);
+        for (int i = 0; i < 500; i++) indices.push_back(rng() % MappingGenerator::getTotalCombinations());
+
+        for (uint64_t index : indices) {
+            Permutation permutation;
+            MappingGenerator::unrankPermutation(index, permutation);
+            std::vector<int> expected = legacyIndexToPermutation(index);
+            ASSERT_TRUE(std::equal(expected.begin(), expected.end(), permutation.begin()));
+        }
+
+        ASSERT_EQ(static_cast<uint64_t>(3), MappingGenerator::stepsUntilPrefixChange(boundary - 3));
+        ASSERT_TRUE(MappingGenerator::stepsUntilPrefixChange(0) == boundary);
+
+        std::cout << "✓ Allocation-free unranking matches legacy indices" << std::endl;
+    }
+
+    void testEnumeratorCoverage() {
+        const uint64_t boundary = wrappedFactorial(25);
+        size_t swapSteps = 0;
+        size_t resetSteps = 0;
+
+        checkRangeCoverage(0, 15, swapSteps, resetSteps);
+        checkRangeCoverage(0, 5040, swapSteps, resetSteps);
+        checkRangeCoverage(123457, 123457 + 3000, swapSteps, resetSteps);
+        checkRangeCoverage(boundary - 700, boundary + 700, swapSteps, resetSteps);
+
+        // Almost every step should be a single transposition
+        ASSERT_TRUE(swapSteps > 8 * resetSteps);
+
+        std::cout << "✓ Swap enumerator covers ranges exactly (" << swapSteps << " single-swap steps, "
+                  << resetSteps << " resets)" << std::endl;
+    }
+
+    void testIncrementalScorerMatchesFullScoring() {
+        auto lexicon = HebrewLexicon::acquire("resources/Tanah2.txt", HebrewLexicon::Backend::PERFECT_HASH);
+        WordSet voynichWords;
+        voynichWords.readFromFile("resources/Script_freq100.txt", Alphabet::EVA);
+        if (lexicon->empty() || voynichWords.size() == 0) {
+            std::cout << "⚠ resources not found - incremental scorer comparison skipped" << std::endl;
+            return;
+        }
+
+        IncrementalScorer scorer(voynichWords.getLetterMasks(), lexicon);
+        Permutation permutation = PermutationTranslator::identityPermutation();
+        scorer.reset(permutation);
+
+        std::mt19937 rng(11);
+        std::vector<uint32_t> hebrewMasks(voynichWords.size());
+        for (int i = 0; i < 2000; i++) {
+            int a = rng() % Word::ALPHABET_SIZE;
+            int b = rng() % Word::ALPHABET_SIZE;
+            scorer.applySwap(a, b);
+            std::swap(permutation[a], permutation[b]);
+
+            PermutationTranslator::LookupTable table;
+            PermutationTranslator::buildLookupTable(permutation, table);
+            PermutationTranslator::translateMasks(table, voynichWords.maskData(), hebrewMasks.data(), hebrewMasks.size());
+
+            ASSERT_TRUE(scorer.getPermutation() == permutation);
+            ASSERT_TRUE(scorer.getHebrewMasks() == hebrewMasks);
+            ASSERT_EQ(static_cast<uint64_t>(lexicon->countMatches(hebrewMasks.data(), hebrewMasks.size())),
+                      static_cast<uint64_t>(scorer.getMatchedWords()));
+        }
+
+        std::cout << "✓ Incremental scorer matches full scoring ("
+                  << (static_cast<double>(scorer.getWordsRescored() - voynichWords.size()) / 2000.0)
+                  << " of " << voynichWords.size() << " words rescored per swap)" << std::endl;
+    }
+
+    void testDecoderEnumerationModesAgree() {
+        const std::string resultsFile = "test_swap_enumeration_results.txt";
+        std::map<VoynichDecoder::EnumerationMode, std::vector<std::pair<uint64_t, size_t>>> outcomes;
+
+        VoynichDecoder::EnumerationMode modes[] = { VoynichDecoder::EnumerationMode::INDEXED, VoynichDecoder::EnumerationMode::ADJACENT_SWAP };
+        for (auto mode : modes) {
+            VoynichDecoder::DecoderConfig config;
+            config.translatorType = VoynichDecoder::TranslatorType::CPU;
+            config.enumerationMode = mode;
+            config.scoreThreshold = 0.0; // Every mapping is a high score, so every mapping ID is reported
+            config.resultsFilePath = resultsFile;
+
+            VoynichDecoder decoder(config);
+            ASSERT_TRUE(decoder.initialize());
+
+            MappingGenerator::GeneratorConfig generatorConfig;
+            generatorConfig.blockSize = 2000;
+            generatorConfig.enableStateFile = false;
+            MappingGenerator generator(generatorConfig);
+
+            auto& results = outcomes[mode];
+            decoder.processMappingBlock(generator, 0,
+                [&results](const VoynichDecoder::ProcessingResult& result) {
+                    results.push_back(std::make_pair(result.mappingId, result.matchedWords));
+                },
+                [](int, uint64_t, uint64_t, double, bool) {});
+
+            ASSERT_EQ(1ULL, generator.getCurrentState().totalBlocksCompleted);
+            std::sort(results.begin(), results.end());
+        }
+        std::remove(resultsFile.c_str());
+
+        // Block 0 starts at global index 0, so indexed IDs and generator indices coincide
+        ASSERT_EQ(2000ULL, static_cast<uint64_t>(outcomes[VoynichDecoder::EnumerationMode::INDEXED].size()));
+        ASSERT_TRUE(outcomes[VoynichDecoder::EnumerationMode::INDEXED] == outcomes[VoynichDecoder::EnumerationMode::ADJACENT_SWAP]);
+
+        std::cout << "✓ INDEXED and ADJACENT_SWAP enumeration produce identical results" << std::endl;
+    }
+};
+
+void testSwapUnrankMatchesLegacy() {
+    SwapEnumeratorTests tests;
+    tests.testUnrankMatchesLegacy();
+}
+
+void testSwapEnumeratorCoverage() {
+    SwapEnumeratorTests tests;
+    tests.testEnumeratorCoverage();
+}
+
+void testSwapIncrementalScorer() {
+    SwapEnumeratorTests tests;
+    tests.testIncrementalScorerMatchesFullScoring();
+}
+
+void testSwapDecoderEnumerationModes() {
+    SwapEnumeratorTests tests;
+    tests.testDecoderEnumerationModesAgree();
+}
+
+void registerSwapEnumeratorTests(TestFramework& framework) {
+    framework.addTest("Swap Unrank Matches Legacy", testSwapUnrankMatchesLegacy);
+    framework.addTest("Swap Enumerator Coverage", testSwapEnumeratorCoverage);
+    framework.addTest("Swap Incremental Scorer", testSwapIncrementalScorer);
+    framework.addTest("Swap Decoder Enumeration Modes", testSwapDecoderEnumerationModes);
+}
\ No newline at end of file
@@ -6,6 +6,24 @@ void registerMappingGeneratorTests(TestFramework& framework);
 void registerMinimalTests(TestFramework& framework);
 void registerPerfectScoreTest(TestFramework& framework);
 void registerBatchCudaTests(TestFramework& framework);
+void registerPermutationTranslatorTests(TestFramework& framework);
+void registerLexiconBackendTests(TestFramework& framework);
+void registerSwapEnumeratorTests(TestFramework& framework);
+void registerWorkStealingSchedulerTests(TestFramework& framework);
+void registerThreadManagerTests(TestFramework& framework);
+void registerClusterCoordinatorTests(TestFramework& framework);
+void registerResultSinkTests(TestFramework& framework);
+void registerTopResultsTests(TestFramework& framework);
+void registerStatsProviderTests(TestFramework& framework);
+void registerMetricsExporterTests(TestFramework& framework);
+void registerSearchSpaceTests(TestFramework& framework);
+void registerMaskTableTests(TestFramework& framework);
+void registerBoundedScoringTests(TestFramework& framework);
+void registerPrefixSearchTests(TestFramework& framework);
+void registerLocalSearchTests(TestFramework& framework);
+void registerLexiconImageTests(TestFramework& framework);
+void registerProfilerTests(TestFramework& framework);
+void registerScoringKernelsTests(TestFramework& framework);
 
 int main() {
     std::cout << "VoynichDecoder Unit Tests" << std::endl;
@@ -18,6 +36,24 @@ int main() {
     registerMappingGeneratorTests(testFramework);
     registerMinimalTests(testFramework);
     registerBatchCudaTests(testFramework);    
+    registerPermutationTranslatorTests(testFramework);
+    registerLexiconBackendTests(testFramework);
+    registerSwapEnumeratorTests(testFramework);
+    registerWorkStealingSchedulerTests(testFramework);
+    registerThreadManagerTests(testFramework);
+    registerClusterCoordinatorTests(testFramework);
+    registerResultSinkTests(testFramework);
+    registerTopResultsTests(testFramework);
+    registerStatsProviderTests(testFramework);
+    registerMetricsExporterTests(testFramework);
+    registerSearchSpaceTests(testFramework);
+    registerMaskTableTests(testFramework);
+    registerBoundedScoringTests(testFramework);
+    registerPrefixSearchTests(testFramework);
+    registerLocalSearchTests(testFramework);
+    registerLexiconImageTests(testFramework);
+    registerProfilerTests(testFramework);
+    registerScoringKernelsTests(testFramework);
     
     testFramework.runAllTests();
     testFramework.printResults();
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../VoynichDecoder.h"
+#include "../HebrewValidator.h"
+#include "../HebrewLexicon.h"
+#include "../PermutationTranslator.h"
+#include "../WordSet.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <string>
+
+// Helpers shared by several test files
+namespace TestSupport {
+    // Uniformly random EVA -> Hebrew permutation
+    inline Permutation randomPermutation(std::mt19937& rng) {
+        Permutation permutation = PermutationTranslator::identityPermutation();
+        std::shuffle(permutation.begin(), permutation.end(), rng);
+        return permutation;
+    }
+
+    // Reference score: translate every word of the corpus and count those in the lexicon
+    inline size_t countMatches(const HebrewLexicon& lexicon, const WordSet& words, const Permutation& permutation) {
+        PermutationTranslator::LookupTable table;
+        PermutationTranslator::buildLookupTable(permutation, table);
+        std::vector<uint32_t> hebrewMasks(words.size());
+        PermutationTranslator::translateMasks(table, words.getLetterMasks().data(), hebrewMasks.data(), words.size());
+        return lexicon.countMatches(hebrewMasks.data(), hebrewMasks.size());
+    }
+
+    // Validator over the bundled lexicon that saves nothing
+    inline HebrewValidator::ValidatorConfig createValidatorConfig(HebrewValidator::LexiconBackend backend) {
+        HebrewValidator::ValidatorConfig config;
+        config.hebrewLexiconPath = "resources/Tanah2.txt";
+        config.enableResultsSaving = false;
+        config.lexiconBackend = backend;
+        return config;
+    }
+
+    // Decoder on the bundled corpus and perfect-hash lexicon; tests set the rest themselves
+    inline VoynichDecoder::DecoderConfig createDecoderConfig(VoynichDecoder::TranslatorType translatorType,
+                                                             const std::string& resultsFilePath) {
+        VoynichDecoder::DecoderConfig config;
+        config.translatorType = translatorType;
+        config.lexiconBackend = HebrewValidator::LexiconBackend::PERFECT_HASH;
+        config.resultsFilePath = resultsFilePath;
+        return config;
+    }
+}
@@ -0,0 +1,102 @@
+#include "TestFramework.h"
+#include "../ThreadManager.h"
+#include "../NumaTopology.h"
+#include <vector>
+#include <thread>
+
+namespace {
+    using TranslatorType = VoynichDecoder::TranslatorType;
+    using ThreadAffinity = ThreadManager::ThreadAffinity;
+}
+
+void testPlanWorkersSpreadsCudaOverDevices() {
+    auto plan = ThreadManager::planWorkers(5, TranslatorType::CUDA, 2, 2);
+    ASSERT_EQ(5ULL, static_cast<uint64_t>(plan.size()));
+    for (size_t i = 0; i < plan.size(); i++) {
+        ASSERT_TRUE(plan[i].translatorType == TranslatorType::CUDA);
+        ASSERT_EQ(static_cast<int>(i % 2), plan[i].cudaDevice);
+    }
+    
+    // AUTO uses every device when there are any, and stays on the CPU otherwise
+    auto autoPlan = ThreadManager::planWorkers(3, TranslatorType::AUTO, 3, 2);
+    ASSERT_EQ(2, autoPlan[2].cudaDevice);
+    auto cpuPlan = ThreadManager::planWorkers(3, TranslatorType::AUTO, 0, 2);
+    ASSERT_TRUE(cpuPlan[0].translatorType == TranslatorType::AUTO);
+    ASSERT_EQ(-1, cpuPlan[0].cudaDevice);
+}
+
+void testPlanWorkersHybridSplitsGpuAndCpu() {
+    auto plan = ThreadManager::planWorkers(8, TranslatorType::HYBRID, 2, 2);
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(plan[i].translatorType == TranslatorType::CUDA);
+        ASSERT_EQ(static_cast<int>(i % 2), plan[i].cudaDevice);
+    }
+    for (size_t i = 4; i < plan.size(); i++) {
+        ASSERT_TRUE(plan[i].translatorType == TranslatorType::SIMD);
+        ASSERT_EQ(-1, plan[i].cudaDevice);
+    }
+    
+    // Fewer threads than GPU slots: every thread drives a device
+    auto small = ThreadManager::planWorkers(3, TranslatorType::HYBRID, 2, 2);
+    ASSERT_TRUE(small[2].translatorType == TranslatorType::CUDA);
+    
+    // Without devices HYBRID is pure SIMD
+    auto noGpu = ThreadManager::planWorkers(2, TranslatorType::HYBRID, 0, 2);
+    ASSERT_TRUE(noGpu[0].translatorType == TranslatorType::SIMD);
+    ASSERT_TRUE(noGpu[1].translatorType == TranslatorType::SIMD);
+    
+    // CPU-only types are never moved to a device
+    auto permutation = ThreadManager::planWorkers(2, TranslatorType::PERMUTATION, 4, 2);
+    ASSERT_TRUE(permutation[1].translatorType == TranslatorType::PERMUTATION);
+    ASSERT_EQ(-1, permutation[1].cudaDevice);
+}
+
+void testPlanPlacementAlternatesNumaNodes() {
+    NumaTopology topology({ { 0, { 0, 1, 2, 3 } }, { 1, { 4, 5 } }, { 2, {} } });
+    ASSERT_EQ(2ULL, static_cast<uint64_t>(topology.nodeCount()));
+    ASSERT_EQ(6ULL, static_cast<uint64_t>(topology.cpuCount()));
+    
+    // Nodes alternate until the smaller one runs out; extra threads wrap around
+    auto plan = ThreadManager::planPlacement(7, topology, ThreadAffinity::CORE);
+    const int expectedCpus[] = { 0, 4, 1, 5, 2, 3, 0 };
+    const int expectedNodes[] = { 0, 1, 0, 1, 0, 0, 0 };
+    for (size_t i = 0; i < plan.size(); i++) {
+        ASSERT_EQ(expectedNodes[i], plan[i].numaNode);
+        ASSERT_EQ(1ULL, static_cast<uint64_t>(plan[i].cpus.size()));
+        ASSERT_EQ(expectedCpus[i], plan[i].cpus[0]);
+    }
+    
+    // NUMA_NODE pins to the whole node; NONE pins nothing
+    auto nodePlan = ThreadManager::planPlacement(2, topology, ThreadAffinity::NUMA_NODE);
+    ASSERT_EQ(4ULL, static_cast<uint64_t>(nodePlan[0].cpus.size()));
+    ASSERT_EQ(1, nodePlan[1].numaNode);
+    ASSERT_EQ(2ULL, static_cast<uint64_t>(nodePlan[1].cpus.size()));
+    auto floating = ThreadManager::planPlacement(2, topology, ThreadAffinity::NONE);
+    ASSERT_EQ(-1, floating[1].numaNode);
+    ASSERT_TRUE(floating[1].cpus.empty());
+}
+
+void testNumaTopologyDetectAndPin() {
+    ASSERT_TRUE(NumaTopology::parseCpuList("0-3,8,10-11\n") == std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }));
+    ASSERT_TRUE(NumaTopology::parseCpuList("5,x,3-1,2") == std::vector<int>({ 2, 5 }));
+    ASSERT_TRUE(NumaTopology::parseCpuList("").empty());
+    
+    // Every host has at least one node with a CPU this thread may be pinned to
+    NumaTopology topology = NumaTopology::detect();
+    ASSERT_TRUE(topology.nodeCount() >= 1);
+    ASSERT_TRUE(topology.cpuCount() >= 1);
+    std::cout << "  " << topology.describe() << std::endl;
+    
+    bool pinned = false;
+    std::thread worker([&]() { pinned = NumaTopology::pinCurrentThread(topology.getNodes()[0].cpus); });
+    worker.join();
+    ASSERT_TRUE(pinned);
+    ASSERT_FALSE(NumaTopology::pinCurrentThread({}));
+}
+
+void registerThreadManagerTests(TestFramework& framework) {
+    framework.addTest("Plan Workers Spreads CUDA Over Devices", testPlanWorkersSpreadsCudaOverDevices);
+    framework.addTest("Plan Workers Hybrid Splits GPU And CPU", testPlanWorkersHybridSplitsGpuAndCpu);
+    framework.addTest("Plan Placement Alternates NUMA Nodes", testPlanPlacementAlternatesNumaNodes);
+    framework.addTest("NUMA Topology Detect And Pin", testNumaTopologyDetectAndPin);
+}
@@ -0,0 +1,139 @@
+#include "TestFramework.h"
+#include "../TopResults.h"
+#include "../VoynichDecoder.h"
+#include "../MappingGenerator.h"
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <cstdio>
+
+namespace {
+    TopResults::Entry makeEntry(double score, uint64_t mappingIndex) {
+        TopResults::Entry entry;
+        entry.score = score;
+        entry.mappingIndex = mappingIndex;
+        entry.matchedWords = static_cast<uint32_t>(score);
+        entry.totalWords = 100;
+        MappingGenerator::unrankPermutation(mappingIndex, entry.permutation);
+        return entry;
+    }
+}
+
+void testTopResultsKeepsBestEntries() {
+    TopResults top(3);
+    for (uint64_t i = 0; i < 10; i++) {
+        top.offer(makeEntry(static_cast<double>((i * 7) % 10), i));
+    }
+    
+    // Scores 0..9 were offered once each; the three best remain
+    auto sorted = top.getSorted();
+    ASSERT_EQ(3ULL, static_cast<uint64_t>(sorted.size()));
+    ASSERT_TRUE(sorted[0].score == 9.0);
+    ASSERT_TRUE(sorted[2].score == 7.0);
+    ASSERT_TRUE(top.getAdmissionScore() == 7.0);
+    ASSERT_TRUE(top.takeChanged());
+    ASSERT_FALSE(top.takeChanged());
+    
+    // Weaker and already-kept mappings are turned away
+    ASSERT_FALSE(top.offer(makeEntry(6.5, 42)));
+    ASSERT_FALSE(top.offer(makeEntry(11.0, sorted[0].mappingIndex)));
+    ASSERT_TRUE(top.offer(makeEntry(8.5, 42)));
+    ASSERT_TRUE(top.getAdmissionScore() == 8.0);
+    
+    // Capacity 0 keeps nothing
+    TopResults disabled(0);
+    ASSERT_FALSE(disabled.offer(makeEntry(99.0, 1)));
+    ASSERT_TRUE(disabled.empty());
+}
+
+void testTopResultsMergeAndPersist() {
+    // Per-thread sets merge into the best of their union
+    TopResults first(4), second(4), merged(4);
+    for (uint64_t i = 0; i < 20; i++) {
+        (i % 2 == 0 ? first : second).offer(makeEntry(static_cast<double>(i), i));
+    }
+    merged.merge(first);
+    merged.merge(second);
+    auto sorted = merged.getSorted();
+    ASSERT_EQ(4ULL, static_cast<uint64_t>(sorted.size()));
+    ASSERT_EQ(19ULL, sorted[0].mappingIndex);
+    ASSERT_EQ(16ULL, sorted[3].mappingIndex);
+    
+    const std::string path = "test_top_results.bin";
+    std::remove(path.c_str());
+    ASSERT_TRUE(merged.saveToFile(path));
+    ASSERT_FALSE(std::ifstream(path + ".tmp").good());
+    
+    TopResults restored(4);
+    ASSERT_TRUE(restored.loadFromFile(path));
+    auto restoredSorted = restored.getSorted();
+    ASSERT_EQ(4ULL, static_cast<uint64_t>(restoredSorted.size()));
+    for (size_t i = 0; i < sorted.size(); i++) {
+        ASSERT_EQ(sorted[i].mappingIndex, restoredSorted[i].mappingIndex);
+        ASSERT_TRUE(sorted[i].score == restoredSorted[i].score);
+        ASSERT_TRUE(sorted[i].permutation == restoredSorted[i].permutation);
+    }
+    
+    // A smaller set keeps only the best of what was saved; a foreign file is rejected
+    TopResults smaller(2);
+    ASSERT_TRUE(smaller.loadFromFile(path));
+    ASSERT_EQ(18ULL, smaller.getSorted()[1].mappingIndex);
+    {
+        std::ofstream garbage(path, std::ios::binary | std::ios::trunc);
+        garbage << "not a top results file";
+    }
+    TopResults rejected(4);
+    ASSERT_FALSE(rejected.loadFromFile(path));
+    ASSERT_TRUE(rejected.empty());
+    std::remove(path.c_str());
+    ASSERT_FALSE(rejected.loadFromFile(path));
+}
+
+void testDecoderCollectsTopResults() {
+    const size_t topCount = 8;
+    const uint64_t startIndex = 1000, endIndex = 3000;
+    
+    VoynichDecoder::EnumerationMode modes[] = { VoynichDecoder::EnumerationMode::INDEXED, VoynichDecoder::EnumerationMode::ADJACENT_SWAP };
+    std::vector<std::vector<double>> topScores;
+    for (auto mode : modes) {
+        VoynichDecoder::DecoderConfig config;
+        config.translatorType = VoynichDecoder::TranslatorType::CPU;
+        config.enumerationMode = mode;
+        config.scoreThreshold = 101.0;  // Nothing reaches the results file; the top set needs no threshold
+        config.resultsFilePath = "test_top_results_decoder.txt";
+        config.topResultsCount = topCount;
+        
+        VoynichDecoder decoder(config);
+        ASSERT_TRUE(decoder.initialize());
+        
+        std::vector<double> scores;
+        ASSERT_TRUE(decoder.processMappingRange(startIndex, endIndex, 0,
+            [&scores](const VoynichDecoder::ProcessingResult& result) { scores.push_back(result.score); },
+            [](int, uint64_t, uint64_t, double, bool) {}));
+        ASSERT_EQ(endIndex - startIndex, static_cast<uint64_t>(scores.size()));
+        
+        // The kept set holds exactly the best scores of the range, keyed by generator index
+        std::sort(scores.begin(), scores.end(), std::greater<double>());
+        auto entries = decoder.getTopResults().getSorted();
+        ASSERT_EQ(static_cast<uint64_t>(topCount), static_cast<uint64_t>(entries.size()));
+        std::vector<double> kept;
+        for (size_t i = 0; i < entries.size(); i++) {
+            ASSERT_TRUE(entries[i].score == scores[i]);
+            ASSERT_TRUE(entries[i].mappingIndex >= startIndex && entries[i].mappingIndex < endIndex);
+            
+            Permutation expected;
+            MappingGenerator::unrankPermutation(entries[i].mappingIndex, expected);
+            ASSERT_TRUE(entries[i].permutation == expected);
+            kept.push_back(entries[i].score);
+        }
+        topScores.push_back(kept);
+    }
+    ASSERT_TRUE(topScores[0] == topScores[1]);
+}
+
+void registerTopResultsTests(TestFramework& framework) {
+    framework.addTest("Top Results Keeps Best Entries", testTopResultsKeepsBestEntries);
+    framework.addTest("Top Results Merge And Persist", testTopResultsMergeAndPersist);
+    framework.addTest("Decoder Collects Top Results", testDecoderCollectsTopResults);
+}
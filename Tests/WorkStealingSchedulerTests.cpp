@@ -0,0 +1,211 @@
+#include "TestFramework.h"
+#include "../WorkStealingScheduler.h"
+#include "../MappingGenerator.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    MappingGenerator::GeneratorConfig schedulerGeneratorConfig(size_t blockSize) {
+        MappingGenerator::GeneratorConfig config;
+        config.blockSize = blockSize;
+        config.enableStateFile = false;
+        return config;
+    }
+}
+
+void testSchedulerStealsTailOfBlock() {
+    MappingGenerator generator(schedulerGeneratorConfig(100));
+    
+    WorkStealingScheduler::SchedulerConfig config;
+    config.chunkSize = 10;
+    config.minStealSize = 4;
+    config.mappingBudget = 100;
+    WorkStealingScheduler scheduler(generator, 2, config);
+    
+    // Worker 0 claims block 0 and takes its first piece
+    WorkStealingScheduler::WorkItem first;
+    ASSERT_TRUE(scheduler.acquire(0, first));
+    ASSERT_EQ(0ULL, first.startIndex);
+    ASSERT_EQ(10ULL, first.endIndex);
+    
+    // The claimed block already covers the budget, so worker 1 splits off the back half
+    WorkStealingScheduler::WorkItem stolen;
+    ASSERT_TRUE(scheduler.acquire(1, stolen));
+    ASSERT_EQ(55ULL, stolen.startIndex);
+    ASSERT_EQ(65ULL, stolen.endIndex);
+    ASSERT_EQ(1ULL, scheduler.getStats().steals);
+    ASSERT_EQ(1ULL, generator.getCurrentState().nextBlockToGenerate);
+    
+    std::vector<WorkStealingScheduler::WorkItem> pieces = { first, stolen };
+    WorkStealingScheduler::WorkItem item;
+    while (scheduler.acquire(0, item)) pieces.push_back(item);
+    while (scheduler.acquire(1, item)) pieces.push_back(item);
+    
+    // Every index of the block was handed out exactly once
+    std::sort(pieces.begin(), pieces.end(),
+              [](const WorkStealingScheduler::WorkItem& a, const WorkStealingScheduler::WorkItem& b) { return a.startIndex < b.startIndex; });
+    uint64_t expectedStart = 0;
+    for (const auto& piece : pieces) {
+        ASSERT_EQ(expectedStart, piece.startIndex);
+        expectedStart = piece.endIndex;
+    }
+    ASSERT_EQ(100ULL, expectedStart);
+    
+    // The block stays PENDING until its last piece is reported, whoever scored it
+    for (size_t i = 0; i + 1 < pieces.size(); i++) {
+        scheduler.complete(pieces[i]);
+    }
+    ASSERT_EQ(0ULL, generator.getCurrentState().totalBlocksCompleted);
+    ASSERT_EQ(1ULL, static_cast<uint64_t>(generator.getBlockStatus().activeBlocks));
+    
+    scheduler.complete(pieces.back());
+    ASSERT_EQ(1ULL, generator.getCurrentState().totalBlocksCompleted);
+    ASSERT_EQ(0ULL, static_cast<uint64_t>(generator.getBlockStatus().windowSize));
+}
+
+void testSchedulerAbandonedPieceKeepsBlockPending() {
+    MappingGenerator generator(schedulerGeneratorConfig(50));
+    
+    WorkStealingScheduler::SchedulerConfig config;
+    config.chunkSize = 50;
+    WorkStealingScheduler scheduler(generator, 1, config);
+    
+    WorkStealingScheduler::WorkItem item;
+    ASSERT_TRUE(scheduler.acquire(0, item));
+    scheduler.complete(item);
+    
+    // A piece that is never reported (worker stopped mid-piece) leaves its block for resume
+    ASSERT_TRUE(scheduler.acquire(0, item));
+    ASSERT_EQ(50ULL, item.startIndex);
+    
+    auto window = generator.getWindowSnapshot();
+    ASSERT_EQ(1ULL, static_cast<uint64_t>(window.size()));
+    ASSERT_EQ(1ULL, window[0].blockIndex);
+    ASSERT_TRUE(window[0].state == MappingGenerator::BlockState::PENDING);
+    ASSERT_EQ(1ULL, generator.getCurrentState().totalBlocksCompleted);
+}
+
+void testSchedulerConcurrentCoverage() {
+    MappingGenerator generator(schedulerGeneratorConfig(1000));
+    
+    WorkStealingScheduler::SchedulerConfig config;
+    config.chunkSize = 64;
+    config.minStealSize = 16;
+    config.mappingBudget = 20000;
+    const int workerCount = 6;
+    WorkStealingScheduler scheduler(generator, workerCount, config);
+    
+    // Workers of very different speeds drain the budget together
+    std::mutex piecesMutex;
+    std::vector<WorkStealingScheduler::WorkItem> pieces;
+    std::vector<std::thread> workers;
+    for (int workerId = 0; workerId < workerCount; workerId++) {
+        workers.emplace_back([&, workerId]() {
+            WorkStealingScheduler::WorkItem item;
+            while (scheduler.acquire(workerId, item)) {
+                if (workerId == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+                scheduler.complete(item);
+                std::lock_guard<std::mutex> lock(piecesMutex);
+                pieces.push_back(item);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    // Exactly the budget was handed out, with no index issued twice
+    std::sort(pieces.begin(), pieces.end(),
+              [](const WorkStealingScheduler::WorkItem& a, const WorkStealingScheduler::WorkItem& b) { return a.startIndex < b.startIndex; });
+    uint64_t total = 0;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        total += pieces[i].size();
+        if (i > 0) {
+            ASSERT_TRUE(pieces[i - 1].endIndex <= pieces[i].startIndex);
+        }
+    }
+    ASSERT_EQ(20000ULL, total);
+    
+    // Fully scored blocks are completed; any block the budget cut short stays PENDING
+    auto stats = scheduler.getStats();
+    auto state = generator.getCurrentState();
+    ASSERT_EQ(stats.blocksCompleted, state.totalBlocksCompleted);
+    ASSERT_EQ(state.totalBlocksGenerated - state.totalBlocksCompleted,
+              static_cast<uint64_t>(generator.getBlockStatus().activeBlocks));
+    ASSERT_TRUE(state.totalBlocksGenerated >= 20000ULL / 1000ULL);
+}
+
+void testSchedulerAdaptsPieceSizeToThroughput() {
+    MappingGenerator generator(schedulerGeneratorConfig(1000000));
+    
+    WorkStealingScheduler::SchedulerConfig config;
+    config.chunkSize = 1000;
+    config.minStealSize = 100;
+    config.targetPieceMs = 100.0;
+    config.maxChunkSize = 50000;
+    WorkStealingScheduler scheduler(generator, 2, config);
+    
+    WorkStealingScheduler::WorkItem item;
+    ASSERT_TRUE(scheduler.acquire(0, item));
+    ASSERT_EQ(1000ULL, item.size());
+    
+    // A fast worker (100k mappings/s) gets 100 ms pieces, capped at maxChunkSize
+    scheduler.recordThroughput(0, 1000, 0.01);
+    ASSERT_EQ(10000ULL, scheduler.getWorkerThroughput(0).chunkSize);
+    ASSERT_TRUE(scheduler.acquire(0, item));
+    ASSERT_EQ(10000ULL, item.size());
+    scheduler.recordThroughput(0, 10000, 0.001);
+    ASSERT_EQ(50000ULL, scheduler.getWorkerThroughput(0).chunkSize);
+    
+    // A slow worker shrinks towards minStealSize; the other worker is unaffected
+    scheduler.recordThroughput(1, 10, 1.0);
+    ASSERT_EQ(100ULL, scheduler.getWorkerThroughput(1).chunkSize);
+    ASSERT_TRUE(scheduler.acquire(1, item));
+    ASSERT_EQ(100ULL, item.size());
+    
+    auto throughput = scheduler.getWorkerThroughput(0);
+    ASSERT_EQ(11000ULL, throughput.mappings);
+    ASSERT_TRUE(throughput.mappingsPerSecond() > 900000.0);
+}
+
+void testSchedulerPrefersNodeLocalSteals() {
+    MappingGenerator generator(schedulerGeneratorConfig(100));
+    
+    WorkStealingScheduler::SchedulerConfig config;
+    config.chunkSize = 10;
+    config.minStealSize = 4;
+    config.mappingBudget = 200;
+    config.workerNodes = { 0, 1, 0, 2 };
+    WorkStealingScheduler scheduler(generator, 4, config);
+    
+    // Workers 0 and 1 claim the two blocks the budget allows; worker 1 has more left
+    WorkStealingScheduler::WorkItem item;
+    ASSERT_TRUE(scheduler.acquire(0, item));
+    ASSERT_TRUE(scheduler.acquire(0, item));
+    ASSERT_TRUE(scheduler.acquire(1, item));
+    ASSERT_EQ(100ULL, item.startIndex);
+    
+    // Worker 2 shares node 0 with worker 0 and splits its range, although worker 1's is larger
+    ASSERT_TRUE(scheduler.acquire(2, item));
+    ASSERT_EQ(60ULL, item.startIndex);
+    ASSERT_EQ(1ULL, scheduler.getStats().nodeLocalSteals);
+    
+    // Worker 3 is alone on node 2, so it falls back to the largest range anywhere
+    ASSERT_TRUE(scheduler.acquire(3, item));
+    ASSERT_EQ(155ULL, item.startIndex);
+    ASSERT_EQ(2ULL, scheduler.getStats().steals);
+    ASSERT_EQ(1ULL, scheduler.getStats().nodeLocalSteals);
+}
+
+void registerWorkStealingSchedulerTests(TestFramework& framework) {
+    framework.addTest("Scheduler Steals Tail Of Block", testSchedulerStealsTailOfBlock);
+    framework.addTest("Scheduler Abandoned Piece Keeps Block Pending", testSchedulerAbandonedPieceKeepsBlockPending);
+    framework.addTest("Scheduler Concurrent Coverage", testSchedulerConcurrentCoverage);
+    framework.addTest("Scheduler Adapts Piece Size To Throughput", testSchedulerAdaptsPieceSizeToThroughput);
+    framework.addTest("Scheduler Prefers Node-Local Steals", testSchedulerPrefersNodeLocalSteals);
+}
@@ -3,17 +3,25 @@
 #include <iomanip>
 #include <algorithm>
 #include <thread>
+#include <map>
 
 // Static member definitions
 std::atomic<bool> ThreadManager::signalReceived{false};
 ThreadManager* ThreadManager::instance = nullptr;
 
-ThreadManager::ThreadManager(const ThreadManagerConfig& config) : config(config) {
+ThreadManager::ThreadManager(const ThreadManagerConfig& config)
+    : config(config), mergedTopResults(config.topResultsCount) {
     instance = this;
 }
 
 ThreadManager::~ThreadManager() {
     stop();
+    if (mappingGenerator) {
+        mappingGenerator->setCheckpointListener(nullptr);  // The generator outlives mergedTopResults
+    }
+    if (prefixSearch) {
+        prefixSearch->setCheckpointListener(nullptr);
+    }
     cleanupSignalHandling();
     instance = nullptr;
 }
@@ -55,19 +63,101 @@ BOOL WINAPI ThreadManager::consoleHandler(DWORD dwCtrlType) {
 bool ThreadManager::initialize() {
     std::wcout << L"Initializing Thread Manager..." << std::endl;
     
-    // Initialize mapping generator
-    MappingGenerator::GeneratorConfig genConfig;
-    genConfig.blockSize = config.mappingBlockSize;
-    genConfig.stateFilePath = config.generatorStateFile;
-    genConfig.enableStateFile = true;
+    // Determine number of threads
+    NumaTopology topology = NumaTopology::detect();
+    if (config.numThreads == 0) {
+        config.numThreads = getOptimalThreadCount(topology);
+    }
+    
+    // Pin workers to CPUs or nodes; steals and lexicon replicas then follow the nodes
+    placementPlan = planPlacement(config.numThreads, topology, config.threadAffinity);
+    if (config.threadAffinity != ThreadAffinity::NONE) {
+        std::wcout << L"Thread affinity: " << (config.threadAffinity == ThreadAffinity::CORE ? L"one CPU" : L"one NUMA node")
+                   << L" per worker, " << topology.describe().c_str() << std::endl;
+    }
     
-    mappingGenerator = std::make_unique<MappingGenerator>(genConfig);
+    // Letters the corpus never uses cannot change a score, so their assignments need no search.
+    // Block indices are shared with the coordinator, so cluster nodes keep the full space.
+    SearchSpace searchSpace;
+    if (config.reduceSearchSpace) {
+        if (!config.coordinatorAddress.empty()) {
+            std::wcout << L"Search space reduction is not available in cluster mode, using the full space" << std::endl;
+        } else {
+            WordSet corpus;
+            corpus.readFromFile(config.voynichWordsPath, Alphabet::EVA);
+            searchSpace = SearchSpace::forWords(corpus);
+            if (!searchSpace.isFull() && searchSpace.isTruncated()) {
+                std::wcerr << L"Warning: the reduced space has " << searchSpace.getExactSize()
+                           << L" assignments, more than the 64-bit mapping index holds; only the first "
+                           << searchSpace.getSize() << L" (the rarest letters' leading choices) are searched" << std::endl;
+            }
+        }
+    }
     
-    // Display block status information
-    auto blockStatus = mappingGenerator->getBlockStatus();
-    std::wcout << L"Block Status: Window " << blockStatus.windowSize 
-               << L", Next block: " << blockStatus.nextBlockToGenerate 
-               << L", Completed: " << blockStatus.completedBlocks << std::endl;
+    // The prefix and local searches choose their own mappings, so they have no blocks to share
+    // with a coordinator
+    if (config.searchEngine != SearchEngine::FLAT && !config.coordinatorAddress.empty()) {
+        std::wcout << (config.searchEngine == SearchEngine::PREFIX ? L"Prefix" : L"Local")
+                   << L" search is not available in cluster mode, using flat enumeration" << std::endl;
+        config.searchEngine = SearchEngine::FLAT;
+    }
+    
+    // Folded targets are scored by the decoders' CPU table kernels only
+    if (config.targetAlphabet != TargetAlphabet::HEBREW_27) {
+        using TranslatorType = VoynichDecoder::TranslatorType;
+        if (config.searchEngine != SearchEngine::FLAT) {
+            std::wcout << (config.searchEngine == SearchEngine::PREFIX ? L"Prefix" : L"Local")
+                       << L" search supports the HEBREW_27 target only, using flat enumeration" << std::endl;
+            config.searchEngine = SearchEngine::FLAT;
+        }
+        if (config.translatorType == TranslatorType::CUDA || config.translatorType == TranslatorType::AUTO ||
+            config.translatorType == TranslatorType::HYBRID) {
+            std::wcout << L"Target alphabet " << ScoringKernels::getTargetAlphabetName(config.targetAlphabet).c_str()
+                       << L" is scored on the CPU, using the SIMD translator" << std::endl;
+            config.translatorType = TranslatorType::SIMD;
+        }
+    }
+    if (config.searchEngine == SearchEngine::FLAT) {
+        std::wcout << L"Search space: " << searchSpace.describe().c_str() << std::endl;
+    }
+    
+    BlockSource* blockSource = nullptr;
+    if (config.searchEngine != SearchEngine::FLAT) {
+        // Subtree roots or chains come from the search engine, created once the lexicon is loaded
+    } else if (!config.coordinatorAddress.empty()) {
+        // Cluster node: the coordinator owns the block window and its state file
+        ClusterClient::ClientConfig clientConfig;
+        if (!parseHostPort(config.coordinatorAddress, clientConfig.host, clientConfig.port)) {
+            std::wcerr << L"Invalid coordinator address (expected host:port): " << config.coordinatorAddress.c_str() << std::endl;
+            return false;
+        }
+        clientConfig.nodeName = config.nodeName;
+        clientConfig.threads = config.numThreads;
+        
+        clusterClient = std::make_unique<ClusterClient>(clientConfig);
+        if (!clusterClient->connect()) {
+            return false;
+        }
+        blockSource = clusterClient.get();
+    } else {
+        // Initialize mapping generator
+        MappingGenerator::GeneratorConfig genConfig;
+        genConfig.blockSize = config.mappingBlockSize;
+        genConfig.stateFilePath = config.generatorStateFile;
+        genConfig.enableStateFile = true;
+        genConfig.searchSpace = searchSpace;
+        
+        mappingGenerator = std::make_unique<MappingGenerator>(genConfig);
+        blockSource = mappingGenerator.get();
+        
+        // Display block status information
+        auto blockStatus = mappingGenerator->getBlockStatus();
+        std::wcout << L"Block Status: Window " << blockStatus.windowSize 
+                   << L", Next block: " << blockStatus.nextBlockToGenerate 
+                   << L", Completed: " << blockStatus.completedBlocks << std::endl;
+        
+        mappingGenerator->setCheckpointListener(resumeTopResults(blockStatus.nextBlockToGenerate > 0, config.topResultsFile));
+    }
     
     // Initialize stats provider
     StatsProvider::StatsConfig statsConfig;
@@ -75,29 +165,122 @@ bool ThreadManager::initialize() {
     statsConfig.resultsFilePath = config.resultsFilePath;
     statsConfig.scoreThreshold = config.scoreThreshold;
     statsConfig.maxMappingsToProcess = config.maxMappingsToProcess;
+    statsConfig.threadCount = config.numThreads;
     
     statsProvider = std::make_unique<StatsProvider>(statsConfig);
     
-    // Determine number of threads
-    if (config.numThreads == 0) {
-        config.numThreads = getOptimalThreadCount();
+    if (config.metrics.mode != MetricsExporter::Mode::DISABLED) {
+        metricsExporter = std::make_unique<MetricsExporter>(config.metrics, [this]() { return collectMetrics(); });
     }
     
     std::wcout << L"Configured for " << config.numThreads << L" worker threads" << std::endl;
     
+    // Workers take pieces of blocks from the scheduler; idle workers steal unprocessed tails
+    WorkStealingScheduler::SchedulerConfig schedulerConfig;
+    schedulerConfig.chunkSize = config.schedulerChunkSize;
+    schedulerConfig.minStealSize = config.minStealSize;
+    schedulerConfig.mappingBudget = config.maxMappingsToProcess;
+    schedulerConfig.targetPieceMs = config.targetPieceMs;
+    if (config.threadAffinity != ThreadAffinity::NONE) {
+        for (const WorkerPlacement& placement : placementPlan) {
+            schedulerConfig.workerNodes.push_back(placement.numaNode);
+        }
+    }
+    
+    if (blockSource) {
+        scheduler = std::make_unique<WorkStealingScheduler>(*blockSource, config.numThreads, schedulerConfig);
+    }
+    
     std::wcout << L"Score threshold: " << std::fixed << std::setprecision(1) << config.scoreThreshold << std::endl;
     std::wcout << L"Max mappings to process: " << (config.maxMappingsToProcess > 0 ? 
         std::to_wstring(config.maxMappingsToProcess) : L"unlimited") << std::endl;
     
+    // Load the Hebrew lexicon once; every decoder's validator attaches to this instance
+    auto lexiconStart = std::chrono::steady_clock::now();
+    sharedLexicon = HebrewLexicon::acquire(config.hebrewLexiconPath, config.lexiconBackend, config.lexiconImagePath, config.targetAlphabet);
+    auto lexiconMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lexiconStart).count();
+    std::wcout << L"Hebrew lexicon: " << sharedLexicon->getWordCount() << L" words, "
+               << sharedLexicon->getUniqueMaskCount() << L" letter sets, "
+               << (sharedLexicon->getMemoryBytes() / 1024) << L" KiB, loaded in " << lexiconMs << L" ms (shared by all threads)" << std::endl;
+    if (config.numaReplicas && config.threadAffinity != ThreadAffinity::NONE && topology.nodeCount() > 1) {
+        replicateLexicon(topology);
+    }
+    
+    if (config.searchEngine == SearchEngine::PREFIX) {
+        WordSet corpus;
+        corpus.readFromFile(config.voynichWordsPath, Alphabet::EVA);
+        PrefixSearch::SearchConfig searchConfig;
+        searchConfig.rootDepth = config.prefixRootDepth;
+        searchConfig.stateFilePath = config.prefixStateFile;
+        prefixSearch = std::make_unique<PrefixSearch>(corpus, sharedLexicon, searchConfig);
+        
+        auto progress = prefixSearch->getProgress();
+        std::wcout << L"Search engine: prefix search over " << prefixSearch->getLetterOrder().size()
+                   << L" EVA letters, " << progress.rootCount << L" subtrees of depth " << prefixSearch->getRootDepth()
+                   << L" (" << progress.rootsCompleted << L" completed)" << std::endl;
+        
+        prefixSearch->setCheckpointListener(resumeTopResults(prefixSearch->wasResumed(), config.prefixTopResultsFile));
+    } else if (config.searchEngine == SearchEngine::LOCAL) {
+        WordSet corpus;
+        corpus.readFromFile(config.voynichWordsPath, Alphabet::EVA);
+        LocalSearch::SearchConfig searchConfig;
+        searchConfig.movesPerRound = config.localMovesPerRound;
+        searchConfig.initialTemperature = config.localInitialTemperature;
+        searchConfig.coolingRate = config.localCoolingRate;
+        searchConfig.moveBudget = config.maxMappingsToProcess;
+        searchConfig.targetMatched = config.localTargetMatched;
+        searchConfig.randomSeed = config.localRandomSeed;
+        
+        // Saved best mappings (of any engine) make good starting points
+        if (!config.localSeedFile.empty()) {
+            TopResults seeds(std::max<size_t>(config.topResultsCount, 1));
+            if (seeds.loadFromFile(config.localSeedFile)) {
+                for (const auto& entry : seeds.getSorted()) {
+                    searchConfig.seedPermutations.push_back(entry.permutation);
+                }
+            }
+        }
+        localSearch = std::make_unique<LocalSearch>(corpus, sharedLexicon, searchConfig);
+        
+        std::wcout << L"Search engine: local search over " << localSearch->getUsedLetterCount() << L" EVA letters, "
+                   << config.localMovesPerRound << L" moves per round, temperature " << config.localInitialTemperature
+                   << L", " << (searchConfig.seedPermutations.empty() ? L"random starts" :
+                      std::to_wstring(searchConfig.seedPermutations.size()) + L" seed mappings") << std::endl;
+    }
+    
+    // Spread workers over the CUDA devices (and the CPU in HYBRID mode)
+    int cudaDeviceCount = StaticTranslator::getCudaDeviceCount();
+    workerPlan = planWorkers(config.numThreads, config.translatorType, cudaDeviceCount, config.gpuWorkersPerDevice);
+    size_t gpuWorkers = std::count_if(workerPlan.begin(), workerPlan.end(),
+                                      [](const WorkerAssignment& assignment) { return assignment.cudaDevice >= 0; });
+    if (gpuWorkers > 0) {
+        std::wcout << L"Workers: " << gpuWorkers << L" on " << cudaDeviceCount << L" CUDA device(s), "
+                   << (config.numThreads - gpuWorkers) << L" on CPU" << std::endl;
+        for (int device = 0; device < cudaDeviceCount; ++device) {
+            std::wcout << L"  CUDA " << device << L": " << StaticTranslator::getCudaDeviceInfo(device).c_str() << std::endl;
+        }
+    }
+    
     // Create decoder instances for each thread
     decoders.reserve(config.numThreads);
     for (size_t i = 0; i < config.numThreads; ++i) {
         VoynichDecoder::DecoderConfig decoderConfig;
         decoderConfig.hebrewLexiconPath = config.hebrewLexiconPath;
         decoderConfig.voynichWordsPath = config.voynichWordsPath;
+        decoderConfig.lexiconImagePath = config.lexiconImagePath;
         decoderConfig.scoreThreshold = config.scoreThreshold;
         decoderConfig.resultsFilePath = config.resultsFilePath;
-        decoderConfig.translatorType = config.translatorType;
+        decoderConfig.resultsFormat = config.resultsFormat;
+        decoderConfig.translatorType = workerPlan[i].translatorType;
+        decoderConfig.cudaDevice = workerPlan[i].cudaDevice;
+        decoderConfig.lexiconBackend = config.lexiconBackend;
+        decoderConfig.enumerationMode = config.enumerationMode;
+        decoderConfig.boundedScoring = config.boundedScoring;
+        decoderConfig.targetAlphabet = config.targetAlphabet;
+        decoderConfig.topResultsCount = config.topResultsCount;
+        decoderConfig.searchSpace = searchSpace;
+        auto replica = nodeLexicons.find(placementPlan[i].numaNode);
+        decoderConfig.lexicon = (replica != nodeLexicons.end()) ? replica->second : sharedLexicon;
         
         decoders.push_back(std::make_unique<VoynichDecoder>(decoderConfig));
     }
@@ -110,9 +293,91 @@ bool ThreadManager::initialize() {
 }
 
 
-size_t ThreadManager::getOptimalThreadCount() const {
-    size_t hardwareThreads = std::thread::hardware_concurrency();
-    return hardwareThreads > 0 ? hardwareThreads : 4;
+std::vector<ThreadManager::WorkerAssignment> ThreadManager::planWorkers(size_t numThreads, VoynichDecoder::TranslatorType translatorType,
+                                                                       int cudaDeviceCount, size_t gpuWorkersPerDevice) {
+    using TranslatorType = VoynichDecoder::TranslatorType;
+    std::vector<WorkerAssignment> plan(numThreads, WorkerAssignment{ translatorType, -1 });
+    
+    bool spreadAll = (translatorType == TranslatorType::CUDA || translatorType == TranslatorType::AUTO) && cudaDeviceCount > 0;
+    if (spreadAll) {
+        for (size_t i = 0; i < numThreads; ++i) {
+            plan[i] = WorkerAssignment{ TranslatorType::CUDA, static_cast<int>(i % cudaDeviceCount) };
+        }
+        return plan;
+    }
+    
+    if (translatorType == TranslatorType::HYBRID) {
+        size_t gpuWorkers = (cudaDeviceCount > 0)
+            ? std::min(numThreads, static_cast<size_t>(cudaDeviceCount) * std::max<size_t>(gpuWorkersPerDevice, 1))
+            : 0;
+        for (size_t i = 0; i < numThreads; ++i) {
+            plan[i] = (i < gpuWorkers)
+                ? WorkerAssignment{ TranslatorType::CUDA, static_cast<int>(i % cudaDeviceCount) }
+                : WorkerAssignment{ TranslatorType::SIMD, -1 };
+        }
+    }
+    return plan;
+}
+
+std::vector<ThreadManager::WorkerPlacement> ThreadManager::planPlacement(size_t numThreads, const NumaTopology& topology,
+                                                                         ThreadAffinity affinity) {
+    std::vector<WorkerPlacement> plan(numThreads, WorkerPlacement{ -1, {} });
+    if (affinity == ThreadAffinity::NONE || topology.cpuCount() == 0) {
+        return plan;
+    }
+    
+    // CPU k of every node before CPU k+1 of any, so consecutive workers alternate nodes
+    const auto& nodes = topology.getNodes();
+    std::vector<std::pair<size_t, int>> order;  // (node index, CPU)
+    for (size_t k = 0; order.size() < topology.cpuCount(); ++k) {
+        for (size_t n = 0; n < nodes.size(); ++n) {
+            if (k < nodes[n].cpus.size()) {
+                order.emplace_back(n, nodes[n].cpus[k]);
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < numThreads; ++i) {
+        const auto& slot = order[i % order.size()];
+        plan[i].numaNode = nodes[slot.first].id;
+        plan[i].cpus = (affinity == ThreadAffinity::CORE) ? std::vector<int>{ slot.second } : nodes[slot.first].cpus;
+    }
+    return plan;
+}
+
+size_t ThreadManager::getOptimalThreadCount(const NumaTopology& topology) const {
+    // CPUs this process may run on (affinity masks and container limits included)
+    size_t cpus = topology.cpuCount();
+    return cpus > 0 ? cpus : 4;
+}
+
+void ThreadManager::replicateLexicon(const NumaTopology& topology) {
+    // Each copy is made by a thread pinned to its node, so its pages are allocated there
+    const auto& nodes = topology.getNodes();
+    std::vector<std::shared_ptr<const HebrewLexicon>> replicas(nodes.size());
+    std::vector<std::thread> builders;
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        bool used = std::any_of(placementPlan.begin(), placementPlan.end(),
+                                [&](const WorkerPlacement& placement) { return placement.numaNode == nodes[n].id; });
+        if (!used) {
+            continue;
+        }
+        builders.emplace_back([this, &nodes, &replicas, n]() {
+            NumaTopology::pinCurrentThread(nodes[n].cpus);
+            replicas[n] = std::make_shared<const HebrewLexicon>(*sharedLexicon);
+        });
+    }
+    for (auto& builder : builders) {
+        builder.join();
+    }
+    
+    for (size_t n = 0; n < nodes.size(); ++n) {
+        if (replicas[n]) {
+            nodeLexicons[nodes[n].id] = replicas[n];
+        }
+    }
+    std::wcout << L"Hebrew lexicon: replicated on " << nodeLexicons.size() << L" NUMA node(s), "
+               << (sharedLexicon->getMemoryBytes() / 1024) << L" KiB each" << std::endl;
 }
 
 void ThreadManager::setupSignalHandling() {
@@ -139,11 +404,21 @@ void ThreadManager::start() {
     shouldStop = false;
     signalReceived = false;
     isRunning = true;
+    activeWorkers = config.numThreads;
     
     std::wcout << L"Starting Thread Manager with " << config.numThreads << L" threads..." << std::endl;
     
+    // Totals start from zero with every run, before the stats provider takes its first sample
+    if (Profiler::isCompiledIn()) {
+        Profiler::configure(config.profiler);
+        std::wcout << L"Profiling: 1 in " << config.profiler.sampleInterval << L" mappings timed per stage" << std::endl;
+    }
+    
     // Start stats provider
     statsProvider->start();
+    if (metricsExporter) {
+        metricsExporter->start();
+    }
     
     // Start worker threads
     for (size_t i = 0; i < config.numThreads; ++i) {
@@ -159,6 +434,9 @@ void ThreadManager::stop() {
     }
     
     shouldStop = true;
+    if (clusterClient) {
+        clusterClient->requestStop();  // Workers waiting for a lease give up
+    }
     
     // Wait for all worker threads to complete
     for (auto& thread : workerThreads) {
@@ -169,6 +447,57 @@ void ThreadManager::stop() {
     
     workerThreads.clear();
     
+    if (Profiler::isCompiledIn() && !config.profiler.traceFilePath.empty()) {
+        if (Profiler::writeTrace(config.profiler.traceFilePath)) {
+            std::wcout << L"Profile trace written to " << config.profiler.traceFilePath.c_str() << std::endl;
+        } else {
+            std::wcerr << L"Could not write profile trace " << config.profiler.traceFilePath.c_str() << std::endl;
+        }
+    }
+    
+    if (scheduler) {
+        auto schedulerStats = scheduler->getStats();
+        std::wcout << L"Scheduler: " << schedulerStats.blocksClaimed << L" blocks claimed, "
+                   << schedulerStats.blocksCompleted << L" completed, " << schedulerStats.steals << L" steals ("
+                   << schedulerStats.mappingsStolen << L" mappings moved)" << std::endl;
+        if (config.threadAffinity != ThreadAffinity::NONE) {
+            std::wcout << L"  " << schedulerStats.nodeLocalSteals << L" of the steals stayed on the thief's NUMA node" << std::endl;
+        }
+        printDeviceThroughput();
+    }
+    
+    if (prefixSearch) {
+        prefixSearch->saveState();
+        auto progress = prefixSearch->getProgress();
+        std::wcout << L"Prefix search: " << progress.rootsCompleted << L" of " << progress.rootCount << L" subtrees completed, "
+                   << progress.totals.nodesVisited << L" nodes expanded, " << progress.totals.nodesPruned << L" pruned, "
+                   << progress.totals.leavesScored << L" mappings scored" << std::endl;
+    }
+    
+    if (localSearch) {
+        auto progress = localSearch->getProgress();
+        std::wcout << L"Local search: best " << progress.bestMatched << L" of " << localSearch->getTotalWords()
+                   << L" words after " << std::fixed << std::setprecision(1) << progress.secondsToBest << L" s; "
+                   << progress.totals.movesEvaluated << L" moves over " << progress.chains << L" chains, "
+                   << progress.totals.movesAccepted << L" accepted, " << progress.totals.restarts << L" restarts" << std::endl;
+    }
+    
+    // Workers merged their sets as they went; the final list is saved whatever the checkpoint timing
+    if (config.topResultsCount > 0) {
+        saveTopResults();
+        printTopResults(10);
+    }
+    
+    // Leave the cluster; the coordinator reassigns any lease this node did not finish
+    if (clusterClient) {
+        clusterClient->disconnect();
+    }
+    
+    // The last metrics sample includes the final totals
+    if (metricsExporter) {
+        metricsExporter->stop();
+    }
+    
     // Stop stats provider
     if (statsProvider) {
         statsProvider->stop();
@@ -177,6 +506,28 @@ void ThreadManager::stop() {
     isRunning = false;
 }
 
+void ThreadManager::printDeviceThroughput() const {
+    // Sum worker rates per device (-1 = CPU workers); only shown when GPUs were in use
+    std::map<int, std::pair<double, uint64_t>> devices;
+    bool anyGpu = false;
+    for (size_t i = 0; i < workerPlan.size(); ++i) {
+        auto throughput = scheduler->getWorkerThroughput(static_cast<int>(i));
+        auto& device = devices[workerPlan[i].cudaDevice];
+        device.first += throughput.mappingsPerSecond();
+        device.second = std::max(device.second, throughput.chunkSize);
+        anyGpu = anyGpu || workerPlan[i].cudaDevice >= 0;
+    }
+    if (!anyGpu) {
+        return;
+    }
+    
+    for (const auto& entry : devices) {
+        std::wstring name = entry.first >= 0 ? L"CUDA " + std::to_wstring(entry.first) : L"CPU";
+        std::wcout << L"  " << name << L": " << std::fixed << std::setprecision(0) << entry.second.first
+                   << L" mappings/s, pieces of " << entry.second.second << L" mappings" << std::endl;
+    }
+}
+
 void ThreadManager::waitForCompletion() {
     while (isRunning.load() && !shouldStop.load() && !signalReceived.load()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(50)); // Check more frequently
@@ -197,6 +548,12 @@ void ThreadManager::waitForCompletion() {
             shouldStop = true;
             break;
         }
+        
+        // Every worker has run out of work (budget handed out or generation complete)
+        if (activeWorkers.load() == 0) {
+            std::wcout << L"\nAll workers finished. Stopping..." << std::endl;
+            break;
+        }
     }
     
     stop();
@@ -206,60 +563,97 @@ void ThreadManager::workerThreadFunction(int threadId) {
     try {
         auto& decoder = *decoders[threadId];
         
+        // Pinned before the decoder allocates, so its corpus masks and buffers are node-local
+        const WorkerPlacement& placement = placementPlan[threadId];
+        if (!placement.cpus.empty() && !NumaTopology::pinCurrentThread(placement.cpus)) {
+            std::wcerr << L"Thread " << threadId << L": could not pin to NUMA node " << placement.numaNode << std::endl;
+        }
+        
         // Initialize decoder
         if (!decoder.initialize()) {
             statsProvider->submitThreadCompleted(threadId, 0);
+            activeWorkers--;
             return;
         }
         
         statsProvider->submitThreadStarted(threadId);
         
         uint64_t localMappingsProcessed = 0;
+        auto resultCallback = [this, threadId, &localMappingsProcessed](const VoynichDecoder::ProcessingResult& result) {
+            localMappingsProcessed++;
+            
+            // Only submit high scores individually for immediate reporting
+            if (result.isHighScore) {
+                statsProvider->submitHighScore(threadId, result.mappingId, result.score, 
+                                             result.matchedWords, result.totalWords, result.matchPercentage);
+                if (clusterClient && result.hasPermutation) {
+                    clusterClient->submitResult(result.mappingIndex, result.permutation, result.score,
+                                                result.matchedWords, result.totalWords);
+                }
+            }
+        };
+        auto batchStatsCallback = [this](int tId, uint64_t mappings, uint64_t words, double highScore, bool hasHigh) {
+            // Batch stats callback - called every 1 second by decoder; updates this thread's counters
+            statsProvider->submitBatchStats(tId, mappings, words, highScore, hasHigh);
+        };
+        auto shouldStopCallback = [this]() -> bool {
+            // Signal check callback - returns true if thread should stop
+            return shouldStop.load() || signalReceived.load();
+        };
         
-        while (!shouldStop.load() && !signalReceived.load()) {
-            // Check if generation is complete
-            if (mappingGenerator->isGenerationComplete()) {
+        // Prefix search: each claimed subtree is searched to the end; one left unfinished by a
+        // stop is searched again on resume
+        uint64_t root = 0;
+        while (prefixSearch && !shouldStop.load() && !signalReceived.load() && prefixSearch->claimRoot(root)) {
+            auto rootStart = std::chrono::steady_clock::now();
+            PrefixSearch::SubtreeStats subtreeStats;
+            if (!decoder.processPrefixSubtree(*prefixSearch, root, threadId, resultCallback, batchStatsCallback,
+                                              shouldStopCallback, subtreeStats)) {
                 break;
             }
             
-            // Process a block of mappings using decoder with batch stats callback
-            decoder.processMappingBlock(*mappingGenerator, threadId, 
-                [this, threadId, &localMappingsProcessed](const VoynichDecoder::ProcessingResult& result) {
-                    localMappingsProcessed++;
-                    
-                    // Only submit high scores individually for immediate reporting
-                    if (result.isHighScore) {
-                        statsProvider->submitHighScore(threadId, result.mappingId, result.score, 
-                                                     result.matchedWords, result.totalWords, result.matchPercentage);
-                    }
-                },
-                [this](int tId, uint64_t mappings, uint64_t words, double highScore, bool hasHigh) {
-                    // Batch stats callback - called every 1 second by decoder
-                    statsProvider->submitBatchStats(tId, mappings, words, highScore, hasHigh);
-                },
-                [this]() -> bool {
-                    // Signal check callback - returns true if thread should stop
-                    return shouldStop.load() || signalReceived.load();
-                });
-            
-            // Check termination conditions
-            if (config.maxMappingsToProcess > 0) {
-                auto stats = getCurrentStats();
-                if (stats.totalMappingsProcessed >= config.maxMappingsToProcess) {
-                    shouldStop = true;
-                    break;
-                }
+            // Merged first, so the checkpoint written on completion includes this subtree's results
+            mergeTopResults(decoder);
+            prefixSearch->completeRoot(root, subtreeStats);
+            statsProvider->submitPieceCompleted(threadId, std::chrono::duration<double>(std::chrono::steady_clock::now() - rootStart).count());
+        }
+        
+        // Local search: this worker's chain runs rounds until it is stopped, the move budget is
+        // spent or some chain reaches the target
+        if (localSearch) {
+            auto chain = localSearch->createChain(static_cast<uint64_t>(threadId));
+            bool keepGoing = true;
+            while (keepGoing && !shouldStop.load() && !signalReceived.load()) {
+                auto roundStart = std::chrono::steady_clock::now();
+                keepGoing = decoder.processLocalSearchRound(*localSearch, *chain, threadId, resultCallback,
+                                                            batchStatsCallback, shouldStopCallback);
+                mergeTopResults(decoder);
+                statsProvider->submitPieceCompleted(threadId, std::chrono::duration<double>(std::chrono::steady_clock::now() - roundStart).count());
+            }
+        }
+        
+        // Pieces come from this thread's own block first, then a fresh block, then the
+        // unprocessed tail of another thread's block; no work left means this thread is done
+        WorkStealingScheduler::WorkItem item;
+        while (scheduler && !shouldStop.load() && !signalReceived.load() && scheduler->acquire(threadId, item)) {
+            auto pieceStart = std::chrono::steady_clock::now();
+            if (!decoder.processMappingRange(item.startIndex, item.endIndex, threadId,
+                                             resultCallback, batchStatsCallback, shouldStopCallback)) {
+                // Stopped mid-piece: leave its block PENDING so it is reassigned on resume
+                break;
             }
+            scheduler->complete(item);
+            mergeTopResults(decoder);
             
-            // Small delay if no mappings were processed
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Measured speed sizes this worker's next pieces (GPU workers get far larger ones)
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - pieceStart).count();
+            scheduler->recordThroughput(threadId, item.size(), seconds);
+            statsProvider->submitPieceCompleted(threadId, seconds);
         }
         
-        // Final report of any remaining stats
-        decoder.reportBatchStatsIfNeeded(
-            [this](int tId, uint64_t mappings, uint64_t words, double highScore, bool hasHigh) {
-                statsProvider->submitBatchStats(tId, mappings, words, highScore, hasHigh);
-            }, threadId, true); // force = true
+        // Final report of any remaining stats (and of results scored in an unfinished piece)
+        decoder.reportBatchStatsIfNeeded(batchStatsCallback, threadId, true); // force = true
+        mergeTopResults(decoder);
         
         statsProvider->submitThreadCompleted(threadId, localMappingsProcessed);
         
@@ -267,6 +661,8 @@ void ThreadManager::workerThreadFunction(int threadId) {
         std::wcerr << L"Thread " << threadId << L" error: " << e.what() << std::endl;
         statsProvider->submitThreadCompleted(threadId, 0);
     }
+    
+    activeWorkers--;
 }
 
 StatsProvider::StatsSnapshot ThreadManager::getCurrentStats() const {
@@ -276,6 +672,118 @@ StatsProvider::StatsSnapshot ThreadManager::getCurrentStats() const {
     return {};
 }
 
+MetricsExporter::Metrics ThreadManager::collectMetrics() const {
+    MetricsExporter::Metrics metrics;
+    metrics.nodeName = config.nodeName;
+    if (!statsProvider) {
+        return metrics;
+    }
+    
+    auto snapshot = statsProvider->getCurrentSnapshot();
+    metrics.uptimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - snapshot.startTime).count();
+    metrics.mappingsProcessed = snapshot.totalMappingsProcessed;
+    metrics.mappingsPerSecond = snapshot.getMappingsPerSecond();
+    metrics.wordsValidated = snapshot.totalWordsValidated;
+    metrics.highestScore = snapshot.highestScore;
+    metrics.highScoreCount = snapshot.highScoreCount;
+    metrics.activeThreads = snapshot.activeThreads;
+    
+    for (const auto& thread : statsProvider->getThreadSnapshots()) {
+        MetricsExporter::ThreadMetrics threadMetrics;
+        threadMetrics.threadId = thread.threadId;
+        threadMetrics.mappingsProcessed = thread.mappingsProcessed;
+        threadMetrics.mappingsPerSecond = thread.mappingsPerSecond;
+        threadMetrics.piecesCompleted = thread.piecesCompleted;
+        threadMetrics.averagePieceMs = thread.averagePieceMs;
+        threadMetrics.highestScore = thread.highestScore;
+        metrics.threads.push_back(threadMetrics);
+        
+        for (size_t b = 0; b < thread.pieceLatencyCounts.size(); ++b) {
+            metrics.pieceLatencyCounts[b] += thread.pieceLatencyCounts[b];
+        }
+        metrics.piecesCompleted += thread.piecesCompleted;
+        metrics.pieceLatencySumMs += thread.averagePieceMs * thread.piecesCompleted;
+    }
+    
+    // Decoders publish their counters with each batch report
+    for (const auto& decoder : decoders) {
+        auto decoderMetrics = decoder->getMetrics();
+        metrics.lexiconProbes += decoderMetrics.wordsProbed;
+        metrics.lexiconHits += decoderMetrics.wordsMatched;
+        metrics.gpuChunksScored += decoderMetrics.gpuChunksScored;
+        metrics.gpuKernelMs += decoderMetrics.gpuKernelMs;
+        metrics.gpuTransferMs += decoderMetrics.gpuTransferMs;
+    }
+    if (metrics.gpuChunksScored > 0) {
+        metrics.gpuDevices = StaticTranslator::getCudaDeviceCount();
+    }
+    
+    if (mappingGenerator) {
+        auto blockStatus = mappingGenerator->getBlockStatus();
+        metrics.hasGenerator = true;
+        metrics.generatorWindowSize = blockStatus.windowSize;
+        metrics.pendingBlocks = blockStatus.activeBlocks;
+        metrics.completedBlocks = blockStatus.completedBlocks;
+        metrics.nextBlockToGenerate = blockStatus.nextBlockToGenerate;
+    }
+    return metrics;
+}
+
+void ThreadManager::mergeTopResults(VoynichDecoder& decoder) {
+    // Called on the decoder's own thread, so its set is not being written concurrently
+    TopResults& local = decoder.getTopResults();
+    if (!local.takeChanged()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(topResultsMutex);
+    mergedTopResults.merge(local);
+}
+
+std::function<void()> ThreadManager::resumeTopResults(bool resumed, const std::string& path) {
+    if (config.topResultsCount == 0) {
+        return nullptr;
+    }
+    
+    // A resumed search continues the saved best list; a fresh one starts empty
+    if (resumed && mergedTopResults.loadFromFile(path)) {
+        std::wcout << L"Top results: resumed " << mergedTopResults.size() << L" saved mappings" << std::endl;
+    }
+    return [this]() { saveTopResults(); };
+}
+
+bool ThreadManager::saveTopResults() const {
+    std::lock_guard<std::mutex> lock(topResultsMutex);
+    return mergedTopResults.saveToFile(getTopResultsFile());
+}
+
+const std::string& ThreadManager::getTopResultsFile() const {
+    // Prefix- and local-search entries are keyed by permutation hash, not generator index
+    if (prefixSearch) {
+        return config.prefixTopResultsFile;
+    }
+    return localSearch ? config.localTopResultsFile : config.topResultsFile;
+}
+
+std::vector<TopResults::Entry> ThreadManager::getTopResults() const {
+    std::lock_guard<std::mutex> lock(topResultsMutex);
+    return mergedTopResults.getSorted();
+}
+
+void ThreadManager::printTopResults(size_t count) const {
+    auto entries = getTopResults();
+    if (entries.empty()) {
+        return;
+    }
+    
+    std::wcout << L"Top " << std::min(count, entries.size()) << L" of " << entries.size()
+               << L" best mappings (saved to " << getTopResultsFile().c_str() << L"):" << std::endl;
+    for (size_t i = 0; i < entries.size() && i < count; ++i) {
+        std::wcout << L"  " << (i + 1) << L". Score " << std::fixed << std::setprecision(2) << entries[i].score
+                   << L" (" << entries[i].matchedWords << L"/" << entries[i].totalWords << L"), mapping "
+                   << entries[i].mappingIndex << std::endl;
+    }
+}
+
 void ThreadManager::updateScoreThreshold(double newThreshold) {
     config.scoreThreshold = newThreshold;
     if (statsProvider) {
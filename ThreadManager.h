@@ -3,10 +3,19 @@
 #include "VoynichDecoder.h"
 #include "StatsProvider.h"
 #include "MappingGenerator.h"
+#include "WorkStealingScheduler.h"
+#include "PrefixSearch.h"
+#include "LocalSearch.h"
+#include "ClusterClient.h"
+#include "MetricsExporter.h"
+#include "NumaTopology.h"
+#include "Profiler.h"
 #include <vector>
 #include <thread>
 #include <atomic>
 #include <memory>
+#include <map>
+#include <functional>
 #include <csignal>
 #ifdef _WIN32
 #include <windows.h>
@@ -14,46 +23,160 @@
 
 class ThreadManager {
 public:
+    // How the mappings to score are chosen
+    enum class SearchEngine {
+        FLAT,     // Every mapping, in MappingGenerator blocks split by the work-stealing scheduler
+        PREFIX,   // Branch and bound over partial mappings (PrefixSearch), subtree roots as work units
+        LOCAL     // Annealed swap moves, one LocalSearch chain per worker (finds good mappings, proves nothing)
+    };
+    
+    // Where worker threads may run
+    enum class ThreadAffinity {
+        NONE,       // Threads float; the OS scheduler places them
+        CORE,       // Each worker pinned to one CPU, CPUs taken alternately from each NUMA node
+        NUMA_NODE   // Each worker pinned to all CPUs of its NUMA node (nodes taken alternately)
+    };
+    
     // Configuration for the thread manager
     struct ThreadManagerConfig {
         size_t numThreads;                    // Number of worker threads (0 = auto-detect)
         VoynichDecoder::TranslatorType translatorType;        // Type of translator implementation to use
+        HebrewValidator::LexiconBackend lexiconBackend;       // Lexicon storage used by each decoder
+        VoynichDecoder::EnumerationMode enumerationMode;      // How mappings within a block are enumerated
+        bool boundedScoring;                  // Drop mappings that can no longer be saved or kept (CPU, INDEXED)
+        TargetAlphabet targetAlphabet;        // Hebrew letters mappings are scored in (HEBREW_22: FLAT engine on CPU workers)
         std::string voynichWordsPath;         // Path to Voynich manuscript words
         std::string hebrewLexiconPath;        // Path to Hebrew lexicon
+        std::string lexiconImagePath;         // Prebuilt lexicon image, rebuilt when stale ("" = parse every start)
         std::string resultsFilePath;          // Path to save results
+        HebrewValidator::ResultFormat resultsFormat;          // TEXT, CSV or BINARY results file
         double scoreThreshold;                // Minimum score to save results
         size_t statusUpdateIntervalMs;        // How often to print status (milliseconds)
         size_t maxMappingsToProcess;          // Maximum mappings to process (0 = unlimited)
+        SearchEngine searchEngine;            // FLAT enumeration, PREFIX branch and bound or LOCAL search
         
         // MappingGenerator configuration
         size_t mappingBlockSize;              // Mappings per block in generator
         std::string generatorStateFile;       // Generator state persistence file
+        bool reduceSearchSpace;               // Enumerate only assignments of the EVA letters the corpus uses
+        
+        // PrefixSearch configuration (searchEngine = PREFIX, standalone only)
+        size_t prefixRootDepth;               // Letters fixed by each subtree root handed to a worker
+        std::string prefixStateFile;          // Completed subtrees, for resuming
+        std::string prefixTopResultsFile;     // Best mappings of the prefix search
+        
+        // LocalSearch configuration (searchEngine = LOCAL, standalone only)
+        uint64_t localMovesPerRound;          // Swap moves per chain between exchanges of the best mapping
+        double localInitialTemperature;       // Annealing start temperature in matched words (0 = hill climbing)
+        double localCoolingRate;              // Temperature factor per round
+        size_t localTargetMatched;            // Stop once a chain matches this many words (0 = run until stopped)
+        uint64_t localRandomSeed;             // 0 = a different run every time
+        std::string localSeedFile;            // Top results file whose mappings seed the chains ("" = random starts)
+        std::string localTopResultsFile;      // Best mappings of the local search
+        
+        // Best mappings, independent of scoreThreshold (merged across threads, saved with each checkpoint)
+        size_t topResultsCount;               // Mappings kept (0 = off)
+        std::string topResultsFile;           // Where the merged list is persisted
+        
+        // Work-stealing scheduler configuration
+        size_t schedulerChunkSize;            // Mappings per piece handed to a worker (initial size)
+        size_t minStealSize;                  // Smallest remaining range an idle worker splits
+        double targetPieceMs;                 // Resize each worker's pieces to its measured speed (0 = fixed)
+        
+        // Multi-GPU configuration (CUDA, AUTO and HYBRID translator types)
+        size_t gpuWorkersPerDevice;           // HYBRID: worker threads driving each CUDA device
+        
+        // NUMA placement (see NumaTopology); pinned workers steal from their own node first
+        ThreadAffinity threadAffinity;        // NONE, or pin workers per CPU or per node
+        bool numaReplicas;                    // Pinned workers probe a lexicon copy on their node (2+ nodes)
+        
+        // Cluster mode: lease blocks from a ClusterCoordinator instead of the local generator
+        std::string coordinatorAddress;       // "host:port" (empty = standalone)
+        std::string nodeName;                 // This node's name in the coordinator's logs and results
+        
+        // Machine-readable metrics (JSON-lines file or Prometheus endpoint, see MetricsExporter)
+        MetricsExporter::ExporterConfig metrics;
+        
+        // Per-stage timing of sampled mappings (builds with VOYNICH_PROFILING, see Profiler)
+        Profiler::ProfilerConfig profiler;
         
         ThreadManagerConfig() :
             numThreads(0),  // Auto-detect
             translatorType(VoynichDecoder::TranslatorType::AUTO),  // Auto-detect best implementation
+            lexiconBackend(HebrewValidator::LexiconBackend::HASH_SET),
+            enumerationMode(VoynichDecoder::EnumerationMode::INDEXED),
+            boundedScoring(false),
+            targetAlphabet(TargetAlphabet::HEBREW_27),
             voynichWordsPath("resources/Script_freq100.txt"),
             hebrewLexiconPath("resources/Tanah2.txt"),
+            lexiconImagePath(""),
             resultsFilePath("voynich_decoder_results.txt"),
+            resultsFormat(HebrewValidator::ResultFormat::TEXT),
             scoreThreshold(25.0),
             statusUpdateIntervalMs(5000),  // 5 seconds
             maxMappingsToProcess(0),  // Unlimited
+            searchEngine(SearchEngine::FLAT),
             mappingBlockSize(1000000),
-            generatorStateFile("mapping_generator_state.json") {}
+            generatorStateFile("mapping_generator_state.bin"),
+            reduceSearchSpace(false),
+            prefixRootDepth(3),
+            prefixStateFile("prefix_search_state.bin"),
+            prefixTopResultsFile("prefix_search_top.bin"),
+            localMovesPerRound(100000),
+            localInitialTemperature(2.0),
+            localCoolingRate(0.9),
+            localTargetMatched(0),
+            localRandomSeed(0),
+            localTopResultsFile("local_search_top.bin"),
+            topResultsCount(100),
+            topResultsFile("mapping_generator_top.bin"),
+            schedulerChunkSize(65536),
+            minStealSize(8192),
+            targetPieceMs(500.0),
+            gpuWorkersPerDevice(2),
+            threadAffinity(ThreadAffinity::NONE),
+            numaReplicas(true),
+            nodeName("node") {}
+    };
+    
+    // Translator and device chosen for one worker thread
+    struct WorkerAssignment {
+        VoynichDecoder::TranslatorType translatorType;
+        int cudaDevice;                       // -1 = CPU worker or runtime default device
+    };
+    
+    // NUMA node and CPUs one worker thread is pinned to
+    struct WorkerPlacement {
+        int numaNode;                         // Node id (-1 = not pinned)
+        std::vector<int> cpus;                // Empty = not pinned
     };
 
 private:
     ThreadManagerConfig config;
     
     // Core components
-    std::unique_ptr<MappingGenerator> mappingGenerator;
+    std::unique_ptr<MappingGenerator> mappingGenerator;  // Standalone block source
+    std::unique_ptr<ClusterClient> clusterClient;        // Cluster block source (coordinator address set)
+    std::unique_ptr<WorkStealingScheduler> scheduler;  // Splits generator blocks across workers
+    std::unique_ptr<PrefixSearch> prefixSearch;           // Subtree roots instead of blocks (PREFIX)
+    std::unique_ptr<LocalSearch> localSearch;             // Chains instead of blocks (LOCAL)
     std::unique_ptr<StatsProvider> statsProvider;
+    std::unique_ptr<MetricsExporter> metricsExporter;   // Only when config.metrics.mode is set
+    std::shared_ptr<const HebrewLexicon> sharedLexicon;  // Loaded once, referenced by every decoder
+    std::vector<WorkerAssignment> workerPlan;            // Translator/device per worker thread
+    std::vector<WorkerPlacement> placementPlan;          // NUMA node/CPUs per worker thread
+    std::map<int, std::shared_ptr<const HebrewLexicon>> nodeLexicons;  // Lexicon replica per NUMA node
+    
+    // Best mappings of all workers; each worker merges its decoder's set after every piece
+    mutable std::mutex topResultsMutex;
+    TopResults mergedTopResults;
     
     // Threading
     std::vector<std::thread> workerThreads;
     std::vector<std::unique_ptr<VoynichDecoder>> decoders;  // One decoder per thread
     std::atomic<bool> shouldStop{false};
     std::atomic<bool> isRunning{false};
+    std::atomic<size_t> activeWorkers{0};  // Workers that have not yet run out of work
     
     // Signal handling
     static std::atomic<bool> signalReceived;
@@ -67,9 +190,18 @@ private:
     void workerThreadFunction(int threadId);
     
     // Utilities
-    size_t getOptimalThreadCount() const;
+    size_t getOptimalThreadCount(const NumaTopology& topology) const;
+    void replicateLexicon(const NumaTopology& topology);
     void setupSignalHandling();
     void cleanupSignalHandling();
+    void printDeviceThroughput() const;
+    void mergeTopResults(VoynichDecoder& decoder);
+    // Load a resumed search's saved best list from path; returns the checkpoint listener that
+    // saves the list (empty when top results are off)
+    std::function<void()> resumeTopResults(bool resumed, const std::string& path);
+    bool saveTopResults() const;
+    const std::string& getTopResultsFile() const;
+    void printTopResults(size_t count) const;
     
 public:
     explicit ThreadManager(const ThreadManagerConfig& config = ThreadManagerConfig());
@@ -85,10 +217,29 @@ public:
     bool isManagerRunning() const { return isRunning.load(); }
     StatsProvider::StatsSnapshot getCurrentStats() const;
     
+    // Sample of the stats counters, decoders, generator window and GPU timings (any thread)
+    MetricsExporter::Metrics collectMetrics() const;
+    
+    // Best mappings merged so far, best first
+    std::vector<TopResults::Entry> getTopResults() const;
+    
     // Configuration access
     const ThreadManagerConfig& getConfig() const { return config; }
     void updateScoreThreshold(double newThreshold);
     
     // Convenience method for complete run
     void runDecoding();
+    
+    // Assign workers to devices: CUDA and AUTO spread every worker round-robin over all
+    // devices, HYBRID drives each device with gpuWorkersPerDevice workers and runs the rest
+    // as SIMD CPU workers. Blocks are then balanced by the work-stealing scheduler, whose
+    // piece sizes follow each worker's measured throughput.
+    static std::vector<WorkerAssignment> planWorkers(size_t numThreads, VoynichDecoder::TranslatorType translatorType,
+                                                     int cudaDeviceCount, size_t gpuWorkersPerDevice);
+    
+    // Place workers on the topology's CPUs, interleaving the nodes so any thread count is
+    // spread evenly over them (more threads than CPUs wrap around). NONE leaves every worker
+    // unpinned.
+    static std::vector<WorkerPlacement> planPlacement(size_t numThreads, const NumaTopology& topology,
+                                                      ThreadAffinity affinity);
 };
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include "TopResults.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+    const char FILE_MAGIC[4] = { 'V', 'D', 'T', 'K' };
+    const size_t HEADER_SIZE = 16;
+    const size_t ENTRY_SIZE = 24 + Word::ALPHABET_SIZE;
+    
+    // Lower score = higher priority, so std heap functions keep the weakest entry on top
+    bool strongerThan(const TopResults::Entry& a, const TopResults::Entry& b) {
+        return a.score > b.score;
+    }
+    
+    template <typename T>
+    void appendInteger(std::string& out, T value) {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            out.push_back(static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+        }
+    }
+    
+    template <typename T>
+    T readInteger(const unsigned char* bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        }
+        return static_cast<T>(value);
+    }
+}
+
+TopResults::TopResults(size_t capacity) : capacity(capacity), changed(false) {
+    heap.reserve(capacity);
+    updateAdmissionScore();
+}
+
+void TopResults::updateAdmissionScore() {
+    if (capacity == 0) {
+        admissionScore = std::numeric_limits<double>::infinity();
+    } else if (heap.size() < capacity) {
+        admissionScore = -std::numeric_limits<double>::infinity();
+    } else {
+        admissionScore = heap.front().score;
+    }
+}
+
+bool TopResults::offer(const Entry& entry) {
+    if (!(entry.score > admissionScore)) {
+        return false;
+    }
+    
+    // A rescored mapping (block reassigned after a stop) keeps a single entry
+    for (const auto& existing : heap) {
+        if (existing.mappingIndex == entry.mappingIndex) {
+            return false;
+        }
+    }
+    
+    if (heap.size() >= capacity) {
+        std::pop_heap(heap.begin(), heap.end(), strongerThan);
+        heap.back() = entry;
+    } else {
+        heap.push_back(entry);
+    }
+    std::push_heap(heap.begin(), heap.end(), strongerThan);
+    
+    updateAdmissionScore();
+    changed = true;
+    return true;
+}
+
+void TopResults::merge(const TopResults& other) {
+    for (const auto& entry : other.heap) {
+        offer(entry);
+    }
+}
+
+std::vector<TopResults::Entry> TopResults::getSorted() const {
+    std::vector<Entry> sorted = heap;
+    std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+        return a.score != b.score ? a.score > b.score : a.mappingIndex < b.mappingIndex;
+    });
+    return sorted;
+}
+
+bool TopResults::takeChanged() {
+    bool wasChanged = changed;
+    changed = false;
+    return wasChanged;
+}
+
+void TopResults::clear() {
+    heap.clear();
+    changed = false;
+    updateAdmissionScore();
+}
+
+bool TopResults::saveToFile(const std::string& filePath) const {
+    std::string contents(FILE_MAGIC, sizeof(FILE_MAGIC));
+    appendInteger(contents, FILE_FORMAT_VERSION);
+    appendInteger(contents, static_cast<uint64_t>(heap.size()));
+    for (const auto& entry : getSorted()) {
+        uint64_t scoreBits;
+        std::memcpy(&scoreBits, &entry.score, sizeof(scoreBits));
+        appendInteger(contents, scoreBits);
+        appendInteger(contents, entry.mappingIndex);
+        appendInteger(contents, entry.matchedWords);
+        appendInteger(contents, entry.totalWords);
+        contents.append(reinterpret_cast<const char*>(entry.permutation.data()), entry.permutation.size());
+    }
+    
+    std::string tempPath = filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        file.flush();
+        if (!file) {
+            file.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(tempPath, filePath, error);
+    if (error) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TopResults::loadFromFile(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+        readInteger<uint32_t>(bytes.data() + 4) != FILE_FORMAT_VERSION) {
+        return false;
+    }
+    uint64_t count = readInteger<uint64_t>(bytes.data() + 8);
+    if (count > (bytes.size() - HEADER_SIZE) / ENTRY_SIZE) {
+        return false;
+    }
+    
+    for (uint64_t i = 0; i < count; i++) {
+        const unsigned char* data = bytes.data() + HEADER_SIZE + i * ENTRY_SIZE;
+        Entry entry;
+        uint64_t scoreBits = readInteger<uint64_t>(data);
+        std::memcpy(&entry.score, &scoreBits, sizeof(scoreBits));
+        entry.mappingIndex = readInteger<uint64_t>(data + 8);
+        entry.matchedWords = readInteger<uint32_t>(data + 16);
+        entry.totalWords = readInteger<uint32_t>(data + 20);
+        std::memcpy(entry.permutation.data(), data + 24, entry.permutation.size());
+        offer(entry);
+    }
+    return true;
+}
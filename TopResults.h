@@ -0,0 +1,63 @@
+#pragma once
+
+#include "PermutationTranslator.h"
+#include <vector>
+#include <string>
+#include <limits>
+#include <cstdint>
+
+// Bounded set of the best-scoring mappings, kept as a min-heap so the weakest entry is the one
+// replaced. Each decoder fills its own instance on its worker thread (one compare per mapping
+// against getAdmissionScore()); ThreadManager merges them under its own lock and persists the
+// merged list with the generator checkpoint, so the best mappings survive without a score
+// threshold chosen up front and without disk I/O in the hot path.
+class TopResults {
+public:
+    struct Entry {
+        double score;
+        uint64_t mappingIndex;       // Generator index (reproduces the mapping on its own)
+        uint32_t matchedWords;
+        uint32_t totalWords;
+        Permutation permutation;     // Hebrew letter for each EVA letter
+    };
+    
+    // File layout: "VDTK" | u32 version | u64 count | count x (f64 score | u64 mappingIndex |
+    //   u32 matchedWords | u32 totalWords | 27 x u8 permutation), little-endian
+    static constexpr uint32_t FILE_FORMAT_VERSION = 1;
+
+private:
+    size_t capacity;
+    std::vector<Entry> heap;         // Min-heap on score; heap.front() is the weakest kept entry
+    double admissionScore;           // Score a new entry must exceed (-inf until full)
+    bool changed;                    // Entries added since the last takeChanged()
+    
+    void updateAdmissionScore();
+
+public:
+    explicit TopResults(size_t capacity = 0);
+    
+    // Hot-path filter: offer() can only succeed for scores above this
+    double getAdmissionScore() const { return admissionScore; }
+    
+    // Keep the entry if it is among the best seen; a mapping already present is not added twice
+    bool offer(const Entry& entry);
+    
+    // Offer every entry of another set (merging per-thread sets into one)
+    void merge(const TopResults& other);
+    
+    // Entries from best to worst
+    std::vector<Entry> getSorted() const;
+    
+    // True once after entries were added (lets owners skip merging unchanged sets)
+    bool takeChanged();
+    
+    size_t size() const { return heap.size(); }
+    size_t getCapacity() const { return capacity; }
+    bool empty() const { return heap.empty(); }
+    void clear();
+    
+    // Persist to / restore from a file; saving writes a temporary file and renames it over the
+    // previous one. Loading offers the saved entries (the capacity stays this instance's own).
+    bool saveToFile(const std::string& filePath) const;
+    bool loadFromFile(const std::string& filePath);
+};
@@ -1,11 +1,17 @@
 #include "VoynichDecoder.h"
 #include "WordSet.h"
+#include "Profiler.h"
 #include <iostream>
 #include <iomanip>
 #include <thread>
 #include <algorithm>
+#include <numeric>
+#include <limits>
 
-VoynichDecoder::VoynichDecoder(const DecoderConfig& config) : config(config), nextMappingId(0), useCudaTranslation(false) {
+VoynichDecoder::VoynichDecoder(const DecoderConfig& config)
+    : config(config), nextMappingId(0), useCudaTranslation(false),
+      kernels(ScoringKernels::select(config.targetAlphabet, Word::FULL_MASK, 0)), topResults(config.topResultsCount),
+      minMatchedForHighScore(0), boundAdmissionScore(-std::numeric_limits<double>::infinity()), boundAdmissionMatched(0) {
 }
 
 bool VoynichDecoder::initialize() {
@@ -15,57 +21,297 @@ bool VoynichDecoder::initialize() {
         return false;
     }
     
-    std::wcout << L"Loaded " << voynichWords.size() << L" Voynich words" << std::endl;
+    // Words with the same letter set are translated and probed once, weighted by their count
+    voynichMaskTable = voynichWords.buildMaskTable();
+    std::wcout << L"Loaded " << voynichWords.size() << L" Voynich words (" << voynichMaskTable.masks.size()
+               << L" distinct letter sets)" << std::endl;
+    
+    // Bounded scoring drops a mapping sooner the more words its first chunks decide
+    if (config.boundedScoring) {
+        std::vector<size_t> order(voynichMaskTable.masks.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return voynichMaskTable.weights[a] > voynichMaskTable.weights[b];
+        });
+        
+        WordSet::MaskTable ordered;
+        size_t remainingWords = voynichWords.size();
+        for (size_t i = 0; i < order.size(); ++i) {
+            ordered.masks.push_back(voynichMaskTable.masks[order[i]]);
+            ordered.weights.push_back(voynichMaskTable.weights[order[i]]);
+            remainingWords -= ordered.weights.back();
+            if ((i + 1) % BOUND_CHUNK_MASKS == 0 || i + 1 == order.size()) {
+                remainingWordsAfterChunk.push_back(remainingWords);
+            }
+        }
+        voynichMaskTable = std::move(ordered);
+    }
+    
+    // The corpus fixes the letters, nibbles and mask count for the whole run
+    uint32_t letterUnion = 0;
+    for (uint32_t mask : voynichMaskTable.masks) {
+        letterUnion |= mask;
+    }
+    kernels = ScoringKernels::select(config.targetAlphabet, letterUnion, voynichMaskTable.masks.size());
+    std::wcout << L"Scoring kernels: " << ScoringKernels::describe(kernels).c_str() << std::endl;
+    
+    // Device kernels and swap rescoring translate into the 27 letters only
+    if (config.targetAlphabet != TargetAlphabet::HEBREW_27) {
+        if (config.translatorType == TranslatorType::CUDA) {
+            throw std::runtime_error("CUDA translation supports the HEBREW_27 target only");
+        }
+        if (config.translatorType == TranslatorType::AUTO || config.translatorType == TranslatorType::HYBRID) {
+            std::wcout << L"Target alphabet " << ScoringKernels::getTargetAlphabetName(config.targetAlphabet).c_str()
+                       << L" is scored on the CPU, using the SIMD translator" << std::endl;
+            config.translatorType = TranslatorType::SIMD;
+        }
+        if (config.enumerationMode == EnumerationMode::ADJACENT_SWAP) {
+            std::wcout << L"Adjacent-swap enumeration supports the HEBREW_27 target only, using indexed enumeration" << std::endl;
+            config.enumerationMode = EnumerationMode::INDEXED;
+        }
+    }
     
     // Determine translator implementation
     useCudaTranslation = determineTranslatorImplementation(config.translatorType);
     
+    // Bind this thread to its device before any CUDA work (streams and buffers follow it)
+    if (useCudaTranslation && config.cudaDevice >= 0) {
+        StaticTranslator::selectCudaDevice(config.cudaDevice);
+    }
+    
+    std::string implementationName = useCudaTranslation ?
+        (config.cudaDevice >= 0 ? "CUDA (Static, device " + std::to_string(config.cudaDevice) + ")" : "CUDA (Static)") :
+        (config.translatorType == TranslatorType::PERMUTATION ? "CPU (Permutation Table)" :
+        (config.translatorType == TranslatorType::SIMD ? "CPU (SIMD " + StaticTranslator::getSimdLevelName(StaticTranslator::getSimdLevel()) + ")" :
+         "CPU (Static)"));
     std::wcout << L"Translator implementation: " << getTranslatorTypeName(config.translatorType).c_str() 
-               << L" (" << (useCudaTranslation ? "CUDA (Static)" : "CPU (Static)") << L")" << std::endl;
+               << L" (" << implementationName.c_str() << L")" << std::endl;
+    
+    translatedMasks.resize(voynichMaskTable.masks.size());
     
     // Initialize Hebrew validator
     HebrewValidator::ValidatorConfig validatorConfig;
     validatorConfig.hebrewLexiconPath = config.hebrewLexiconPath;
+    validatorConfig.lexiconImagePath = config.lexiconImagePath;
     validatorConfig.scoreThreshold = config.scoreThreshold;
     validatorConfig.resultsFilePath = config.resultsFilePath;
+    validatorConfig.resultsFormat = config.resultsFormat;
     validatorConfig.enableResultsSaving = true;
+    validatorConfig.lexiconBackend = config.lexiconBackend;
+    validatorConfig.targetAlphabet = config.targetAlphabet;
     
-    validator = std::make_unique<HebrewValidator>(validatorConfig);
+    validator = std::make_unique<HebrewValidator>(validatorConfig, config.lexicon);
     
     // Wait for Hebrew lexicon to load
     while (!validator->isLexiconReady()) {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
     
+    // A shared lexicon must have been folded for the same target
+    if (validator->getLexicon()->getTargetAlphabet() != config.targetAlphabet) {
+        std::wcerr << L"Lexicon target alphabet does not match the decoder's ("
+                   << ScoringKernels::getTargetAlphabetName(config.targetAlphabet).c_str() << L")" << std::endl;
+        return false;
+    }
+    
+    minMatchedForHighScore = validator->getMinMatchedForHighScore(voynichWords.size());
+    
+    // Swap enumeration walks the legacy ordering only; reduced spaces are enumerated by index
+    if (config.enumerationMode == EnumerationMode::ADJACENT_SWAP && !config.searchSpace.isFull()) {
+        std::wcout << L"Adjacent-swap enumeration needs the full search space, using indexed enumeration" << std::endl;
+        config.enumerationMode = EnumerationMode::INDEXED;
+    }
+    if (config.enumerationMode == EnumerationMode::ADJACENT_SWAP) {
+        incrementalScorer = std::make_unique<IncrementalScorer>(voynichMaskTable.masks, validator->getLexicon(), voynichMaskTable.weights);
+    }
+    
     return validator->isLexiconReady();
 }
 
 VoynichDecoder::ProcessingResult VoynichDecoder::processMapping(const WordSet& voynichWords, const Mapping& mapping, bool useCuda) {
+    if (useCuda && config.targetAlphabet == TargetAlphabet::HEBREW_27) {
+        // GPU path still goes through the matrix translator; score its packed masks directly
+        WordSet translatedWords = StaticTranslator::translateWordSet(voynichWords, mapping, true);
+        return scoreTranslatedMasks(translatedWords.maskData(), nullptr, translatedWords.size(), mapping);
+    }
+    
+    // Fused CPU path: translate packed masks into the reusable buffer, no Hebrew words built
+    StaticTranslator::translateMasks(voynichWords.getLetterMasks(), mapping, translatedMasks);
+    if (config.targetAlphabet == TargetAlphabet::HEBREW_22) {
+        for (uint32_t& mask : translatedMasks) {
+            mask = Word::foldFinalForms(mask);
+        }
+    }
+    return scoreTranslatedMasks(translatedMasks.data(), nullptr, translatedMasks.size(), mapping);
+}
+
+VoynichDecoder::ProcessingResult VoynichDecoder::processMapping(const Mapping& mapping) {
+    if (config.translatorType == TranslatorType::PERMUTATION || config.translatorType == TranslatorType::SIMD) {
+        return processMappingWithPermutationTable(mapping);
+    }
+    if (useCudaTranslation) {
+        return processMapping(voynichWords, mapping, true);
+    }
+    if (config.boundedScoring || config.targetAlphabet != TargetAlphabet::HEBREW_27) {
+        // Chunked scoring and folded targets work on lookup tables
+        return processMappingWithPermutationTable(mapping);
+    }
+    
+    // Own corpus: translate each distinct letter set once
+    {
+        PROFILE_SCOPE(Profiler::Stage::TRANSLATION);
+        StaticTranslator::translateMasks(voynichMaskTable.masks, mapping, translatedMasks);
+    }
+    return scoreTranslatedMasks(translatedMasks.data(), voynichMaskTable.weights.data(), translatedMasks.size(), mapping);
+}
+
+VoynichDecoder::ProcessingResult VoynichDecoder::processMappingWithPermutationTable(const Mapping& mapping) {
+    // Compile the mapping into lookup tables (on the stack) and translate the packed Voynich masks
+    PermutationTranslator::LookupTable table;
+    PermutationTranslator::buildLookupTable(mapping, table);
+    ScoringKernels::foldTable(config.targetAlphabet, table);
+    
     ProcessingResult result;
     result.mappingId = nextMappingId++;
     
-    // Translate Voynich words to Hebrew using static method
-    WordSet translatedWords = StaticTranslator::translateWordSet(voynichWords, mapping, useCuda);
+    auto validationResult = validateWithTable(table, result.wordsProbed);
+    if (validationResult.isHighScore) {
+        validator->recordHighScore(validationResult, result.mappingId, mapping);
+    }
     
-    // Serialize the mapping for saving
-    std::string mappingVisualization = mapping.serializeMappingVisualization();
-    std::vector<uint8_t> mappingData(mappingVisualization.begin(), mappingVisualization.end());
+    result.totalWords = validationResult.totalWords;
+    result.matchedWords = validationResult.matchedWords;
+    result.score = validationResult.score;
+    result.matchPercentage = validationResult.matchPercentage;
+    result.isHighScore = validationResult.isHighScore;
+    result.exitedEarly = result.wordsProbed < result.totalWords;
     
-    // Validate translation against Hebrew lexicon
-    auto validationResult = validator->validateTranslationWithMapping(translatedWords, result.mappingId, mappingData);
+    return result;
+}
+
+VoynichDecoder::ProcessingResult VoynichDecoder::processPermutation(const Permutation& permutation) {
+    // Permutations compile straight into lookup tables; a Mapping is only built for saved results
+    PermutationTranslator::LookupTable table;
+    {
+        PROFILE_SCOPE(Profiler::Stage::TRANSLATION);
+        kernels.buildTable(permutation, table);
+    }
+    
+    ProcessingResult result;
+    result.mappingId = nextMappingId++;
+    
+    auto validationResult = validateWithTable(table, result.wordsProbed);
+    if (validationResult.isHighScore) {
+        PROFILE_SCOPE(Profiler::Stage::BOOKKEEPING);
+        Mapping mapping;
+        PermutationTranslator::permutationToMapping(permutation, mapping);
+        validator->recordHighScore(validationResult, result.mappingId, mapping);
+    }
     
-    // Fill result structure
     result.totalWords = validationResult.totalWords;
     result.matchedWords = validationResult.matchedWords;
     result.score = validationResult.score;
     result.matchPercentage = validationResult.matchPercentage;
     result.isHighScore = validationResult.isHighScore;
+    result.exitedEarly = result.wordsProbed < result.totalWords;
     
     return result;
 }
 
-VoynichDecoder::ProcessingResult VoynichDecoder::processMapping(const Mapping& mapping) {
-    return processMapping(voynichWords, mapping, useCudaTranslation);
+void VoynichDecoder::translateWithTable(const PermutationTranslator::LookupTable& table) {
+    translatedMasks.resize(voynichMaskTable.masks.size());
+    if (config.translatorType == TranslatorType::SIMD) {
+        translateMaskRange(table, 0, translatedMasks.size());
+        return;
+    }
+    
+    // Whole corpus: the kernel compiled for its nibble count and mask bucket
+    PROFILE_SCOPE(Profiler::Stage::TRANSLATION);
+    kernels.translateCorpus(table, voynichMaskTable.masks.data(), translatedMasks.data(), translatedMasks.size());
+}
+
+void VoynichDecoder::translateMaskRange(const PermutationTranslator::LookupTable& table, size_t first, size_t count) {
+    const uint32_t* masks = voynichMaskTable.masks.data() + first;
+    uint32_t* hebrewMasks = translatedMasks.data() + first;
+    PROFILE_SCOPE(Profiler::Stage::TRANSLATION);
+    if (config.translatorType == TranslatorType::SIMD) {
+        // 8 or 16 words per iteration, kernel chosen for this CPU at runtime
+        StaticTranslator::translateMasksSimd(table, masks, hebrewMasks, count);
+    } else {
+        kernels.translateRange(table, masks, hebrewMasks, count);
+    }
+}
+
+HebrewValidator::ValidationResult VoynichDecoder::validateWithTable(const PermutationTranslator::LookupTable& table, size_t& wordsProbed) {
+    wordsProbed = voynichWords.size();
+    if (!config.boundedScoring || !validator->isLexiconReady()) {
+        translateWithTable(table);
+        PROFILE_SCOPE(Profiler::Stage::VALIDATION);
+        return validator->validateMasks(translatedMasks.data(), voynichMaskTable.weights.data(),
+                                        translatedMasks.size(), voynichWords.size());
+    }
+    
+    size_t count = voynichMaskTable.masks.size();
+    translatedMasks.resize(count);
+    size_t required = getBoundMatched();
+    const HebrewLexicon& lexicon = *validator->getLexicon();
+    size_t matched = 0;
+    for (size_t first = 0, chunk = 0; first < count; first += BOUND_CHUNK_MASKS, ++chunk) {
+        size_t chunkCount = std::min(BOUND_CHUNK_MASKS, count - first);
+        translateMaskRange(table, first, chunkCount);
+        PROFILE_SCOPE(Profiler::Stage::VALIDATION);
+        matched += lexicon.countMatches(translatedMasks.data() + first, voynichMaskTable.weights.data() + first, chunkCount);
+        
+        // Even if every remaining word matched, the mapping would be neither saved nor kept
+        if (matched + remainingWordsAfterChunk[chunk] < required) {
+            wordsProbed = voynichWords.size() - remainingWordsAfterChunk[chunk];
+            break;
+        }
+    }
+    return validator->buildResult(voynichWords.size(), matched);
+}
+
+size_t VoynichDecoder::getBoundMatched() {
+    if (topResults.getCapacity() == 0) {
+        return minMatchedForHighScore;
+    }
+    
+    // The admission score only moves when the top-K changes, so its inversion is cached
+    double admissionScore = topResults.getAdmissionScore();
+    if (admissionScore != boundAdmissionScore) {
+        boundAdmissionScore = admissionScore;
+        boundAdmissionMatched = validator->getMinMatchedAbove(voynichWords.size(), admissionScore);
+    }
+    return std::min(minMatchedForHighScore, boundAdmissionMatched);
+}
+
+VoynichDecoder::ProcessingResult VoynichDecoder::scoreTranslatedMasks(const uint32_t* hebrewMasks, const uint32_t* weights, size_t count, const Mapping& mapping) {
+    ProcessingResult result;
+    result.mappingId = nextMappingId++;
+    
+    // Validate translation against Hebrew lexicon
+    HebrewValidator::ValidationResult validationResult;
+    {
+        PROFILE_SCOPE(Profiler::Stage::VALIDATION);
+        validationResult = weights ? validator->validateMasks(hebrewMasks, weights, count, voynichWords.size())
+                                   : validator->validateMasks(hebrewMasks, count);
+    }
+    
+    // Mapping text is only built for results that are actually saved
+    if (validationResult.isHighScore) {
+        validator->recordHighScore(validationResult, result.mappingId, mapping);
+    }
+    
+    // Fill result structure
+    result.totalWords = validationResult.totalWords;
+    result.wordsProbed = validationResult.totalWords;
+    result.matchedWords = validationResult.matchedWords;
+    result.score = validationResult.score;
+    result.matchPercentage = validationResult.matchPercentage;
+    result.isHighScore = validationResult.isHighScore;
+    result.exitedEarly = result.wordsProbed < result.totalWords;
+    
+    return result;
 }
 
 void VoynichDecoder::processMappings(const std::vector<std::unique_ptr<Mapping>>& mappings, 
@@ -80,58 +326,101 @@ void VoynichDecoder::processMappingBlock(MappingGenerator& generator, int thread
                                        std::function<void(const ProcessingResult&)> resultCallback,
                                        std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
                                        std::function<bool()> shouldStopCallback) {
-    // Get next block of mappings
-    auto mappings = generator.getNextBlock(threadId);
-    if (mappings.empty()) {
+    // Claim the next block as a global index range - permutations are produced on demand
+    uint64_t startIndex = 0;
+    uint64_t endIndex = 0;
+    if (!generator.claimBlockRange(threadId, startIndex, endIndex)) {
         return;
     }
     
-    // Check for early termination before starting block processing
+    if (processMappingRange(startIndex, endIndex, threadId, resultCallback, batchStatsCallback, shouldStopCallback)) {
+        // Mark block as completed
+        generator.completeCurrentBlock(threadId);
+    }
+    // Otherwise return without completing the block - it should remain PENDING for reassignment
+}
+
+bool VoynichDecoder::processMappingRange(uint64_t startIndex, uint64_t endIndex, int threadId,
+                                         std::function<void(const ProcessingResult&)> resultCallback,
+                                         std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                                         std::function<bool()> shouldStopCallback) {
+    // Swap enumeration replaces per-mapping construction on the CPU
+    if (incrementalScorer && !useCudaTranslation) {
+        return processMappingRangeIncremental(startIndex, endIndex, threadId, resultCallback, batchStatsCallback, shouldStopCallback);
+    }
+    
+    MappingGenerator::BlockCursor cursor(startIndex, endIndex, config.searchSpace);
+    if (cursor.empty()) {
+        return true;
+    }
+    
+    // Check for early termination before starting range processing
     if (shouldStopCallback && shouldStopCallback()) {
-        // Return without completing the block - it should remain PENDING for reassignment
-        return;
+        return false;
     }
     
+    Permutation permutation;
+    uint64_t globalIndex = 0;
+    
     // Use batch processing for CUDA, single processing for CPU
-    if (useCudaTranslation && mappings.size() > 1) {
-        // Process in chunks to avoid GPU memory overflow
+    if (useCudaTranslation && cursor.size() > 1) {
+        // The device generates the permutations, so chunks are described by index alone.
+        // Chunks are pipelined: the GPU scores the next chunk while this thread reports one.
         const size_t CHUNK_SIZE = 10000; // Process 10K mappings at a time
-        for (size_t i = 0; i < mappings.size(); i += CHUNK_SIZE) {
-            if (shouldStopCallback && shouldStopCallback()) return;
-            
-            size_t endIdx = std::min(i + CHUNK_SIZE, mappings.size());
-            std::vector<std::unique_ptr<Mapping>> chunk;
-            chunk.reserve(endIdx - i);
-            
-            for (size_t j = i; j < endIdx; ++j) {
-                chunk.push_back(std::move(mappings[j]));
+        size_t numWords = voynichWords.size();
+        
+        // The score only grows with matches, so the device flags high scores by count alone
+        size_t minMatched = std::min<size_t>(validator->getMinMatchedForHighScore(numWords), UINT32_MAX);
+        
+        bool completed = StaticTranslator::scorePermutationRangePipelinedCuda(
+            voynichMaskTable.masks, voynichMaskTable.weights, cursor.startIndex(), cursor.size(), CHUNK_SIZE,
+            validator->getLexicon(), static_cast<uint32_t>(minMatched),
+            [&](uint64_t chunkStart, const uint32_t* matchedCounts, size_t count, const std::vector<uint32_t>& highScoreIndices) {
+                return consumeBatchScores(chunkStart, matchedCounts, count, highScoreIndices,
+                                          resultCallback, batchStatsCallback, threadId, shouldStopCallback);
+            }, config.searchSpace);
+        if (!completed) return false;
+        
+        // A stop request during the last batch leaves part of the range unscored
+        if (shouldStopCallback && shouldStopCallback()) return false;
+    } else {
+        // Process all mappings in the range one by one (CPU or single mapping)
+        for (;;) {
+            PROFILE_ITEM();
+            {
+                PROFILE_SCOPE(Profiler::Stage::GENERATION);
+                if (!cursor.next(permutation, globalIndex)) {
+                    break;
+                }
             }
             
-            processMappingsBatch(chunk, resultCallback, batchStatsCallback, threadId, shouldStopCallback);
-            
-            // Move the mappings back
-            for (size_t j = 0; j < chunk.size(); ++j) {
-                mappings[i + j] = std::move(chunk[j]);
-            }
-        }
-    } else {
-        // Process all mappings in the block one by one (CPU or single mapping)
-        for (auto& mapping : mappings) {
             // Check if we should stop processing on every mapping for immediate response
             if (shouldStopCallback && shouldStopCallback()) {
-                // Return without completing the block - it should remain PENDING for reassignment
-                return;
+                return false;
             }
             
-            auto result = processMapping(*mapping);
+            auto result = processPermutation(permutation);
             
-            // Update thread-local stats
-            threadStats.localMappingsProcessed++;
-            threadStats.localWordsValidated += result.totalWords;
+            PROFILE_SCOPE(Profiler::Stage::BOOKKEEPING);
+            result.mappingIndex = globalIndex;
+            if (result.isHighScore) {
+                result.hasPermutation = true;
+                result.permutation = permutation;
+            }
+            offerTopResult(result, globalIndex, &permutation);
             
-            if (result.score > threadStats.localHighestScore) {
-                threadStats.localHighestScore = result.score;
-                threadStats.hasHighScore = true;
+            // Update thread-local stats; a dropped mapping's partial count says nothing about its score
+            threadStats.localMappingsProcessed++;
+            threadStats.localWordsValidated += result.wordsProbed;
+            if (result.exitedEarly) {
+                threadStats.localMappingsExitedEarly++;
+                threadStats.localWordsPruned += result.wordsProbed;
+            } else {
+                threadStats.localWordsMatched += result.matchedWords;
+                if (result.score > threadStats.localHighestScore) {
+                    threadStats.localHighestScore = result.score;
+                    threadStats.hasHighScore = true;
+                }
             }
             
             // Report batch stats if needed (every 1 second)
@@ -141,72 +430,136 @@ void VoynichDecoder::processMappingBlock(MappingGenerator& generator, int thread
         }
     }
     
-    // Mark block as completed
-    generator.completeCurrentBlock(threadId);
+    return true;
 }
 
-void VoynichDecoder::processMappingsBatch(const std::vector<std::unique_ptr<Mapping>>& mappings,
-                                         std::function<void(const ProcessingResult&)> resultCallback,
-                                         std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
-                                         int threadId,
-                                         std::function<bool()> shouldStopCallback) {
-    if (mappings.empty()) return;
+bool VoynichDecoder::processMappingRangeIncremental(uint64_t startIndex, uint64_t endIndex, int threadId,
+                                                    std::function<void(const ProcessingResult&)> resultCallback,
+                                                    std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                                                    std::function<bool()> shouldStopCallback) {
+    if (startIndex >= endIndex) {
+        return true;
+    }
     
-    // Check for early termination
+    // Check for early termination before starting range processing
     if (shouldStopCallback && shouldStopCallback()) {
-        return;
+        return false;
     }
     
-    // Prepare batch data for CUDA processing
-    size_t numWords = voynichWords.size();
-    size_t numMappings = mappings.size();
-    
-    // Convert word set to input matrix (same for all mappings)
-    auto inputMatrix = StaticTranslator::wordSetToMatrix(voynichWords);
+    const size_t STOP_CHECK_INTERVAL = 1024;
+    SwapEnumerator enumerator(startIndex, endIndex);
+    SwapEnumerator::Step step;
+    incrementalScorer->reset(enumerator.current());
     
-    // Convert all mappings to transform matrices
-    std::vector<std::vector<std::vector<int>>> transformMatrices;
-    transformMatrices.reserve(numMappings);
-    
-    for (const auto& mapping : mappings) {
-        auto transformMatrix = mapping->getMappingMatrix();
-        transformMatrices.push_back(transformMatrix);
-    }
+    uint64_t processed = 0;
+    bool more = true;
+    do {
+        PROFILE_ITEM();
+        if (processed > 0) {
+            // The scorer retranslates and reprobes only the words a swap touches, in one pass
+            PROFILE_SCOPE(Profiler::Stage::VALIDATION);
+            if (step.reset) {
+                incrementalScorer->reset(enumerator.current());
+            } else {
+                for (int i = 0; i < step.swapCount; ++i) {
+                    incrementalScorer->applySwap(step.first[i], step.second[i]);
+                }
+            }
+        }
+        processed++;
+        
+        {
+            PROFILE_SCOPE(Profiler::Stage::BOOKKEEPING);
+            ProcessingResult result;
+            auto validationResult = validator->buildResult(incrementalScorer->getTotalWords(), incrementalScorer->getMatchedWords());
+            result.mappingIndex = enumerator.currentIndex();
+            if (validationResult.isHighScore) {
+                result.mappingId = enumerator.currentIndex();
+                result.hasPermutation = true;
+                result.permutation = enumerator.current();
+                Mapping mapping;
+                PermutationTranslator::permutationToMapping(enumerator.current(), mapping);
+                validator->recordHighScore(validationResult, result.mappingId, mapping);
+            }
+        
+            result.totalWords = validationResult.totalWords;
+            result.matchedWords = validationResult.matchedWords;
+            result.score = validationResult.score;
+            result.matchPercentage = validationResult.matchPercentage;
+            result.isHighScore = validationResult.isHighScore;
+            offerTopResult(result, enumerator.currentIndex(), &enumerator.current());
+            
+            // Update thread-local stats
+            threadStats.localMappingsProcessed++;
+            threadStats.localWordsValidated += result.totalWords;
+            threadStats.localWordsMatched += result.matchedWords;
+            
+            if (result.score > threadStats.localHighestScore) {
+                threadStats.localHighestScore = result.score;
+                threadStats.hasHighScore = true;
+            }
+        
+            resultCallback(result);
+            
+            // Stop checks and stats reporting are amortized over several mappings
+            if (processed % STOP_CHECK_INTERVAL == 0) {
+                if (shouldStopCallback && shouldStopCallback()) {
+                    return false;
+                }
+                reportBatchStatsIfNeeded(batchStatsCallback, threadId);
+            }
+        }
+        
+        PROFILE_SCOPE(Profiler::Stage::GENERATION);
+        more = enumerator.advance(step);
+    } while (more);
     
-    // Perform batch CUDA matrix multiplication
-    std::vector<std::vector<std::vector<int>>> resultMatrices;
-    StaticTranslator::performBatchMatrixMultiplicationCuda(inputMatrix, transformMatrices, resultMatrices);
+    reportBatchStatsIfNeeded(batchStatsCallback, threadId);
+    return true;
+}
+
+bool VoynichDecoder::consumeBatchScores(uint64_t startIndex, const uint32_t* matchedCounts, size_t count,
+                                        const std::vector<uint32_t>& highScoreIndices,
+                                        std::function<void(const ProcessingResult&)> resultCallback,
+                                        std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                                        int threadId,
+                                        std::function<bool()> shouldStopCallback) {
+    size_t numWords = voynichWords.size();
     
     // Process results for each mapping
-    for (size_t i = 0; i < mappings.size(); ++i) {
-        if (shouldStopCallback && shouldStopCallback()) return;
-        
-        // Convert result matrix back to WordSet
-        WordSet translatedWords = StaticTranslator::matrixToWordSet(
-            resultMatrices[i], voynichWords, Alphabet::HEBREW
-        );
+    size_t nextHighScore = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (shouldStopCallback && shouldStopCallback()) return false;
         
-        // Create ProcessingResult
+        // The device generated, translated and scored the chunk; only bookkeeping is left here
+        PROFILE_ITEM();
+        PROFILE_SCOPE(Profiler::Stage::BOOKKEEPING);
         ProcessingResult result;
         result.mappingId = nextMappingId++;
+        result.mappingIndex = startIndex + i;
         
-        // Serialize the mapping for saving
-        std::string mappingVisualization = mappings[i]->serializeMappingVisualization();
-        std::vector<uint8_t> mappingData(mappingVisualization.begin(), mappingVisualization.end());
-        
-        // Validate translation against Hebrew lexicon
-        auto validationResult = validator->validateTranslationWithMapping(translatedWords, result.mappingId, mappingData);
+        auto validationResult = validator->buildResult(numWords, matchedCounts[i]);
+        if (nextHighScore < highScoreIndices.size() && highScoreIndices[nextHighScore] == i) {
+            // Mapping text is only built for results that are actually saved
+            nextHighScore++;
+            result.hasPermutation = true;
+            config.searchSpace.unrank(startIndex + i, result.permutation);
+            Mapping mapping;
+            PermutationTranslator::permutationToMapping(result.permutation, mapping);
+            validator->recordHighScore(validationResult, result.mappingId, mapping);
+        }
         
-        // Fill result structure
         result.totalWords = validationResult.totalWords;
         result.matchedWords = validationResult.matchedWords;
         result.score = validationResult.score;
         result.matchPercentage = validationResult.matchPercentage;
         result.isHighScore = validationResult.isHighScore;
+        offerTopResult(result, startIndex + i, nullptr);
         
         // Update thread-local stats
         threadStats.localMappingsProcessed++;
         threadStats.localWordsValidated += result.totalWords;
+        threadStats.localWordsMatched += result.matchedWords;
         
         if (result.score > threadStats.localHighestScore) {
             threadStats.localHighestScore = result.score;
@@ -218,6 +571,116 @@ void VoynichDecoder::processMappingsBatch(const std::vector<std::unique_ptr<Mapp
         
         resultCallback(result);
     }
+    
+    return true;
+}
+
+void VoynichDecoder::addTopResult(const ProcessingResult& result, uint64_t globalIndex, const Permutation* permutation) {
+    TopResults::Entry entry;
+    entry.score = result.score;
+    entry.mappingIndex = globalIndex;
+    entry.matchedWords = static_cast<uint32_t>(result.matchedWords);
+    entry.totalWords = static_cast<uint32_t>(result.totalWords);
+    if (permutation) {
+        entry.permutation = *permutation;
+    } else {
+        config.searchSpace.unrank(globalIndex, entry.permutation);
+    }
+    topResults.offer(entry);
+}
+
+bool VoynichDecoder::processPrefixSubtree(const PrefixSearch& search, uint64_t root, int threadId,
+                                          std::function<void(const ProcessingResult&)> resultCallback,
+                                          std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                                          std::function<bool()> shouldStopCallback,
+                                          PrefixSearch::SubtreeStats& stats) {
+    // The bound follows this decoder's top results, so it tightens as good leaves are found
+    PrefixSearch::BoundFunction requiredMatched = [this]() { return getBoundMatched(); };
+    PrefixSearch::LeafCallback onLeaf = [&](const Permutation& permutation, size_t matched) {
+        // The search scored the leaf while expanding it; only bookkeeping is timed per leaf
+        PROFILE_ITEM();
+        PROFILE_SCOPE(Profiler::Stage::BOOKKEEPING);
+        auto validationResult = validator->buildResult(voynichWords.size(), matched);
+        
+        ProcessingResult result;
+        result.mappingId = PrefixSearch::leafKey(permutation);
+        result.mappingIndex = result.mappingId;
+        result.totalWords = validationResult.totalWords;
+        result.matchedWords = validationResult.matchedWords;
+        result.score = validationResult.score;
+        result.matchPercentage = validationResult.matchPercentage;
+        result.isHighScore = validationResult.isHighScore;
+        
+        if (result.isHighScore) {
+            result.hasPermutation = true;
+            result.permutation = permutation;
+            Mapping mapping;
+            PermutationTranslator::permutationToMapping(permutation, mapping);
+            validator->recordHighScore(validationResult, result.mappingId, mapping);
+        }
+        offerTopResult(result, result.mappingId, &permutation);
+        
+        // Update thread-local stats
+        threadStats.localMappingsProcessed++;
+        threadStats.localWordsValidated += result.totalWords;
+        threadStats.localWordsMatched += result.matchedWords;
+        
+        if (result.score > threadStats.localHighestScore) {
+            threadStats.localHighestScore = result.score;
+            threadStats.hasHighScore = true;
+        }
+        
+        reportBatchStatsIfNeeded(batchStatsCallback, threadId);
+        resultCallback(result);
+        return true;
+    };
+    
+    bool completed = search.searchSubtree(root, requiredMatched, onLeaf, shouldStopCallback, stats);
+    reportBatchStatsIfNeeded(batchStatsCallback, threadId);
+    return completed;
+}
+
+bool VoynichDecoder::processLocalSearchRound(LocalSearch& search, LocalSearch::Chain& chain, int threadId,
+                                             std::function<void(const ProcessingResult&)> resultCallback,
+                                             std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                                             std::function<bool()> shouldStopCallback) {
+    LocalSearch::ImprovementCallback onImprovement = [&](const Permutation& permutation, size_t matched) {
+        auto validationResult = validator->buildResult(voynichWords.size(), matched);
+        
+        ProcessingResult result;
+        result.mappingId = PrefixSearch::leafKey(permutation);
+        result.mappingIndex = result.mappingId;
+        result.totalWords = validationResult.totalWords;
+        result.matchedWords = validationResult.matchedWords;
+        result.score = validationResult.score;
+        result.matchPercentage = validationResult.matchPercentage;
+        result.isHighScore = validationResult.isHighScore;
+        
+        if (result.isHighScore) {
+            result.hasPermutation = true;
+            result.permutation = permutation;
+            Mapping mapping;
+            PermutationTranslator::permutationToMapping(permutation, mapping);
+            validator->recordHighScore(validationResult, result.mappingId, mapping);
+        }
+        offerTopResult(result, result.mappingId, &permutation);
+        
+        if (result.score > threadStats.localHighestScore) {
+            threadStats.localHighestScore = result.score;
+            threadStats.hasHighScore = true;
+        }
+        resultCallback(result);
+    };
+    
+    LocalSearch::RoundStats roundStats;
+    bool keepGoing = search.runRound(chain, onImprovement, shouldStopCallback, roundStats);
+    
+    // Every evaluated move is a scored mapping, but only the words it changed were looked up
+    threadStats.localMappingsProcessed += roundStats.movesEvaluated;
+    threadStats.localWordsValidated += roundStats.wordsProbed;
+    threadStats.localWordsMatched += roundStats.wordsProbedMatched;
+    reportBatchStatsIfNeeded(batchStatsCallback, threadId);
+    return keepGoing;
 }
 
 void VoynichDecoder::reportBatchStatsIfNeeded(std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback, int threadId, bool force) {
@@ -230,9 +693,14 @@ void VoynichDecoder::reportBatchStatsIfNeeded(std::function<void(int, uint64_t,
             batchStatsCallback(threadId, threadStats.localMappingsProcessed, threadStats.localWordsValidated, 
                              threadStats.localHighestScore, threadStats.hasHighScore);
             
+            publishMetrics();
+            
             // Reset thread-local counters
             threadStats.localMappingsProcessed = 0;
             threadStats.localWordsValidated = 0;
+            threadStats.localWordsMatched = 0;
+            threadStats.localMappingsExitedEarly = 0;
+            threadStats.localWordsPruned = 0;
             threadStats.localHighestScore = 0.0;
             threadStats.hasHighScore = false;
             threadStats.lastReportTime = now;
@@ -240,6 +708,37 @@ void VoynichDecoder::reportBatchStatsIfNeeded(std::function<void(int, uint64_t,
     }
 }
 
+void VoynichDecoder::publishMetrics() {
+    // Words per second count every lookup; the probe and hit counters only fully scored mappings
+    publishedWordsProbed.store(publishedWordsProbed.load(std::memory_order_relaxed) + threadStats.localWordsValidated - threadStats.localWordsPruned,
+                               std::memory_order_relaxed);
+    publishedWordsMatched.store(publishedWordsMatched.load(std::memory_order_relaxed) + threadStats.localWordsMatched,
+                                std::memory_order_relaxed);
+    publishedMappingsExitedEarly.store(publishedMappingsExitedEarly.load(std::memory_order_relaxed) + threadStats.localMappingsExitedEarly,
+                                       std::memory_order_relaxed);
+    publishedWordsPruned.store(publishedWordsPruned.load(std::memory_order_relaxed) + threadStats.localWordsPruned,
+                               std::memory_order_relaxed);
+    if (useCudaTranslation) {
+        // The timings are per thread and cumulative; this decoder is the thread's only CUDA user
+        auto timings = StaticTranslator::getCudaTimings();
+        publishedGpuChunks.store(timings.chunksScored, std::memory_order_relaxed);
+        publishedGpuKernelMs.store(timings.kernelMs, std::memory_order_relaxed);
+        publishedGpuTransferMs.store(timings.transferMs, std::memory_order_relaxed);
+    }
+}
+
+VoynichDecoder::DecoderMetrics VoynichDecoder::getMetrics() const {
+    DecoderMetrics metrics;
+    metrics.wordsProbed = publishedWordsProbed.load(std::memory_order_relaxed);
+    metrics.wordsMatched = publishedWordsMatched.load(std::memory_order_relaxed);
+    metrics.mappingsExitedEarly = publishedMappingsExitedEarly.load(std::memory_order_relaxed);
+    metrics.wordsPruned = publishedWordsPruned.load(std::memory_order_relaxed);
+    metrics.gpuChunksScored = publishedGpuChunks.load(std::memory_order_relaxed);
+    metrics.gpuKernelMs = publishedGpuKernelMs.load(std::memory_order_relaxed);
+    metrics.gpuTransferMs = publishedGpuTransferMs.load(std::memory_order_relaxed);
+    return metrics;
+}
+
 bool VoynichDecoder::loadVoynichWords() {
     voynichWords.readFromFile(config.voynichWordsPath, Alphabet::EVA);
     return voynichWords.size() > 0;
@@ -248,6 +747,8 @@ bool VoynichDecoder::loadVoynichWords() {
 bool VoynichDecoder::determineTranslatorImplementation(TranslatorType type) {
     switch (type) {
         case TranslatorType::CPU:
+        case TranslatorType::PERMUTATION:
+        case TranslatorType::SIMD:
             return false;  // Use CPU
             
         case TranslatorType::CUDA:
@@ -258,7 +759,9 @@ bool VoynichDecoder::determineTranslatorImplementation(TranslatorType type) {
             return true;  // Use CUDA
             
         case TranslatorType::AUTO:
-            // Auto-select: prefer CUDA if available, otherwise CPU
+        case TranslatorType::HYBRID:
+            // Auto-select: prefer CUDA if available, otherwise CPU (ThreadManager splits HYBRID
+            // into CUDA and SIMD decoders, so a decoder only sees it when used on its own)
             return StaticTranslator::isCudaAvailable();
             
         default:
@@ -274,6 +777,12 @@ std::string VoynichDecoder::getTranslatorTypeName(TranslatorType type) const {
             return "CUDA";
         case TranslatorType::AUTO:
             return StaticTranslator::isCudaAvailable() ? "AUTO (CUDA)" : "AUTO (CPU)";
+        case TranslatorType::PERMUTATION:
+            return "PERMUTATION";
+        case TranslatorType::SIMD:
+            return "SIMD";
+        case TranslatorType::HYBRID:
+            return "HYBRID";
         default:
             return "Unknown";
     }
@@ -283,5 +792,6 @@ void VoynichDecoder::updateScoreThreshold(double newThreshold) {
     config.scoreThreshold = newThreshold;
     if (validator) {
         validator->updateScoreThreshold(newThreshold);
+        minMatchedForHighScore = validator->getMinMatchedForHighScore(voynichWords.size());
     }
 }
\ No newline at end of file
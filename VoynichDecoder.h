@@ -1,38 +1,84 @@
 #pragma once
 
 #include "StaticTranslator.h"
+#include "PermutationTranslator.h"
+#include "ScoringKernels.h"
+#include "SwapEnumerator.h"
+#include "IncrementalScorer.h"
 #include "HebrewValidator.h"
 #include "WordSet.h"
 #include "Mapping.h"
 #include "MappingGenerator.h"
+#include "TopResults.h"
+#include "PrefixSearch.h"
+#include "LocalSearch.h"
 #include <vector>
 #include <chrono>
 #include <memory>
 #include <functional>
+#include <atomic>
 
 class VoynichDecoder {
 public:
     // Translator implementation types
     enum class TranslatorType {
-        CPU,    // Use CPU-based implementation
-        CUDA,   // Use CUDA GPU implementation (falls back to CPU if unavailable)
-        AUTO    // Automatically choose best available (CUDA if available, otherwise CPU)
+        CPU,          // Use CPU-based implementation
+        CUDA,         // Use CUDA GPU implementation (falls back to CPU if unavailable)
+        AUTO,         // Automatically choose best available (CUDA if available, otherwise CPU)
+        PERMUTATION,  // CPU permutation-table engine (lookup tables instead of matrix multiply)
+        SIMD,         // Permutation-table engine with AVX2/AVX-512 kernels (scalar fallback)
+        HYBRID        // ThreadManager: CUDA workers on every device plus SIMD CPU workers alongside
+    };
+    
+    // Order in which the mappings of a block are visited
+    enum class EnumerationMode {
+        INDEXED,        // Build every mapping of the block from its global index
+        ADJACENT_SWAP   // Walk the block by transpositions and rescore only affected words (CPU only)
     };
     
     // Configuration for the decoder
     struct DecoderConfig {
         std::string hebrewLexiconPath;        // Path to Hebrew lexicon
+        std::string lexiconImagePath;         // Prebuilt lexicon image ("" = parse the lexicon file)
         std::string voynichWordsPath;         // Path to Voynich manuscript words
         std::string resultsFilePath;          // Path to save results
+        HebrewValidator::ResultFormat resultsFormat;  // Layout of the results file
         double scoreThreshold;                // Minimum score to save results
         TranslatorType translatorType;        // Type of translator implementation to use
+        HebrewValidator::LexiconBackend lexiconBackend;  // Lexicon storage used by the validator
+        EnumerationMode enumerationMode;      // How mappings within a block are enumerated
+        int cudaDevice;                       // CUDA device for this decoder's thread (-1 = runtime default)
+        size_t topResultsCount;               // Best mappings kept by processMappingRange (0 = off)
+        SearchSpace searchSpace;              // How range indices unrank (must match the generator's)
+        bool boundedScoring;                  // Stop scoring a mapping once it can no longer be saved or kept (CPU table paths)
+        std::shared_ptr<const HebrewLexicon> lexicon;  // Already loaded lexicon, e.g. a NUMA node replica (null = acquire)
+        TargetAlphabet targetAlphabet;        // Hebrew letters mappings are scored in (HEBREW_22: CPU translators, indexed enumeration)
         
         DecoderConfig() :
             hebrewLexiconPath("resources/Tanah2.txt"),
+            lexiconImagePath(""),
             voynichWordsPath("resources/Script_freq100.txt"),
             resultsFilePath("voynich_decoder_results.txt"),
+            resultsFormat(HebrewValidator::ResultFormat::TEXT),
             scoreThreshold(25.0),
-            translatorType(TranslatorType::AUTO) {}
+            translatorType(TranslatorType::AUTO),
+            lexiconBackend(HebrewValidator::LexiconBackend::HASH_SET),
+            enumerationMode(EnumerationMode::INDEXED),
+            cudaDevice(-1),
+            topResultsCount(100),
+            boundedScoring(false),
+            targetAlphabet(TargetAlphabet::HEBREW_27) {}
+    };
+    
+    // Cumulative counters published with each batch report (readable from any thread)
+    struct DecoderMetrics {
+        uint64_t wordsProbed;                 // Translated words looked up in the lexicon
+        uint64_t wordsMatched;                // Lookups that found a Hebrew word
+        uint64_t mappingsExitedEarly;         // boundedScoring: mappings abandoned before their last word
+        uint64_t wordsPruned;                 // boundedScoring: words probed for those mappings (not in the two above)
+        uint64_t gpuChunksScored;             // CUDA path only (see StaticTranslator::getCudaTimings)
+        double gpuKernelMs;
+        double gpuTransferMs;
     };
     
     // Processing result structure
@@ -43,9 +89,15 @@ public:
         double score;
         double matchPercentage;
         bool isHighScore;
+        size_t wordsProbed;               // Words looked up to score it (processMapping and the CPU range loop)
+        bool exitedEarly;                 // boundedScoring dropped it: matchedWords counts only wordsProbed
+        uint64_t mappingIndex;            // Range paths: generator index of the mapping (prefix and local search: leaf key)
+        bool hasPermutation;              // Range paths, high scores only: permutation is the scored mapping
+        Permutation permutation;
         
         ProcessingResult() : mappingId(0), totalWords(0), matchedWords(0), 
-                           score(0.0), matchPercentage(0.0), isHighScore(false) {}
+                           score(0.0), matchPercentage(0.0), isHighScore(false),
+                           wordsProbed(0), exitedEarly(false), mappingIndex(0), hasPermutation(false), permutation{} {}
     };
 
 private:
@@ -54,13 +106,29 @@ private:
     // Core components
     std::unique_ptr<HebrewValidator> validator;
     WordSet voynichWords;
+    WordSet::MaskTable voynichMaskTable;     // Distinct Voynich masks and their word counts (what is scored)
     uint64_t nextMappingId;
     bool useCudaTranslation;
+    std::vector<uint32_t> translatedMasks;   // Reused output buffer for mask-based translators
+    ScoringKernels::KernelSet kernels;       // Table and translation kernels chosen for this corpus and target
+    std::unique_ptr<IncrementalScorer> incrementalScorer;  // ADJACENT_SWAP enumeration state
+    TopResults topResults;                   // Best mappings scored by this decoder's thread
+    
+    // Bounded scoring: voynichMaskTable is ordered heaviest first and scored in chunks; a mapping
+    // is dropped once its matches plus every word still unscored fall short of the bound
+    static constexpr size_t BOUND_CHUNK_MASKS = 16;
+    std::vector<size_t> remainingWordsAfterChunk;  // Words in the masks after each chunk
+    size_t minMatchedForHighScore;           // Score threshold, inverted for the corpus size
+    double boundAdmissionScore;              // Top-K admission score the cached count is for
+    size_t boundAdmissionMatched;            // Fewest matches that would enter the top-K
     
     // Thread-local performance tracking (to minimize StatsProvider contention)
     struct ThreadStats {
         uint64_t localMappingsProcessed = 0;
         uint64_t localWordsValidated = 0;
+        uint64_t localWordsMatched = 0;
+        uint64_t localMappingsExitedEarly = 0;
+        uint64_t localWordsPruned = 0;       // Part of localWordsValidated spent on mappings that exited early
         double localHighestScore = 0.0;
         bool hasHighScore = false;
         std::chrono::steady_clock::time_point lastReportTime;
@@ -69,17 +137,58 @@ private:
     };
     ThreadStats threadStats;
     
+    // Written by this decoder's thread when it reports (plain load + store), read by exporters
+    std::atomic<uint64_t> publishedWordsProbed{0};
+    std::atomic<uint64_t> publishedWordsMatched{0};
+    std::atomic<uint64_t> publishedMappingsExitedEarly{0};
+    std::atomic<uint64_t> publishedWordsPruned{0};
+    std::atomic<uint64_t> publishedGpuChunks{0};
+    std::atomic<double> publishedGpuKernelMs{0.0};
+    std::atomic<double> publishedGpuTransferMs{0.0};
+    void publishMetrics();
+    
     // Private helper methods
     bool loadVoynichWords();
     bool determineTranslatorImplementation(TranslatorType type);
     std::string getTranslatorTypeName(TranslatorType type) const;
+    ProcessingResult processMappingWithPermutationTable(const Mapping& mapping);
+    ProcessingResult processPermutation(const Permutation& permutation);
+    // weights: word count of each mask when scoring voynichMaskTable (nullptr: one word per mask)
+    ProcessingResult scoreTranslatedMasks(const uint32_t* hebrewMasks, const uint32_t* weights, size_t count, const Mapping& mapping);
+    void translateWithTable(const PermutationTranslator::LookupTable& table);  // Distinct Voynich masks -> translatedMasks
+    void translateMaskRange(const PermutationTranslator::LookupTable& table, size_t first, size_t count);
+    
+    // Translate and validate the distinct Voynich masks. wordsProbed is the words in the masks
+    // looked up: with boundedScoring a mapping that cannot reach the bound is dropped after fewer
+    // than totalWords, and the matched count is only what those words found.
+    HebrewValidator::ValidationResult validateWithTable(const PermutationTranslator::LookupTable& table, size_t& wordsProbed);
+    size_t getBoundMatched();                // Fewest matches that are saved or enter the top-K
+    
+    // Keep a generator-range result among the best seen (permutation unranked if not given)
+    void offerTopResult(const ProcessingResult& result, uint64_t globalIndex, const Permutation* permutation) {
+        if (result.score > topResults.getAdmissionScore()) {
+            addTopResult(result, globalIndex, permutation);
+        }
+    }
+    void addTopResult(const ProcessingResult& result, uint64_t globalIndex, const Permutation* permutation);
     
-    // Batch processing for CUDA optimization
-    void processMappingsBatch(const std::vector<std::unique_ptr<Mapping>>& mappings,
-                             std::function<void(const ProcessingResult&)> resultCallback,
-                             std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
-                             int threadId,
-                             std::function<bool()> shouldStopCallback);
+    // Adjacent-swap enumeration of a global index range (mapping IDs are global generator
+    // indices, resolved only for high scores)
+    bool processMappingRangeIncremental(uint64_t startIndex, uint64_t endIndex, int threadId,
+                                        std::function<void(const ProcessingResult&)> resultCallback,
+                                        std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                                        std::function<bool()> shouldStopCallback);
+    
+    // Consume one fused GPU chunk over the global indices [startIndex, startIndex + count):
+    // the device generated, translated and validated the mappings and only matched counts came
+    // back, so a Mapping is built (unranked on the host) only for the flagged high scores.
+    // Returns false if stopped before the whole chunk was reported.
+    bool consumeBatchScores(uint64_t startIndex, const uint32_t* matchedCounts, size_t count,
+                            const std::vector<uint32_t>& highScoreIndices,
+                            std::function<void(const ProcessingResult&)> resultCallback,
+                            std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                            int threadId,
+                            std::function<bool()> shouldStopCallback);
     
 public:
     explicit VoynichDecoder(const DecoderConfig& config = DecoderConfig());
@@ -104,6 +213,31 @@ public:
                            std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
                            std::function<bool()> shouldStopCallback = nullptr);
     
+    // Process the generator index range [startIndex, endIndex) without any block accounting
+    // (used for sub-block pieces handed out by the work-stealing scheduler). Returns false if
+    // stopped before the whole range was scored.
+    bool processMappingRange(uint64_t startIndex, uint64_t endIndex, int threadId,
+                           std::function<void(const ProcessingResult&)> resultCallback,
+                           std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                           std::function<bool()> shouldStopCallback = nullptr);
+    
+    // Search one subtree root of a prefix search. Leaves are reported like range mappings,
+    // keyed by PrefixSearch::leafKey; subtrees that can neither reach the score threshold nor
+    // enter the top results are pruned. Returns false if stopped before the subtree was done.
+    bool processPrefixSubtree(const PrefixSearch& search, uint64_t root, int threadId,
+                              std::function<void(const ProcessingResult&)> resultCallback,
+                              std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                              std::function<bool()> shouldStopCallback,
+                              PrefixSearch::SubtreeStats& stats);
+    
+    // Run one round of a local-search chain. Every move counts as a scored mapping in the
+    // batch stats; each new chain best is reported like a range mapping, keyed by
+    // PrefixSearch::leafKey. Returns false once the search is over or stopped.
+    bool processLocalSearchRound(LocalSearch& search, LocalSearch::Chain& chain, int threadId,
+                                 std::function<void(const ProcessingResult&)> resultCallback,
+                                 std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback,
+                                 std::function<bool()> shouldStopCallback = nullptr);
+    
     // Configuration access
     const DecoderConfig& getConfig() const { return config; }
     void updateScoreThreshold(double newThreshold);
@@ -112,6 +246,10 @@ public:
     const WordSet& getVoynichWords() const { return voynichWords; }
     bool isUsingCudaTranslation() const { return useCudaTranslation; }
     
+    // Best mappings scored so far by processMappingRange; only touch from this decoder's thread
+    TopResults& getTopResults() { return topResults; }
+    
     // Performance tracking
+    DecoderMetrics getMetrics() const;
     void reportBatchStatsIfNeeded(std::function<void(int, uint64_t, uint64_t, double, bool)> batchStatsCallback, int threadId, bool force = false);
 };
\ No newline at end of file
@@ -17,19 +17,19 @@ const std::unordered_map<wchar_t, int> Word::hebrewAlphabet = {
 };
 
 void Word::generateBinaryMatrix() {
-    binaryMatrix.assign(27, 0);
+    letterMask = 0;
     
     const auto& currentAlphabet = (alphabet == Alphabet::EVA) ? evaAlphabet : hebrewAlphabet;
     
     for (wchar_t ch : text) {
         auto it = currentAlphabet.find(ch);
         if (it != currentAlphabet.end()) {
-            binaryMatrix[it->second] = 1;
+            letterMask |= (1u << it->second);
         }
     }
 }
 
-Word::Word(const std::wstring& word, Alphabet alph) : text(word), alphabet(alph) {
+Word::Word(const std::wstring& word, Alphabet alph) : text(word), letterMask(0), alphabet(alph) {
     generateBinaryMatrix();
 }
 
@@ -37,8 +37,12 @@ const std::wstring& Word::getText() const {
     return text;
 }
 
-const std::vector<int>& Word::getBinaryMatrix() const {
-    return binaryMatrix;
+uint32_t Word::getLetterMask() const {
+    return letterMask;
+}
+
+std::vector<int> Word::getBinaryMatrix() const {
+    return maskToBinaryVector(letterMask);
 }
 
 Alphabet Word::getAlphabet() const {
@@ -46,8 +50,31 @@ Alphabet Word::getAlphabet() const {
 }
 
 void Word::printBinaryMatrix() const {
-    for (int bit : binaryMatrix) {
-        std::wcout << bit << L" ";
+    for (int i = 0; i < ALPHABET_SIZE; ++i) {
+        std::wcout << ((letterMask >> i) & 1u) << L" ";
     }
     std::wcout << std::endl;
+}
+
+uint32_t Word::binaryVectorToMask(const std::vector<int>& binaryVector) {
+    uint32_t mask = 0;
+    size_t count = binaryVector.size() < size_t(ALPHABET_SIZE) ? binaryVector.size() : size_t(ALPHABET_SIZE);
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (binaryVector[i]) {
+            mask |= (1u << i);
+        }
+    }
+    
+    return mask;
+}
+
+std::vector<int> Word::maskToBinaryVector(uint32_t mask) {
+    std::vector<int> binaryVector(ALPHABET_SIZE, 0);
+    
+    for (int i = 0; i < ALPHABET_SIZE; ++i) {
+        binaryVector[i] = (mask >> i) & 1u;
+    }
+    
+    return binaryVector;
 }
\ No newline at end of file
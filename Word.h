@@ -4,16 +4,47 @@
 #include <vector>
 #include <unordered_map>
 #include <iostream>
+#include <cstdint>
 
 enum class Alphabet {
     EVA,
     HEBREW
 };
 
+// Letters a mapping is scored in: a permutation always assigns the 27 Hebrew letter indices,
+// and a target alphabet decides which of them are told apart
+enum class TargetAlphabet {
+    HEBREW_27,      // The 22 letters and the 5 final forms, each its own letter
+    HEBREW_22       // Final forms folded onto their base letters (kaf, mem, nun, pe, tsadi)
+};
+
 class Word {
+public:
+    // Both alphabets have 27 letters, so a word's letter set fits in the low 27 bits of a uint32_t
+    static constexpr int ALPHABET_SIZE = 27;
+    static constexpr uint32_t FULL_MASK = (1u << ALPHABET_SIZE) - 1;
+    
+    // Hebrew letter index of each letter's base form: 22-26 are the final forms of 10, 12, 13, 16, 17
+    static constexpr int HEBREW_BASE_LETTER_COUNT = 22;
+    static constexpr uint8_t HEBREW_BASE_LETTER[ALPHABET_SIZE] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+        10, 12, 13, 16, 17
+    };
+    
+    // Hebrew mask with every final form replaced by its base letter
+    static constexpr uint32_t foldFinalForms(uint32_t hebrewMask) {
+        uint32_t folded = hebrewMask & ((1u << HEBREW_BASE_LETTER_COUNT) - 1);
+        for (int letter = HEBREW_BASE_LETTER_COUNT; letter < ALPHABET_SIZE; ++letter) {
+            if (hebrewMask & (1u << letter)) {
+                folded |= 1u << HEBREW_BASE_LETTER[letter];
+            }
+        }
+        return folded;
+    }
+
 private:
     std::wstring text;
-    std::vector<int> binaryMatrix;
+    uint32_t letterMask;    // Packed letter set: bit i is set when letter i occurs in the word
     Alphabet alphabet;
     
     static const std::unordered_map<wchar_t, int> evaAlphabet;
@@ -25,7 +56,12 @@ public:
     Word(const std::wstring& word, Alphabet alph);
     
     const std::wstring& getText() const;
-    const std::vector<int>& getBinaryMatrix() const;
+    uint32_t getLetterMask() const;
+    std::vector<int> getBinaryMatrix() const;  // 27-element 0/1 view of the letter mask
     Alphabet getAlphabet() const;
     void printBinaryMatrix() const;
-};
\ No newline at end of file
+    
+    // Conversion between the packed mask and the 27-element binary vector form
+    static uint32_t binaryVectorToMask(const std::vector<int>& binaryVector);
+    static std::vector<int> maskToBinaryVector(uint32_t mask);
+};
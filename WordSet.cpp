@@ -3,9 +3,11 @@
 #include <iostream>
 #include <locale>
 #include <codecvt>
+#include <unordered_map>
 
 void WordSet::addWord(const Word& word) {
     words.push_back(word);
+    letterMasks.push_back(word.getLetterMask());
 }
 
 void WordSet::readFromFile(const std::string& filename, Alphabet alphabet) {
@@ -21,6 +23,7 @@ void WordSet::readFromFile(const std::string& filename, Alphabet alphabet) {
     while (std::getline(file, line)) {
         if (!line.empty()) {
             words.emplace_back(line, alphabet);
+            letterMasks.push_back(words.back().getLetterMask());
         }
     }
     
@@ -31,6 +34,30 @@ size_t WordSet::size() const {
     return words.size();
 }
 
+const std::vector<uint32_t>& WordSet::getLetterMasks() const {
+    return letterMasks;
+}
+
+const uint32_t* WordSet::maskData() const {
+    return letterMasks.data();
+}
+
+WordSet::MaskTable WordSet::buildMaskTable() const {
+    MaskTable table;
+    std::unordered_map<uint32_t, size_t> positions;
+    positions.reserve(letterMasks.size());
+    for (uint32_t mask : letterMasks) {
+        auto inserted = positions.emplace(mask, table.masks.size());
+        if (inserted.second) {
+            table.masks.push_back(mask);
+            table.weights.push_back(1);
+        } else {
+            table.weights[inserted.first->second]++;
+        }
+    }
+    return table;
+}
+
 // Iterator implementation
 WordSet::iterator::iterator(std::vector<Word>::iterator iter) : it(iter) {}
 
@@ -3,10 +3,12 @@
 #include "Word.h"
 #include <vector>
 #include <string>
+#include <cstdint>
 
 class WordSet {
 private:
     std::vector<Word> words;
+    std::vector<uint32_t> letterMasks;  // Packed letter masks, contiguous and parallel to words
     
 public:
     WordSet() = default;
@@ -15,6 +17,19 @@ public:
     void readFromFile(const std::string& filename, Alphabet alphabet);
     size_t size() const;
     
+    // Packed view of the set: one 27-bit letter mask per word, in word order
+    const std::vector<uint32_t>& getLetterMasks() const;
+    const uint32_t* maskData() const;
+    
+    // Distinct letter masks (in order of first occurrence) and how many words have each.
+    // Words differing only in repeated letters (daiin/dain) translate and score alike, so
+    // scorers can probe each mask once and count its weight in matches.
+    struct MaskTable {
+        std::vector<uint32_t> masks;
+        std::vector<uint32_t> weights;
+    };
+    MaskTable buildMaskTable() const;
+    
     class iterator {
     private:
         std::vector<Word>::iterator it;
@@ -0,0 +1,255 @@
+#include "WorkStealingScheduler.h"
+#include <algorithm>
+
+WorkStealingScheduler::WorkStealingScheduler(BlockSource& generator, size_t workerCount,
+                                             const SchedulerConfig& config)
+    : generator(generator), config(config), issuedMappings(0), unissuedMappings(0), generatorDrained(false),
+      blocksClaimed(0), blocksCompleted(0), steals(0), nodeLocalSteals(0), mappingsStolen(0) {
+    if (this->config.chunkSize == 0) {
+        this->config.chunkSize = 1;
+    }
+    
+    if (this->config.maxChunkSize < this->config.chunkSize) {
+        this->config.maxChunkSize = this->config.chunkSize;
+    }
+    
+    ranges.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        ranges.push_back(std::make_unique<WorkerRange>());
+        ranges.back()->chunkSize = this->config.chunkSize;
+    }
+}
+
+bool WorkStealingScheduler::acquire(int workerId, WorkItem& item) {
+    if (workerId < 0 || static_cast<size_t>(workerId) >= ranges.size()) {
+        return false;
+    }
+    
+    while (true) {
+        if (takeFromOwnRange(workerId, item)) {
+            return true;
+        }
+        
+        if (config.mappingBudget > 0 && issuedMappings.load() >= config.mappingBudget) {
+            return false; // Budget fully handed out
+        }
+        
+        // Fresh blocks keep the block window compact; steal only when none may be claimed
+        if (mayClaimBlock() && claimNewBlock(workerId)) {
+            continue;
+        }
+        
+        if (!stealRange(workerId)) {
+            return false;
+        }
+    }
+}
+
+void WorkStealingScheduler::complete(const WorkItem& item) {
+    if (!item.ticket || item.size() == 0) {
+        return;
+    }
+    
+    // The piece that scores the last mappings of a block completes it in the generator
+    uint64_t pieceSize = item.size();
+    if (item.ticket->unscoredMappings.fetch_sub(pieceSize) == pieceSize) {
+        generator.completeSharedBlock(item.ticket->claimingThreadId, item.ticket->blockIndex);
+        blocksCompleted++;
+    }
+}
+
+void WorkStealingScheduler::recordThroughput(int workerId, uint64_t mappings, double seconds) {
+    if (workerId < 0 || static_cast<size_t>(workerId) >= ranges.size() || mappings == 0 || seconds <= 0.0) {
+        return;
+    }
+    
+    WorkerRange& range = *ranges[workerId];
+    std::lock_guard<std::mutex> lock(range.rangeMutex);
+    range.measuredMappings += mappings;
+    range.measuredSeconds += seconds;
+    
+    if (config.targetPieceMs <= 0.0) {
+        return;
+    }
+    
+    // Smooth over pieces so one stalled piece does not collapse the size
+    double rate = mappings / seconds;
+    range.smoothedRate = (range.smoothedRate > 0.0) ? 0.7 * range.smoothedRate + 0.3 * rate : rate;
+    
+    double target = range.smoothedRate * config.targetPieceMs / 1000.0;
+    uint64_t lowerBound = std::max<uint64_t>(1, std::min(config.minStealSize, config.chunkSize));
+    range.chunkSize = std::min(config.maxChunkSize, std::max(lowerBound, static_cast<uint64_t>(target)));
+}
+
+WorkStealingScheduler::WorkerThroughput WorkStealingScheduler::getWorkerThroughput(int workerId) const {
+    WorkerThroughput throughput = { 0, 0.0, config.chunkSize };
+    if (workerId < 0 || static_cast<size_t>(workerId) >= ranges.size()) {
+        return throughput;
+    }
+    
+    WorkerRange& range = *ranges[workerId];
+    std::lock_guard<std::mutex> lock(range.rangeMutex);
+    throughput.mappings = range.measuredMappings;
+    throughput.seconds = range.measuredSeconds;
+    throughput.chunkSize = range.chunkSize;
+    return throughput;
+}
+
+WorkStealingScheduler::SchedulerStats WorkStealingScheduler::getStats() const {
+    SchedulerStats stats;
+    stats.blocksClaimed = blocksClaimed.load();
+    stats.blocksCompleted = blocksCompleted.load();
+    stats.steals = steals.load();
+    stats.nodeLocalSteals = nodeLocalSteals.load();
+    stats.mappingsStolen = mappingsStolen.load();
+    return stats;
+}
+
+bool WorkStealingScheduler::takeFromOwnRange(int workerId, WorkItem& item) {
+    WorkerRange& range = *ranges[workerId];
+    std::lock_guard<std::mutex> lock(range.rangeMutex);
+    
+    if (range.nextIndex >= range.endIndex) {
+        return false;
+    }
+    
+    uint64_t size = reserveBudget(std::min(range.chunkSize, range.endIndex - range.nextIndex));
+    if (size == 0) {
+        return false;
+    }
+    
+    item.startIndex = range.nextIndex;
+    item.endIndex = range.nextIndex + size;
+    item.ticket = range.ticket;
+    
+    range.nextIndex += size;
+    unissuedMappings -= size;
+    if (range.nextIndex >= range.endIndex) {
+        range.ticket.reset();
+    }
+    return true;
+}
+
+bool WorkStealingScheduler::claimNewBlock(int workerId) {
+    uint64_t blockIndex = 0;
+    uint64_t startIndex = 0;
+    uint64_t endIndex = 0;
+    if (!generator.claimSharedBlock(workerId, blockIndex, startIndex, endIndex)) {
+        generatorDrained = true;
+        return false;
+    }
+    
+    WorkerRange& range = *ranges[workerId];
+    std::lock_guard<std::mutex> lock(range.rangeMutex);
+    range.nextIndex = startIndex;
+    range.endIndex = endIndex;
+    range.ticket = std::make_shared<BlockTicket>(blockIndex, workerId, endIndex - startIndex);
+    
+    unissuedMappings += endIndex - startIndex;
+    blocksClaimed++;
+    return true;
+}
+
+bool WorkStealingScheduler::stealRange(int workerId) {
+    // A few attempts, since the chosen victim may drain its range before it is locked
+    for (size_t attempt = 0; attempt < ranges.size(); ++attempt) {
+        // Largest range on the thief's node, and anywhere; a local one worth splitting wins
+        size_t victimId = ranges.size();
+        uint64_t largestRemaining = 0;
+        size_t localVictimId = ranges.size();
+        uint64_t largestLocalRemaining = 0;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            if (static_cast<int>(i) == workerId) continue;
+            
+            WorkerRange& candidate = *ranges[i];
+            std::lock_guard<std::mutex> lock(candidate.rangeMutex);
+            uint64_t remaining = candidate.endIndex - candidate.nextIndex;
+            if (remaining > largestRemaining) {
+                largestRemaining = remaining;
+                victimId = i;
+            }
+            if (remaining > largestLocalRemaining && sameNode(i, static_cast<size_t>(workerId))) {
+                largestLocalRemaining = remaining;
+                localVictimId = i;
+            }
+        }
+        if (localVictimId != ranges.size() && largestLocalRemaining >= config.minStealSize) {
+            victimId = localVictimId;
+            largestRemaining = largestLocalRemaining;
+        }
+        
+        if (victimId == ranges.size() || largestRemaining < config.minStealSize) {
+            return false; // Nothing left that is worth splitting
+        }
+        
+        // Split off the back half; the victim keeps the front it is already walking
+        uint64_t stolenStart = 0;
+        uint64_t stolenEnd = 0;
+        std::shared_ptr<BlockTicket> ticket;
+        {
+            WorkerRange& victim = *ranges[victimId];
+            std::lock_guard<std::mutex> lock(victim.rangeMutex);
+            uint64_t remaining = victim.endIndex - victim.nextIndex;
+            if (remaining < config.minStealSize) {
+                continue;
+            }
+            
+            stolenStart = victim.nextIndex + (remaining + 1) / 2;
+            stolenEnd = victim.endIndex;
+            victim.endIndex = stolenStart;
+            ticket = victim.ticket;
+        }
+        
+        WorkerRange& range = *ranges[workerId];
+        std::lock_guard<std::mutex> lock(range.rangeMutex);
+        range.nextIndex = stolenStart;
+        range.endIndex = stolenEnd;
+        range.ticket = ticket;
+        
+        steals++;
+        if (sameNode(victimId, static_cast<size_t>(workerId))) {
+            nodeLocalSteals++;
+        }
+        mappingsStolen += stolenEnd - stolenStart;
+        return true;
+    }
+    
+    return false;
+}
+
+bool WorkStealingScheduler::sameNode(size_t a, size_t b) const {
+    // Without a node map every worker counts as local
+    if (a >= config.workerNodes.size() || b >= config.workerNodes.size()) {
+        return true;
+    }
+    return config.workerNodes[a] == config.workerNodes[b];
+}
+
+bool WorkStealingScheduler::mayClaimBlock() const {
+    if (generatorDrained.load()) {
+        return false;
+    }
+    
+    // Under a budget, claim only while the work already claimed cannot cover it
+    return config.mappingBudget == 0 ||
+           issuedMappings.load() + unissuedMappings.load() < config.mappingBudget;
+}
+
+uint64_t WorkStealingScheduler::reserveBudget(uint64_t requested) {
+    if (config.mappingBudget == 0) {
+        issuedMappings += requested;
+        return requested;
+    }
+    
+    uint64_t issued = issuedMappings.load();
+    while (true) {
+        if (issued >= config.mappingBudget) {
+            return 0;
+        }
+        
+        uint64_t granted = std::min(requested, config.mappingBudget - issued);
+        if (issuedMappings.compare_exchange_weak(issued, issued + granted)) {
+            return granted;
+        }
+    }
+}
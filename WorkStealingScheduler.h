@@ -0,0 +1,123 @@
+#pragma once
+
+#include "BlockSource.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+// Hands out sub-block pieces of generator blocks to worker threads. Blocks come from a
+// BlockSource (the local generator or a cluster coordinator). Each worker owns the
+// range of its current block and consumes it from the front; a worker whose range is empty
+// claims a new block, and once no new block may be claimed it steals the back half of the
+// largest remaining range of another worker. A generator block is completed only when every
+// piece of it has been scored, whichever threads scored them. With workerNodes set, thieves
+// prefer victims on their own NUMA node and cross nodes only when no local range is large
+// enough to split.
+class WorkStealingScheduler {
+public:
+    struct SchedulerConfig {
+        uint64_t chunkSize;       // Mappings per piece handed to a worker (initial size when adaptive)
+        uint64_t minStealSize;    // Smallest remaining range worth splitting
+        uint64_t mappingBudget;   // Maximum mappings handed out in total (0 = unlimited)
+        double targetPieceMs;     // Size each worker's pieces to take this long (0 = fixed chunkSize)
+        uint64_t maxChunkSize;    // Upper bound for adaptive pieces
+        std::vector<int> workerNodes;  // NUMA node of each worker (empty = steal from any worker)
+        
+        SchedulerConfig() : chunkSize(65536), minStealSize(8192), mappingBudget(0),
+                            targetPieceMs(0.0), maxChunkSize(1ULL << 24) {}
+    };
+    
+    // One generator block; pieces of it may be spread across several workers
+    struct BlockTicket {
+        uint64_t blockIndex;
+        int claimingThreadId;                  // Thread whose generator slot holds the claim
+        std::atomic<uint64_t> unscoredMappings;  // Mappings not yet reported complete
+        
+        BlockTicket(uint64_t index, int threadId, uint64_t mappings)
+            : blockIndex(index), claimingThreadId(threadId), unscoredMappings(mappings) {}
+    };
+    
+    // A piece of work: the global index range [startIndex, endIndex) of one block
+    struct WorkItem {
+        uint64_t startIndex;
+        uint64_t endIndex;
+        std::shared_ptr<BlockTicket> ticket;
+        
+        WorkItem() : startIndex(0), endIndex(0) {}
+        uint64_t size() const { return endIndex - startIndex; }
+    };
+    
+    // Counters for the end-of-run summary
+    struct SchedulerStats {
+        uint64_t blocksClaimed;
+        uint64_t blocksCompleted;
+        uint64_t steals;
+        uint64_t nodeLocalSteals;   // Steals from a worker on the thief's NUMA node
+        uint64_t mappingsStolen;
+    };
+    
+    // Measured speed of one worker (pieces reported through recordThroughput)
+    struct WorkerThroughput {
+        uint64_t mappings;
+        double seconds;
+        uint64_t chunkSize;       // Piece size currently handed to the worker
+        
+        double mappingsPerSecond() const { return seconds > 0.0 ? mappings / seconds : 0.0; }
+    };
+
+private:
+    // Unprocessed part of one worker's block. Only the owner and occasional thieves lock it.
+    struct alignas(64) WorkerRange {
+        std::mutex rangeMutex;
+        uint64_t nextIndex;
+        uint64_t endIndex;
+        std::shared_ptr<BlockTicket> ticket;
+        uint64_t chunkSize;          // Piece size for this worker (adapts to its throughput)
+        uint64_t measuredMappings;   // Totals reported through recordThroughput
+        double measuredSeconds;
+        double smoothedRate;         // Mappings per second, exponentially smoothed
+        
+        WorkerRange() : nextIndex(0), endIndex(0), chunkSize(0), measuredMappings(0), measuredSeconds(0.0), smoothedRate(0.0) {}
+    };
+    
+    BlockSource& generator;
+    SchedulerConfig config;
+    std::vector<std::unique_ptr<WorkerRange>> ranges;
+    
+    std::atomic<uint64_t> issuedMappings;      // Mappings handed out as pieces
+    std::atomic<uint64_t> unissuedMappings;    // Mappings sitting in worker ranges
+    std::atomic<bool> generatorDrained;        // Generator has no more blocks to claim
+    std::atomic<uint64_t> blocksClaimed;
+    std::atomic<uint64_t> blocksCompleted;
+    std::atomic<uint64_t> steals;
+    std::atomic<uint64_t> nodeLocalSteals;
+    std::atomic<uint64_t> mappingsStolen;
+    
+    bool takeFromOwnRange(int workerId, WorkItem& item);
+    bool claimNewBlock(int workerId);
+    bool stealRange(int workerId);
+    bool mayClaimBlock() const;
+    bool sameNode(size_t a, size_t b) const;
+    uint64_t reserveBudget(uint64_t requested);
+
+public:
+    WorkStealingScheduler(BlockSource& generator, size_t workerCount,
+                          const SchedulerConfig& config = SchedulerConfig());
+    
+    // Next piece for a worker (thread-safe); false when there is no work left for it
+    bool acquire(int workerId, WorkItem& item);
+    
+    // Report a piece as fully scored; completes its generator block after the last piece.
+    // Pieces abandoned on shutdown are simply not reported, so their blocks stay PENDING.
+    void complete(const WorkItem& item);
+    
+    // Report how long a worker took for a piece. With targetPieceMs set, the worker's next
+    // pieces are resized so fast workers (GPUs) get large pieces and slow ones (CPU cores)
+    // small ones, keeping every piece about targetPieceMs long.
+    void recordThroughput(int workerId, uint64_t mappings, double seconds);
+    WorkerThroughput getWorkerThroughput(int workerId) const;
+    
+    SchedulerStats getStats() const;
+};
@@ -1,10 +1,79 @@
 #include "ThreadManager.h"
 #include "StaticTranslator.h"
+#include "ClusterCoordinator.h"
 #include <iostream>
 #include <locale>
 #include <exception>
+#include <string>
+#include <csignal>
+#include <atomic>
+#include <chrono>
 
-int main()
+namespace {
+    std::atomic<bool> coordinatorStopRequested{false};
+    
+    void coordinatorSignalHandler(int) {
+        coordinatorStopRequested = true;
+    }
+    
+    // Serve the mapping space to worker nodes until Ctrl+C or until every block is done
+    int runCoordinator(uint16_t port) {
+        ClusterCoordinator::CoordinatorConfig coordinatorConfig;
+        coordinatorConfig.port = port;
+        coordinatorConfig.blockSize = 1000000;
+        coordinatorConfig.resultsFilePath = "cluster_analysis_results.txt";
+        
+        ClusterCoordinator coordinator(coordinatorConfig);
+        if (!coordinator.start()) {
+            return 1;
+        }
+        
+        std::signal(SIGINT, coordinatorSignalHandler);
+        int secondsSinceStatus = 0;
+        while (!coordinatorStopRequested.load() && !coordinator.isSearchComplete()) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            if (++secondsSinceStatus < 10) continue;
+            secondsSinceStatus = 0;
+            
+            auto stats = coordinator.getStats();
+            std::wcout << L"[Cluster] Nodes: " << stats.nodesConnected << L", leases: " << stats.leasesGranted
+                       << L" granted / " << stats.leasesExpired << L" expired, blocks completed: " << stats.blocksCompleted
+                       << L", results: " << stats.resultsReceived << std::endl;
+        }
+        std::signal(SIGINT, SIG_DFL);
+        
+        coordinator.stop();
+        std::wcout << L"Cluster coordinator stopped. Results: " << coordinatorConfig.resultsFilePath.c_str() << std::endl;
+        return 0;
+    }
+    
+    // Compile a lexicon image ahead of time (batch jobs then start by mapping it)
+    int buildLexiconImage(const std::string& sourcePath, const std::string& imagePath) {
+        auto start = std::chrono::steady_clock::now();
+        WordSet hebrewWords;
+        hebrewWords.readFromFile(sourcePath, Alphabet::HEBREW);
+        HebrewLexicon lexicon(hebrewWords, HebrewLexicon::Backend::PERFECT_HASH);
+        if (lexicon.empty() || !lexicon.saveImage(imagePath, sourcePath)) {
+            std::wcerr << L"Could not build a lexicon image from " << sourcePath.c_str() << std::endl;
+            return 1;
+        }
+        auto buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        
+        start = std::chrono::steady_clock::now();
+        bool mapped = HebrewLexicon::loadImage(imagePath, sourcePath, HebrewLexicon::Backend::PERFECT_HASH) != nullptr;
+        auto loadMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::wcout << L"Lexicon image " << imagePath.c_str() << L": " << lexicon.getWordCount() << L" words, "
+                   << lexicon.getUniqueMaskCount() << L" letter sets; built in " << buildMs << L" ms, "
+                   << (mapped ? L"mapped in " + std::to_wstring(loadMs) + L" ms" : std::wstring(L"could not be mapped")) << std::endl;
+        return mapped ? 0 : 1;
+    }
+}
+
+// Usage: VoynichDecoder                      standalone run
+//        VoynichDecoder --coordinator [port] lease the mapping space to worker nodes
+//        VoynichDecoder --worker host:port [name]  score blocks leased by a coordinator
+//        VoynichDecoder --build-lexicon-image [words] [image]  compile the Hebrew lexicon image
+int main(int argc, char* argv[])
 {
     // Set console to handle Unicode output
     std::wcout.imbue(std::locale(""));
@@ -14,17 +83,30 @@ int main()
     std::wcout << L"Systematic analysis of EVA-to-Hebrew translation mappings" << std::endl;
     std::wcout << std::endl;
     
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--coordinator") {
+        return runCoordinator(static_cast<uint16_t>(argc > 2 ? std::stoi(argv[2]) : 5757));
+    }
+    if (mode == "--build-lexicon-image") {
+        return buildLexiconImage(argc > 2 ? argv[2] : "resources/Tanah2.txt", argc > 3 ? argv[3] : "resources/Tanah2.lexicon.bin");
+    }
+    
     // Display available translator implementations
     std::wcout << L"Available Translator Implementations:" << std::endl;
     std::wcout << L"  CPU  - High-performance CPU implementation with multi-threading" << std::endl;
     std::wcout << L"  CUDA - GPU-accelerated implementation (if CUDA is available)" << std::endl;
     std::wcout << L"  AUTO - Automatically choose best available implementation" << std::endl;
+    std::wcout << L"  PERMUTATION - CPU lookup-table engine for permutation mappings" << std::endl;
+    std::wcout << L"  SIMD - Lookup-table engine with AVX2/AVX-512 kernels (detected: "
+               << StaticTranslator::getSimdLevelName(StaticTranslator::getSimdLevel()).c_str() << L")" << std::endl;
+    std::wcout << L"  HYBRID - CUDA workers on every device plus SIMD CPU workers" << std::endl;
     std::wcout << std::endl;
     
     // Check CUDA availability
     bool cudaAvailable = StaticTranslator::isCudaAvailable();
     std::wcout << L"CUDA Status: " << (cudaAvailable ? L"Available" : L"Not Available") << std::endl;
     if (cudaAvailable) {
+        std::wcout << L"CUDA Devices: " << StaticTranslator::getCudaDeviceCount() << std::endl;
         std::wcout << L"CUDA Device: " << StaticTranslator::getCudaDeviceInfo().c_str() << std::endl;
     }
     std::wcout << std::endl;
@@ -34,24 +116,85 @@ int main()
     config.numThreads = 10;  // 0 - Auto-detect optimal thread count
     
     // Choose translator implementation
-    // Options: VoynichDecoder::TranslatorType::CPU, CUDA, or AUTO
+    // Options: VoynichDecoder::TranslatorType::CPU, CUDA, AUTO, PERMUTATION, SIMD, or HYBRID
     //config.translatorType = VoynichDecoder::TranslatorType::AUTO;  // Let system choose best
     
     // Alternative configurations:
      config.translatorType = VoynichDecoder::TranslatorType::CPU;   // Force CPU implementation
      //config.translatorType = VoynichDecoder::TranslatorType::CUDA;  // Force CUDA (will throw exception if unavailable)
+     //config.translatorType = VoynichDecoder::TranslatorType::PERMUTATION;  // CPU permutation-table engine
+     //config.translatorType = VoynichDecoder::TranslatorType::SIMD;  // Permutation tables, AVX2/AVX-512 kernels
+     //config.translatorType = VoynichDecoder::TranslatorType::HYBRID;  // Every CUDA device plus SIMD CPU workers
+    
+    // CUDA/AUTO spread all workers over every CUDA device; HYBRID drives each device with
+    // gpuWorkersPerDevice workers and runs the remaining threads on the CPU
+    config.gpuWorkersPerDevice = 2;
+    
+    // Thread placement: NONE lets threads float; CORE pins each worker to one CPU and NUMA_NODE
+    // to its node's CPUs (nodes alternate). Pinned workers steal from their own node first and,
+    // with numaReplicas on a multi-socket host, probe a lexicon copy in their node's memory
+    config.threadAffinity = ThreadManager::ThreadAffinity::NONE;
+    config.numaReplicas = true;
     
     // Note: If you force CUDA on a system without CUDA, the decoder will throw an exception
     // Use AUTO for automatic fallback to CPU when CUDA is not available
     
+    // Lexicon backend: HASH_SET, BITSET (16 MiB per decoder, fastest probe) or PERFECT_HASH (compact)
+    config.lexiconBackend = HebrewValidator::LexiconBackend::PERFECT_HASH;
+    
+    // Enumeration: INDEXED builds each mapping, ADJACENT_SWAP walks blocks by single swaps (CPU)
+    config.enumerationMode = VoynichDecoder::EnumerationMode::ADJACENT_SWAP;
+    
+    // Bounded scoring (INDEXED CPU enumeration): stop scoring a mapping as soon as it can no longer
+    // reach scoreThreshold or the top results; partial scores only ever fall below both
+    config.boundedScoring = false;
+    
+    // Target alphabet: HEBREW_27 tells the five final forms apart, HEBREW_22 folds them onto their
+    // base letters (flat enumeration on CPU workers; CUDA translators switch to SIMD)
+    config.targetAlphabet = TargetAlphabet::HEBREW_27;
+    
     config.voynichWordsPath = "resources/Script_freq100.txt";
     config.hebrewLexiconPath = "resources/Tanah2.txt";
+    config.lexiconImagePath = "resources/Tanah2.lexicon.bin";  // Mapped at startup, rebuilt when Tanah2.txt changes
     config.resultsFilePath = "voynich_analysis_results.txt";
+    config.resultsFormat = HebrewValidator::ResultFormat::TEXT;  // TEXT (readable), CSV or BINARY (compact records)
     config.scoreThreshold = 45.0;  // Save results with 45%+ Hebrew word matches
     config.statusUpdateIntervalMs = 5000;  // Status update every 5 seconds
     config.maxMappingsToProcess = 0;  // Limited for batch CUDA performance testing
     config.mappingBlockSize = 1000000;  // 1M mappings per generator block
     
+    // Search only the assignments of the EVA letters the corpus uses (indexed enumeration, no
+    // cluster mode). A state file written for the other space is ignored, so switching restarts.
+    config.reduceSearchSpace = false;
+    
+    // Search engine: FLAT enumerates generator blocks; PREFIX assigns letters one at a time and
+    // skips subtrees that cannot reach scoreThreshold or the top results; LOCAL anneals one chain
+    // of swap moves per worker (CPU, standalone only)
+    config.searchEngine = ThreadManager::SearchEngine::FLAT;
+    config.prefixRootDepth = 3;
+    config.localInitialTemperature = 2.0;  // 0 = hill climbing
+    config.localTargetMatched = 0;  // Words a chain must match to end the run (time-to-score runs)
+    config.localSeedFile = "";  // e.g. "mapping_generator_top.bin" to start from saved best mappings
+    
+    // Machine-readable metrics: JSON_LINES appends a sample to metrics.filePath every intervalMs,
+    // HTTP serves Prometheus text on metrics.port (/metrics); DISABLED keeps only the console output
+    config.metrics.mode = MetricsExporter::Mode::DISABLED;
+    config.metrics.filePath = "voynich_metrics.jsonl";
+    config.metrics.port = 9464;
+    config.metrics.intervalMs = 10000;
+    
+    // Per-stage timing (generation, translation, validation, bookkeeping) in the status lines and
+    // final report; only builds that define VOYNICH_PROFILING record anything. A trace path also
+    // writes the first traceWindowMs of sampled scopes as Chrome trace JSON (chrome://tracing, Perfetto)
+    config.profiler.sampleInterval = 64;
+    config.profiler.traceFilePath = "";
+    
+    // Cluster worker node: blocks (and their size) come from the coordinator
+    if (mode == "--worker" && argc > 2) {
+        config.coordinatorAddress = argv[2];
+        config.nodeName = argc > 3 ? argv[3] : "node";
+    }
+    
     // Create and run the thread manager with exception handling
     try {
         ThreadManager threadManager(config);